@@ -4,7 +4,7 @@
 declare interface ScriptConnection {
     /**
      * Disconnect the script connection,
-     * established by {@link engine.makeConnection} or {@link engine.makeUnbufferedConnection}
+     * established by {@link engine.makeConnection}, {@link engine.makeUnbufferedConnection} or {@link engine.makePolledConnection}
      *
      * @returns Returns true if the connection has been disconnected successfully
      */
@@ -12,7 +12,7 @@ declare interface ScriptConnection {
 
     /**
      * Triggers the execution of the callback function of the script connection,
-     * established by {@link engine.makeConnection} or {@link engine.makeUnbufferedConnection}
+     * established by {@link engine.makeConnection}, {@link engine.makeUnbufferedConnection} or {@link engine.makePolledConnection}
      * with the actual value of a control.
      *
      * Note: To execute all callback functions connected to a ControlObject at once, use {@link engine.trigger} instead
@@ -128,6 +128,30 @@ declare namespace engine {
      */
     function makeUnbufferedConnection(group: string, name: string, callback: CoCallback): ScriptConnection | undefined;
 
+    /**
+     * Connects a specified Mixxx Control with a callback function, which is executed if the value of the control changes
+     *
+     * This connection is polled - the value of the control is sampled periodically (see {@link engine.setPollInterval}) and the
+     * callback function is only executed if the value has changed since the last poll. All intermediate
+     * values are skipped and no events are queued, which makes it the most efficient connection
+     * for controls that change continuously.
+     *
+     * {@link engine.trigger} executes the callback function immediately, like for the other connections.
+     *
+     * @param group Group of the control e.g. "[Channel1]"
+     * @param name Name of the control e.g. "playposition"
+     * @param callback JS function, which will be called at most once per poll interval, if the value of the connected control has changed.
+     * @returns Returns script connection object on success, otherwise 'undefined''
+     */
+    function makePolledConnection(group: string, name: string, callback: CoCallback): ScriptConnection | undefined;
+
+    /**
+     * Sets the interval for sampling the controls of all polled connections of this mapping
+     *
+     * @param milliseconds Interval in milliseconds, 16 ms by default
+     */
+    function setPollInterval(milliseconds: number): void;
+
     /**
      * This function is a legacy version of makeConnection with several alternate
      * ways of invoking it. The callback function can be passed either as a string of
@@ -1,4 +1,21 @@
 
+/*
+ * Input reports
+ *
+ * Each input report is passed to the `incomingData(data, length)` function
+ * of the mapping unless the mapping declares input fields for the report.
+ *
+ * Input fields are declared by `<control>` elements in the `<controls>`
+ * section of the mapping file. They are decoded natively and only changed
+ * fields set the bound control or call the bound script function.
+ *
+ * If at least one field is declared for the ID of a report, i.e. the first
+ * byte for devices with report IDs, the report is no longer passed to
+ * `incomingData()`. Undeclared bytes of such a report are discarded. Reports
+ * with other IDs are still passed to `incomingData()` unchanged. Either
+ * declare all inputs of a report as fields or none of them.
+ */
+
 /** HidControllerJSProxy */
 
 declare namespace controller {
@@ -95,4 +112,57 @@ declare namespace controller {
      *           allowing it to be read, modified and sent it back to the controller.
      */
     function getFeatureReport(reportID: number): ArrayBuffer;
+
+    /**
+     * Creates the framebuffer of a screen of the controller
+     *
+     * The framebuffer is compared with the previously sent frame on each update
+     * and only the changed parts are encoded and sent asynchronously.
+     *
+     *  @param width Width in pixels
+     *  @param height Height in pixels
+     *  @param options Encoding of the packets, which consist of the header, x, y,
+     *                 width and height as 16 bit integers and the pixels.
+     *                 For HID devices the header starts with the ReportID.
+     *  @returns The screen or null for invalid arguments or if the packets of
+     *           the complete framebuffer exceed the output queue of the device
+     */
+    function createScreen(width: number, height: number, options?: {
+        pixelFormat?: "rgb565" | "rgb888",
+        bigEndian?: boolean,
+        header?: number[],
+        maxPacketSize?: number,
+        tileSize?: number,
+    }): ControllerScreen | null;
+}
+
+/** ControllerScreenJSProxy */
+interface ControllerScreen {
+    width(): number;
+    height(): number;
+
+    /**
+     * Copies pixels into the framebuffer
+     *
+     *  @param rgbaData 4 bytes R, G, B, A per pixel and width * 4 bytes per row
+     */
+    setPixels(x: number, y: number, width: number, height: number, rgbaData: ArrayBuffer): void;
+
+    /**
+     * Fills a rectangle of the framebuffer
+     *
+     *  @param color 0xRRGGBB
+     */
+    fillRect(x: number, y: number, width: number, height: number, color: number): void;
+
+    /** Sends the complete framebuffer with the next update */
+    invalidate(): void;
+
+    /**
+     * Sends the changed parts of the framebuffer asynchronously
+     *
+     *  @returns false if the device didn't keep up and the update was dropped.
+     *           The next update then contains its changes as well.
+     */
+    update(): boolean;
 }
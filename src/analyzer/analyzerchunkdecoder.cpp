@@ -0,0 +1,242 @@
+#include "analyzer/analyzerchunkdecoder.h"
+
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+std::atomic<int> AnalyzerBusyThreadScope::s_busyThreadCount{0};
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerChunkDecoder");
+
+// Limits both the number of concurrently opened files and the
+// memory consumption for the reorder buffer.
+constexpr int kMaxHelperThreadCount = 3;
+
+bool isParallelDecodingSupported(const QString& fileType) {
+    // Formats with constant frame sizes, seek tables, or a restored
+    // seek index (see SeekIndexCache) that report their exact length.
+    return fileType == QLatin1String("wav") ||
+            fileType == QLatin1String("aif") ||
+            fileType == QLatin1String("aiff") ||
+            fileType == QLatin1String("flac") ||
+            fileType == QLatin1String("mp3");
+}
+
+} // anonymous namespace
+
+//static
+std::unique_ptr<AnalyzerChunkDecoder> AnalyzerChunkDecoder::create(
+        const TrackPointer& pTrack,
+        const mixxx::AudioSource::OpenParams& openParams,
+        mixxx::IndexRange frameIndexRange) {
+    DEBUG_ASSERT(pTrack);
+    if (!isParallelDecodingSupported(pTrack->getType())) {
+        return nullptr;
+    }
+    if (frameIndexRange.length() < 2 * kFramesPerStripe) {
+        // Not worth the effort
+        return nullptr;
+    }
+    const int idleThreadCount = QThread::idealThreadCount() -
+            AnalyzerBusyThreadScope::busyThreadCount();
+    const int helperThreadCount = math_min(
+            math_min(idleThreadCount, kMaxHelperThreadCount),
+            static_cast<int>(frameIndexRange.length() / kFramesPerStripe));
+    if (helperThreadCount <= 0) {
+        return nullptr;
+    }
+    return std::make_unique<AnalyzerChunkDecoder>(
+            [pTrack, openParams] {
+                auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+                if (!pAudioSource) {
+                    kLogger.warning()
+                            << "Failed to open file for decoding:"
+                            << pTrack->getLocation();
+                }
+                return pAudioSource;
+            },
+            frameIndexRange,
+            helperThreadCount);
+}
+
+AnalyzerChunkDecoder::AnalyzerChunkDecoder(
+        OpenAudioSourceFunc openAudioSource,
+        mixxx::IndexRange frameIndexRange,
+        int helperThreadCount)
+        : m_openAudioSource(std::move(openAudioSource)),
+          m_maxStripesAhead(2 * helperThreadCount),
+          m_aborted(false),
+          m_activeHelperThreadCount(helperThreadCount),
+          m_nextDecodeStripeIndex(0),
+          m_nextConsumeStripeIndex(0),
+          m_endStripeIndex(0),
+          m_currentStripeOffset(0),
+          m_failed(false) {
+    // Stripe boundaries are aligned to chunk boundaries. The analyzers
+    // receive exactly the same chunks as when decoding sequentially.
+    while (!frameIndexRange.empty()) {
+        m_stripeRanges.push_back(frameIndexRange.splitAndShrinkFront(
+                math_min(kFramesPerStripe, frameIndexRange.length())));
+    }
+    m_endStripeIndex = static_cast<int>(m_stripeRanges.size());
+    kLogger.debug()
+            << "Decoding"
+            << m_stripeRanges.size()
+            << "stripes with"
+            << helperThreadCount
+            << "helper threads";
+    m_helperThreads.reserve(helperThreadCount);
+    for (int i = 0; i < helperThreadCount; ++i) {
+        auto pHelperThread = std::unique_ptr<QThread>(QThread::create([this] {
+            decodeStripes();
+        }));
+        pHelperThread->setObjectName(QStringLiteral("AnalyzerChunkDecoder %1").arg(i + 1));
+        // Same priority as the analyzer thread
+        pHelperThread->start(QThread::InheritPriority);
+        m_helperThreads.push_back(std::move(pHelperThread));
+    }
+}
+
+AnalyzerChunkDecoder::~AnalyzerChunkDecoder() {
+    m_aborted.store(true);
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_stripeConsumed.wakeAll();
+    }
+    for (const auto& pHelperThread : m_helperThreads) {
+        pHelperThread->wait();
+    }
+}
+
+void AnalyzerChunkDecoder::decodeStripes() {
+    AnalyzerBusyThreadScope busyThreadScope;
+    // Each helper thread needs its own audio source
+    mixxx::AudioSourcePointer pAudioSource;
+    if (!m_aborted.load()) {
+        pAudioSource = m_openAudioSource();
+    }
+    if (pAudioSource) {
+        mixxx::AudioSourceStereoProxy stereoSource(
+                pAudioSource,
+                mixxx::kAnalysisFramesPerChunk);
+        while (true) {
+            int stripeIndex;
+            {
+                const auto locker = lockMutex(&m_mutex);
+                while (!m_aborted.load() &&
+                        m_nextDecodeStripeIndex < m_endStripeIndex &&
+                        m_nextDecodeStripeIndex >=
+                                m_nextConsumeStripeIndex + m_maxStripesAhead) {
+                    m_stripeConsumed.wait(&m_mutex);
+                }
+                if (m_aborted.load() ||
+                        m_nextDecodeStripeIndex >= m_endStripeIndex) {
+                    break;
+                }
+                stripeIndex = m_nextDecodeStripeIndex++;
+            }
+            const auto stripeRange = m_stripeRanges[stripeIndex];
+            Stripe stripe = decodeStripe(&stereoSource, stripeRange);
+            {
+                const auto locker = lockMutex(&m_mutex);
+                if (stripe.decodedRange.length() < stripeRange.length()) {
+                    m_endStripeIndex = math_min(m_endStripeIndex, stripeIndex + 1);
+                }
+                m_decodedStripes.emplace(stripeIndex, std::move(stripe));
+                m_stripeDecoded.wakeAll();
+            }
+        }
+        pAudioSource->close();
+    }
+    const auto locker = lockMutex(&m_mutex);
+    --m_activeHelperThreadCount;
+    m_stripeDecoded.wakeAll();
+}
+
+AnalyzerChunkDecoder::Stripe AnalyzerChunkDecoder::decodeStripe(
+        mixxx::AudioSource* pAudioSource,
+        mixxx::IndexRange stripeRange) {
+    Stripe stripe{
+            mixxx::SampleBuffer(pAudioSource->getSignalInfo().frames2samples(
+                    stripeRange.length())),
+            mixxx::IndexRange::forward(stripeRange.start(), 0)};
+    auto remainingRange = stripeRange;
+    while (!remainingRange.empty() && !m_aborted.load()) {
+        const auto chunkRange = remainingRange.splitAndShrinkFront(
+                math_min(mixxx::kAnalysisFramesPerChunk, remainingRange.length()));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        chunkRange,
+                        mixxx::SampleBuffer::WritableSlice(
+                                stripe.sampleBuffer,
+                                pAudioSource->getSignalInfo().frames2samples(
+                                        chunkRange.start() - stripeRange.start()),
+                                pAudioSource->getSignalInfo().frames2samples(
+                                        chunkRange.length()))));
+        if (readableSampleFrames.frameIndexRange() != chunkRange) {
+            // Stop before the incomplete chunk, i.e. the stream ended
+            // prematurely or a decoding error occurred. The caller reads
+            // it again sequentially.
+            break;
+        }
+        stripe.decodedRange.growBack(chunkRange.length());
+    }
+    return stripe;
+}
+
+mixxx::ReadableSampleFrames AnalyzerChunkDecoder::nextChunk() {
+    if (m_currentStripeOffset >= m_currentStripe.decodedRange.length()) {
+        // Release the consumed stripe before waiting for the next one
+        m_currentStripe = Stripe{};
+        m_currentStripeOffset = 0;
+        const auto locker = lockMutex(&m_mutex);
+        if (m_nextConsumeStripeIndex >= m_endStripeIndex) {
+            return mixxx::ReadableSampleFrames();
+        }
+        auto decodedStripe = m_decodedStripes.find(m_nextConsumeStripeIndex);
+        while (decodedStripe == m_decodedStripes.end() &&
+                m_activeHelperThreadCount > 0) {
+            m_stripeDecoded.wait(&m_mutex);
+            decodedStripe = m_decodedStripes.find(m_nextConsumeStripeIndex);
+        }
+        if (decodedStripe == m_decodedStripes.end()) {
+            // All helper threads failed to open the file
+            m_failed = true;
+            m_endStripeIndex = m_nextConsumeStripeIndex;
+            return mixxx::ReadableSampleFrames();
+        }
+        m_currentStripe = std::move(decodedStripe->second);
+        m_decodedStripes.erase(decodedStripe);
+        if (m_currentStripe.decodedRange.length() <
+                m_stripeRanges[m_nextConsumeStripeIndex].length()) {
+            kLogger.warning()
+                    << "Failed to decode stripe"
+                    << m_stripeRanges[m_nextConsumeStripeIndex]
+                    << "completely:"
+                    << m_currentStripe.decodedRange;
+            m_failed = true;
+        }
+        ++m_nextConsumeStripeIndex;
+        m_stripeConsumed.wakeAll();
+        if (m_currentStripe.decodedRange.empty()) {
+            return mixxx::ReadableSampleFrames();
+        }
+    }
+    const auto chunkRange = mixxx::IndexRange::forward(
+            m_currentStripe.decodedRange.start() + m_currentStripeOffset,
+            math_min(mixxx::kAnalysisFramesPerChunk,
+                    m_currentStripe.decodedRange.length() - m_currentStripeOffset));
+    const auto chunkFrames = mixxx::ReadableSampleFrames(
+            chunkRange,
+            mixxx::SampleBuffer::ReadableSlice(
+                    m_currentStripe.sampleBuffer,
+                    m_currentStripeOffset * mixxx::kAnalysisChannels,
+                    chunkRange.length() * mixxx::kAnalysisChannels));
+    m_currentStripeOffset += chunkRange.length();
+    return chunkFrames;
+}
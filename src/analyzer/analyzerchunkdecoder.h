@@ -0,0 +1,130 @@
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "util/samplebuffer.h"
+
+/// Counts the threads that are currently busy with decoding or
+/// analyzing audio data, including helper threads, for deciding
+/// if idle cores are available.
+class AnalyzerBusyThreadScope final {
+  public:
+    AnalyzerBusyThreadScope() {
+        s_busyThreadCount.fetch_add(1);
+    }
+    ~AnalyzerBusyThreadScope() {
+        s_busyThreadCount.fetch_sub(1);
+    }
+    AnalyzerBusyThreadScope(const AnalyzerBusyThreadScope&) = delete;
+    AnalyzerBusyThreadScope& operator=(const AnalyzerBusyThreadScope&) = delete;
+
+    static int busyThreadCount() {
+        return s_busyThreadCount.load();
+    }
+
+  private:
+    static std::atomic<int> s_busyThreadCount;
+};
+
+/// Decodes the audio data of a track for analysis with multiple threads
+/// and delivers it in order in chunks of kAnalysisFramesPerChunk frames.
+///
+/// The track is split into stripes of consecutive chunks that are decoded
+/// concurrently by helper threads, each reading from its own audio source.
+/// The helper threads are owned by the decoder and inherit the priority
+/// of the thread that creates it.
+/// Decoded stripes are kept in a reorder buffer until all preceding stripes
+/// have been consumed. Helper threads that are too far ahead are suspended
+/// to limit the memory consumption.
+///
+/// Only used for formats that support cheap and sample accurate seeking
+/// and that know their exact length after opening.
+///
+/// Decoding stops at the first chunk that could not be read completely.
+/// The caller then continues reading sequentially after the last delivered
+/// chunk, i.e. both the results and the handling of corrupt files are the
+/// same as when decoding sequentially.
+class AnalyzerChunkDecoder final {
+  public:
+    /// Each stripe requires a seek operation. The stripes must be long
+    /// enough to amortize the costs for seeking, e.g. the MP3 decoder
+    /// needs to decode some preceding frames after seeking.
+    static constexpr SINT kFramesPerStripe = 32 * mixxx::kAnalysisFramesPerChunk;
+
+    /// Opens a separate audio source for each helper thread
+    using OpenAudioSourceFunc = std::function<mixxx::AudioSourcePointer()>;
+
+    /// Returns nullptr if parallel decoding is not supported for the
+    /// track or if no idle cores are available for helper threads.
+    static std::unique_ptr<AnalyzerChunkDecoder> create(
+            const TrackPointer& pTrack,
+            const mixxx::AudioSource::OpenParams& openParams,
+            mixxx::IndexRange frameIndexRange);
+
+    /// Starts helperThreadCount helper threads for decoding the range
+    AnalyzerChunkDecoder(
+            OpenAudioSourceFunc openAudioSource,
+            mixxx::IndexRange frameIndexRange,
+            int helperThreadCount);
+
+    /// Aborts decoding and waits until all helper threads have finished.
+    ~AnalyzerChunkDecoder();
+
+    /// Blocks until the next chunk is available. Returns an empty range
+    /// when all chunks have been delivered or if decoding failed. All
+    /// chunks are complete, the sample data is valid until the next
+    /// invocation.
+    mixxx::ReadableSampleFrames nextChunk();
+
+    /// Decoding stopped before reaching the end of the range, e.g. if
+    /// reading failed after seeking. The remaining frames must be read
+    /// sequentially.
+    bool hasFailed() const {
+        return m_failed;
+    }
+
+  private:
+    struct Stripe {
+        mixxx::SampleBuffer sampleBuffer;
+        // The complete chunks, shorter than requested if reading failed
+        mixxx::IndexRange decodedRange;
+    };
+
+    void decodeStripes();
+    Stripe decodeStripe(
+            mixxx::AudioSource* pAudioSource,
+            mixxx::IndexRange stripeRange);
+
+    const OpenAudioSourceFunc m_openAudioSource;
+    const int m_maxStripesAhead;
+    std::vector<mixxx::IndexRange> m_stripeRanges;
+
+    std::atomic<bool> m_aborted;
+    std::vector<std::unique_ptr<QThread>> m_helperThreads;
+
+    // Guards all following members that are shared with the helper threads
+    QMutex m_mutex;
+    QWaitCondition m_stripeDecoded;
+    QWaitCondition m_stripeConsumed;
+    int m_activeHelperThreadCount;
+    int m_nextDecodeStripeIndex;
+    int m_nextConsumeStripeIndex;
+    // Stripes after an incomplete stripe are not decoded
+    int m_endStripeIndex;
+    std::map<int, Stripe> m_decodedStripes;
+
+    // Only accessed by the consuming thread
+    Stripe m_currentStripe;
+    SINT m_currentStripeOffset;
+    bool m_failed;
+};
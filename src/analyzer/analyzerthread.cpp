@@ -3,6 +3,7 @@
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerchunkdecoder.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
 #include "analyzer/analyzerkey.h"
@@ -124,6 +125,7 @@ void AnalyzerThread::doRun() {
 
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisChannels);
+    openParams.setAccessPattern(mixxx::AudioSource::AccessPattern::Sequential);
 
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
@@ -152,7 +154,7 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
-            const auto analysisResult = analyzeAudioSource(audioSource);
+            const auto analysisResult = analyzeAudioSource(audioSource, openParams);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
@@ -219,9 +221,37 @@ WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
 }
 
 AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
-        const mixxx::AudioSourcePointer& audioSource) {
+        const mixxx::AudioSourcePointer& audioSource,
+        const mixxx::AudioSource::OpenParams& openParams) {
     DEBUG_ASSERT(m_currentTrack.has_value());
 
+    AnalyzerBusyThreadScope busyThreadScope;
+
+    // Analysis starts now
+    emitBusyProgress(kAnalyzerProgressNone);
+
+    mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
+
+    // Idle cores are utilized for decoding in parallel
+    const auto pChunkDecoder = AnalyzerChunkDecoder::create(
+            m_currentTrack->getTrack(),
+            openParams,
+            remainingFrameRange);
+    if (pChunkDecoder) {
+        const auto analysisResult = analyzeDecodedChunks(
+                pChunkDecoder.get(),
+                &remainingFrameRange);
+        if (analysisResult != AnalysisResult::Finished ||
+                remainingFrameRange.empty()) {
+            return analysisResult;
+        }
+        // Same results as if the whole file was read sequentially,
+        // including the handling of corrupt files
+        kLogger.info()
+                << "Continuing to decode sequentially:"
+                << remainingFrameRange;
+    }
+
     mixxx::AudioSourceStereoProxy audioSourceProxy(
             audioSource,
             mixxx::kAnalysisFramesPerChunk);
@@ -229,10 +259,6 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             audioSourceProxy.getSignalInfo().getChannelCount() ==
             mixxx::kAnalysisChannels);
 
-    // Analysis starts now
-    emitBusyProgress(kAnalyzerProgressNone);
-
-    mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
         if (isStopping()) {
@@ -329,6 +355,58 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     return AnalysisResult::Finished;
 }
 
+AnalyzerThread::AnalysisResult AnalyzerThread::analyzeDecodedChunks(
+        AnalyzerChunkDecoder* pChunkDecoder,
+        mixxx::IndexRange* pRemainingFrameRange) {
+    DEBUG_ASSERT(m_currentTrack.has_value());
+    DEBUG_ASSERT(pChunkDecoder);
+
+    const auto frameIndexRange = *pRemainingFrameRange;
+    while (true) {
+        sleepWhileSuspended();
+        if (isStopping()) {
+            return AnalysisResult::Cancelled;
+        }
+
+        // 1st step: Receive the next chunk of decoded audio data in order
+        const auto readableSampleFrames = pChunkDecoder->nextChunk();
+        if (readableSampleFrames.frameIndexRange().empty()) {
+            break;
+        }
+        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(frameIndexRange));
+        pRemainingFrameRange->shrinkFront(readableSampleFrames.frameLength());
+
+        sleepWhileSuspended();
+        if (isStopping()) {
+            return AnalysisResult::Cancelled;
+        }
+
+        // 2nd: step: Analyze chunk of decoded audio data
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.processSamples(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength());
+        }
+
+        // 3rd step: Update & emit progress
+        const double frameProgress =
+                static_cast<double>(readableSampleFrames.frameIndexRange().end() -
+                        frameIndexRange.start()) /
+                frameIndexRange.length();
+        // math_min is required to compensate rounding errors
+        const AnalyzerProgress progress =
+                math_min(kAnalyzerProgressFinalizing,
+                        frameProgress *
+                                (kAnalyzerProgressFinalizing - kAnalyzerProgressNone));
+        DEBUG_ASSERT(progress > kAnalyzerProgressNone);
+        emitBusyProgress(progress);
+    }
+    // All chunks are delivered in order without gaps
+    DEBUG_ASSERT(pChunkDecoder->hasFailed() || pRemainingFrameRange->empty());
+
+    return AnalysisResult::Finished;
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
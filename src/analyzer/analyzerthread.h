@@ -17,6 +17,8 @@
 #include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class AnalyzerChunkDecoder;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
@@ -132,7 +134,13 @@ class AnalyzerThread : public WorkerThread {
         Cancelled,
     };
     AnalysisResult analyzeAudioSource(
-            const mixxx::AudioSourcePointer& audioSource);
+            const mixxx::AudioSourcePointer& audioSource,
+            const mixxx::AudioSource::OpenParams& openParams);
+    /// Shrinks the remaining range by the analyzed chunks. Frames that
+    /// remain after decoding failed must be analyzed sequentially.
+    AnalysisResult analyzeDecodedChunks(
+            AnalyzerChunkDecoder* pChunkDecoder,
+            mixxx::IndexRange* pRemainingFrameRange);
 
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
@@ -1,10 +1,12 @@
 #include "control/controlobjectscript.h"
 
 #include "moc_controlobjectscript.cpp"
+#include "util/fpclassify.h"
 
 ControlObjectScript::ControlObjectScript(
         const ConfigKey& key, const RuntimeLoggingCategory& logger, QObject* pParent)
         : ControlProxy(key, pParent, ControlFlag::AllowMissingOrInvalid),
+          m_lastPolledValue(0.0),
           m_logger(logger),
           m_proxy(key, logger, this),
           m_skipSuperseded(false) {
@@ -81,7 +83,37 @@ bool ControlObjectScript::addScriptConnection(const ScriptConnection& conn) {
     return true;
 }
 
+bool ControlObjectScript::addPolledScriptConnection(const ScriptConnection& conn) {
+    for (const auto& priorConnection : qAsConst(m_polledScriptConnections)) {
+        if (conn == priorConnection) {
+            qCWarning(m_logger) << "Connection " + conn.id.toString() +
+                            " already connected to (" +
+                            conn.key.group + ", " + conn.key.item +
+                            "). Ignoring attempt to connect again.";
+            return false;
+        }
+    }
+
+    if (m_polledScriptConnections.isEmpty()) {
+        // Only changes after the connection has been made are reported
+        m_lastPolledValue = get();
+    }
+    m_polledScriptConnections.append(conn);
+    qCDebug(m_logger) << "Connected (" +
+                    conn.key.group + ", " + conn.key.item +
+                    ") to polled connection " + conn.id.toString();
+    return true;
+}
+
 bool ControlObjectScript::removeScriptConnection(const ScriptConnection& conn) {
+    if (m_polledScriptConnections.removeOne(conn)) {
+        // No signals are connected for polled connections
+        qCDebug(m_logger) << "Disconnected (" +
+                        conn.key.group + ", " + conn.key.item +
+                        ") from polled connection " + conn.id.toString();
+        return true;
+    }
+
     bool success = m_scriptConnections.removeOne(conn);
     if (success) {
         qCDebug(m_logger) << "Disconnected (" +
@@ -119,7 +151,7 @@ bool ControlObjectScript::removeScriptConnection(const ScriptConnection& conn) {
 
 void ControlObjectScript::disconnectAllConnectionsToFunction(const QJSValue& function) {
     // Make a local copy of m_scriptConnections because items are removed within the loop.
-    const QVector<ScriptConnection> connections = m_scriptConnections;
+    const QVector<ScriptConnection> connections = m_scriptConnections + m_polledScriptConnections;
     for (const auto& conn: connections) {
         if (conn.callback.strictlyEquals(function)) {
             removeScriptConnection(conn);
@@ -127,6 +159,26 @@ void ControlObjectScript::disconnectAllConnectionsToFunction(const QJSValue& fun
     }
 }
 
+void ControlObjectScript::pollScriptConnections() {
+    // Lock-free read of the atomic value of the control
+    const double value = get();
+    // NaN never compares equal to itself
+    if (value == m_lastPolledValue ||
+            (util_isnan(value) && util_isnan(m_lastPolledValue))) {
+        return;
+    }
+    executePolledScriptConnections(value);
+}
+
+void ControlObjectScript::executePolledScriptConnections(double value) {
+    m_lastPolledValue = value;
+    // A callback might disconnect itself, see slotValueChanged()
+    const QVector<ScriptConnection> connections = m_polledScriptConnections;
+    for (auto&& conn : connections) {
+        conn.executeCallback(value);
+    }
+}
+
 void ControlObjectScript::slotValueChanged(double value, QObject*) {
     // Make a local copy of m_connectedScriptFunctions first.
     // This allows a script to disconnect a callback from inside the
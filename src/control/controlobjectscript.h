@@ -17,8 +17,20 @@ class ControlObjectScript : public ControlProxy {
 
     bool addScriptConnection(const ScriptConnection& conn);
 
+    /// Polled connections don't receive any signals for value changes.
+    /// Instead pollScriptConnections() executes them at most once with
+    /// the latest value, which coalesces all intermediate changes.
+    bool addPolledScriptConnection(const ScriptConnection& conn);
+
     bool removeScriptConnection(const ScriptConnection& conn);
 
+    inline bool hasPolledScriptConnections() const {
+        return !m_polledScriptConnections.isEmpty();
+    }
+    /// Executes the polled connections if the value has changed since the
+    /// last poll.
+    void pollScriptConnections();
+
     // Required for legacy behavior of ControllerEngine::connectControl
     inline int countConnections() {
             return m_scriptConnections.size(); };
@@ -29,6 +41,9 @@ class ControlObjectScript : public ControlProxy {
     // Called from update();
     void emitValueChanged() override {
         emit trigger(get(), this);
+        // Polled connections don't receive signals and are executed
+        // immediately instead of with the next poll
+        executePolledScriptConnections(get());
     }
 
   signals:
@@ -41,7 +56,11 @@ class ControlObjectScript : public ControlProxy {
     virtual void slotValueChanged(double v, QObject*);
 
   private:
+    void executePolledScriptConnections(double value);
+
     QVector<ScriptConnection> m_scriptConnections;
+    QVector<ScriptConnection> m_polledScriptConnections;
+    double m_lastPolledValue;
     const RuntimeLoggingCategory m_logger;
     CompressingProxy m_proxy;
     bool m_skipSuperseded; // This flag is combined for all connections of this Control Object
@@ -5,6 +5,7 @@
 #include "controllers/bulk/bulksupported.h"
 #include "controllers/defs_controllers.h"
 #include "moc_bulkcontroller.cpp"
+#include "util/compatibility/qmutex.h"
 #include "util/time.h"
 #include "util/trace.h"
 
@@ -52,6 +53,57 @@ void BulkReader::run() {
     qDebug() << "Stopped Reader";
 }
 
+BulkWriter::BulkWriter(libusb_device_handle* handle, unsigned char out_epaddr)
+        : QThread(),
+          m_phandle(handle),
+          m_stop(0),
+          m_out_epaddr(out_epaddr) {
+}
+
+BulkWriter::~BulkWriter() {
+}
+
+void BulkWriter::stop() {
+    m_stop = 1;
+    m_queue.wakeUp();
+}
+
+int BulkWriter::transfer(const QByteArray& data, unsigned int timeoutMillis) {
+    const auto locker = lockMutex(&m_transferMutex);
+    int transferred;
+    return libusb_bulk_transfer(m_phandle,
+            m_out_epaddr,
+            reinterpret_cast<unsigned char*>(const_cast<char*>(data.constData())),
+            data.size(),
+            &transferred,
+            timeoutMillis);
+}
+
+void BulkWriter::run() {
+    // m_stop is not reset, a stop() before starting must not be lost
+    QByteArray packet;
+    while (m_stop.loadAcquire() == 0 || !m_queue.isEmpty()) {
+        // The timeout only limits the delay until a stop is noticed
+        if (!m_queue.pop(&packet, 500)) {
+            continue;
+        }
+        Trace process("BulkWriter send packet");
+        const int result = transfer(packet, 1000);
+        if (result < 0) {
+            qWarning() << "BulkWriter: Unable to send" << packet.size() << "bytes:"
+                       << libusb_error_name(result);
+            if (m_stop.loadAcquire() != 0) {
+                // Otherwise closing the device might be blocked for minutes
+                // by the timeouts of the remaining packets, e.g. if it has
+                // been unplugged
+                qWarning() << "BulkWriter: Dropping remaining packets";
+                m_queue.clear();
+            }
+        }
+    }
+    qDebug() << "Stopped Writer";
+}
+
 static QString get_string(libusb_device_handle* handle, uint8_t id) {
     unsigned char buf[128] = { 0 };
 
@@ -84,6 +136,7 @@ BulkController::BulkController(libusb_context* context,
     setInputDevice(true);
     setOutputDevice(true);
     m_pReader = nullptr;
+    m_pWriter = nullptr;
 }
 
 BulkController::~BulkController() {
@@ -168,6 +221,13 @@ int BulkController::open() {
     }
 
     setOpen(true);
+
+    // Started before the engine, so that the scripts can update the
+    // screens right from the beginning
+    m_pWriter = new BulkWriter(m_phandle, out_epaddr);
+    m_pWriter->setObjectName(QString("BulkWriter %1").arg(getName()));
+    m_pWriter->start();
+
     startEngine();
 
     if (m_pReader != nullptr) {
@@ -211,6 +271,15 @@ int BulkController::close() {
     // closed in case it has any final parting messages
     stopEngine();
 
+    // Send the final screen updates of the shutdown scripts
+    if (m_pWriter != nullptr) {
+        m_pWriter->stop();
+        qCInfo(m_logBase) << "  Waiting on writer to finish";
+        m_pWriter->wait();
+        delete m_pWriter;
+        m_pWriter = nullptr;
+    }
+
     // Close device
     qCInfo(m_logBase) << "  Closing device";
     libusb_close(m_phandle);
@@ -231,12 +300,17 @@ void BulkController::send(const QList<int>& data, unsigned int length) {
 
 void BulkController::sendBytes(const QByteArray& data) {
     int ret;
-    int transferred;
 
-    // XXX: don't get drunk again.
-    ret = libusb_bulk_transfer(m_phandle, out_epaddr,
-                               (unsigned char *)data.constData(), data.size(),
-                               &transferred, 0);
+    if (m_pWriter) {
+        // Must not interleave with the screen updates of the writer
+        ret = m_pWriter->transfer(data, 0);
+    } else {
+        int transferred;
+        // XXX: don't get drunk again.
+        ret = libusb_bulk_transfer(m_phandle, out_epaddr,
+                                   (unsigned char *)data.constData(), data.size(),
+                                   &transferred, 0);
+    }
     if (ret < 0) {
         qCWarning(m_logOutput) << "Unable to send data to" << getName()
                                << "serial #" << m_sUID;
@@ -245,3 +319,22 @@ void BulkController::sendBytes(const QByteArray& data) {
                              << "serial #" << m_sUID;
     }
 }
+
+bool BulkController::sendScreenPackets(const QList<QByteArray>& packets) {
+    VERIFY_OR_DEBUG_ASSERT(m_pWriter) {
+        return false;
+    }
+    if (!m_pWriter->queuePackets(packets)) {
+        qCDebug(m_logOutput) << "Screen update dropped, because the previous"
+                             << "updates are not yet sent to" << getName();
+        return false;
+    }
+    return true;
+}
+
+qsizetype BulkController::maxScreenUpdateBytes() const {
+    VERIFY_OR_DEBUG_ASSERT(m_pWriter) {
+        return 0;
+    }
+    return m_pWriter->maxQueuedBytes();
+}
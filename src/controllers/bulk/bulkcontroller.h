@@ -1,9 +1,11 @@
 #pragma once
 
 #include <QAtomicInt>
+#include <QMutex>
 #include <QThread>
 
 #include "controllers/controller.h"
+#include "controllers/controllerscreen.h"
 #include "controllers/hid/legacyhidcontrollermapping.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "util/duration.h"
@@ -33,6 +35,43 @@ class BulkReader : public QThread {
     unsigned char m_in_epaddr;
 };
 
+/// Sends the packets of screen updates, so that the controller thread
+/// isn't blocked by the transfers
+class BulkWriter : public QThread {
+    Q_OBJECT
+  public:
+    BulkWriter(libusb_device_handle* handle, unsigned char out_epaddr);
+    ~BulkWriter() override;
+
+    /// Stops after all queued packets have been sent. The remaining
+    /// packets are dropped after the first failed transfer.
+    void stop();
+
+    bool queuePackets(const QList<QByteArray>& packets) {
+        return m_queue.push(packets);
+    }
+    qsizetype maxQueuedBytes() const {
+        return m_queue.maxBytes();
+    }
+
+    /// Sends data immediately and returns the libusb result. Transfers
+    /// are serialized with the queued packets, which are sent to the same
+    /// endpoint.
+    ///
+    /// Thread-safe
+    int transfer(const QByteArray& data, unsigned int timeoutMillis);
+
+  protected:
+    void run() override;
+
+  private:
+    libusb_device_handle* m_phandle;
+    QAtomicInt m_stop;
+    unsigned char m_out_epaddr;
+    ControllerScreenOutputQueue m_queue;
+    QMutex m_transferMutex;
+};
+
 class BulkController : public Controller {
     Q_OBJECT
   public:
@@ -67,6 +106,8 @@ class BulkController : public Controller {
     // For devices which only support a single report, reportID must be set to
     // 0x0.
     void sendBytes(const QByteArray& data) override;
+    bool sendScreenPackets(const QList<QByteArray>& packets) override;
+    qsizetype maxScreenUpdateBytes() const override;
 
     bool matchProductInfo(const ProductInfo& product);
 
@@ -84,5 +125,6 @@ class BulkController : public Controller {
 
     QString m_sUID;
     BulkReader* m_pReader;
+    BulkWriter* m_pWriter;
     std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
 };
@@ -1,12 +1,18 @@
 #include "controllers/controller.h"
 
 #include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJSEngine>
 #include <QJSValue>
 #include <QRegularExpression>
 #include <algorithm>
 
+#include "controllers/controllerscreen.h"
 #include "controllers/defs_controllers.h"
 #include "moc_controller.cpp"
+#include "util/cmdlineargs.h"
 #include "util/screensaver.h"
 
 namespace {
@@ -56,6 +62,35 @@ void Controller::stopEngine() {
     }
     delete m_pScriptEngineLegacy;
     m_pScriptEngineLegacy = nullptr;
+    m_pInputRecorder.reset();
+}
+
+void Controller::startInputRecording(const QString& mappingFilePath) {
+    const QString recordPath = CmdlineArgs::Instance().getControllerRecordPath();
+    if (recordPath.isEmpty()) {
+        return;
+    }
+    QDir recordDir(recordPath);
+    if (!recordDir.mkpath(QStringLiteral("."))) {
+        qCWarning(m_logBase) << "Failed to create" << recordPath;
+        return;
+    }
+    // A new file for each mapping that is applied
+    QString fileName = m_sDeviceName;
+    fileName.replace(QRegularExpression(QStringLiteral("[^A-Za-z0-9_-]+")),
+            QStringLiteral("_"));
+    fileName += QChar('-') +
+            QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmsszzz")) +
+            QStringLiteral(".controllerinput");
+    const QString filePath = recordDir.filePath(fileName);
+    m_pInputRecorder = std::make_unique<ControllerInputRecorder>(filePath,
+            m_sDeviceName,
+            QFileInfo(mappingFilePath).fileName());
+    if (!m_pInputRecorder->isOpen()) {
+        m_pInputRecorder.reset();
+        return;
+    }
+    qCInfo(m_logBase) << "Recording input to" << filePath;
 }
 
 bool Controller::applyMapping() {
@@ -69,6 +104,8 @@ bool Controller::applyMapping() {
         return false;
     }
 
+    startInputRecording(pMapping->filePath());
+
     QList<LegacyControllerMapping::ScriptFileInfo> scriptFiles = pMapping->getScriptFiles();
     if (scriptFiles.isEmpty()) {
         qCWarning(m_logBase)
@@ -106,6 +143,13 @@ void Controller::send(const QList<int>& data, unsigned int length) {
     sendBytes(msg);
 }
 
+bool Controller::sendScreenPackets(const QList<QByteArray>& packets) {
+    for (const auto& packet : packets) {
+        sendBytes(packet);
+    }
+    return true;
+}
+
 void Controller::triggerActivity()
 {
      // Inhibit Updates for 1000 milliseconds
@@ -121,6 +165,7 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
         //  queued signals flush out
         return;
     }
+    recordInput(data, timestamp);
     triggerActivity();
 
     int length = data.size();
@@ -149,3 +194,33 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
 
     m_pScriptEngineLegacy->handleIncomingData(data);
 }
+
+QObject* ControllerJSProxy::createScreen(int width, int height, const QVariantMap& options) {
+    ControllerScreen::Config config;
+    config.width = width;
+    config.height = height;
+    // Coordinates are sent as 16 bit integers
+    if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) {
+        qCWarning(m_pController->m_logBase)
+                << "Invalid screen size" << width << "x" << height;
+        return nullptr;
+    }
+    if (!ControllerScreenJSProxy::configFromOptions(&config, options)) {
+        return nullptr;
+    }
+    // Otherwise every update with the complete framebuffer would be
+    // dropped, including the first one
+    const qsizetype maxUpdateBytes = m_pController->maxScreenUpdateBytes();
+    if (maxUpdateBytes > 0 &&
+            ControllerScreen::fullFrameBytes(config) > maxUpdateBytes) {
+        qCWarning(m_pController->m_logBase)
+                << "Screen size" << width << "x" << height
+                << "exceeds the maximum size of an update of"
+                << maxUpdateBytes << "bytes";
+        return nullptr;
+    }
+    // Deleted together with this proxy when the script engine is shut down
+    auto* pScreen = new ControllerScreenJSProxy(m_pController, config, this);
+    QJSEngine::setObjectOwnership(pScreen, QJSEngine::CppOwnership);
+    return pScreen;
+}
@@ -3,7 +3,10 @@
 #include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QTimerEvent>
+#include <QVariantMap>
+#include <memory>
 
+#include "controllers/controllerinputrecording.h"
 #include "controllers/controllermappinginfo.h"
 #include "controllers/legacycontrollermapping.h"
 #include "controllers/legacycontrollermappingfilehandler.h"
@@ -106,6 +109,18 @@ class Controller : public QObject {
     // controller.
     virtual void sendBytes(const QByteArray& data) = 0;
 
+    /// Sends the packets of a screen update, see ControllerScreen. The
+    /// default implementation sends them immediately with sendBytes().
+    /// Devices with an I/O thread queue them for asynchronous sending.
+    /// Returns false if the packets have been dropped.
+    virtual bool sendScreenPackets(const QList<QByteArray>& packets);
+
+    /// The maximum total size of the packets of a single screen update
+    /// that can be queued by sendScreenPackets(). 0 if unlimited.
+    virtual qsizetype maxScreenUpdateBytes() const {
+        return 0;
+    }
+
     // To be called in sub-class' open() functions after opening the device but
     // before starting any input polling/processing.
     virtual void startEngine();
@@ -117,6 +132,17 @@ class Controller : public QObject {
     // To be called when receiving events
     void triggerActivity();
 
+    /// Whether the raw input is recorded, see --controller-record-path
+    inline bool isRecordingInput() const {
+        return static_cast<bool>(m_pInputRecorder);
+    }
+    /// To be called with the raw input before processing it
+    inline void recordInput(const QByteArray& data, mixxx::Duration timestamp) {
+        if (m_pInputRecorder) {
+            m_pInputRecorder->record(data, timestamp);
+        }
+    }
+
     inline ControllerScriptEngineLegacy* getScriptEngine() const {
         return m_pScriptEngineLegacy;
     }
@@ -153,8 +179,18 @@ class Controller : public QObject {
         return false;
     }
 
+    // Output messages are collected over this duration and then sent in
+    // a single batch if supported by the device. Zero sends all messages
+    // immediately.
+    virtual void setOutputFrameDuration(mixxx::Duration frameDuration) {
+        Q_UNUSED(frameDuration);
+    }
+
   private:
+    void startInputRecording(const QString& mappingFilePath);
+
     ControllerScriptEngineLegacy* m_pScriptEngineLegacy;
+    std::unique_ptr<ControllerInputRecorder> m_pInputRecorder;
 
     // Verbose and unique description of device type, defaults to empty
     QString m_sDeviceCategory;
@@ -169,8 +205,12 @@ class Controller : public QObject {
     QElapsedTimer m_userActivityInhibitTimer;
 
     friend class ControllerJSProxy;
+    friend class ControllerScreenJSProxy;
     // accesses lots of our stuff, but in the same thread
     friend class ControllerManager;
+    // polls the device and reads the script engine statistics in
+    // the controller thread
+    friend class ControllerThread;
     // For testing
     friend class LegacyControllerMappingValidationTest;
 };
@@ -192,6 +232,18 @@ class ControllerJSProxy : public QObject {
         m_pController->send(data, data.length());
     }
 
+    /// @brief Creates the framebuffer of a screen of the controller
+    /// @param width Width in pixels
+    /// @param height Height in pixels
+    /// @param options (optional) pixelFormat ("rgb565" or "rgb888"),
+    /// bigEndian, header (array of bytes that starts each packet),
+    /// maxPacketSize and tileSize, see ControllerScreen::Config
+    /// @return The screen or null for invalid arguments or if the complete
+    /// framebuffer exceeds the maximum size of an update
+    Q_INVOKABLE QObject* createScreen(int width,
+            int height,
+            const QVariantMap& options = QVariantMap());
+
   private:
     Controller* const m_pController;
 };
@@ -0,0 +1,38 @@
+#include "controllers/controllerinputbinding.h"
+
+#include "control/control.h"
+#include "control/controlobject.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "util/assert.h"
+
+ControlObject* ControllerInputBinding::control(const ConfigKey& key) {
+    auto pControl = m_pControl.toStrongRef();
+    if (!pControl) {
+        // Not resolved yet, or the control has been deleted and
+        // might have been created again in the meantime
+        pControl = ControlDoublePrivate::getControl(key);
+        if (!pControl) {
+            return nullptr;
+        }
+        m_pControl = pControl;
+    }
+    return pControl->getCreatorCO();
+}
+
+void ControllerInputBinding::resolveControl(const ConfigKey& key) {
+    m_pControl = ControlDoublePrivate::getControl(
+            key,
+            ControlFlag::AllowInvalidKey | ControlFlag::NoWarnIfMissing);
+}
+
+QJSValue* ControllerInputBinding::scriptFunction(
+        ControllerScriptEngineLegacy* pEngine,
+        const QString& functionCode,
+        int argCount) {
+    DEBUG_ASSERT(pEngine);
+    if (m_scriptGeneration != pEngine->generation()) {
+        m_scriptFunction = pEngine->wrapFunctionCode(functionCode, argCount);
+        m_scriptGeneration = pEngine->generation();
+    }
+    return &m_scriptFunction;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QJSValue>
+#include <QWeakPointer>
+
+#include "preferences/configobject.h"
+
+class ControlDoublePrivate;
+class ControlObject;
+class ControllerScriptEngineLegacy;
+
+/// The control or script function that is bound to a controller input,
+/// e.g. a MIDI message or a field of a HID report.
+///
+/// Both are resolved when needed and then cached. The control is only
+/// referenced weakly, i.e. it is looked up again after it has been
+/// deleted and created again. The script function is wrapped again
+/// after the scripts have been reloaded.
+class ControllerInputBinding final {
+  public:
+    /// Returns nullptr if the control doesn't exist (yet).
+    ControlObject* control(const ConfigKey& key);
+
+    /// Looks up the control in advance, e.g. when compiling the
+    /// mapping. Doesn't warn if the control doesn't exist yet.
+    void resolveControl(const ConfigKey& key);
+
+    /// The script function with the given code, i.e. the function name
+    /// or an inline function, that accepts the given number of arguments.
+    QJSValue* scriptFunction(
+            ControllerScriptEngineLegacy* pEngine,
+            const QString& functionCode,
+            int argCount);
+
+  private:
+    QWeakPointer<ControlDoublePrivate> m_pControl;
+    QJSValue m_scriptFunction;
+    int m_scriptGeneration = 0;
+};
@@ -0,0 +1,91 @@
+#include "controllers/controllerinputrecording.h"
+
+#include <QtDebug>
+
+namespace {
+
+const QString kMagicHeader = QStringLiteral("# Mixxx controller input recording");
+const QString kControllerHeader = QStringLiteral("# controller: ");
+const QString kMappingHeader = QStringLiteral("# mapping: ");
+
+} // anonymous namespace
+
+// static
+std::optional<ControllerInputRecording> ControllerInputRecording::load(
+        const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "open" << filePath << "failed";
+        return std::nullopt;
+    }
+
+    QTextStream in(&file);
+    if (in.readLine() != kMagicHeader) {
+        qWarning() << filePath << "is not a controller input recording";
+        return std::nullopt;
+    }
+
+    ControllerInputRecording recording;
+    int lineNumber = 1;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (line.startsWith(QChar('#'))) {
+            if (line.startsWith(kControllerHeader)) {
+                recording.controllerName = line.mid(kControllerHeader.size());
+            } else if (line.startsWith(kMappingHeader)) {
+                recording.mappingFileName = line.mid(kMappingHeader.size());
+            }
+            continue;
+        }
+        const int separator = line.indexOf(QChar(' '));
+        bool ok = false;
+        const qint64 micros = line.left(separator).toLongLong(&ok);
+        if (separator <= 0 || !ok || micros < 0) {
+            qWarning() << "Invalid event in line" << lineNumber << "of" << filePath;
+            return std::nullopt;
+        }
+        Event event;
+        event.timestamp = mixxx::Duration::fromMicros(micros);
+        event.data = QByteArray::fromHex(line.mid(separator + 1).toLatin1());
+        if (event.data.isEmpty()) {
+            qWarning() << "Empty event in line" << lineNumber << "of" << filePath;
+            return std::nullopt;
+        }
+        recording.events.append(std::move(event));
+    }
+    return recording;
+}
+
+ControllerInputRecorder::ControllerInputRecorder(const QString& filePath,
+        const QString& controllerName,
+        const QString& mappingFileName)
+        : m_file(filePath) {
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "open" << filePath << "failed";
+        return;
+    }
+    m_stream.setDevice(&m_file);
+    m_stream << kMagicHeader << '\n'
+             << kControllerHeader << controllerName << '\n'
+             << kMappingHeader << mappingFileName << '\n';
+}
+
+void ControllerInputRecorder::record(
+        const QByteArray& data, mixxx::Duration timestamp) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (!m_firstTimestamp) {
+        m_firstTimestamp = timestamp;
+    }
+    // The timestamps of some devices are not strictly monotonic
+    const mixxx::Duration relativeTimestamp = timestamp > *m_firstTimestamp
+            ? timestamp - *m_firstTimestamp
+            : mixxx::Duration::empty();
+    // The stream is buffered and flushed when it is destroyed
+    m_stream << relativeTimestamp.toIntegerMicros() << ' ' << data.toHex(' ') << '\n';
+}
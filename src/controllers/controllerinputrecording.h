@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QTextStream>
+#include <optional>
+
+#include "util/duration.h"
+
+/// The raw input of a controller together with the time of arrival of
+/// each message, e.g. recorded during a real session. Recordings are
+/// replayed by the controller benchmarks.
+///
+/// The file format is line based text. Header lines start with '#',
+/// each event is stored as its timestamp in microseconds followed by
+/// the bytes of the message in hex, e.g. "1500 b0 16 41".
+class ControllerInputRecording final {
+  public:
+    struct Event {
+        /// Relative to the first event of the recording
+        mixxx::Duration timestamp;
+        /// A single MIDI message or a single HID/bulk packet
+        QByteArray data;
+    };
+
+    /// The name of the device the input has been recorded from
+    QString controllerName;
+    /// The file name of the mapping that was active during the recording,
+    /// relative to the controller mapping directories. Empty if none
+    /// was loaded.
+    QString mappingFileName;
+    QList<Event> events;
+
+    static std::optional<ControllerInputRecording> load(const QString& filePath);
+};
+
+/// Appends the input of a controller to a recording file.
+///
+/// Must only be used from the thread of the controller.
+class ControllerInputRecorder final {
+  public:
+    ControllerInputRecorder(const QString& filePath,
+            const QString& controllerName,
+            const QString& mappingFileName);
+
+    ControllerInputRecorder(const ControllerInputRecorder&) = delete;
+    ControllerInputRecorder& operator=(const ControllerInputRecorder&) = delete;
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    void record(const QByteArray& data, mixxx::Duration timestamp);
+
+  private:
+    QFile m_file;
+    QTextStream m_stream;
+    std::optional<mixxx::Duration> m_firstTimestamp;
+};
@@ -0,0 +1,167 @@
+#include "controllers/controllerinputwaiter.h"
+
+#ifdef __LINUX__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ControllerInputWaiter");
+
+} // anonymous namespace
+
+#ifdef __LINUX__
+
+ControllerInputWaiter::ControllerInputWaiter()
+        : m_epollFd(epoll_create1(EPOLL_CLOEXEC)),
+          m_wakeUpFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    if (m_epollFd < 0 || m_wakeUpFd < 0) {
+        kLogger.warning()
+                << "Failed to create epoll instance:"
+                << errno;
+        return;
+    }
+    if (!addInput(m_wakeUpFd)) {
+        ::close(m_wakeUpFd);
+        m_wakeUpFd = -1;
+    }
+}
+
+ControllerInputWaiter::~ControllerInputWaiter() {
+    if (m_wakeUpFd >= 0) {
+        ::close(m_wakeUpFd);
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+    }
+}
+
+bool ControllerInputWaiter::isValid() const {
+    return m_epollFd >= 0 && m_wakeUpFd >= 0;
+}
+
+bool ControllerInputWaiter::addInput(int fd) {
+    VERIFY_OR_DEBUG_ASSERT(m_epollFd >= 0 && fd >= 0) {
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        kLogger.warning()
+                << "Failed to register file descriptor"
+                << fd
+                << "for input events:"
+                << errno;
+        return false;
+    }
+    return true;
+}
+
+void ControllerInputWaiter::removeInput(int fd) {
+    VERIFY_OR_DEBUG_ASSERT(m_epollFd >= 0 && fd >= 0) {
+        return;
+    }
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr) != 0) {
+        kLogger.warning()
+                << "Failed to unregister file descriptor"
+                << fd
+                << ":"
+                << errno;
+    }
+}
+
+void ControllerInputWaiter::wakeUp() {
+    if (m_wakeUpFd < 0) {
+        return;
+    }
+    const uint64_t increment = 1;
+    // The counter only overflows after 2^64 - 1 pending wake-ups
+    [[maybe_unused]] const auto bytesWritten = ::write(m_wakeUpFd, &increment, sizeof(increment));
+}
+
+ControllerInputWaiter::Result ControllerInputWaiter::wait(mixxx::Duration timeout) {
+    VERIFY_OR_DEBUG_ASSERT(isValid()) {
+        return Result::Failed;
+    }
+    // The input file descriptor and the wake-up event
+    constexpr int kMaxEvents = 2;
+    epoll_event events[kMaxEvents];
+    // Round up to avoid busy waiting with sub-millisecond timeouts
+    const int timeoutMillis = static_cast<int>(
+            (timeout.toIntegerMicros() + 999) / 1000);
+    const int eventCount = epoll_wait(m_epollFd, events, kMaxEvents, timeoutMillis);
+    if (eventCount < 0) {
+        if (errno == EINTR) {
+            return Result::TimedOut;
+        }
+        kLogger.warning()
+                << "Failed to wait for input events:"
+                << errno;
+        return Result::Failed;
+    }
+    bool inputAvailable = false;
+    bool inputClosed = false;
+    bool wokenUp = false;
+    for (int i = 0; i < eventCount; ++i) {
+        if (events[i].data.fd == m_wakeUpFd) {
+            // Reset the counter
+            uint64_t counter;
+            [[maybe_unused]] const auto bytesRead = ::read(m_wakeUpFd, &counter, sizeof(counter));
+            wokenUp = true;
+        } else if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+            // Level-triggered, i.e. reported again on every wait()
+            inputClosed = true;
+        } else {
+            inputAvailable = true;
+        }
+    }
+    if (inputClosed) {
+        return Result::InputClosed;
+    }
+    if (inputAvailable) {
+        return Result::InputAvailable;
+    }
+    if (wokenUp) {
+        return Result::WokenUp;
+    }
+    return Result::TimedOut;
+}
+
+#else // __LINUX__
+
+ControllerInputWaiter::ControllerInputWaiter()
+        : m_epollFd(-1),
+          m_wakeUpFd(-1) {
+}
+
+ControllerInputWaiter::~ControllerInputWaiter() = default;
+
+bool ControllerInputWaiter::isValid() const {
+    return false;
+}
+
+bool ControllerInputWaiter::addInput(int /*fd*/) {
+    return false;
+}
+
+void ControllerInputWaiter::removeInput(int /*fd*/) {
+}
+
+void ControllerInputWaiter::wakeUp() {
+}
+
+ControllerInputWaiter::Result ControllerInputWaiter::wait(mixxx::Duration /*timeout*/) {
+    DEBUG_ASSERT(!"unsupported");
+    return Result::Failed;
+}
+
+#endif // __LINUX__
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "util/duration.h"
+
+/// Blocks a controller I/O thread until input data arrives on one of
+/// the registered file descriptors, until wakeUp() is invoked from
+/// another thread, or until the timeout expires.
+///
+/// Only available on Linux where it is based on epoll and eventfd.
+/// Callers must check isValid() and fall back to polling otherwise.
+class ControllerInputWaiter final {
+  public:
+    ControllerInputWaiter();
+    ~ControllerInputWaiter();
+
+    ControllerInputWaiter(const ControllerInputWaiter&) = delete;
+    ControllerInputWaiter& operator=(const ControllerInputWaiter&) = delete;
+
+    bool isValid() const;
+
+    /// Registers a non-blocking file descriptor for readability.
+    /// The ownership is not transferred.
+    bool addInput(int fd);
+
+    /// Unregisters a file descriptor, e.g. before closing it after
+    /// wait() returned Result::InputClosed.
+    void removeInput(int fd);
+
+    /// Interrupts a concurrent or the next invocation of wait().
+    ///
+    /// Thread-safe
+    void wakeUp();
+
+    enum class Result {
+        InputAvailable,
+        /// The device has been disconnected or failed. The state is
+        /// reported until the file descriptor is removed.
+        InputClosed,
+        WokenUp,
+        TimedOut,
+        Failed,
+    };
+
+    Result wait(mixxx::Duration timeout);
+
+  private:
+    int m_epollFd;
+    int m_wakeUpFd;
+};
@@ -9,7 +9,6 @@
 #include "moc_controllermanager.cpp"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
-#include "util/time.h"
 #include "util/trace.h"
 #ifdef __HSS1394__
 #include "controllers/midi/hss1394enumerator.h"
@@ -61,6 +60,11 @@ QFileInfo findMappingFile(const QString& pathOrFilename, const QStringList& path
 // kept for backwards compatibility.
 const QString kSettingsGroup = QLatin1String("[ControllerPreset]");
 
+// Output messages are collected over this duration and sent in a single
+// batch. Disabled by default, because some mappings might rely on every
+// single message being sent.
+const ConfigKey kOutputFrameMillisConfigKey("[Controller]", "OutputFrameMillis");
+
 } // anonymous namespace
 
 QString firstAvailableFilename(QSet<QString>& filenames,
@@ -85,9 +89,7 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
           // WARNING: Do not parent m_pControllerLearningEventFilter to
           // ControllerManager because the CM is moved to its own thread and runs
           // its own event loop.
-          m_pControllerLearningEventFilter(new ControllerLearningEventFilter()),
-          m_pollTimer(this),
-          m_skipPoll(false) {
+          m_pControllerLearningEventFilter(new ControllerLearningEventFilter()) {
     qRegisterMetaType<std::shared_ptr<LegacyControllerMapping>>(
             "std::shared_ptr<LegacyControllerMapping>");
 
@@ -98,17 +100,13 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
         QDir().mkpath(userMappings);
     }
 
-    m_pollTimer.setInterval(kPollInterval.toIntegerMillis());
-    connect(&m_pollTimer, &QTimer::timeout, this, &ControllerManager::pollDevices);
-
     m_pThread = new QThread;
     m_pThread->setObjectName("Controller");
 
-    // Moves all children (including the poll timer) to m_pThread
+    // Moves all children to m_pThread. The controllers are moved to their
+    // own threads when they are opened, see startControllerThread().
     moveToThread(m_pThread);
 
-    // Controller processing needs to be prioritized since it can affect the
-    // audio directly, like when scratching
     m_pThread->start(QThread::HighPriority);
 
     connect(this, &ControllerManager::requestInitialize, this, &ControllerManager::slotInitialize);
@@ -159,7 +157,16 @@ void ControllerManager::slotInitialize() {
 }
 
 void ControllerManager::slotShutdown() {
-    stopPolling();
+    // Return all controllers to this thread before their enumerators
+    // delete them.
+    auto threadsLocker = lockMutex(&m_mutex);
+    const QList<ControllerThread*> controllerThreads = m_controllerThreads.values();
+    m_controllerThreads.clear();
+    threadsLocker.unlock();
+    for (ControllerThread* pControllerThread : controllerThreads) {
+        pControllerThread->shutdown(m_pThread);
+        delete pControllerThread;
+    }
 
     // Clear m_enumerators before deleting the enumerators to prevent other code
     // paths from accessing them.
@@ -173,7 +180,6 @@ void ControllerManager::slotShutdown() {
         delete pEnumerator;
     }
 
-    // Stop the processor after the enumerators since the engines live in it
     m_pThread->quit();
 }
 
@@ -194,6 +200,14 @@ void ControllerManager::updateControllerList() {
         newDeviceList.append(pEnumerator->queryDevices());
     }
 
+    const auto outputFrameDuration = mixxx::Duration::fromMillis(
+            m_pConfig->getValue(kOutputFrameMillisConfigKey, 0));
+    for (Controller* pController : qAsConst(newDeviceList)) {
+        invokeOnControllerThread(pController, [pController, outputFrameDuration] {
+            pController->setOutputFrameDuration(outputFrameDuration);
+        });
+    }
+
     locker.relock();
     if (newDeviceList != m_controllers) {
         m_controllers = newDeviceList;
@@ -227,6 +241,58 @@ QList<Controller*> ControllerManager::getControllerList(bool bOutputDevices, boo
     return filteredDeviceList;
 }
 
+std::optional<ControllerThread::Stats> ControllerManager::getControllerThreadStats(
+        Controller* pController) const {
+    const auto locker = lockMutex(&m_mutex);
+    const ControllerThread* pControllerThread = m_controllerThreads.value(pController);
+    if (!pControllerThread) {
+        return std::nullopt;
+    }
+    return pControllerThread->stats();
+}
+
+ControllerThread* ControllerManager::startControllerThread(Controller* pController) {
+    auto locker = lockMutex(&m_mutex);
+    ControllerThread* pControllerThread = m_controllerThreads.value(pController);
+    if (pControllerThread) {
+        return pControllerThread;
+    }
+    pControllerThread = new ControllerThread(pController);
+    m_controllerThreads.insert(pController, pControllerThread);
+    locker.unlock();
+
+    // Controller processing needs to be prioritized since it can affect the
+    // audio directly, like when scratching
+    pControllerThread->start(QThread::HighPriority);
+    return pControllerThread;
+}
+
+ControllerThread* ControllerManager::findControllerThread(Controller* pController) const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_controllerThreads.value(pController);
+}
+
+void ControllerManager::invokeOnControllerThread(Controller* pController,
+        const std::function<void()>& function) {
+    ControllerThread* pControllerThread = findControllerThread(pController);
+    if (!pControllerThread) {
+        // The controller has never been opened and still lives on this thread
+        function();
+        return;
+    }
+    pControllerThread->invoke(function);
+}
+
+void ControllerManager::closeControllerOnThread(Controller* pController) {
+    invokeOnControllerThread(pController, [pController] {
+        pController->close();
+    });
+    ControllerThread* pControllerThread = findControllerThread(pController);
+    if (pControllerThread) {
+        pControllerThread->updatePolling();
+    }
+}
+
 QString ControllerManager::getConfiguredMappingFileForDevice(const QString& name) {
     return m_pConfig->getValueString(ConfigKey(kSettingsGroup, sanitizeDeviceName(name)));
 }
@@ -242,7 +308,7 @@ void ControllerManager::slotSetUpDevices() {
         QString name = pController->getName();
 
         if (pController->isOpen()) {
-            pController->close();
+            closeControllerOnThread(pController);
         }
 
         // The filename for this device name.
@@ -276,7 +342,9 @@ void ControllerManager::slotSetUpDevices() {
         }
 
         // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-        pController->setMapping(pMapping->clone());
+        invokeOnControllerThread(pController, [pController, &pMapping] {
+            pController->setMapping(pMapping->clone());
+        });
 
         // If we are in safe mode, skip opening controllers.
         if (CmdlineArgs::Instance().getSafeMode()) {
@@ -286,88 +354,19 @@ void ControllerManager::slotSetUpDevices() {
 
         qDebug() << "Opening controller:" << name;
 
-        int value = pController->open();
+        ControllerThread* pControllerThread = startControllerThread(pController);
+        int value = pControllerThread->invoke([pController] {
+            return pController->open();
+        });
+        pControllerThread->updatePolling();
         if (value != 0) {
             qWarning() << "There was a problem opening" << name;
             continue;
         }
-        pController->applyMapping();
+        pControllerThread->invoke([pController] {
+            pController->applyMapping();
+        });
     }
-
-    pollIfAnyControllersOpen();
-}
-
-void ControllerManager::pollIfAnyControllersOpen() {
-    auto locker = lockMutex(&m_mutex);
-    QList<Controller*> controllers = m_controllers;
-    locker.unlock();
-
-    bool shouldPoll = false;
-    for (Controller* pController : controllers) {
-        if (pController->isOpen() && pController->isPolling()) {
-            shouldPoll = true;
-        }
-    }
-    if (shouldPoll) {
-        startPolling();
-    } else {
-        stopPolling();
-    }
-}
-
-void ControllerManager::startPolling() {
-    // Start the polling timer.
-    if (!m_pollTimer.isActive()) {
-        m_pollTimer.start();
-        qDebug() << "Controller polling started.";
-    }
-}
-
-void ControllerManager::stopPolling() {
-    m_pollTimer.stop();
-    qDebug() << "Controller polling stopped.";
-}
-
-void ControllerManager::pollDevices() {
-    // Note: this function is called from a high priority thread which
-    // may stall the GUI or may reduce the available CPU time for other
-    // High Priority threads like caching reader or broadcasting more
-    // then desired, if it is called endless loop like.
-    //
-    // This especially happens if a controller like the 3x Speed
-    // Stanton SCS.1D emits more massages than Mixxx is able to handle
-    // or a controller like Hercules RMX2 goes wild. In such a case the
-    // receive buffer is stacked up every call to insane values > 500 messages.
-    //
-    // To avoid this we pick here a strategies similar like the audio
-    // thread. In case pollDevice() takes longer than a call cycle
-    // we are cooperative a skip the next cycle to free at least some
-    // CPU time
-    //
-    // Some random test data form a i5-3317U CPU @ 1.70GHz Running
-    // Ubuntu Trusty:
-    // * Idle poll: ~5 µs.
-    // * 5 messages burst (full midi bandwidth): ~872 µs.
-
-    if (m_skipPoll) {
-        // skip poll in overload situation
-        m_skipPoll = false;
-        //qDebug() << "ControllerManager::pollDevices() skip";
-        return;
-    }
-
-    mixxx::Duration start = mixxx::Time::elapsed();
-    for (Controller* pDevice : qAsConst(m_controllers)) {
-        if (pDevice->isOpen() && pDevice->isPolling()) {
-            pDevice->poll();
-        }
-    }
-
-    mixxx::Duration duration = mixxx::Time::elapsed() - start;
-    if (duration > kPollInterval) {
-        m_skipPoll = true;
-    }
-    //qDebug() << "ControllerManager::pollDevices()" << duration << start;
 }
 
 void ControllerManager::openController(Controller* pController) {
@@ -375,15 +374,20 @@ void ControllerManager::openController(Controller* pController) {
         return;
     }
     if (pController->isOpen()) {
-        pController->close();
+        closeControllerOnThread(pController);
     }
-    int result = pController->open();
-    pollIfAnyControllersOpen();
+    ControllerThread* pControllerThread = startControllerThread(pController);
+    int result = pControllerThread->invoke([pController] {
+        return pController->open();
+    });
+    pControllerThread->updatePolling();
 
     // If successfully opened the device, apply the mapping and save the
     // preference setting.
     if (result == 0) {
-        pController->applyMapping();
+        pControllerThread->invoke([pController] {
+            pController->applyMapping();
+        });
 
         // Update configuration to reflect controller is enabled.
         m_pConfig->setValue(
@@ -395,8 +399,7 @@ void ControllerManager::closeController(Controller* pController) {
     if (!pController) {
         return;
     }
-    pController->close();
-    pollIfAnyControllersOpen();
+    closeControllerOnThread(pController);
     // Update configuration to reflect controller is disabled.
     m_pConfig->setValue(
             ConfigKey("[Controller]", sanitizeDeviceName(pController->getName())), 0);
@@ -429,7 +432,9 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     m_pConfig->set(key, pMapping->filePath());
 
     // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-    pController->setMapping(pMapping->clone());
+    invokeOnControllerThread(pController, [pController, &pMapping] {
+        pController->setMapping(pMapping->clone());
+    });
 
     if (bEnabled) {
         openController(pController);
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QSharedPointer>
-#include <QTimer>
+#include <functional>
+#include <optional>
 
 #include "controllers/controllerenumerator.h"
 #include "controllers/controllermappinginfo.h"
 #include "controllers/controllermappinginfoenumerator.h"
+#include "controllers/controllerthread.h"
 #include "controllers/legacycontrollermapping.h"
 #include "preferences/usersettings.h"
 
@@ -42,6 +45,11 @@ class ControllerManager : public QObject {
 
     static QList<QString> getMappingPaths(UserSettingsPointer pConfig);
 
+    /// Load statistics of the thread the controller runs on. Returns
+    /// nullopt if the controller has not been opened yet.
+    std::optional<ControllerThread::Stats> getControllerThreadStats(
+            Controller* pController) const;
+
   signals:
     void devicesChanged();
     void requestSetUpDevices();
@@ -67,21 +75,25 @@ class ControllerManager : public QObject {
     /// preferences dialog on apply, and only open/close changed devices
     void slotSetUpDevices();
     void slotShutdown();
-    /// Calls poll() on all devices that have isPolling() true.
-    void pollDevices();
-    void startPolling();
-    void stopPolling();
-    void pollIfAnyControllersOpen();
 
   private:
+    /// Each controller runs on its own thread once it has been opened
+    /// for the first time. Returns the existing thread or starts a new one.
+    ControllerThread* startControllerThread(Controller* pController);
+    ControllerThread* findControllerThread(Controller* pController) const;
+    /// Executes the function on the thread of the controller and waits
+    /// until it has finished.
+    void invokeOnControllerThread(Controller* pController,
+            const std::function<void()>& function);
+    void closeControllerOnThread(Controller* pController);
+
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
-    QTimer m_pollTimer;
     mutable QMutex m_mutex;
     QList<ControllerEnumerator*> m_enumerators;
     QList<Controller*> m_controllers;
+    QHash<Controller*, ControllerThread*> m_controllerThreads;
     QThread* m_pThread;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadUserMappingEnumerator;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadSystemMappingEnumerator;
-    bool m_skipPoll;
 };
@@ -0,0 +1,437 @@
+#include "controllers/controllerscreen.h"
+
+#include <QtDebug>
+#include <algorithm>
+#include <cstring>
+
+#include "controllers/controller.h"
+#include "moc_controllerscreen.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+// Size of x, y, width and height in each packet
+constexpr int kPacketCoordinatesSize = 4 * 2;
+
+// The conversion loops have no dependencies between the pixels and are
+// vectorized by the compiler, see SampleUtil.
+void convertToRgb565(uchar* pDest, const uchar* pSrc, int count) {
+    for (int i = 0; i < count; ++i) {
+        const auto pixel = static_cast<uint16_t>(((pSrc[i * 4] & 0xF8) << 8) |
+                ((pSrc[i * 4 + 1] & 0xFC) << 3) | (pSrc[i * 4 + 2] >> 3));
+        pDest[i * 2] = static_cast<uchar>(pixel);
+        pDest[i * 2 + 1] = static_cast<uchar>(pixel >> 8);
+    }
+}
+
+void convertToRgb565BigEndian(uchar* pDest, const uchar* pSrc, int count) {
+    for (int i = 0; i < count; ++i) {
+        const auto pixel = static_cast<uint16_t>(((pSrc[i * 4] & 0xF8) << 8) |
+                ((pSrc[i * 4 + 1] & 0xFC) << 3) | (pSrc[i * 4 + 2] >> 3));
+        pDest[i * 2] = static_cast<uchar>(pixel >> 8);
+        pDest[i * 2 + 1] = static_cast<uchar>(pixel);
+    }
+}
+
+void convertToRgb888(uchar* pDest, const uchar* pSrc, int count) {
+    for (int i = 0; i < count; ++i) {
+        pDest[i * 3] = pSrc[i * 4];
+        pDest[i * 3 + 1] = pSrc[i * 4 + 1];
+        pDest[i * 3 + 2] = pSrc[i * 4 + 2];
+    }
+}
+
+void convertToBgr888(uchar* pDest, const uchar* pSrc, int count) {
+    for (int i = 0; i < count; ++i) {
+        pDest[i * 3] = pSrc[i * 4 + 2];
+        pDest[i * 3 + 1] = pSrc[i * 4 + 1];
+        pDest[i * 3 + 2] = pSrc[i * 4];
+    }
+}
+
+int packetHeaderSize(const ControllerScreen::Config& config) {
+    return config.header.size() + kPacketCoordinatesSize;
+}
+
+// The size of the stripes a rectangle is split into to fit into
+// maxPacketSize
+QSize stripeSize(const ControllerScreen::Config& config, const QSize& rectSize) {
+    if (config.maxPacketSize <= 0) {
+        return rectSize;
+    }
+    const int maxPixels = std::max(
+            (config.maxPacketSize - packetHeaderSize(config)) /
+                    ControllerScreen::bytesPerPixel(config),
+            1);
+    const int stripeWidth = std::min(rectSize.width(), maxPixels);
+    return QSize(stripeWidth,
+            std::clamp(maxPixels / stripeWidth, 1, rectSize.height()));
+}
+
+void appendUInt16(QByteArray* pData, int value, bool bigEndian) {
+    const auto lowByte = static_cast<char>(value & 0xFF);
+    const auto highByte = static_cast<char>((value >> 8) & 0xFF);
+    if (bigEndian) {
+        pData->append(highByte);
+        pData->append(lowByte);
+    } else {
+        pData->append(lowByte);
+        pData->append(highByte);
+    }
+}
+
+} // anonymous namespace
+
+ControllerScreen::ControllerScreen(const Config& config)
+        : m_config(config),
+          m_image(config.width, config.height, QImage::Format_RGBA8888),
+          m_sentImage(config.width, config.height, QImage::Format_RGBA8888),
+          m_invalidated(true) {
+    DEBUG_ASSERT(m_config.tileSize > 0);
+    m_image.fill(Qt::black);
+    m_sentImage.fill(Qt::black);
+}
+
+void ControllerScreen::markTouched(const QRect& rect) {
+    m_touched = m_touched.united(rect);
+}
+
+void ControllerScreen::setPixels(const QRect& rect, const QByteArray& rgbaData) {
+    const QRect target = rect.intersected(m_image.rect());
+    if (target.isEmpty()) {
+        return;
+    }
+    const qsizetype sourceBytesPerLine = qsizetype{rect.width()} * 4;
+    if (rgbaData.size() < sourceBytesPerLine * rect.height()) {
+        qWarning() << "ControllerScreen: Expected"
+                   << sourceBytesPerLine * rect.height() << "bytes of RGBA data for"
+                   << rect << "but got" << rgbaData.size();
+        return;
+    }
+    const auto* pSource = reinterpret_cast<const uchar*>(rgbaData.constData()) +
+            (target.y() - rect.y()) * sourceBytesPerLine +
+            (target.x() - rect.x()) * 4;
+    for (int y = target.top(); y <= target.bottom(); ++y) {
+        std::memcpy(m_image.scanLine(y) + target.x() * 4,
+                pSource,
+                static_cast<std::size_t>(target.width()) * 4);
+        pSource += sourceBytesPerLine;
+    }
+    markTouched(target);
+}
+
+void ControllerScreen::fillRect(const QRect& rect, QRgb color) {
+    const QRect target = rect.intersected(m_image.rect());
+    if (target.isEmpty()) {
+        return;
+    }
+    const uchar pixel[4] = {
+            static_cast<uchar>(qRed(color)),
+            static_cast<uchar>(qGreen(color)),
+            static_cast<uchar>(qBlue(color)),
+            0xFF,
+    };
+    for (int y = target.top(); y <= target.bottom(); ++y) {
+        uchar* pDest = m_image.scanLine(y) + target.x() * 4;
+        for (int x = 0; x < target.width(); ++x) {
+            std::memcpy(pDest + x * 4, pixel, sizeof(pixel));
+        }
+    }
+    markTouched(target);
+}
+
+void ControllerScreen::invalidate() {
+    m_invalidated = true;
+}
+
+bool ControllerScreen::isTileChanged(const QRect& tile) const {
+    const auto bytesPerLine = static_cast<std::size_t>(tile.width()) * 4;
+    for (int y = tile.top(); y <= tile.bottom(); ++y) {
+        if (std::memcmp(m_image.constScanLine(y) + tile.x() * 4,
+                    m_sentImage.constScanLine(y) + tile.x() * 4,
+                    bytesPerLine) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QList<QRect> ControllerScreen::dirtyRects() const {
+    if (m_invalidated) {
+        return {m_image.rect()};
+    }
+    QList<QRect> dirtyRects;
+    if (m_touched.isEmpty()) {
+        return dirtyRects;
+    }
+
+    const int tileSize = m_config.tileSize;
+    const int firstColumn = m_touched.left() / tileSize;
+    const int lastColumn = m_touched.right() / tileSize;
+    const int firstRow = m_touched.top() / tileSize;
+    const int lastRow = m_touched.bottom() / tileSize;
+
+    // Runs of changed tiles in a row of tiles are merged with the runs
+    // of the previous row if they span the same columns
+    std::vector<QRect> previousRuns;
+    std::vector<QRect> runs;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        runs.clear();
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const QRect tile = QRect(column * tileSize, row * tileSize, tileSize, tileSize)
+                                       .intersected(m_image.rect());
+            if (!isTileChanged(tile)) {
+                continue;
+            }
+            if (!runs.empty() && runs.back().right() + 1 == tile.left()) {
+                runs.back().setRight(tile.right());
+            } else {
+                runs.push_back(tile);
+            }
+        }
+        for (auto& run : runs) {
+            const auto previous = std::find_if(previousRuns.begin(),
+                    previousRuns.end(),
+                    [&run](const QRect& rect) {
+                        return rect.left() == run.left() &&
+                                rect.right() == run.right() &&
+                                rect.bottom() + 1 == run.top();
+                    });
+            if (previous != previousRuns.end()) {
+                run.setTop(previous->top());
+                previousRuns.erase(previous);
+            }
+        }
+        // The remaining runs of the previous row can't grow anymore
+        for (const auto& rect : previousRuns) {
+            dirtyRects.append(rect);
+        }
+        std::swap(previousRuns, runs);
+    }
+    for (const auto& rect : previousRuns) {
+        dirtyRects.append(rect);
+    }
+    return dirtyRects;
+}
+
+void ControllerScreen::markSent(const QList<QRect>& dirtyRects) {
+    // All changes are contained in the dirty rectangles
+    m_invalidated = false;
+    m_touched = QRect();
+    for (const auto& rect : dirtyRects) {
+        DEBUG_ASSERT(m_image.rect().contains(rect));
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            std::memcpy(m_sentImage.scanLine(y) + rect.x() * 4,
+                    m_image.constScanLine(y) + rect.x() * 4,
+                    static_cast<std::size_t>(rect.width()) * 4);
+        }
+    }
+}
+
+QList<QRect> ControllerScreen::takeDirtyRects() {
+    const auto rects = dirtyRects();
+    markSent(rects);
+    return rects;
+}
+
+QByteArray ControllerScreen::encode(const QRect& rect) const {
+    DEBUG_ASSERT(m_image.rect().contains(rect));
+    const int bytesPerLine = rect.width() * bytesPerPixel();
+    QByteArray data(qsizetype{bytesPerLine} * rect.height(), Qt::Uninitialized);
+    auto* pDest = reinterpret_cast<uchar*>(data.data());
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const uchar* pSource = m_image.constScanLine(y) + rect.x() * 4;
+        switch (m_config.pixelFormat) {
+        case PixelFormat::RGB565:
+            if (m_config.bigEndian) {
+                convertToRgb565BigEndian(pDest, pSource, rect.width());
+            } else {
+                convertToRgb565(pDest, pSource, rect.width());
+            }
+            break;
+        case PixelFormat::RGB888:
+            // Little-endian 24 bit integers store blue first
+            if (m_config.bigEndian) {
+                convertToRgb888(pDest, pSource, rect.width());
+            } else {
+                convertToBgr888(pDest, pSource, rect.width());
+            }
+            break;
+        }
+        pDest += bytesPerLine;
+    }
+    return data;
+}
+
+void ControllerScreen::appendPackets(QList<QByteArray>* pPackets, const QRect& rect) const {
+    const int headerSize = packetHeaderSize(m_config);
+    const QSize maxStripe = stripeSize(m_config, rect.size());
+    for (int y = rect.top(); y <= rect.bottom(); y += maxStripe.height()) {
+        for (int x = rect.left(); x <= rect.right(); x += maxStripe.width()) {
+            const QRect stripe = QRect(QPoint(x, y), maxStripe).intersected(rect);
+            QByteArray packet;
+            packet.reserve(headerSize + stripe.width() * stripe.height() * bytesPerPixel());
+            packet.append(m_config.header);
+            appendUInt16(&packet, stripe.x(), m_config.bigEndian);
+            appendUInt16(&packet, stripe.y(), m_config.bigEndian);
+            appendUInt16(&packet, stripe.width(), m_config.bigEndian);
+            appendUInt16(&packet, stripe.height(), m_config.bigEndian);
+            packet.append(encode(stripe));
+            pPackets->append(std::move(packet));
+        }
+    }
+}
+
+QList<QByteArray> ControllerScreen::packets(const QList<QRect>& rects) const {
+    QList<QByteArray> packets;
+    for (const auto& rect : rects) {
+        appendPackets(&packets, rect);
+    }
+    return packets;
+}
+
+QList<QByteArray> ControllerScreen::takeUpdatePackets() {
+    return packets(takeDirtyRects());
+}
+
+//static
+qsizetype ControllerScreen::fullFrameBytes(const Config& config) {
+    const QSize stripe = stripeSize(config, QSize(config.width, config.height));
+    const qsizetype stripeCount =
+            qsizetype{(config.width + stripe.width() - 1) / stripe.width()} *
+            ((config.height + stripe.height() - 1) / stripe.height());
+    return stripeCount * packetHeaderSize(config) +
+            qsizetype{config.width} * config.height * bytesPerPixel(config);
+}
+
+ControllerScreenOutputQueue::ControllerScreenOutputQueue(qsizetype maxBytes)
+        : m_maxBytes(maxBytes),
+          m_queuedBytes(0) {
+}
+
+bool ControllerScreenOutputQueue::push(const QList<QByteArray>& packets) {
+    qsizetype bytes = 0;
+    for (const auto& packet : packets) {
+        bytes += packet.size();
+    }
+    // Would never fit, even into an empty queue. Screens with a larger
+    // framebuffer are rejected when they are created.
+    VERIFY_OR_DEBUG_ASSERT(bytes <= m_maxBytes) {
+        return false;
+    }
+    auto lock = lockMutex(&m_mutex);
+    if (m_queuedBytes + bytes > m_maxBytes) {
+        return false;
+    }
+    for (const auto& packet : packets) {
+        m_packets.push_back(packet);
+    }
+    m_queuedBytes += bytes;
+    lock.unlock();
+    m_packetQueued.wakeAll();
+    return true;
+}
+
+bool ControllerScreenOutputQueue::pop(QByteArray* pPacket, unsigned long timeoutMillis) {
+    auto lock = lockMutex(&m_mutex);
+    if (m_packets.empty() && timeoutMillis > 0) {
+        m_packetQueued.wait(&m_mutex, timeoutMillis);
+    }
+    if (m_packets.empty()) {
+        return false;
+    }
+    *pPacket = std::move(m_packets.front());
+    m_packets.pop_front();
+    m_queuedBytes -= pPacket->size();
+    return true;
+}
+
+bool ControllerScreenOutputQueue::isEmpty() const {
+    auto lock = lockMutex(&m_mutex);
+    return m_packets.empty();
+}
+
+void ControllerScreenOutputQueue::clear() {
+    auto lock = lockMutex(&m_mutex);
+    m_packets.clear();
+    m_queuedBytes = 0;
+}
+
+void ControllerScreenOutputQueue::wakeUp() {
+    m_packetQueued.wakeAll();
+}
+
+ControllerScreenJSProxy::ControllerScreenJSProxy(Controller* pController,
+        const ControllerScreen::Config& config,
+        QObject* pParent)
+        : QObject(pParent),
+          m_pController(pController),
+          m_screen(config) {
+}
+
+bool ControllerScreenJSProxy::configFromOptions(
+        ControllerScreen::Config* pConfig, const QVariantMap& options) {
+    const QString pixelFormat =
+            options.value(QStringLiteral("pixelFormat"), QStringLiteral("rgb565"))
+                    .toString()
+                    .toLower();
+    if (pixelFormat == QLatin1String("rgb565")) {
+        pConfig->pixelFormat = ControllerScreen::PixelFormat::RGB565;
+    } else if (pixelFormat == QLatin1String("rgb888")) {
+        pConfig->pixelFormat = ControllerScreen::PixelFormat::RGB888;
+    } else {
+        qWarning() << "Unsupported screen pixel format" << pixelFormat;
+        return false;
+    }
+    pConfig->bigEndian = options.value(QStringLiteral("bigEndian"), false).toBool();
+
+    const QVariantList header = options.value(QStringLiteral("header")).toList();
+    pConfig->header.clear();
+    for (const auto& byte : header) {
+        pConfig->header.append(static_cast<char>(byte.toInt()));
+    }
+
+    pConfig->maxPacketSize = options.value(QStringLiteral("maxPacketSize"), 0).toInt();
+    if (pConfig->maxPacketSize < 0 ||
+            (pConfig->maxPacketSize > 0 &&
+                    pConfig->maxPacketSize < pConfig->header.size() +
+                                    kPacketCoordinatesSize + 3)) {
+        qWarning() << "Screen packet size" << pConfig->maxPacketSize
+                   << "is too small for the header";
+        return false;
+    }
+
+    pConfig->tileSize = options.value(QStringLiteral("tileSize"), pConfig->tileSize).toInt();
+    if (pConfig->tileSize <= 0) {
+        qWarning() << "Invalid screen tile size" << pConfig->tileSize;
+        return false;
+    }
+    return true;
+}
+
+void ControllerScreenJSProxy::setPixels(
+        int x, int y, int width, int height, const QByteArray& rgbaData) {
+    m_screen.setPixels(QRect(x, y, width, height), rgbaData);
+}
+
+void ControllerScreenJSProxy::fillRect(int x, int y, int width, int height, uint color) {
+    m_screen.fillRect(QRect(x, y, width, height), color);
+}
+
+void ControllerScreenJSProxy::invalidate() {
+    m_screen.invalidate();
+}
+
+bool ControllerScreenJSProxy::update() {
+    const auto dirtyRects = m_screen.dirtyRects();
+    if (dirtyRects.isEmpty()) {
+        return true;
+    }
+    if (!m_pController->sendScreenPackets(m_screen.packets(dirtyRects))) {
+        // The changes remain dirty and are sent with the next update
+        return false;
+    }
+    m_screen.markSent(dirtyRects);
+    return true;
+}
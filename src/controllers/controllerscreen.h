@@ -0,0 +1,181 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QRect>
+#include <QVariantMap>
+#include <QWaitCondition>
+#include <deque>
+#include <vector>
+
+class Controller;
+
+/// The framebuffer of a controller screen
+///
+/// The mapping renders into the RGBA image of the screen. On each update
+/// the image is compared tile by tile with the previously sent frame and
+/// only the changed tiles are encoded in the pixel format of the device,
+/// merged into as few rectangles as possible.
+class ControllerScreen final {
+  public:
+    enum class PixelFormat {
+        RGB565,
+        RGB888,
+    };
+
+    struct Config {
+        int width = 0;
+        int height = 0;
+        PixelFormat pixelFormat = PixelFormat::RGB565;
+        /// Byte order of the pixels and the coordinates in the packets
+        bool bigEndian = false;
+        /// Prepended to each packet. For HID devices the header starts
+        /// with the report ID.
+        QByteArray header;
+        /// The maximum size of a packet including the header, e.g. the
+        /// size of a HID OutputReport. 0 doesn't split rectangles.
+        int maxPacketSize = 0;
+        /// Edge length of the tiles that are compared
+        int tileSize = 16;
+    };
+
+    explicit ControllerScreen(const Config& config);
+
+    const Config& config() const {
+        return m_config;
+    }
+
+    /// Copies pixels in memory order R, G, B, A into the framebuffer
+    void setPixels(const QRect& rect, const QByteArray& rgbaData);
+    void fillRect(const QRect& rect, QRgb color);
+
+    /// Sends the complete framebuffer with the next update, e.g. after the
+    /// device has lost its content.
+    void invalidate();
+
+    /// Returns the rectangles that have changed since the content has
+    /// been marked as sent
+    QList<QRect> dirtyRects() const;
+
+    /// Remembers the current content of the dirty rectangles as sent
+    void markSent(const QList<QRect>& dirtyRects);
+
+    /// Returns the dirty rectangles and marks them as sent
+    QList<QRect> takeDirtyRects();
+
+    /// The pixels of the rectangle in the pixel format of the device
+    QByteArray encode(const QRect& rect) const;
+
+    /// The packets for the rectangles. Each packet consists of the
+    /// header, x, y, width and height as 16 bit integers and the pixels.
+    /// Rectangles that don't fit into maxPacketSize are split into
+    /// stripes of rows.
+    QList<QByteArray> packets(const QList<QRect>& rects) const;
+
+    /// The packets for all dirty rectangles, which are marked as sent
+    QList<QByteArray> takeUpdatePackets();
+
+    /// The total size of the packets that contain the complete framebuffer
+    static qsizetype fullFrameBytes(const Config& config);
+
+    static int bytesPerPixel(const Config& config) {
+        return config.pixelFormat == PixelFormat::RGB565 ? 2 : 3;
+    }
+    int bytesPerPixel() const {
+        return bytesPerPixel(m_config);
+    }
+
+  private:
+    void markTouched(const QRect& rect);
+    bool isTileChanged(const QRect& tile) const;
+    void appendPackets(QList<QByteArray>* pPackets, const QRect& rect) const;
+
+    const Config m_config;
+    QImage m_image;
+    QImage m_sentImage;
+    // Only tiles in this area are compared on the next update
+    QRect m_touched;
+    bool m_invalidated;
+};
+
+/// Thread-safe queue for the packets of screen updates that are sent by
+/// an I/O thread. The size is limited to avoid an ever increasing latency
+/// if the device is slower than the mapping.
+class ControllerScreenOutputQueue final {
+  public:
+    static constexpr qsizetype kDefaultMaxBytes = 2 * 1024 * 1024;
+
+    explicit ControllerScreenOutputQueue(qsizetype maxBytes = kDefaultMaxBytes);
+
+    qsizetype maxBytes() const {
+        return m_maxBytes;
+    }
+
+    /// Queues either all or none of the packets. Returns false if the
+    /// packets don't fit.
+    bool push(const QList<QByteArray>& packets);
+
+    /// Takes the next packet, waiting up to timeoutMillis if the queue is
+    /// empty. Returns false if no packet is available.
+    bool pop(QByteArray* pPacket, unsigned long timeoutMillis = 0);
+
+    bool isEmpty() const;
+
+    /// Drops all queued packets
+    void clear();
+
+    /// Wakes up a blocking pop()
+    void wakeUp();
+
+  private:
+    const qsizetype m_maxBytes;
+    mutable QMutex m_mutex;
+    QWaitCondition m_packetQueued;
+    std::deque<QByteArray> m_packets;
+    qsizetype m_queuedBytes;
+};
+
+/// The object that is returned by controller.createScreen() to scripts
+class ControllerScreenJSProxy : public QObject {
+    Q_OBJECT
+  public:
+    ControllerScreenJSProxy(Controller* pController,
+            const ControllerScreen::Config& config,
+            QObject* pParent);
+
+    /// Parses the options of controller.createScreen(). Returns false
+    /// for invalid options.
+    static bool configFromOptions(ControllerScreen::Config* pConfig,
+            const QVariantMap& options);
+
+    Q_INVOKABLE int width() const {
+        return m_screen.config().width;
+    }
+    Q_INVOKABLE int height() const {
+        return m_screen.config().height;
+    }
+
+    /// @brief Copies pixels into the framebuffer
+    /// @param rgbaData ArrayBuffer with 4 bytes R, G, B, A per pixel and
+    /// width * 4 bytes per row
+    Q_INVOKABLE void setPixels(int x, int y, int width, int height, const QByteArray& rgbaData);
+
+    /// @brief Fills a rectangle of the framebuffer
+    /// @param color 0xRRGGBB
+    Q_INVOKABLE void fillRect(int x, int y, int width, int height, uint color);
+
+    /// @brief Sends the complete framebuffer with the next update
+    Q_INVOKABLE void invalidate();
+
+    /// @brief Sends the changed parts of the framebuffer asynchronously
+    /// @return false if the device didn't keep up and the update was
+    /// dropped. The next update then contains its changes as well.
+    Q_INVOKABLE bool update();
+
+  private:
+    Controller* const m_pController;
+    ControllerScreen m_screen;
+};
@@ -0,0 +1,188 @@
+#include "controllers/controllerthread.h"
+
+#include <algorithm>
+
+#include "controllers/controller.h"
+#include "controllers/controllermanager.h"
+#include "moc_controllerthread.cpp"
+#include "util/compatibility/qmutex.h"
+#include "util/stat.h"
+#include "util/time.h"
+
+namespace {
+
+constexpr mixxx::Duration kStatsInterval = mixxx::Duration::fromSeconds(1);
+
+} // anonymous namespace
+
+ControllerThread::ControllerThread(Controller* pController)
+        : m_pController(pController),
+          m_statPollJitterTag(
+                  QStringLiteral("Controller poll jitter ") + pController->getName()),
+          m_skipPoll(false),
+          m_lastPollStarted(mixxx::Duration::empty()),
+          m_lastStatsUpdated(mixxx::Duration::empty()) {
+    setObjectName(QStringLiteral("Controller ") + pController->getName());
+
+    m_pollTimer.setInterval(ControllerManager::kPollInterval.toIntegerMillis());
+    // The default coarse timer may deviate up to 5% from the interval,
+    // which adds to the input latency of polled controllers.
+    m_pollTimer.setTimerType(Qt::PreciseTimer);
+    m_statsTimer.setInterval(kStatsInterval.toIntegerMillis());
+    m_statsTimer.setTimerType(Qt::PreciseTimer);
+
+    // The thread object itself lives in the creating thread. Direct
+    // connections ensure that the timeouts are handled on this thread.
+    connect(&m_pollTimer,
+            &QTimer::timeout,
+            this,
+            &ControllerThread::pollController,
+            Qt::DirectConnection);
+    connect(&m_statsTimer,
+            &QTimer::timeout,
+            this,
+            &ControllerThread::updateStats,
+            Qt::DirectConnection);
+    m_pollTimer.moveToThread(this);
+    m_statsTimer.moveToThread(this);
+
+    // Moves all children of the controller as well
+    m_pController->moveToThread(this);
+}
+
+ControllerThread::~ControllerThread() {
+    DEBUG_ASSERT(!isRunning());
+}
+
+void ControllerThread::run() {
+    m_cpuTimer.start();
+    m_lastStatsUpdated = mixxx::Time::elapsed();
+    m_statsTimer.start();
+    exec();
+    m_pollTimer.stop();
+    m_statsTimer.stop();
+}
+
+void ControllerThread::shutdown(QThread* pTargetThread) {
+    invoke([this, pTargetThread] {
+        if (m_pController->isOpen()) {
+            m_pController->close();
+        }
+        m_pollTimer.stop();
+        m_pController->moveToThread(pTargetThread);
+    });
+    quit();
+    wait();
+}
+
+void ControllerThread::updatePolling() {
+    invoke([this] {
+        if (!m_pController->isOpen() || !m_pController->isPolling()) {
+            if (m_pollTimer.isActive()) {
+                m_pollTimer.stop();
+                qDebug() << "Controller polling stopped:" << m_pController->getName();
+            }
+            return;
+        }
+        if (!m_pollTimer.isActive()) {
+            m_skipPoll = false;
+            m_lastPollStarted = mixxx::Duration::empty();
+            m_pollTimer.start();
+            qDebug() << "Controller polling started:" << m_pController->getName();
+        }
+    });
+}
+
+void ControllerThread::pollController() {
+    // Note: this function is called from a high priority thread which
+    // may stall the GUI or may reduce the available CPU time for other
+    // High Priority threads like caching reader or broadcasting more
+    // then desired, if it is called endless loop like.
+    //
+    // This especially happens if a controller like the 3x Speed
+    // Stanton SCS.1D emits more massages than Mixxx is able to handle
+    // or a controller like Hercules RMX2 goes wild. In such a case the
+    // receive buffer is stacked up every call to insane values > 500 messages.
+    //
+    // To avoid this we pick here a strategies similar like the audio
+    // thread. In case poll() takes longer than a call cycle
+    // we are cooperative a skip the next cycle to free at least some
+    // CPU time
+    //
+    // Some random test data form a i5-3317U CPU @ 1.70GHz Running
+    // Ubuntu Trusty:
+    // * Idle poll: ~5 µs.
+    // * 5 messages burst (full midi bandwidth): ~872 µs.
+
+    if (m_skipPoll) {
+        // skip poll in overload situation
+        m_skipPoll = false;
+        // Skipped cycles must not be accounted as jitter
+        m_lastPollStarted = mixxx::Duration::empty();
+        return;
+    }
+
+    const mixxx::Duration start = mixxx::Time::elapsed();
+    if (m_lastPollStarted != mixxx::Duration::empty()) {
+        // Deviation of the actual from the nominal poll interval,
+        // i.e. the additional input latency caused by the timer.
+        const mixxx::Duration interval = start - m_lastPollStarted;
+        const mixxx::Duration& pollInterval = ControllerManager::kPollInterval;
+        const mixxx::Duration jitter = interval > pollInterval
+                ? interval - pollInterval
+                : pollInterval - interval;
+        Stat::track(m_statPollJitterTag,
+                Stat::DURATION_NANOSEC,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                        Stat::MIN | Stat::MAX | Stat::SAMPLE_VARIANCE),
+                jitter.toIntegerNanos());
+        if (interval > pollInterval) {
+            m_maxEventLoopDelay = std::max(m_maxEventLoopDelay, jitter);
+        }
+    }
+    m_lastPollStarted = start;
+
+    m_pController->poll();
+
+    const mixxx::Duration duration = mixxx::Time::elapsed() - start;
+    if (duration > ControllerManager::kPollInterval) {
+        m_skipPoll = true;
+    }
+}
+
+void ControllerThread::updateStats() {
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    const mixxx::Duration elapsed = now - m_lastStatsUpdated;
+    m_lastStatsUpdated = now;
+    if (elapsed > kStatsInterval) {
+        m_maxEventLoopDelay = std::max(m_maxEventLoopDelay, elapsed - kStatsInterval);
+    }
+
+    Stats stats;
+    const mixxx::Duration cpuTime = m_cpuTimer.restart();
+    if (elapsed > mixxx::Duration::empty()) {
+        stats.cpuLoad = cpuTime.toDoubleSeconds() / elapsed.toDoubleSeconds();
+    }
+    ControllerScriptEngineLegacy* pEngine = m_pController->getScriptEngine();
+    if (pEngine) {
+        const auto callbackStats = pEngine->takeCallbackStats();
+        stats.callbackCount = callbackStats.count;
+        if (callbackStats.timedCount > 0) {
+            stats.callbackDurationsMeasured = true;
+            stats.averageCallbackDuration = mixxx::Duration::fromNanos(
+                    callbackStats.totalDuration.toIntegerNanos() /
+                    callbackStats.timedCount);
+        }
+        stats.maxCallbackDuration = callbackStats.maxDuration;
+    }
+    stats.maxEventLoopDelay = m_maxEventLoopDelay;
+    m_maxEventLoopDelay = mixxx::Duration::empty();
+
+    const auto locker = lockMutex(&m_statsMutex);
+    m_stats = stats;
+}
+
+ControllerThread::Stats ControllerThread::stats() const {
+    const auto locker = lockMutex(&m_statsMutex);
+    return m_stats;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <type_traits>
+#include <utility>
+
+#include "util/duration.h"
+#include "util/threadcputimer.h"
+
+class Controller;
+
+/// Runs a single controller together with its script engine and all
+/// script timers on a dedicated thread with its own event loop.
+///
+/// A mapping that keeps its thread busy, e.g. with animations on a
+/// controller screen, only delays the input handling of its own
+/// controller. The controller and all objects created by it are moved
+/// to this thread. Afterwards it must only be accessed through invoke()
+/// or queued signals.
+class ControllerThread : public QThread {
+    Q_OBJECT
+  public:
+    /// Load statistics of the controller thread, updated once per second
+    struct Stats {
+        /// CPU time spent on the thread relative to the elapsed time
+        double cpuLoad = 0.0;
+        /// Number of script callbacks executed per second
+        int callbackCount = 0;
+        /// The execution time of callbacks is only measured while the
+        /// ControllerScriptProfiler is enabled
+        bool callbackDurationsMeasured = false;
+        mixxx::Duration averageCallbackDuration;
+        mixxx::Duration maxCallbackDuration;
+        /// Maximum delay of timer events, i.e. how long events had to
+        /// wait in the event loop before they were handled.
+        mixxx::Duration maxEventLoopDelay;
+    };
+
+    /// Moves the controller to the new thread. Must be called from the
+    /// thread the controller currently lives in.
+    explicit ControllerThread(Controller* pController);
+    ~ControllerThread() override;
+
+    Controller* controller() const {
+        return m_pController;
+    }
+
+    /// Executes the function on the controller thread and waits for its
+    /// result.
+    template<typename Function>
+    auto invoke(Function&& function) -> decltype(function()) {
+        if (QThread::currentThread() == this) {
+            return function();
+        }
+        using Result = decltype(function());
+        if constexpr (std::is_void_v<Result>) {
+            QMetaObject::invokeMethod(m_pController,
+                    std::forward<Function>(function),
+                    Qt::BlockingQueuedConnection);
+        } else {
+            Result result{};
+            QMetaObject::invokeMethod(m_pController,
+                    std::forward<Function>(function),
+                    Qt::BlockingQueuedConnection,
+                    &result);
+            return result;
+        }
+    }
+
+    /// Starts or stops polling the controller depending on whether
+    /// it is open and a polling device. Must be called after opening
+    /// or closing the controller.
+    void updatePolling();
+
+    /// Closes the controller, moves it back to the given thread and stops
+    /// the event loop. The controller must not be used on this thread
+    /// afterwards.
+    void shutdown(QThread* pTargetThread);
+
+    Stats stats() const;
+
+  protected:
+    void run() override;
+
+  private:
+    void pollController();
+    void updateStats();
+
+    Controller* const m_pController;
+    const QString m_statPollJitterTag;
+
+    // Both timers live on this thread
+    QTimer m_pollTimer;
+    QTimer m_statsTimer;
+
+    bool m_skipPoll;
+    mixxx::Duration m_lastPollStarted;
+    mixxx::Duration m_lastStatsUpdated;
+    mixxx::Duration m_maxEventLoopDelay;
+    ThreadCpuTimer m_cpuTimer;
+
+    mutable QMutex m_statsMutex;
+    Stats m_stats;
+};
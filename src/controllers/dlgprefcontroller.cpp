@@ -45,6 +45,7 @@ DlgPrefController::DlgPrefController(
           m_pInputProxyModel(nullptr),
           m_pOutputTableModel(nullptr),
           m_pOutputProxyModel(nullptr),
+          m_engineStatsTimer(this),
           m_GuiInitialized(false),
           m_bDirty(false) {
     m_ui.setupUi(this);
@@ -160,6 +161,15 @@ DlgPrefController::DlgPrefController(
             &QPushButton::clicked,
             this,
             &DlgPrefController::slotOutputControlSearch);
+
+    // The controller thread updates its statistics once per second
+    m_engineStatsTimer.setInterval(1000);
+    connect(&m_engineStatsTimer,
+            &QTimer::timeout,
+            this,
+            &DlgPrefController::slotUpdateEngineStats);
+    m_engineStatsTimer.start();
+    m_ui.labelEngineStats->setText(tr("Not running"));
 }
 
 DlgPrefController::~DlgPrefController() {
@@ -576,6 +586,45 @@ void DlgPrefController::keyPressEvent(QKeyEvent* pEvent) {
     QWidget::keyPressEvent(pEvent);
 }
 
+void DlgPrefController::slotUpdateEngineStats() {
+    if (!isVisible()) {
+        return;
+    }
+    const auto stats = m_pControllerManager->getControllerThreadStats(m_pController);
+    if (!stats || !m_pController->isOpen()) {
+        m_ui.labelEngineStats->setText(tr("Not running"));
+        return;
+    }
+    if (!stats->callbackDurationsMeasured) {
+        m_ui.labelEngineStats->setText(
+                tr("CPU load %1 %, %2 callbacks/s, event delay up to %3 ms")
+                        .arg(QString::number(stats->cpuLoad * 100, 'f', 1),
+                                QString::number(stats->callbackCount),
+                                QString::number(
+                                        stats->maxEventLoopDelay.toDoubleMillis(),
+                                        'f',
+                                        2)));
+        return;
+    }
+    m_ui.labelEngineStats->setText(
+            tr("CPU load %1 %, %2 callbacks/s (average %3 ms, maximum %4 ms), "
+               "event delay up to %5 ms")
+                    .arg(QString::number(stats->cpuLoad * 100, 'f', 1),
+                            QString::number(stats->callbackCount),
+                            QString::number(stats->averageCallbackDuration
+                                                    .toDoubleMillis(),
+                                    'f',
+                                    2),
+                            QString::number(
+                                    stats->maxCallbackDuration.toDoubleMillis(),
+                                    'f',
+                                    2),
+                            QString::number(
+                                    stats->maxEventLoopDelay.toDoubleMillis(),
+                                    'f',
+                                    2)));
+}
+
 void DlgPrefController::enableWizardAndIOTabs(bool enable) {
     // We always enable the Wizard button if this is a MIDI controller so we can
     // create a new mapping from scratch with 'No Mapping'
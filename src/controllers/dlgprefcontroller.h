@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QHash>
+#include <QTimer>
 #include <memory>
 
 #include "controllers/controllerinputmappingtablemodel.h"
@@ -56,6 +57,8 @@ class DlgPrefController : public DlgPreferencePage {
     /// Called when the Controller Learning Wizard is closed.
     void slotStopLearning();
     void enableWizardAndIOTabs(bool enable);
+    /// Shows the load of the controller thread
+    void slotUpdateEngineStats();
 
     // Input mappings
     void addInputMapping();
@@ -125,6 +128,7 @@ class DlgPrefController : public DlgPreferencePage {
     ControllerMappingTableProxyModel* m_pInputProxyModel;
     ControllerOutputMappingTableModel* m_pOutputTableModel;
     ControllerMappingTableProxyModel* m_pOutputProxyModel;
+    QTimer m_engineStatsTimer;
     bool m_GuiInitialized;
     bool m_bDirty;
 };
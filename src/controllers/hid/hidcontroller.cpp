@@ -32,6 +32,50 @@ QString HidController::mappingExtension() {
 
 void HidController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyHidControllerMapping>(std::move(pMapping));
+    if (m_pMapping) {
+        m_inputReportDecoder.compile(m_pMapping->getInputFields());
+    } else {
+        m_inputReportDecoder.clear();
+    }
+}
+
+bool HidController::applyMapping() {
+    const bool result = Controller::applyMapping();
+    // All fields are reported to the new scripts
+    m_inputReportDecoder.reset();
+    m_inputReportDecoder.resolveScriptFunctions(getScriptEngine());
+    return result;
+}
+
+void HidController::receive(const QByteArray& data, mixxx::Duration timestamp) {
+    if (m_inputReportDecoder.isEmpty() || !getScriptEngine()) {
+        Controller::receive(data, timestamp);
+        return;
+    }
+
+    // Reports with an ID for which the mapping declares input fields are
+    // handled completely by the decoder, i.e. they are not passed to the
+    // incomingData function, not even the undeclared bytes. This is
+    // documented in hid-controller-api.d.ts.
+    m_inputFieldChanges.clear();
+    if (!m_inputReportDecoder.decode(data, &m_inputFieldChanges)) {
+        Controller::receive(data, timestamp);
+        return;
+    }
+    recordInput(data, timestamp);
+    if (m_inputFieldChanges.empty()) {
+        return;
+    }
+    triggerActivity();
+    for (const auto& change : m_inputFieldChanges) {
+        const HidInputField& field = change.pEntry->field();
+        qCDebug(m_logInput) << "incoming field:" << field.control.group
+                            << field.control.item << change.value;
+        if (!HidInputReportDecoder::apply(getScriptEngine(), change)) {
+            qCWarning(m_logBase) << "HidController: Invalid script function"
+                                 << field.control.item;
+        }
+    }
 }
 
 std::shared_ptr<LegacyControllerMapping> HidController::cloneMapping() {
@@ -206,6 +250,20 @@ void HidController::sendBytes(const QByteArray& data) {
     m_pHidIoThread->updateCachedOutputReportData(0, data, false);
 }
 
+bool HidController::sendScreenPackets(const QList<QByteArray>& packets) {
+    VERIFY_OR_DEBUG_ASSERT(m_pHidIoThread) {
+        return false;
+    }
+    return m_pHidIoThread->queueScreenPackets(packets);
+}
+
+qsizetype HidController::maxScreenUpdateBytes() const {
+    VERIFY_OR_DEBUG_ASSERT(m_pHidIoThread) {
+        return 0;
+    }
+    return m_pHidIoThread->maxScreenUpdateBytes();
+}
+
 ControllerJSProxy* HidController::jsProxy() {
     return new HidControllerJSProxy(this);
 }
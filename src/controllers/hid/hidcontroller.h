@@ -1,9 +1,11 @@
 #pragma once
 
 #include <QThread>
+#include <vector>
 
 #include "controllers/controller.h"
 #include "controllers/hid/hiddevice.h"
+#include "controllers/hid/hidinputreportdecoder.h"
 #include "controllers/hid/hidiothread.h"
 #include "controllers/hid/legacyhidcontrollermapping.h"
 #include "util/duration.h"
@@ -32,19 +34,31 @@ class HidController final : public Controller {
 
     bool matchMapping(const MappingInfo& mapping) override;
 
+  protected slots:
+    /// Decodes the input report fields declared by the mapping. Reports
+    /// without declared fields are passed to the incomingData script
+    /// function.
+    void receive(const QByteArray& data, mixxx::Duration timestamp) override;
+
   private slots:
     int open() override;
     int close() override;
+    bool applyMapping() override;
 
   private:
     // For devices which only support a single report, reportID must be set to
     // 0x0.
     void sendBytes(const QByteArray& data) override;
+    bool sendScreenPackets(const QList<QByteArray>& packets) override;
+    qsizetype maxScreenUpdateBytes() const override;
 
     const mixxx::hid::DeviceInfo m_deviceInfo;
 
     std::unique_ptr<HidIoThread> m_pHidIoThread;
     std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
+    HidInputReportDecoder m_inputReportDecoder;
+    // Reused for each report to avoid allocations
+    std::vector<HidInputReportDecoder::Change> m_inputFieldChanges;
 
     friend class HidControllerJSProxy;
 };
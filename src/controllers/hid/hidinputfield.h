@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QFlags>
+#include <QList>
+#include <QString>
+#include <cstdint>
+
+#include "preferences/usersettings.h"
+
+/// The integer representation of a field in a HID input report. Multi
+/// byte values are little-endian like in the USB HID specification.
+enum class HidInputFieldType {
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+};
+
+enum class HidInputFieldOption : uint16_t {
+    None = 0x0000,
+    /// Maps the field to a custom JavaScript function
+    Script = 0x0001,
+    /// The field is a wrapping counter, e.g. of a jog wheel. The
+    /// difference to the previous report is passed instead of the value.
+    Encoder = 0x0002,
+    /// Scales the value from the range of the field to 0.0 .. 1.0
+    Normalize = 0x0004,
+};
+Q_DECLARE_FLAGS(HidInputFieldOptions, HidInputFieldOption);
+Q_DECLARE_OPERATORS_FOR_FLAGS(HidInputFieldOptions);
+
+/// A field of a HID input report that is mapped to a control or a
+/// script function, declared in the <controls> section of a HID mapping.
+struct HidInputField {
+    bool operator==(const HidInputField& other) const {
+        return reportId == other.reportId && offset == other.offset &&
+                type == other.type && bitmask == other.bitmask &&
+                options == other.options && control == other.control &&
+                description == other.description;
+    }
+
+    /// The size of the field in bytes
+    int size() const {
+        switch (type) {
+        case HidInputFieldType::Int8:
+        case HidInputFieldType::UInt8:
+            return 1;
+        case HidInputFieldType::Int16:
+        case HidInputFieldType::UInt16:
+            return 2;
+        case HidInputFieldType::Int32:
+        case HidInputFieldType::UInt32:
+            return 4;
+        }
+        return 1;
+    }
+
+    bool isSigned() const {
+        return type == HidInputFieldType::Int8 ||
+                type == HidInputFieldType::Int16 ||
+                type == HidInputFieldType::Int32;
+    }
+
+    /// 1...255 for devices that use report IDs, 0 for devices without
+    /// report IDs
+    uint8_t reportId = 0;
+    /// Position of the first byte of the field in the report. If the device
+    /// uses report IDs the report ID is the byte at position 0.
+    int offset = 0;
+    HidInputFieldType type = HidInputFieldType::UInt8;
+    /// The bits of the field that are decoded, e.g. a single button of a
+    /// byte with several buttons. 0 decodes all bits.
+    uint32_t bitmask = 0;
+    HidInputFieldOptions options;
+    /// The control or, with HidInputFieldOption::Script, the group and the
+    /// name of the script function.
+    ConfigKey control;
+    QString description;
+};
+typedef QList<HidInputField> HidInputFields;
@@ -0,0 +1,229 @@
+#include "controllers/hid/hidinputreportdecoder.h"
+
+#include <QtDebug>
+#include <algorithm>
+#include <bit>
+
+#include "control/controlobject.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+
+namespace {
+
+// The number of arguments that are passed to script functions, see
+// HidController::processInputField()
+constexpr int kScriptFunctionArgCount = 2;
+
+uint32_t fieldMask(int size) {
+    return size >= 4 ? 0xFFFFFFFFu : (1u << (size * 8)) - 1;
+}
+
+} // anonymous namespace
+
+HidInputReportDecoder::Entry::Entry(const HidInputField& field)
+        : m_field(field),
+          m_mask(0),
+          m_shift(0),
+          m_bitCount(0),
+          m_lastValue(0),
+          m_hasLastValue(false) {
+    const uint32_t mask = field.bitmask == 0
+            ? fieldMask(field.size())
+            : field.bitmask & fieldMask(field.size());
+    if (mask == 0 || field.offset < 0) {
+        return;
+    }
+    m_shift = std::countr_zero(mask);
+    m_mask = mask >> m_shift;
+    m_bitCount = static_cast<int>(std::bit_width(m_mask));
+}
+
+QJSValue* HidInputReportDecoder::Entry::scriptFunction(
+        ControllerScriptEngineLegacy* pEngine) {
+    return m_binding.scriptFunction(
+            pEngine, m_field.control.item, kScriptFunctionArgCount);
+}
+
+int64_t HidInputReportDecoder::Entry::decode(const QByteArray& report) const {
+    const int size = m_field.size();
+    DEBUG_ASSERT(m_field.offset + size <= report.size());
+    // Little-endian
+    uint32_t raw = 0;
+    for (int i = size - 1; i >= 0; --i) {
+        raw = (raw << 8) | static_cast<uint8_t>(report.at(m_field.offset + i));
+    }
+    const uint32_t bits = (raw >> m_shift) & m_mask;
+    if (m_field.isSigned() && (bits & (1u << (m_bitCount - 1)))) {
+        // Sign extension
+        return static_cast<int64_t>(bits) - (int64_t{1} << m_bitCount);
+    }
+    return bits;
+}
+
+bool HidInputReportDecoder::Entry::update(int64_t value, double* pResult) {
+    const bool hadLastValue = m_hasLastValue;
+    const int64_t lastValue = m_lastValue;
+    m_lastValue = value;
+    m_hasLastValue = true;
+
+    if (m_field.options.testFlag(HidInputFieldOption::Encoder)) {
+        // The first report only provides the reference for the difference
+        if (!hadLastValue) {
+            return false;
+        }
+        const int64_t range = int64_t{1} << m_bitCount;
+        int64_t delta = value - lastValue;
+        // Counters wrap around at the end of their range
+        if (delta > range / 2) {
+            delta -= range;
+        } else if (delta < -range / 2) {
+            delta += range;
+        }
+        if (delta == 0) {
+            return false;
+        }
+        *pResult = static_cast<double>(delta);
+        return true;
+    }
+
+    if (hadLastValue && value == lastValue) {
+        return false;
+    }
+    if (m_field.options.testFlag(HidInputFieldOption::Normalize)) {
+        const int64_t minValue = m_field.isSigned() ? -(int64_t{1} << (m_bitCount - 1)) : 0;
+        const int64_t maxValue = minValue + (int64_t{1} << m_bitCount) - 1;
+        *pResult = static_cast<double>(value - minValue) /
+                static_cast<double>(maxValue - minValue);
+    } else {
+        *pResult = static_cast<double>(value);
+    }
+    return true;
+}
+
+void HidInputReportDecoder::compile(const HidInputFields& fields) {
+    m_reports.clear();
+    // Devices either use report IDs for all reports or for none
+    const bool hasReportIds = std::any_of(fields.begin(),
+            fields.end(),
+            [](const HidInputField& field) {
+                return field.reportId != 0;
+            });
+    for (const auto& field : fields) {
+        if (hasReportIds && field.reportId == 0) {
+            qWarning() << "Ignoring HID input field without report ID"
+                       << "for" << field.control.group << field.control.item
+                       << ", other fields have report IDs";
+            continue;
+        }
+        Entry entry(field);
+        if (!entry.isValid()) {
+            qWarning() << "Ignoring HID input field with invalid offset"
+                       << field.offset << "or bitmask" << field.bitmask
+                       << "for" << field.control.group << field.control.item;
+            continue;
+        }
+        auto it = std::find_if(m_reports.begin(),
+                m_reports.end(),
+                [&field](const Report& report) {
+                    return report.reportId == field.reportId;
+                });
+        if (it == m_reports.end()) {
+            it = m_reports.insert(m_reports.end(), Report{field.reportId, {}});
+        }
+        if (!field.options.testFlag(HidInputFieldOption::Script)) {
+            entry.m_binding.resolveControl(field.control);
+        }
+        it->entries.push_back(std::move(entry));
+    }
+}
+
+void HidInputReportDecoder::clear() {
+    m_reports.clear();
+}
+
+void HidInputReportDecoder::resolveScriptFunctions(
+        ControllerScriptEngineLegacy* pEngine) {
+    if (!pEngine) {
+        return;
+    }
+    for (auto& report : m_reports) {
+        for (auto& entry : report.entries) {
+            if (entry.m_field.options.testFlag(HidInputFieldOption::Script)) {
+                entry.scriptFunction(pEngine);
+            }
+        }
+    }
+}
+
+void HidInputReportDecoder::reset() {
+    for (auto& report : m_reports) {
+        for (auto& entry : report.entries) {
+            entry.m_hasLastValue = false;
+        }
+    }
+}
+
+HidInputReportDecoder::Report* HidInputReportDecoder::findReport(
+        const QByteArray& report) {
+    if (report.isEmpty()) {
+        return nullptr;
+    }
+    // Devices without report IDs only send a single kind of report.
+    // Report ID 0 is never mixed with numbered reports, see compile().
+    if (m_reports.size() == 1 && m_reports.front().reportId == 0) {
+        return &m_reports.front();
+    }
+    const auto reportId = static_cast<uint8_t>(report.at(0));
+    for (auto& candidate : m_reports) {
+        if (candidate.reportId == reportId) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+bool HidInputReportDecoder::decode(
+        const QByteArray& report, std::vector<Change>* pChanges) {
+    Report* pReport = findReport(report);
+    if (!pReport) {
+        return false;
+    }
+    for (auto& entry : pReport->entries) {
+        if (entry.m_field.offset + entry.m_field.size() > report.size()) {
+            // Shorter than declared
+            continue;
+        }
+        double value;
+        if (entry.update(entry.decode(report), &value)) {
+            pChanges->push_back(Change{&entry, value});
+        }
+    }
+    return true;
+}
+
+// static
+bool HidInputReportDecoder::apply(
+        ControllerScriptEngineLegacy* pEngine, const Change& change) {
+    const HidInputField& field = change.pEntry->field();
+    if (field.options.testFlag(HidInputFieldOption::Script)) {
+        const auto args = QJSValueList{
+                change.value,
+                field.control.group,
+        };
+        return pEngine->executeFunction(
+                change.pEntry->scriptFunction(pEngine), args, field.control.item);
+    }
+
+    // Only pass values on to valid ControlObjects.
+    ControlObject* pControl = change.pEntry->control();
+    if (!pControl) {
+        return true;
+    }
+    if (field.options.testFlag(HidInputFieldOption::Encoder)) {
+        pControl->set(pControl->get() + change.value);
+    } else if (field.options.testFlag(HidInputFieldOption::Normalize)) {
+        pControl->setParameter(change.value);
+    } else {
+        pControl->set(change.value);
+    }
+    return true;
+}
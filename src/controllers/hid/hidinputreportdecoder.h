@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJSValue>
+#include <cstdint>
+#include <vector>
+
+#include "controllers/controllerinputbinding.h"
+#include "controllers/hid/hidinputfield.h"
+
+/// Decodes the fields of HID input reports that are declared by a mapping
+///
+/// Each report is compared field by field with the previous report with
+/// the same report ID. Only the fields that have changed are returned,
+/// i.e. unchanged buttons and knobs don't cause any script execution.
+/// Like for MIDI, the bindings are resolved once and then cached, see
+/// MidiInputDispatchTable.
+class HidInputReportDecoder final {
+  public:
+    class Entry final {
+      public:
+        explicit Entry(const HidInputField& field);
+
+        const HidInputField& field() const {
+            return m_field;
+        }
+
+        /// The bound control. Returns nullptr if the control doesn't
+        /// exist (yet).
+        ControlObject* control() {
+            return m_binding.control(m_field.control);
+        }
+
+        /// The wrapped script function of a HidInputFieldOption::Script
+        /// field.
+        QJSValue* scriptFunction(ControllerScriptEngineLegacy* pEngine);
+
+      private:
+        friend class HidInputReportDecoder;
+
+        bool isValid() const {
+            return m_mask != 0;
+        }
+        /// Extracts the integer value of the field from the report
+        int64_t decode(const QByteArray& report) const;
+        /// The value that is passed to the control or script for a new
+        /// integer value. Returns false if the field is unchanged.
+        bool update(int64_t value, double* pResult);
+
+        HidInputField m_field;
+        // The decoded bits of the field, shifted to the least significant
+        // bit by m_shift
+        uint32_t m_mask;
+        int m_shift;
+        int m_bitCount;
+        int64_t m_lastValue;
+        bool m_hasLastValue;
+        ControllerInputBinding m_binding;
+    };
+
+    struct Change {
+        Entry* pEntry;
+        double value;
+    };
+
+    void compile(const HidInputFields& fields);
+    void clear();
+
+    /// Pre-resolves all script functions, e.g. after the scripts
+    /// have been loaded to avoid the delay when receiving the first
+    /// report.
+    void resolveScriptFunctions(ControllerScriptEngineLegacy* pEngine);
+
+    /// Forgets the previous reports, i.e. the next report of each ID
+    /// reports all fields as changed.
+    void reset();
+
+    /// Appends the fields that have changed since the previous report
+    /// with the same report ID. Returns false if the mapping declares
+    /// no fields for the report.
+    bool decode(const QByteArray& report, std::vector<Change>* pChanges);
+
+    /// Executes the script function or sets the control of a changed
+    /// field. Returns false if the script function is invalid.
+    static bool apply(ControllerScriptEngineLegacy* pEngine, const Change& change);
+
+    bool isEmpty() const {
+        return m_reports.empty();
+    }
+
+  private:
+    struct Report {
+        uint8_t reportId;
+        std::vector<Entry> entries;
+    };
+
+    Report* findReport(const QByteArray& report);
+
+    // Only a few different reports per device, a linear search is
+    // faster than hashing.
+    std::vector<Report> m_reports;
+};
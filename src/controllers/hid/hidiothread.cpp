@@ -2,11 +2,20 @@
 
 #include <hidapi.h>
 
+#ifdef __LINUX__
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
 #include <QTimer>
 
 #include "controllers/defs_controllers.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "moc_hidiothread.cpp"
+#include "util/stat.h"
 #include "util/string.h"
 #include "util/time.h"
 #include "util/trace.h"
@@ -24,6 +33,25 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 // the fastest possible rate of HID devices with USB HighSpeed or USB SuperSpeed interface is 8kHz
 constexpr int kSleepTimeWhenIdleMicros = 250;
 
+// Upper bound for blocking the run loop while waiting for InputReports.
+// The run loop is woken up immediately when an OutputReport is cached or
+// the state changes. This timeout is only a safety net and does not
+// affect the input latency.
+constexpr mixxx::Duration kMaxWaitTimeWhenIdle = mixxx::Duration::fromMillis(5);
+
+#ifdef __LINUX__
+/// Opens a separate file descriptor for reading, if the hidapi
+/// hidraw backend is used. Returns -1 otherwise.
+int openInputFd(const mixxx::hid::DeviceInfo& deviceInfo) {
+    const char* pPath = deviceInfo.pathRaw();
+    if (!pPath || std::strncmp(pPath, "/dev/hidraw", 11) != 0) {
+        // libusb backend
+        return -1;
+    }
+    return ::open(pPath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+}
+#endif
+
 QString loggingCategoryPrefix(const QString& deviceName) {
     return QStringLiteral("controller.") +
             RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
@@ -43,6 +71,11 @@ HidIoThread::HidIoThread(
           m_pHidDevice(pHidDevice),
           m_lastPollSize(0),
           m_pollingBufferIndex(0),
+          m_inputFd(-1),
+          m_statInputReportJitterTag(QStringLiteral("HID input jitter ") +
+                  deviceInfo.formatName()),
+          m_lastInputReportTimestamp(mixxx::Duration::empty()),
+          m_lastInputReportInterval(mixxx::Duration::empty()),
           m_globalOutputReportFifo(),
           m_runLoopSemaphore(1) {
     // Initializing isn't strictly necessary but is good practice.
@@ -50,10 +83,26 @@ HidIoThread::HidIoThread(
         memset(m_pPollData[i], 0, kBufferSize);
     }
     m_outputReportIterator = m_outputReports.begin();
+#ifdef __LINUX__
+    if (m_inputWaiter.isValid()) {
+        m_inputFd = openInputFd(m_deviceInfo);
+        if (m_inputFd >= 0 && !m_inputWaiter.addInput(m_inputFd)) {
+            ::close(m_inputFd);
+            m_inputFd = -1;
+        }
+    }
+#endif
+    qCDebug(m_logBase) << "Reading InputReports"
+                       << (m_inputFd >= 0 ? "event-driven" : "by polling");
     m_state.storeRelease(static_cast<int>(HidIoThreadState::Initialized));
 }
 
 HidIoThread::~HidIoThread() {
+#ifdef __LINUX__
+    if (m_inputFd >= 0) {
+        ::close(m_inputFd);
+    }
+#endif
     hid_close(m_pHidDevice);
 }
 
@@ -76,11 +125,47 @@ void HidIoThread::run() {
                 break;
             }
             // Sleep run loop, if no OutputReport was send
-            // Tests on Windows and Linux showed that the thread schedulers
-            // handle usleep wait times reliable under CPU load
-            usleep(kSleepTimeWhenIdleMicros);
+            waitForInputReports();
+        }
+    }
+}
+
+void HidIoThread::waitForInputReports() {
+    // While input is inactive pending InputReports are not consumed and
+    // would wake up the waiter immediately again.
+    if (m_inputFd >= 0 &&
+            m_state.loadAcquire() == static_cast<int>(HidIoThreadState::InputOutputActive)) {
+        switch (m_inputWaiter.wait(kMaxWaitTimeWhenIdle)) {
+        case ControllerInputWaiter::Result::InputAvailable:
+        case ControllerInputWaiter::Result::WokenUp:
+        case ControllerInputWaiter::Result::TimedOut:
+            return;
+        case ControllerInputWaiter::Result::InputClosed:
+            // The hang-up is signaled on every wait, which would end up
+            // in a busy loop
+            closeInputFd();
+            break;
+        case ControllerInputWaiter::Result::Failed:
+            break;
         }
     }
+    // Tests on Windows and Linux showed that the thread schedulers
+    // handle usleep wait times reliable under CPU load
+    usleep(kSleepTimeWhenIdleMicros);
+}
+
+void HidIoThread::closeInputFd() {
+#ifdef __LINUX__
+    if (m_inputFd < 0) {
+        return;
+    }
+    qCWarning(m_logBase) << "Stopped reading InputReports event-driven from"
+                         << m_deviceInfo.formatName()
+                         << ", the device has been disconnected or failed";
+    m_inputWaiter.removeInput(m_inputFd);
+    ::close(m_inputFd);
+    m_inputFd = -1;
+#endif
 }
 
 void HidIoThread::pollBufferedInputReports() {
@@ -99,26 +184,52 @@ void HidIoThread::pollBufferedInputReports() {
     // If the interval between two polls is to long, multiple buffered HID InputReports
     // will be processed at the same time.
     while (m_state.loadAcquire() == static_cast<int>(HidIoThreadState::InputOutputActive)) {
-        int bytesRead = hid_read(m_pHidDevice, m_pPollData[m_pollingBufferIndex], kBufferSize);
+        int bytesRead = readInputReport(m_pPollData[m_pollingBufferIndex]);
+        if (bytesRead <= 0) {
+            // Either no InputReports left to be read or an error
+            break;
+        }
+        processInputReport(bytesRead);
+    }
+}
+
+int HidIoThread::readInputReport(unsigned char* pBuffer) {
+#ifdef __LINUX__
+    if (m_inputFd >= 0) {
+        // Same as hid_read() of the hidraw backend, but on our own
+        // file descriptor that is registered at m_inputWaiter
+        const auto bytesRead = ::read(m_inputFd, pBuffer, kBufferSize);
         if (bytesRead < 0) {
-            // -1 is the only error value according to hidapi documentation.
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return 0;
+            }
             qCWarning(m_logOutput) << "Unable to read buffered HID InputReports from"
                                    << m_deviceInfo.formatName() << ":"
-                                   << mixxx::convertWCStringToQString(
-                                              hid_error(m_pHidDevice),
-                                              kMaxHidErrorMessageSize);
-            DEBUG_ASSERT(bytesRead == -1);
-            break;
-        } else if (bytesRead == 0) {
-            // No InputReports left to be read
-            break;
+                                   << std::strerror(errno);
+            // Errors like ENODEV after unplugging are permanent
+            closeInputFd();
+            return -1;
         }
-        processInputReport(bytesRead);
+        return static_cast<int>(bytesRead);
+    }
+#endif
+    int bytesRead = hid_read(m_pHidDevice, pBuffer, kBufferSize);
+    if (bytesRead < 0) {
+        // -1 is the only error value according to hidapi documentation.
+        qCWarning(m_logOutput) << "Unable to read buffered HID InputReports from"
+                               << m_deviceInfo.formatName() << ":"
+                               << mixxx::convertWCStringToQString(
+                                          hid_error(m_pHidDevice),
+                                          kMaxHidErrorMessageSize);
+        DEBUG_ASSERT(bytesRead == -1);
     }
+    return bytesRead;
 }
 
 void HidIoThread::processInputReport(int bytesRead) {
     Trace process("HidIO processInputReport");
+    const mixxx::Duration timestamp = mixxx::Time::elapsed();
+    trackInputReportJitter(timestamp);
     unsigned char* pPreviousBuffer = m_pPollData[(m_pollingBufferIndex + 1) % kNumBuffers];
     unsigned char* pCurrentBuffer = m_pPollData[m_pollingBufferIndex];
     // Some controllers such as the Gemini GMX continuously send input reports even if it
@@ -141,7 +252,28 @@ void HidIoThread::processInputReport(int bytesRead) {
     // This eexecute callback function in JavaScript mapping and print to stdout in case of --controllerDebug
     emit receive(QByteArray(reinterpret_cast<const char*>(pCurrentBuffer),
                          bytesRead),
-            mixxx::Time::elapsed());
+            timestamp);
+}
+
+void HidIoThread::trackInputReportJitter(mixxx::Duration timestamp) {
+    // Devices send InputReports with a constant rate while they are
+    // used, i.e. the variation between consecutive intervals is the
+    // jitter that is added by reading the reports.
+    if (m_lastInputReportTimestamp != mixxx::Duration::empty()) {
+        const mixxx::Duration interval = timestamp - m_lastInputReportTimestamp;
+        if (m_lastInputReportInterval != mixxx::Duration::empty()) {
+            const mixxx::Duration jitter = interval > m_lastInputReportInterval
+                    ? interval - m_lastInputReportInterval
+                    : m_lastInputReportInterval - interval;
+            Stat::track(m_statInputReportJitterTag,
+                    Stat::DURATION_NANOSEC,
+                    Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                            Stat::MIN | Stat::MAX | Stat::SAMPLE_VARIANCE),
+                    jitter.toIntegerNanos());
+        }
+        m_lastInputReportInterval = interval;
+    }
+    m_lastInputReportTimestamp = timestamp;
 }
 
 QByteArray HidIoThread::getInputReport(quint8 reportID) {
@@ -214,6 +346,8 @@ void HidIoThread::updateCachedOutputReportData(quint8 reportID,
     if (useNonSkippingFIFO) {
         m_globalOutputReportFifo.addReportDatasetToFifo(reportID, data, m_deviceInfo, m_logOutput);
     }
+
+    m_inputWaiter.wakeUp();
 }
 
 bool HidIoThread::sendNextCachedOutputReport() {
@@ -255,8 +389,38 @@ bool HidIoThread::sendNextCachedOutputReport() {
             return true;
         }
     }
-    // Returns false if no report required a time consuming sendCachedData
-    return false;
+    // 3.) Screen updates have the lowest priority, to not delay the
+    // feedback of LEDs and displays
+    return sendNextScreenPacket();
+}
+
+bool HidIoThread::queueScreenPackets(const QList<QByteArray>& packets) {
+    if (!m_screenOutputQueue.push(packets)) {
+        qCDebug(m_logOutput) << "Screen update dropped, because the previous"
+                             << "updates are not yet sent to" << m_deviceInfo.formatName();
+        return false;
+    }
+    m_inputWaiter.wakeUp();
+    return true;
+}
+
+bool HidIoThread::sendNextScreenPacket() {
+    QByteArray packet;
+    if (!m_screenOutputQueue.pop(&packet)) {
+        return false;
+    }
+    auto hidDeviceLock = lockMutex(&m_hidDeviceAndPollMutex);
+    int result = hid_write(m_pHidDevice,
+            reinterpret_cast<const unsigned char*>(packet.constData()),
+            packet.size());
+    if (result == -1) {
+        qCWarning(m_logOutput) << "Unable to send screen data to"
+                               << m_deviceInfo.formatName() << ":"
+                               << mixxx::convertWCStringToQString(
+                                          hid_error(m_pHidDevice),
+                                          kMaxHidErrorMessageSize);
+    }
+    return true;
 }
 
 void HidIoThread::sendFeatureReport(
@@ -345,6 +509,7 @@ bool HidIoThread::testAndSetThreadState(HidIoThreadState expectedState,
         return false;
     }
 
+    m_inputWaiter.wakeUp();
     return true;
 }
 
@@ -356,4 +521,5 @@ bool HidIoThread::waitUntilRunLoopIsStopped(unsigned int timeoutMillis) {
 
 void HidIoThread::setThreadState(HidIoThreadState expectedState) {
     m_state.storeRelease(static_cast<int>(expectedState));
+    m_inputWaiter.wakeUp();
 }
@@ -6,6 +6,8 @@
 #include <map>
 
 #include "controllers/controller.h"
+#include "controllers/controllerinputwaiter.h"
+#include "controllers/controllerscreen.h"
 #include "controllers/hid/hiddevice.h"
 #include "controllers/hid/hidioglobaloutputreportfifo.h"
 #include "controllers/hid/hidiooutputreport.h"
@@ -46,6 +48,13 @@ class HidIoThread : public QThread {
     void updateCachedOutputReportData(quint8 reportID,
             const QByteArray& reportData,
             bool useNonSkippingFIFO);
+    /// Queues the packets of a screen update, which are sent as
+    /// OutputReports after all other OutputReports. The first byte of
+    /// each packet is the ReportID. Returns false if the queue is full.
+    bool queueScreenPackets(const QList<QByteArray>& packets);
+    qsizetype maxScreenUpdateBytes() const {
+        return m_screenOutputQueue.maxBytes();
+    }
     QByteArray getInputReport(quint8 reportID);
     void sendFeatureReport(quint8 reportID, const QByteArray& reportData);
     QByteArray getFeatureReport(quint8 reportID);
@@ -56,9 +65,22 @@ class HidIoThread : public QThread {
 
   private:
     bool sendNextCachedOutputReport();
+    bool sendNextScreenPacket();
 
     void pollBufferedInputReports();
+    int readInputReport(unsigned char* pBuffer);
     void processInputReport(int bytesRead);
+    void trackInputReportJitter(mixxx::Duration timestamp);
+
+    /// Blocks the run loop until the next InputReport arrives, an
+    /// OutputReport is cached, or the state is changed. Falls back
+    /// to a short sleep if the device could not be opened for
+    /// event-driven reading.
+    void waitForInputReports();
+
+    /// Stops reading from m_inputFd after the device has been
+    /// disconnected or failed. Falls back to hid_read() and sleeping.
+    void closeInputFd();
 
     const mixxx::hid::DeviceInfo m_deviceInfo;
     const RuntimeLoggingCategory m_logBase;
@@ -81,6 +103,16 @@ class HidIoThread : public QThread {
     int m_lastPollSize;
     int m_pollingBufferIndex;
 
+    /// Non-blocking file descriptor of the hidraw device that is used for
+    /// reading InputReports event-driven instead of hid_read() on Linux,
+    /// or -1 if not available.
+    int m_inputFd;
+    ControllerInputWaiter m_inputWaiter;
+
+    const QString m_statInputReportJitterTag;
+    mixxx::Duration m_lastInputReportTimestamp;
+    mixxx::Duration m_lastInputReportInterval;
+
     /// Must be locked when a operation changes the size of the m_outputReports map,
     /// or when modify the m_outputReportIterator
     QMutex m_outputReportMapMutex;
@@ -95,6 +127,9 @@ class HidIoThread : public QThread {
 
     HidIoGlobalOutputReportFifo m_globalOutputReportFifo;
 
+    /// Screen updates are too large for the FIFO of non-skipping reports
+    ControllerScreenOutputQueue m_screenOutputQueue;
+
     /// State of the HidIoThread lifecycle
     QAtomicInt m_state;
 
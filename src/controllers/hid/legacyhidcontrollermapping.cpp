@@ -16,3 +16,15 @@ bool LegacyHidControllerMapping::saveMapping(const QString& fileName) const {
 bool LegacyHidControllerMapping::isMappable() const {
     return false;
 }
+
+void LegacyHidControllerMapping::addInputField(const HidInputField& field) {
+    m_inputFields.append(field);
+    setDirty(true);
+}
+
+void LegacyHidControllerMapping::setInputFields(const HidInputFields& fields) {
+    if (m_inputFields != fields) {
+        m_inputFields = fields;
+        setDirty(true);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "controllers/hid/hidinputfield.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "controllers/legacycontrollermapping.h"
 
@@ -19,4 +20,14 @@ class LegacyHidControllerMapping : public LegacyControllerMapping {
     bool saveMapping(const QString& fileName) const override;
 
     bool isMappable() const override;
+
+    // Input report fields that are decoded natively
+    void addInputField(const HidInputField& field);
+    const HidInputFields& getInputFields() const {
+        return m_inputFields;
+    }
+    void setInputFields(const HidInputFields& fields);
+
+  private:
+    HidInputFields m_inputFields;
 };
@@ -1,10 +1,44 @@
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "controllers/hid/legacyhidcontrollermapping.h"
 
+namespace {
+
+struct FieldTypeName {
+    HidInputFieldType type;
+    const char* name;
+};
+
+constexpr FieldTypeName kFieldTypeNames[] = {
+        {HidInputFieldType::Int8, "int8"},
+        {HidInputFieldType::UInt8, "uint8"},
+        {HidInputFieldType::Int16, "int16"},
+        {HidInputFieldType::UInt16, "uint16"},
+        {HidInputFieldType::Int32, "int32"},
+        {HidInputFieldType::UInt32, "uint32"},
+};
+
+QDomElement makeTextElement(QDomDocument* doc,
+        const QString& elementName,
+        const QString& text) {
+    QDomElement tagNode = doc->createElement(elementName);
+    tagNode.appendChild(doc->createTextNode(text));
+    return tagNode;
+}
+
+QString formatHex(uint32_t value) {
+    return QStringLiteral("0x") + QString::number(value, 16).toUpper();
+}
+
+} // namespace
+
 bool LegacyHidControllerMappingFileHandler::save(const LegacyHidControllerMapping& mapping,
         const QString& fileName) const {
     QDomDocument doc = buildRootWithScripts(mapping);
+    addInputFieldsToDocument(mapping, &doc);
     return writeDocument(doc, fileName);
 }
 
@@ -25,5 +59,132 @@ LegacyHidControllerMappingFileHandler::load(const QDomElement& root,
     pMapping->setFilePath(filePath);
     parseMappingInfo(root, pMapping);
     addScriptFilesToMapping(controller, pMapping, systemMappingsPath);
+
+    // Optional input report fields that are decoded natively instead of
+    // passing the whole report to the incomingData script function
+    QDomElement control = controller.firstChildElement("controls").firstChildElement("control");
+    while (!control.isNull()) {
+        HidInputField field;
+        bool ok = false;
+
+        // Allow specifying hex, octal, or decimal. Omitted for devices
+        // without report IDs.
+        const QDomElement reportIdNode = control.firstChildElement("reportid");
+        if (!reportIdNode.isNull()) {
+            const int reportId = reportIdNode.text().toInt(&ok, 0);
+            if (!ok || reportId < 0 || reportId > 0xFF) {
+                // Would otherwise match the reports of any ID
+                qWarning() << "Ignoring HID input field with invalid report ID"
+                           << reportIdNode.text() << "for"
+                           << control.firstChildElement("group").text()
+                           << control.firstChildElement("key").text();
+                control = control.nextSiblingElement("control");
+                continue;
+            }
+            field.reportId = static_cast<uint8_t>(reportId);
+        }
+        field.offset = control.firstChildElement("offset").text().toInt(&ok, 0);
+        if (!ok) {
+            field.offset = -1;
+        }
+        const QDomElement bitmaskNode = control.firstChildElement("bitmask");
+        if (!bitmaskNode.isNull()) {
+            field.bitmask = bitmaskNode.text().toUInt(&ok, 0);
+            if (!ok) {
+                field.bitmask = 0;
+            }
+        }
+        const QString typeName = control.firstChildElement("type").text().trimmed().toLower();
+        if (!typeName.isEmpty()) {
+            auto it = std::find_if(std::begin(kFieldTypeNames),
+                    std::end(kFieldTypeNames),
+                    [&typeName](const FieldTypeName& fieldTypeName) {
+                        return typeName == QLatin1String(fieldTypeName.name);
+                    });
+            if (it == std::end(kFieldTypeNames)) {
+                // Would otherwise decode the wrong number of bytes
+                qWarning() << "Ignoring HID input field with unknown type"
+                           << typeName << "for"
+                           << control.firstChildElement("group").text()
+                           << control.firstChildElement("key").text();
+                control = control.nextSiblingElement("control");
+                continue;
+            }
+            field.type = it->type;
+        }
+
+        field.control = ConfigKey(control.firstChildElement("group").text(),
+                control.firstChildElement("key").text());
+        field.description = control.firstChildElement("description").text();
+
+        QDomElement optionsNode = control.firstChildElement("options").firstChildElement();
+        while (!optionsNode.isNull()) {
+            const QString option = optionsNode.nodeName().toLower();
+            if (option == QLatin1String("script-binding")) {
+                field.options.setFlag(HidInputFieldOption::Script);
+            } else if (option == QLatin1String("encoder")) {
+                field.options.setFlag(HidInputFieldOption::Encoder);
+            } else if (option == QLatin1String("normalize")) {
+                field.options.setFlag(HidInputFieldOption::Normalize);
+            }
+            optionsNode = optionsNode.nextSiblingElement();
+        }
+
+        pMapping->addInputField(field);
+        control = control.nextSiblingElement("control");
+    }
     return pMapping;
 }
+
+void LegacyHidControllerMappingFileHandler::addInputFieldsToDocument(
+        const LegacyHidControllerMapping& mapping, QDomDocument* doc) const {
+    if (mapping.getInputFields().isEmpty()) {
+        return;
+    }
+    QDomElement controller = doc->documentElement().firstChildElement("controller");
+    QDomElement controls = doc->createElement("controls");
+    for (const auto& field : mapping.getInputFields()) {
+        controls.appendChild(inputFieldToXML(doc, field));
+    }
+    controller.appendChild(controls);
+}
+
+QDomElement LegacyHidControllerMappingFileHandler::inputFieldToXML(
+        QDomDocument* doc, const HidInputField& field) const {
+    QDomElement controlNode = doc->createElement("control");
+
+    controlNode.appendChild(makeTextElement(doc, "group", field.control.group));
+    controlNode.appendChild(makeTextElement(doc, "key", field.control.item));
+    if (!field.description.isEmpty()) {
+        controlNode.appendChild(makeTextElement(doc, "description", field.description));
+    }
+    if (field.reportId != 0) {
+        controlNode.appendChild(makeTextElement(doc, "reportid", formatHex(field.reportId)));
+    }
+    controlNode.appendChild(makeTextElement(doc, "offset", QString::number(field.offset)));
+    for (const auto& fieldTypeName : kFieldTypeNames) {
+        if (fieldTypeName.type == field.type) {
+            controlNode.appendChild(makeTextElement(
+                    doc, "type", QString::fromLatin1(fieldTypeName.name)));
+            break;
+        }
+    }
+    if (field.bitmask != 0) {
+        controlNode.appendChild(makeTextElement(doc, "bitmask", formatHex(field.bitmask)));
+    }
+
+    QDomElement optionsNode = doc->createElement("options");
+    if (field.options.testFlag(HidInputFieldOption::Script)) {
+        optionsNode.appendChild(doc->createElement("script-binding"));
+    }
+    if (field.options.testFlag(HidInputFieldOption::Encoder)) {
+        optionsNode.appendChild(doc->createElement("encoder"));
+    }
+    if (field.options.testFlag(HidInputFieldOption::Normalize)) {
+        optionsNode.appendChild(doc->createElement("normalize"));
+    }
+    if (optionsNode.hasChildNodes()) {
+        controlNode.appendChild(optionsNode);
+    }
+    return controlNode;
+}
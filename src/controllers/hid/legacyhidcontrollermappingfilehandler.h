@@ -1,5 +1,6 @@
 #pragma once
 
+#include "controllers/hid/hidinputfield.h"
 #include "controllers/legacycontrollermappingfilehandler.h"
 
 class LegacyHidControllerMapping;
@@ -15,4 +16,8 @@ class LegacyHidControllerMappingFileHandler : public LegacyControllerMappingFile
     virtual std::shared_ptr<LegacyControllerMapping> load(const QDomElement& root,
             const QString& filePath,
             const QDir& systemMappingsPath);
+
+    void addInputFieldsToDocument(
+            const LegacyHidControllerMapping& mapping, QDomDocument* doc) const;
+    QDomElement inputFieldToXML(QDomDocument* doc, const HidInputField& field) const;
 };
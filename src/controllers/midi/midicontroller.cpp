@@ -12,8 +12,18 @@
 #include "util/screensaver.h"
 
 MidiController::MidiController(const QString& deviceName)
-        : Controller(deviceName) {
+        : Controller(deviceName),
+          m_outputCoalescer(deviceName),
+          m_outputFlushTimer(this) {
     setDeviceCategory(tr("MIDI Controller"));
+    // Output messages are sent immediately while the interval is 0,
+    // see setOutputFrameDuration()
+    m_outputFlushTimer.setSingleShot(true);
+    m_outputFlushTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_outputFlushTimer,
+            &QTimer::timeout,
+            this,
+            &MidiController::flushOutput);
 }
 
 MidiController::~MidiController() {
@@ -32,6 +42,15 @@ QString MidiController::mappingExtension() {
 
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyMidiControllerMapping>(std::move(pMapping));
+    compileInputMappings();
+}
+
+void MidiController::compileInputMappings() {
+    if (!m_pMapping) {
+        m_inputDispatchTable.clear();
+        return;
+    }
+    m_inputDispatchTable.compile(m_pMapping->getInputMappings());
 }
 
 std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
@@ -42,10 +61,58 @@ std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
 }
 
 int MidiController::close() {
+    // Send the final state, e.g. LEDs that have been switched off by
+    // the shutdown function of the script.
+    flushOutput();
     destroyOutputHandlers();
     return 0;
 }
 
+void MidiController::setOutputFrameDuration(mixxx::Duration frameDuration) {
+    if (frameDuration <= mixxx::Duration::empty()) {
+        flushOutput();
+        m_outputFlushTimer.setInterval(0);
+        return;
+    }
+    m_outputFlushTimer.setInterval(static_cast<int>(frameDuration.toIntegerMillis()));
+}
+
+void MidiController::queueShortMsg(unsigned char status,
+        unsigned char byte1,
+        unsigned char byte2) {
+    if (m_outputFlushTimer.interval() <= 0) {
+        sendShortMsg(status, byte1, byte2);
+        return;
+    }
+    if (m_outputCoalescer.queue(status, byte1, byte2)) {
+        if (!m_outputFlushTimer.isActive()) {
+            m_outputFlushTimer.start();
+        }
+        return;
+    }
+    // Preserve the order of messages that cannot be coalesced
+    flushOutput();
+    sendShortMsg(status, byte1, byte2);
+}
+
+void MidiController::send(const QList<int>& data, unsigned int length) {
+    // Preserve the order of messages
+    flushOutput();
+    Controller::send(data, length);
+}
+
+void MidiController::flushOutput() {
+    m_outputFlushTimer.stop();
+    if (m_outputCoalescer.isEmpty()) {
+        return;
+    }
+    m_outputCoalescer.flush([this](unsigned char status,
+                                    unsigned char byte1,
+                                    unsigned char byte2) {
+        sendShortMsg(status, byte1, byte2);
+    });
+}
+
 bool MidiController::matchMapping(const MappingInfo& mapping) {
     // Product info mapping not implemented for MIDI devices yet
     Q_UNUSED(mapping);
@@ -55,6 +122,7 @@ bool MidiController::matchMapping(const MappingInfo& mapping) {
 bool MidiController::applyMapping() {
     // Handles the engine
     bool result = Controller::applyMapping();
+    m_inputDispatchTable.resolveScriptFunctions(getScriptEngine());
 
     // Only execute this code if this is an output device
     if (isOutputDevice()) {
@@ -208,12 +276,20 @@ void MidiController::commitTemporaryInputMappings() {
         m_pMapping->addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    compileInputMappings();
 }
 
 void MidiController::receivedShortMessage(unsigned char status,
         unsigned char control,
         unsigned char value,
         mixxx::Duration timestamp) {
+    if (isRecordingInput()) {
+        const char message[] = {static_cast<char>(status),
+                static_cast<char>(control),
+                static_cast<char>(value)};
+        recordInput(QByteArray(message, sizeof(message)), timestamp);
+    }
+
     // The rest of this function is for legacy mappings
     unsigned char channel = MidiUtils::channelFromStatus(status);
     MidiOpCode opCode = MidiUtils::opCodeFromStatus(status);
@@ -245,24 +321,27 @@ void MidiController::receivedShortMessage(unsigned char status,
         auto it = m_temporaryInputMappings.constFind(mappingKey.key);
         if (it != m_temporaryInputMappings.constEnd()) {
             for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
+                // Learned mappings are not compiled, they are resolved
+                // for each message while learning.
+                MidiInputDispatchTable::Entry entry(it.value());
+                processInputMapping(&entry, status, control, value, timestamp);
             }
             return;
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    for (auto& entry : m_inputDispatchTable.entries(mappingKey)) {
+        processInputMapping(&entry, status, control, value, timestamp);
     }
 }
 
-void MidiController::processInputMapping(const MidiInputMapping& mapping,
-                                         unsigned char status,
-                                         unsigned char control,
-                                         unsigned char value,
-                                         mixxx::Duration timestamp) {
+void MidiController::processInputMapping(MidiInputDispatchTable::Entry* pEntry,
+        unsigned char status,
+        unsigned char control,
+        unsigned char value,
+        mixxx::Duration timestamp) {
     Q_UNUSED(timestamp);
+    const MidiInputMapping& mapping = pEntry->mapping();
     unsigned char channel = MidiUtils::channelFromStatus(status);
     MidiOpCode opCode = MidiUtils::opCodeFromStatus(status);
 
@@ -272,7 +351,6 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
             return;
         }
 
-        QJSValue function = pEngine->wrapFunctionCode(mapping.control.item, 5);
         const auto args = QJSValueList{
                 channel,
                 control,
@@ -280,7 +358,8 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
                 status,
                 mapping.control.group,
         };
-        if (!pEngine->executeFunction(&function, args)) {
+        if (!pEngine->executeFunction(
+                    pEntry->scriptFunction(pEngine), args, mapping.control.item)) {
             qCWarning(m_logBase) << "MidiController: Invalid script function"
                                  << mapping.control.item;
         }
@@ -288,7 +367,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    ControlObject* pCO = ControlObject::getControl(mapping.control);
+    ControlObject* pCO = pEntry->control();
     if (pCO == nullptr) {
         return;
     }
@@ -497,6 +576,7 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
     qCDebug(m_logInput) << QStringLiteral("incoming: ")
                         << MidiUtils::formatSysexMessage(
                                    getName(), data, timestamp);
+    recordInput(data, timestamp);
     MidiKey mappingKey(data.at(0), 0xFF);
 
     triggerActivity();
@@ -515,9 +595,8 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), data, timestamp);
+    for (const auto& entry : m_inputDispatchTable.entries(mappingKey)) {
+        processInputMapping(entry.mapping(), data, timestamp);
     }
 }
 
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <QTimer>
+
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermapping.h"
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
+#include "controllers/midi/midiinputdispatchtable.h"
 #include "controllers/midi/midimessage.h"
+#include "controllers/midi/midioutputcoalescer.h"
 #include "controllers/midi/midioutputhandler.h"
 #include "controllers/softtakeover.h"
 
@@ -53,6 +57,8 @@ class MidiController : public Controller {
         send(data);
     }
 
+    void send(const QList<int>& data, unsigned int length = 0) override;
+
   protected slots:
     virtual void receivedShortMessage(
             unsigned char status,
@@ -70,9 +76,20 @@ class MidiController : public Controller {
     void clearTemporaryInputMappings();
     void commitTemporaryInputMappings();
 
+  private slots:
+    void flushOutput();
+
   private:
+    void setOutputFrameDuration(mixxx::Duration frameDuration) override;
+
+    /// Sends the message immediately or with the next batch of
+    /// coalesced output messages.
+    void queueShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2);
+
     void processInputMapping(
-            const MidiInputMapping& mapping,
+            MidiInputDispatchTable::Entry* pEntry,
             unsigned char status,
             unsigned char control,
             unsigned char value,
@@ -87,15 +104,22 @@ class MidiController : public Controller {
     void updateAllOutputs();
     void destroyOutputHandlers();
 
+    void compileInputMappings();
+
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
     QList<MidiOutputHandler*> m_outputs;
     std::shared_ptr<LegacyMidiControllerMapping> m_pMapping;
+    MidiInputDispatchTable m_inputDispatchTable;
+    MidiOutputCoalescer m_outputCoalescer;
+    QTimer m_outputFlushTimer;
     SoftTakeoverCtrl m_st;
     QList<QPair<MidiInputMapping, unsigned char>> m_fourteen_bit_queued_mappings;
 
     // So it can access sendShortMsg()
     friend class MidiOutputHandler;
     friend class MidiControllerTest;
+    // Replays recorded input in benchmarks
+    friend class ReplayMidiController;
     friend class MidiControllerJSProxy;
 
     // MIDI learning assistant
@@ -113,7 +137,7 @@ class MidiControllerJSProxy : public ControllerJSProxy {
     Q_INVOKABLE void sendShortMsg(unsigned char status,
             unsigned char byte1,
             unsigned char byte2) {
-        m_pMidiController->sendShortMsg(status, byte1, byte2);
+        m_pMidiController->queueShortMsg(status, byte1, byte2);
     }
 
     Q_INVOKABLE void sendSysexMsg(const QList<int>& data, unsigned int length = 0) {
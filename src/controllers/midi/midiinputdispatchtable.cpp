@@ -0,0 +1,88 @@
+#include "controllers/midi/midiinputdispatchtable.h"
+
+#include <QtDebug>
+#include <algorithm>
+
+#include "util/assert.h"
+
+namespace {
+
+// The number of arguments that are passed to script functions, see
+// MidiController::processInputMapping()
+constexpr int kScriptFunctionArgCount = 5;
+
+} // anonymous namespace
+
+QJSValue* MidiInputDispatchTable::Entry::scriptFunction(
+        ControllerScriptEngineLegacy* pEngine) {
+    return m_binding.scriptFunction(
+            pEngine, m_mapping.control.item, kScriptFunctionArgCount);
+}
+
+MidiInputDispatchTable::MidiInputDispatchTable()
+        : m_offsets(kIndexCount + 1, 0) {
+}
+
+void MidiInputDispatchTable::compile(
+        const QMultiHash<uint16_t, MidiInputMapping>& mappings) {
+    std::fill(m_offsets.begin(), m_offsets.end(), 0);
+    m_entries.clear();
+
+    const QList<uint16_t> keys = mappings.uniqueKeys();
+    // Count the mappings per index at the position of the next index...
+    for (const auto key : keys) {
+        MidiKey midiKey;
+        midiKey.key = key;
+        const int index = indexOf(midiKey);
+        if (index < 0) {
+            qWarning() << "Ignoring MIDI input mapping with invalid key"
+                       << QString::number(key, 16);
+            continue;
+        }
+        m_offsets[index + 1] = static_cast<uint32_t>(mappings.count(key));
+    }
+    // ...and accumulate them into offsets
+    for (int index = 1; index <= kIndexCount; ++index) {
+        m_offsets[index] += m_offsets[index - 1];
+    }
+
+    m_entries.resize(m_offsets[kIndexCount]);
+    for (const auto key : keys) {
+        MidiKey midiKey;
+        midiKey.key = key;
+        const int index = indexOf(midiKey);
+        if (index < 0) {
+            continue;
+        }
+        auto offset = m_offsets[index];
+        for (auto it = mappings.constFind(key);
+                it != mappings.constEnd() && it.key() == key;
+                ++it) {
+            m_entries[offset++] = Entry(it.value());
+        }
+        DEBUG_ASSERT(offset == m_offsets[index + 1]);
+    }
+
+    for (auto& entry : m_entries) {
+        if (!entry.m_mapping.options.testFlag(MidiOption::Script)) {
+            entry.m_binding.resolveControl(entry.m_mapping.control);
+        }
+    }
+}
+
+void MidiInputDispatchTable::clear() {
+    std::fill(m_offsets.begin(), m_offsets.end(), 0);
+    m_entries.clear();
+}
+
+void MidiInputDispatchTable::resolveScriptFunctions(
+        ControllerScriptEngineLegacy* pEngine) {
+    if (!pEngine) {
+        return;
+    }
+    for (auto& entry : m_entries) {
+        if (entry.m_mapping.options.testFlag(MidiOption::Script)) {
+            entry.scriptFunction(pEngine);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QJSValue>
+#include <QMultiHash>
+#include <span>
+#include <vector>
+
+#include "controllers/controllerinputbinding.h"
+#include "controllers/midi/midimessage.h"
+
+/// MIDI input mappings compiled into a flat lookup table
+///
+/// All mappings for a message are stored consecutively and are found
+/// by indexing an array with the status byte and the control byte,
+/// i.e. without hashing. The bindings are resolved once and then cached:
+/// Mappings with a MixxxControl keep a reference to the control and
+/// script mappings keep the callable script function.
+class MidiInputDispatchTable final {
+  public:
+    class Entry final {
+      public:
+        Entry() = default;
+        explicit Entry(const MidiInputMapping& mapping)
+                : m_mapping(mapping) {
+        }
+
+        const MidiInputMapping& mapping() const {
+            return m_mapping;
+        }
+
+        /// The bound control. Returns nullptr if the control doesn't
+        /// exist (yet).
+        ControlObject* control() {
+            return m_binding.control(m_mapping.control);
+        }
+
+        /// The wrapped script function of a MidiOption::Script mapping.
+        QJSValue* scriptFunction(ControllerScriptEngineLegacy* pEngine);
+
+      private:
+        friend class MidiInputDispatchTable;
+
+        MidiInputMapping m_mapping;
+        ControllerInputBinding m_binding;
+    };
+
+    MidiInputDispatchTable();
+
+    void compile(const QMultiHash<uint16_t, MidiInputMapping>& mappings);
+    void clear();
+
+    /// Pre-resolves all script functions, e.g. after the scripts
+    /// have been loaded to avoid the delay when receiving the first
+    /// message.
+    void resolveScriptFunctions(ControllerScriptEngineLegacy* pEngine);
+
+    /// All mappings for the message in the order of the QMultiHash,
+    /// i.e. the most recently added mapping comes first.
+    std::span<Entry> entries(MidiKey key) {
+        const int index = indexOf(key);
+        if (index < 0) {
+            return {};
+        }
+        return std::span<Entry>(m_entries.data() + m_offsets[index],
+                m_offsets[index + 1] - m_offsets[index]);
+    }
+
+    bool isEmpty() const {
+        return m_entries.empty();
+    }
+
+  private:
+    // Status bytes 0x80..0xFF and control bytes 0x00..0x7F. One additional
+    // column for messages without a control byte (0xFF), see MidiKey.
+    static constexpr int kStatusCount = 0x80;
+    static constexpr int kControlCount = 0x80 + 1;
+    static constexpr int kIndexCount = kStatusCount * kControlCount;
+
+    static int indexOf(MidiKey key) {
+        if (key.status < 0x80 || (key.control >= 0x80 && key.control != 0xFF)) {
+            return -1;
+        }
+        const int column = key.control == 0xFF ? kControlCount - 1 : key.control;
+        return (key.status - 0x80) * kControlCount + column;
+    }
+
+    // Start of the entries for each index and the total size at the end
+    std::vector<uint32_t> m_offsets;
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,99 @@
+#include "controllers/midi/midioutputcoalescer.h"
+
+#include "controllers/midi/midiutils.h"
+#include "util/stat.h"
+#include "util/time.h"
+
+namespace {
+
+constexpr mixxx::Duration kStatsReportInterval = mixxx::Duration::fromSeconds(1);
+
+/// Returns the address of the device state that is set by the message,
+/// or -1 if the message must not be coalesced.
+int addressOf(unsigned char status, unsigned char byte1) {
+    const auto channel = MidiUtils::channelFromStatus(status);
+    switch (MidiUtils::opCodeFromStatus(status)) {
+    case MidiOpCode::NoteOff:
+    case MidiOpCode::NoteOn:
+        // Both set the state of the same note
+        return (MidiUtils::statusFromOpCodeAndChannel(MidiOpCode::NoteOn, channel) << 8) | byte1;
+    case MidiOpCode::ControlChange:
+        switch (byte1) {
+        case 0x06: // Data Entry MSB
+        case 0x26: // Data Entry LSB
+        case 0x60: // Data Increment
+        case 0x61: // Data Decrement
+        case 0x62: // NRPN LSB
+        case 0x63: // NRPN MSB
+        case 0x64: // RPN LSB
+        case 0x65: // RPN MSB
+            // Only meaningful as a sequence
+            return -1;
+        default:
+            break;
+        }
+        if (byte1 >= 0x78) {
+            // Channel Mode Messages
+            return -1;
+        }
+        return (status << 8) | byte1;
+    case MidiOpCode::PolyphonicKeyPressure:
+        return (status << 8) | byte1;
+    case MidiOpCode::ChannelPressure:
+    case MidiOpCode::PitchBendChange:
+        // The second byte is part of the value
+        return (status << 8) | 0xFF;
+    default:
+        return -1;
+    }
+}
+
+} // anonymous namespace
+
+MidiOutputCoalescer::MidiOutputCoalescer(const QString& controllerName)
+        : m_statSavedMessagesTag(
+                  QStringLiteral("MIDI output messages saved per second ") +
+                  controllerName),
+          m_savedCount(0),
+          m_lastStatsReported(mixxx::Time::elapsed()) {
+}
+
+bool MidiOutputCoalescer::queue(
+        unsigned char status, unsigned char byte1, unsigned char byte2) {
+    const int address = addressOf(status, byte1);
+    if (address < 0) {
+        return false;
+    }
+    const Message message{status, byte1, byte2};
+    const auto it = m_pendingMessageIndices.constFind(static_cast<uint16_t>(address));
+    if (it != m_pendingMessageIndices.constEnd()) {
+        // Replace the pending message at its original position
+        m_pendingMessages[it.value()] = message;
+        ++m_savedCount;
+        return true;
+    }
+    m_pendingMessageIndices.insert(static_cast<uint16_t>(address),
+            static_cast<int>(m_pendingMessages.size()));
+    m_pendingMessages.push_back(message);
+    return true;
+}
+
+void MidiOutputCoalescer::clear() {
+    m_pendingMessages.clear();
+    m_pendingMessageIndices.clear();
+}
+
+void MidiOutputCoalescer::reportStats() {
+    const auto now = mixxx::Time::elapsed();
+    const auto elapsed = now - m_lastStatsReported;
+    if (elapsed < kStatsReportInterval) {
+        return;
+    }
+    const double savedPerSecond = m_savedCount / elapsed.toDoubleSeconds();
+    Stat::track(m_statSavedMessagesTag,
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+            savedPerSecond);
+    m_savedCount = 0;
+    m_lastStatsReported = now;
+}
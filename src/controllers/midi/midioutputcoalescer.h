@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <vector>
+
+#include "util/duration.h"
+
+/// Collects short MIDI output messages over a frame and sends them in
+/// a single batch
+///
+/// Messages that address the same state on the device, i.e. the same
+/// note or control number on the same channel, replace each other
+/// while they are pending. Only the latest message is finally sent.
+/// Note On and Note Off for the same note address the same state.
+///
+/// Messages that trigger an action instead of setting a state, like
+/// Program Change, RPN/NRPN sequences, and system messages, are never
+/// coalesced. The caller must flush all pending messages before sending
+/// them to preserve the order.
+class MidiOutputCoalescer final {
+  public:
+    explicit MidiOutputCoalescer(const QString& controllerName);
+
+    /// Queues the message for sending it later with flush().
+    /// Returns false if the message could not be coalesced and
+    /// needs to be sent immediately.
+    bool queue(unsigned char status, unsigned char byte1, unsigned char byte2);
+
+    bool isEmpty() const {
+        return m_pendingMessages.empty();
+    }
+
+    /// Sends all pending messages in the order they have been
+    /// queued initially.
+    template<typename SendShortMsg>
+    void flush(SendShortMsg sendShortMsg) {
+        for (const auto& message : m_pendingMessages) {
+            sendShortMsg(message.status, message.byte1, message.byte2);
+        }
+        m_pendingMessages.clear();
+        m_pendingMessageIndices.clear();
+        reportStats();
+    }
+
+    /// Discards all pending messages
+    void clear();
+
+  private:
+    struct Message {
+        unsigned char status;
+        unsigned char byte1;
+        unsigned char byte2;
+    };
+
+    void reportStats();
+
+    const QString m_statSavedMessagesTag;
+
+    std::vector<Message> m_pendingMessages;
+    QHash<uint16_t, int> m_pendingMessageIndices;
+
+    int m_savedCount;
+    mixxx::Duration m_lastStatsReported;
+};
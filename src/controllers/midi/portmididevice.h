@@ -2,6 +2,14 @@
 
 #include <portmidi.h>
 
+#include <QMutex>
+
+#include "util/compatibility/qmutex.h"
+
+/// Thin wrapper around a PortMidi stream
+///
+/// PortMidi is not thread-safe, but each controller runs on its own
+/// thread. All calls into the library are serialized by a global mutex.
 class PortMidiDevice {
   public:
     PortMidiDevice(const PmDeviceInfo* deviceInfo,
@@ -27,6 +35,7 @@ class PortMidiDevice {
     }
 
     virtual PmError openInput(int32_t bufferSize) {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_OpenInput(&m_pStream, m_deviceIndex,
                             NULL, // no drive hacks
                             bufferSize,
@@ -35,6 +44,7 @@ class PortMidiDevice {
     }
 
     virtual PmError openOutput() {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_OpenOutput(&m_pStream,
                              m_deviceIndex,
                              NULL, // No driver hacks
@@ -45,28 +55,35 @@ class PortMidiDevice {
     }
 
     virtual PmError close() {
+        const auto locker = lockMutex(&s_mutex);
         PmError err = Pm_Close(m_pStream);
         m_pStream = NULL;
         return err;
     }
 
     virtual PmError poll() {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_Poll(m_pStream);
     }
 
     virtual int read(PmEvent* buffer, int32_t length) {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_Read(m_pStream, buffer, length);
     }
 
     virtual PmError writeShort(int32_t message) {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_WriteShort(m_pStream, 0, message);
     }
 
     virtual PmError writeSysEx(unsigned char* message) {
+        const auto locker = lockMutex(&s_mutex);
         return Pm_WriteSysEx(m_pStream, 0, message);
     }
 
   private:
+    static inline QMutex s_mutex;
+
     const PmDeviceInfo* m_pDeviceInfo;
     int m_deviceIndex;
     PortMidiStream* m_pStream;
@@ -1,5 +1,7 @@
 #include "controllers/scripting/controllerscriptenginebase.h"
 
+#include <utility>
+
 #include "control/controlobject.h"
 #include "controllers/controller.h"
 #include "controllers/scripting/colormapperjsproxy.h"
@@ -7,6 +9,7 @@
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptenginebase.cpp"
 #include "util/cmdlineargs.h"
+#include "util/time.h"
 
 ControllerScriptEngineBase::ControllerScriptEngineBase(
         Controller* controller, const RuntimeLoggingCategory& logger)
@@ -15,7 +18,8 @@ ControllerScriptEngineBase::ControllerScriptEngineBase(
           m_pController(controller),
           m_logger(logger),
           m_bAbortOnWarning(false),
-          m_bTesting(false) {
+          m_bTesting(false),
+          m_callbackDepth(0) {
     // Handle error dialog buttons
     qRegisterMetaType<QMessageBox::StandardButton>("QMessageBox::StandardButton");
 }
@@ -70,7 +74,7 @@ void ControllerScriptEngineBase::reload() {
 }
 
 bool ControllerScriptEngineBase::executeFunction(
-        QJSValue* pFunctionObject, const QJSValueList& args) {
+        QJSValue* pFunctionObject, const QJSValueList& args, const QString& label) {
     // This function is called from outside the controller engine, so we can't
     // use VERIFY_OR_DEBUG_ASSERT here
     if (!m_pJSEngine) {
@@ -87,6 +91,10 @@ bool ControllerScriptEngineBase::executeFunction(
     }
 
     // If it does happen to be a function, call it.
+    const ScopedCallbackTimer callbackTimer(this,
+            label.isEmpty() && ControllerScriptProfiler::isEnabled()
+                    ? ControllerScriptProfiler::functionLabel(*pFunctionObject)
+                    : label);
     QJSValue returnValue = pFunctionObject->call(args);
     if (returnValue.isError()) {
         showScriptExceptionDialog(returnValue);
@@ -95,6 +103,49 @@ bool ControllerScriptEngineBase::executeFunction(
     return true;
 }
 
+ControllerScriptEngineBase::CallbackStats ControllerScriptEngineBase::takeCallbackStats() {
+    return std::exchange(m_callbackStats, CallbackStats{});
+}
+
+ControllerScriptEngineBase::ScopedCallbackTimer::ScopedCallbackTimer(
+        ControllerScriptEngineBase* pEngine, const QString& label)
+        : m_pEngine(pEngine) {
+    if (!m_pEngine) {
+        return;
+    }
+    const bool outermost = m_pEngine->m_callbackDepth++ == 0;
+    // Reading the clock for every callback is not for free, so the
+    // execution time is only measured while profiling
+    if (ControllerScriptProfiler::isEnabled()) {
+        if (outermost) {
+            m_start = mixxx::Time::elapsed();
+        }
+        m_profilerScope.emplace(m_pEngine->m_pController
+                        ? m_pEngine->m_pController->getName()
+                        : QStringLiteral("(no controller)"),
+                label);
+    }
+}
+
+ControllerScriptEngineBase::ScopedCallbackTimer::~ScopedCallbackTimer() {
+    // Record the nested time in the profiler first
+    m_profilerScope.reset();
+    if (!m_pEngine || --m_pEngine->m_callbackDepth > 0) {
+        return;
+    }
+    CallbackStats& stats = m_pEngine->m_callbackStats;
+    ++stats.count;
+    if (!m_start) {
+        return;
+    }
+    const mixxx::Duration duration = mixxx::Time::elapsed() - *m_start;
+    ++stats.timedCount;
+    stats.totalDuration += duration;
+    if (duration > stats.maxDuration) {
+        stats.maxDuration = duration;
+    }
+}
+
 void ControllerScriptEngineBase::showScriptExceptionDialog(
         const QJSValue& evaluationResult, bool bFatalError) {
     VERIFY_OR_DEBUG_ASSERT(evaluationResult.isError()) {
@@ -5,8 +5,10 @@
 #include <QJSValue>
 #include <QMessageBox>
 #include <memory>
+#include <optional>
 
 #include "controllers/legacycontrollermapping.h"
+#include "controllers/scripting/controllerscriptprofiler.h"
 #include "util/duration.h"
 #include "util/runtimeloggingcategory.h"
 
@@ -19,13 +21,47 @@ class EvaluationException;
 class ControllerScriptEngineBase : public QObject {
     Q_OBJECT
   public:
+    /// Execution times of script callbacks
+    struct CallbackStats {
+        int count = 0;
+        /// The number of callbacks whose execution time has been
+        /// measured, i.e. while the ControllerScriptProfiler was enabled
+        int timedCount = 0;
+        mixxx::Duration totalDuration;
+        mixxx::Duration maxDuration;
+    };
+
+    /// Counts a script callback. The time of nested callbacks, e.g.
+    /// connections triggered by a script function, is only accounted
+    /// to the outermost callback.
+    ///
+    /// The execution time is only measured if the ControllerScriptProfiler
+    /// is enabled, which then also records the callback. The label
+    /// identifies the callback in its report.
+    class ScopedCallbackTimer final {
+      public:
+        ScopedCallbackTimer(ControllerScriptEngineBase* pEngine,
+                const QString& label);
+        ~ScopedCallbackTimer();
+
+      private:
+        ControllerScriptEngineBase* const m_pEngine;
+        // Only set for the outermost callback while profiling
+        std::optional<mixxx::Duration> m_start;
+        std::optional<ControllerScriptProfiler::Scope> m_profilerScope;
+    };
+
     explicit ControllerScriptEngineBase(
             Controller* controller, const RuntimeLoggingCategory& logger);
     virtual ~ControllerScriptEngineBase() override = default;
 
     virtual bool initialize();
 
-    bool executeFunction(QJSValue* pFunctionObject, const QJSValueList& arguments = {});
+    /// Calls the function. The label identifies the function in the
+    /// profiler report. If empty, it is derived from the function itself.
+    bool executeFunction(QJSValue* pFunctionObject,
+            const QJSValueList& arguments = {},
+            const QString& label = QString());
 
     /// Shows a UI dialog notifying of a script evaluation error.
     /// Precondition: QJSValue.isError() == true
@@ -44,6 +80,9 @@ class ControllerScriptEngineBase : public QObject {
         return m_bTesting;
     }
 
+    /// Returns the statistics accumulated since the previous call
+    CallbackStats takeCallbackStats();
+
   protected:
     virtual void shutdown();
 
@@ -60,6 +99,10 @@ class ControllerScriptEngineBase : public QObject {
 
     bool m_bTesting;
 
+  private:
+    int m_callbackDepth;
+    CallbackStats m_callbackStats;
+
   protected slots:
     void reload();
 
@@ -0,0 +1,77 @@
+#include "controllers/scripting/controllerscriptfilecache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+struct Entry {
+    QDateTime lastModified;
+    qint64 size;
+    QString code;
+};
+
+struct Cache {
+    QMutex mutex;
+    QHash<QString, Entry> entries;
+};
+
+Cache& cache() {
+    static Cache s_cache;
+    return s_cache;
+}
+
+} // anonymous namespace
+
+// static
+QString ControllerScriptFileCache::read(const QString& filePath,
+        QString* pErrorString,
+        bool* pCached) {
+    const QFileInfo fileInfo(filePath);
+    const QDateTime lastModified = fileInfo.lastModified();
+    const qint64 size = fileInfo.size();
+
+    auto lock = lockMutex(&cache().mutex);
+    const auto it = cache().entries.constFind(filePath);
+    if (it != cache().entries.constEnd() &&
+            it->lastModified == lastModified && it->size == size) {
+        if (pCached) {
+            *pCached = true;
+        }
+        return it->code;
+    }
+    lock.unlock();
+
+    if (pCached) {
+        *pCached = false;
+    }
+    QFile input(filePath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        *pErrorString = input.errorString();
+        return QString();
+    }
+    // The trailing newline terminates a comment in the last line
+    const QString code = QString(input.readAll()) + QStringLiteral("\n");
+    input.close();
+
+    lock.relock();
+    cache().entries.insert(filePath, Entry{lastModified, size, code});
+    return code;
+}
+
+// static
+void ControllerScriptFileCache::invalidate(const QString& filePath) {
+    const auto lock = lockMutex(&cache().mutex);
+    cache().entries.remove(filePath);
+}
+
+// static
+void ControllerScriptFileCache::clear() {
+    const auto lock = lockMutex(&cache().mutex);
+    cache().entries.clear();
+}
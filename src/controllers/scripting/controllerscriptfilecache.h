@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QString>
+
+/// Process-wide cache of the source code of controller script files
+///
+/// Shared libraries like common-controller-scripts.js are loaded by every
+/// controller and again whenever a mapping is reloaded. They are only read
+/// and decoded again after they have been modified, which is detected by
+/// their size and modification time.
+///
+/// All functions are thread-safe, the controllers might run on different
+/// threads.
+class ControllerScriptFileCache final {
+  public:
+    ControllerScriptFileCache() = delete;
+
+    /// Returns the source code of the file. Returns a null string and sets
+    /// pErrorString if the file can't be read. pCached is set to whether
+    /// the cached source code was returned.
+    static QString read(const QString& filePath,
+            QString* pErrorString,
+            bool* pCached = nullptr);
+
+    /// Forgets the cached source code of a modified file
+    static void invalidate(const QString& filePath);
+
+    static void clear();
+};
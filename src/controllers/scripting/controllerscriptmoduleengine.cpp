@@ -32,7 +32,7 @@ bool ControllerScriptModuleEngine::initialize() {
     }
 
     QJSValue initFunction = mod.property("init");
-    if (!executeFunction(&initFunction)) {
+    if (!executeFunction(&initFunction, {}, QStringLiteral("init"))) {
         shutdown();
         return false;
     }
@@ -47,6 +47,6 @@ bool ControllerScriptModuleEngine::initialize() {
 }
 
 void ControllerScriptModuleEngine::shutdown() {
-    executeFunction(&m_shutdownFunction);
+    executeFunction(&m_shutdownFunction, {}, QStringLiteral("shutdown"));
     ControllerScriptEngineBase::shutdown();
 }
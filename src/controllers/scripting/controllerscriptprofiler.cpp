@@ -0,0 +1,166 @@
+#include "controllers/scripting/controllerscriptprofiler.h"
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QTextStream>
+#include <QtDebug>
+#include <utility>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/stat.h"
+#include "util/time.h"
+
+namespace {
+
+// Source code of anonymous functions is abbreviated to this length
+constexpr int kMaxSourceLabelLength = 40;
+
+struct Frame {
+    // The folded call stack including this frame
+    QString stack;
+    QString label;
+    mixxx::Duration start;
+    mixxx::Duration nestedDuration;
+};
+
+// Each thread profiles its own invocations
+thread_local std::vector<Frame> t_callStack;
+
+struct FunctionEntry {
+    ControllerScriptProfiler::FunctionStats stats;
+    QString statTag;
+};
+
+struct Profile {
+    QMutex mutex;
+    QHash<QString, FunctionEntry> functions;
+    // The self duration of each folded call stack
+    QHash<QString, mixxx::Duration> stacks;
+};
+
+Profile& profile() {
+    static Profile s_profile;
+    return s_profile;
+}
+
+/// Removes the characters that separate frames and counts in the
+/// folded format.
+QString sanitizeFrameLabel(QString label) {
+    return label.replace(QChar(';'), QChar(',')).simplified();
+}
+
+} // anonymous namespace
+
+QAtomicInt ControllerScriptProfiler::s_enabled(0);
+
+ControllerScriptProfiler::Scope::Scope(
+        const QString& controllerName, const QString& label) {
+    Frame frame;
+    frame.label = sanitizeFrameLabel(label);
+    if (t_callStack.empty()) {
+        frame.stack = sanitizeFrameLabel(controllerName) + QChar(';') + frame.label;
+    } else {
+        frame.stack = t_callStack.back().stack + QChar(';') + frame.label;
+    }
+    frame.start = mixxx::Time::elapsed();
+    t_callStack.push_back(std::move(frame));
+}
+
+ControllerScriptProfiler::Scope::~Scope() {
+    const mixxx::Duration end = mixxx::Time::elapsed();
+    DEBUG_ASSERT(!t_callStack.empty());
+    const Frame frame = std::move(t_callStack.back());
+    t_callStack.pop_back();
+    const mixxx::Duration duration = end - frame.start;
+    const mixxx::Duration selfDuration = duration - frame.nestedDuration;
+    if (!t_callStack.empty()) {
+        t_callStack.back().nestedDuration += duration;
+    }
+
+    Profile& p = profile();
+    auto locker = lockMutex(&p.mutex);
+    auto it = p.functions.find(frame.label);
+    if (it == p.functions.end()) {
+        FunctionEntry entry;
+        entry.stats.label = frame.label;
+        entry.statTag = QStringLiteral("Controller script ") + frame.label;
+        it = p.functions.insert(frame.label, entry);
+    }
+    FunctionStats& stats = it->stats;
+    ++stats.callCount;
+    stats.totalDuration += duration;
+    stats.selfDuration += selfDuration;
+    if (duration > stats.maxDuration) {
+        stats.maxDuration = duration;
+    }
+    const QString statTag = it->statTag;
+    p.stacks[frame.stack] += selfDuration;
+    locker.unlock();
+
+    Stat::track(statTag,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
+                    Stat::MAX | Stat::SAMPLE_VARIANCE),
+            duration.toIntegerNanos());
+}
+
+// static
+void ControllerScriptProfiler::setEnabled(bool enabled) {
+    atomicStoreRelaxed(s_enabled, enabled ? 1 : 0);
+}
+
+// static
+void ControllerScriptProfiler::reset() {
+    Profile& p = profile();
+    const auto locker = lockMutex(&p.mutex);
+    p.functions.clear();
+    p.stacks.clear();
+}
+
+// static
+QList<ControllerScriptProfiler::FunctionStats> ControllerScriptProfiler::functionStats() {
+    Profile& p = profile();
+    const auto locker = lockMutex(&p.mutex);
+    QList<FunctionStats> functionStats;
+    functionStats.reserve(p.functions.size());
+    for (const auto& entry : qAsConst(p.functions)) {
+        functionStats.append(entry.stats);
+    }
+    return functionStats;
+}
+
+// static
+bool ControllerScriptProfiler::writeFlameGraph(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "open" << filePath << "failed";
+        return false;
+    }
+    Profile& p = profile();
+    auto locker = lockMutex(&p.mutex);
+    const auto stacks = p.stacks;
+    locker.unlock();
+
+    QTextStream out(&file);
+    for (auto it = stacks.constBegin(); it != stacks.constEnd(); ++it) {
+        out << it.key() << ' ' << it.value().toIntegerMicros() << '\n';
+    }
+    return true;
+}
+
+// static
+QString ControllerScriptProfiler::functionLabel(const QJSValue& function) {
+    const QString name = function.property(QStringLiteral("name")).toString();
+    if (!name.isEmpty()) {
+        return name;
+    }
+    QString source = function.toString().simplified();
+    if (source.size() > kMaxSourceLabelLength) {
+        source.truncate(kMaxSourceLabelLength);
+        source.append(QStringLiteral("..."));
+    }
+    return source;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QJSValue>
+#include <QList>
+#include <QString>
+
+#include "util/compatibility/qatomic.h"
+#include "util/duration.h"
+
+/// Measures the execution time of controller script functions
+///
+/// When enabled, every invocation of a script function by the controller
+/// engines, i.e. input handlers, connection callbacks, and timers, is
+/// timed and aggregated per function. Nested invocations, e.g. connection
+/// callbacks that are triggered by an input handler, are recorded as a
+/// call stack. Profiling is disabled by default and costs only a single
+/// atomic load per invocation while disabled.
+///
+/// All functions are thread-safe, the controllers might run on different
+/// threads.
+class ControllerScriptProfiler final {
+  public:
+    struct FunctionStats {
+        QString label;
+        int callCount = 0;
+        /// Including the time spent in nested invocations
+        mixxx::Duration totalDuration;
+        /// Excluding the time spent in nested invocations
+        mixxx::Duration selfDuration;
+        mixxx::Duration maxDuration;
+    };
+
+    /// Profiles a single invocation of a script function on the current
+    /// thread. The label identifies the function in the report.
+    class Scope final {
+      public:
+        Scope(const QString& controllerName, const QString& label);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    ControllerScriptProfiler() = delete;
+
+    static bool isEnabled() {
+        return atomicLoadRelaxed(s_enabled) != 0;
+    }
+    static void setEnabled(bool enabled);
+
+    /// Discards all recorded data
+    static void reset();
+
+    /// The aggregated statistics of all profiled functions
+    static QList<FunctionStats> functionStats();
+
+    /// Writes the call stacks in the "folded" format that is used by
+    /// flame graph tools, e.g. FlameGraph or speedscope. Each line
+    /// contains a call stack with the frames separated by semicolons
+    /// followed by the time spent in its topmost frame in microseconds.
+    static bool writeFlameGraph(const QString& filePath);
+
+    /// A label for an anonymous function or a function without a
+    /// known binding, derived from its name or source code.
+    static QString functionLabel(const QJSValue& function);
+
+  private:
+    static QAtomicInt s_enabled;
+};
@@ -1,20 +1,44 @@
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 
+#include <QAtomicInt>
+
 #include "control/controlobject.h"
 #include "controllers/controller.h"
 #include "controllers/scripting/colormapperjsproxy.h"
+#include "controllers/scripting/controllerscriptfilecache.h"
 #include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptenginelegacy.cpp"
+#include "util/time.h"
+
+namespace {
+
+QAtomicInt s_lastGeneration;
+
+int nextGeneration() {
+    int generation;
+    do {
+        generation = s_lastGeneration.fetchAndAddRelaxed(1) + 1;
+    } while (generation == 0);
+    return generation;
+}
+
+} // anonymous namespace
 
 ControllerScriptEngineLegacy::ControllerScriptEngineLegacy(
         Controller* controller, const RuntimeLoggingCategory& logger)
-        : ControllerScriptEngineBase(controller, logger) {
+        : ControllerScriptEngineBase(controller, logger),
+          m_generation(nextGeneration()) {
     connect(&m_fileWatcher,
             &QFileSystemWatcher::fileChanged,
             this,
-            &ControllerScriptEngineLegacy::reload);
+            [this](const QString& path) {
+                // Modifications within the resolution of the file time
+                // would not be detected otherwise
+                ControllerScriptFileCache::invalidate(path);
+                reload();
+            });
 }
 
 ControllerScriptEngineLegacy::~ControllerScriptEngineLegacy() {
@@ -103,6 +127,7 @@ bool ControllerScriptEngineLegacy::initialize() {
     if (!ControllerScriptEngineBase::initialize()) {
         return false;
     }
+    m_generation = nextGeneration();
 
     // Binary data is passed from the Controller as a QByteArray, which
     // QJSEngine::toScriptValue converts to an ArrayBuffer in JavaScript.
@@ -126,6 +151,7 @@ bool ControllerScriptEngineLegacy::initialize() {
     engineGlobalObject.setProperty(
             "engine", m_pJSEngine->newQObject(legacyScriptInterface));
 
+    const auto startTime = mixxx::Time::elapsed();
     for (const LegacyControllerMapping::ScriptFileInfo& script : std::as_const(m_scriptFiles)) {
         if (!evaluateScriptFile(script.file)) {
             shutdown();
@@ -135,6 +161,8 @@ bool ControllerScriptEngineLegacy::initialize() {
             m_scriptFunctionPrefixes.append(script.functionPrefix);
         }
     }
+    qCInfo(m_logger) << "Loaded" << m_scriptFiles.size() << "script files in"
+                     << (mixxx::Time::elapsed() - startTime).formatMillisWithUnit();
 
     // For testing, do not actually initialize the scripts, just check for
     // syntax errors above.
@@ -192,8 +220,9 @@ bool ControllerScriptEngineLegacy::handleIncomingData(const QByteArray& data) {
             static_cast<uint>(data.size()),
     };
 
+    static const QString kProfilerLabel = QStringLiteral("incomingData");
     for (auto&& function : m_incomingDataFunctions) {
-        ControllerScriptEngineBase::executeFunction(&function, args);
+        ControllerScriptEngineBase::executeFunction(&function, args, kProfilerLabel);
     }
 
     return true;
@@ -221,15 +250,16 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
                       << scriptFile.absoluteFilePath();
 
     // Read in the script file
+    const auto startTime = mixxx::Time::elapsed();
     QString filename = scriptFile.absoluteFilePath();
-    QFile input(filename);
-    if (!input.open(QIODevice::ReadOnly)) {
+    QString errorString;
+    bool cached = false;
+    const QString scriptCode = ControllerScriptFileCache::read(filename, &errorString, &cached);
+    if (scriptCode.isNull()) {
         qCWarning(m_logger) << QString(
                 "Problem opening the script file: %1, "
-                "error # %2, %3")
-                                       .arg(filename,
-                                               QString::number(input.error()),
-                                               input.errorString());
+                "error: %2")
+                                       .arg(filename, errorString);
         // Set up error dialog
         ErrorDialogProperties* props = ErrorDialogHandler::instance()->newDialogProperties();
         props->setType(DLG_WARNING);
@@ -246,15 +276,14 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
         // when they don't speak english.
         props->setDetails(tr("File:") + QStringLiteral(" ") + filename +
                 QStringLiteral("\n") + tr("Error:") + QStringLiteral(" ") +
-                input.errorString());
+                errorString);
 
         // Ask above layer to display the dialog & handle user response
         ErrorDialogHandler::instance()->requestErrorDialog(props);
         return false;
     }
 
-    QString scriptCode = QString(input.readAll()) + QStringLiteral("\n");
-    input.close();
+    const auto readTime = mixxx::Time::elapsed();
 
     QJSValue scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
     if (scriptFunction.isError()) {
@@ -262,6 +291,11 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
         return false;
     }
 
+    qCDebug(m_logger) << "Read" << filename
+                      << (cached ? "from cache in" : "from disk in")
+                      << (readTime - startTime).formatMicrosWithUnit()
+                      << "and evaluated it in"
+                      << (mixxx::Time::elapsed() - readTime).formatMillisWithUnit();
     return true;
 }
 
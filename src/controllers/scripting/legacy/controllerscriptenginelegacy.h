@@ -26,6 +26,14 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     /// and ensures the function is executed with the correct 'this' object.
     QJSValue wrapFunctionCode(const QString& codeSnippet, int numberOfArgs);
 
+    /// Changes whenever the scripts are (re-)loaded into a new JS engine.
+    /// Functions that have been returned by wrapFunctionCode() for a
+    /// different generation must not be used anymore. Unique among all
+    /// instances and never 0.
+    int generation() const {
+        return m_generation;
+    }
+
   public slots:
     void setScriptFiles(const QList<LegacyControllerMapping::ScriptFileInfo>& scripts);
 
@@ -47,6 +55,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
 
     QFileSystemWatcher m_fileWatcher;
 
+    int m_generation;
+
     // There is lots of tight coupling between ControllerScriptEngineLegacy
     // and ControllerScriptInterface. This is probably not worth improving in legacy code.
     friend class ControllerScriptInterfaceLegacy;
@@ -1,7 +1,11 @@
 #include "controllerscriptinterfacelegacy.h"
 
+#include <algorithm>
+
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
+#include "controllers/controllermanager.h"
+#include "controllers/scripting/controllerscriptprofiler.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "controllers/scripting/legacy/scriptconnectionjsproxy.h"
 #include "mixer/playermanager.h"
@@ -21,12 +25,22 @@ constexpr int kScratchTimerMs = 1;
 constexpr double kAlphaBetaDt = kScratchTimerMs / 1000.0;
 // stop ramping at a rate which doesn't produce any audible output anymore
 constexpr double kBrakeRampToRate = 0.01;
+// Polled connections are sampled with the frame rate of typical
+// displays. LEDs, meters and controller screens don't benefit from
+// faster updates.
+constexpr int kDefaultPollIntervalMillis = 16;
 } // namespace
 
 ControllerScriptInterfaceLegacy::ControllerScriptInterfaceLegacy(
         ControllerScriptEngineLegacy* m_pEngine, const RuntimeLoggingCategory& logger)
         : m_pScriptEngineLegacy(m_pEngine),
           m_logger(logger) {
+    m_pollTimer.setInterval(kDefaultPollIntervalMillis);
+    connect(&m_pollTimer,
+            &QTimer::timeout,
+            this,
+            &ControllerScriptInterfaceLegacy::pollConnections);
+
     // Pre-allocate arrays for average number of virtual decks
     m_intervalAccumulator.resize(kDecks);
     m_lastMovement.resize(kDecks);
@@ -50,6 +64,9 @@ ControllerScriptInterfaceLegacy::ControllerScriptInterfaceLegacy(
 }
 
 ControllerScriptInterfaceLegacy::~ControllerScriptInterfaceLegacy() {
+    m_pollTimer.stop();
+    m_polledControls.clear();
+
     // Stop all timers
     const auto timerIds = m_timers.keys();
     for (const int timerId : timerIds) {
@@ -237,8 +254,17 @@ QJSValue ControllerScriptInterfaceLegacy::makeUnbufferedConnection(
     return ControllerScriptInterfaceLegacy::makeConnectionInternal(group, name, callback, true);
 }
 
-QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(
-        const QString& group, const QString& name, const QJSValue& callback, bool skipSuperseded) {
+QJSValue ControllerScriptInterfaceLegacy::makePolledConnection(
+        const QString& group, const QString& name, const QJSValue& callback) {
+    return ControllerScriptInterfaceLegacy::makeConnectionInternal(
+            group, name, callback, false, true);
+}
+
+QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(const QString& group,
+        const QString& name,
+        const QJSValue& callback,
+        bool skipSuperseded,
+        bool polled) {
     auto pJsEngine = m_pScriptEngineLegacy->jsEngine();
     VERIFY_OR_DEBUG_ASSERT(pJsEngine) {
         return QJSValue();
@@ -273,6 +299,20 @@ QJSValue ControllerScriptInterfaceLegacy::makeConnectionInternal(
     connection.id = QUuid::createUuid();
     connection.skipSuperseded = skipSuperseded;
 
+    if (polled) {
+        if (!coScript->addPolledScriptConnection(connection)) {
+            return QJSValue();
+        }
+        if (!m_polledControls.contains(coScript)) {
+            m_polledControls.append(coScript);
+        }
+        if (!m_pollTimer.isActive()) {
+            m_pollTimer.start();
+        }
+        return pJsEngine->newQObject(
+                new ScriptConnectionJSProxy(connection));
+    }
+
     if (coScript->addScriptConnection(connection)) {
         return pJsEngine->newQObject(
                 new ScriptConnectionJSProxy(connection));
@@ -293,6 +333,39 @@ bool ControllerScriptInterfaceLegacy::removeScriptConnection(
     return coScript->removeScriptConnection(connection);
 }
 
+void ControllerScriptInterfaceLegacy::setPollInterval(int milliseconds) {
+    // Not faster than controllers are polled
+    const int minMillis = static_cast<int>(
+            ControllerManager::kPollInterval.toIntegerMillis());
+    if (milliseconds < minMillis) {
+        m_pScriptEngineLegacy->logOrThrowError(
+                QStringLiteral("Invalid poll interval %1 ms, must be at least %2 ms")
+                        .arg(QString::number(milliseconds), QString::number(minMillis)));
+        return;
+    }
+    m_pollTimer.setInterval(milliseconds);
+}
+
+void ControllerScriptInterfaceLegacy::pollConnections() {
+    // Make a local copy, because callbacks might make new connections
+    const QList<ControlObjectScript*> controls = m_polledControls;
+    for (ControlObjectScript* pControl : controls) {
+        pControl->pollScriptConnections();
+    }
+
+    // Connections might have been removed by any means, e.g. by the
+    // callbacks or engine.connectControl()
+    m_polledControls.erase(std::remove_if(m_polledControls.begin(),
+                                   m_polledControls.end(),
+                                   [](ControlObjectScript* pControl) {
+                                       return !pControl->hasPolledScriptConnections();
+                                   }),
+            m_polledControls.end());
+    if (m_polledControls.isEmpty()) {
+        m_pollTimer.stop();
+    }
+}
+
 void ControllerScriptInterfaceLegacy::triggerScriptConnection(
         const ScriptConnection& connection) {
     VERIFY_OR_DEBUG_ASSERT(m_pScriptEngineLegacy->jsEngine()) {
@@ -538,12 +611,16 @@ void ControllerScriptInterfaceLegacy::timerEvent(QTimerEvent* event) {
         return;
     }
 
-    auto it = m_timers.constFind(timerId);
-    if (it == m_timers.constEnd()) {
+    auto it = m_timers.find(timerId);
+    if (it == m_timers.end()) {
         qCWarning(m_logger) << "Timer" << timerId
                             << "fired but there's no function mapped to it!";
         return;
     }
+    if (ControllerScriptProfiler::isEnabled() && it->profilerLabel.isEmpty()) {
+        it->profilerLabel = QStringLiteral("timer ") +
+                ControllerScriptProfiler::functionLabel(it->callback);
+    }
 
     // NOTE(rryan): Do not assign by reference -- make a copy. I have no idea
     // why but this causes segfaults in ~QScriptValue while scratching if we
@@ -554,7 +631,8 @@ void ControllerScriptInterfaceLegacy::timerEvent(QTimerEvent* event) {
         stopTimer(timerId);
     }
 
-    m_pScriptEngineLegacy->executeFunction(&timerTarget.callback);
+    m_pScriptEngineLegacy->executeFunction(
+            &timerTarget.callback, {}, timerTarget.profilerLabel);
 }
 
 void ControllerScriptInterfaceLegacy::softTakeover(
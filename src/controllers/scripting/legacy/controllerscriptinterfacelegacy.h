@@ -2,6 +2,7 @@
 
 #include <QJSValue>
 #include <QObject>
+#include <QTimer>
 
 #include "controllers/softtakeover.h"
 #include "util/alphabetafilter.h"
@@ -37,6 +38,14 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE QJSValue makeUnbufferedConnection(const QString& group,
             const QString& name,
             const QJSValue& callback);
+    /// The value of the control is sampled periodically and the callback
+    /// is executed only if it has changed. Intended for controls that
+    /// change continuously, e.g. playposition or VU meters.
+    Q_INVOKABLE QJSValue makePolledConnection(const QString& group,
+            const QString& name,
+            const QJSValue& callback);
+    /// Sets the interval for sampling the controls of polled connections
+    Q_INVOKABLE void setPollInterval(int milliseconds);
     // DEPRECATED: Use makeConnection instead.
     Q_INVOKABLE QJSValue connectControl(const QString& group,
             const QString& name,
@@ -76,12 +85,20 @@ class ControllerScriptInterfaceLegacy : public QObject {
     /// Handler for timers that scripts set.
     virtual void timerEvent(QTimerEvent* event);
 
+  public slots:
+    /// Executes the polled connections of all controls that have changed
+    void pollConnections();
+
   private:
     QJSValue makeConnectionInternal(const QString& group,
             const QString& name,
             const QJSValue& callback,
-            bool skipSuperseded = false);
+            bool skipSuperseded = false,
+            bool polled = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
+    // The controls with polled connections
+    QList<ControlObjectScript*> m_polledControls;
+    QTimer m_pollTimer;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
 
     SoftTakeoverCtrl m_st;
@@ -89,6 +106,8 @@ class ControllerScriptInterfaceLegacy : public QObject {
     struct TimerInfo {
         QJSValue callback;
         bool oneShot;
+        // Only resolved while profiling
+        QString profilerLabel;
     };
     QHash<int, TimerInfo> m_timers;
 
@@ -108,4 +127,6 @@ class ControllerScriptInterfaceLegacy : public QObject {
 
     ControllerScriptEngineLegacy* m_pScriptEngineLegacy;
     const RuntimeLoggingCategory m_logger;
+
+    friend class ControllerScriptEngineLegacyTest;
 };
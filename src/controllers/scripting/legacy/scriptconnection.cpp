@@ -1,5 +1,6 @@
 #include "controllers/scripting/legacy/scriptconnection.h"
 
+#include "controllers/scripting/controllerscriptprofiler.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "util/trace.h"
 
@@ -11,6 +12,12 @@ void ScriptConnection::executeCallback(double value) const {
             key.item,
     };
     QJSValue func = callback; // copy function because QJSValue::call is not const
+    QString profilerLabel;
+    if (ControllerScriptProfiler::isEnabled()) {
+        profilerLabel = QStringLiteral("connection ") + key.group + QChar(',') + key.item;
+    }
+    const ControllerScriptEngineBase::ScopedCallbackTimer callbackTimer(
+            controllerEngine, profilerLabel);
     QJSValue result = func.call(args);
     if (result.isError()) {
         if (controllerEngine != nullptr) {
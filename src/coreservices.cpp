@@ -27,6 +27,9 @@
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "soundio/soundmanager.h"
+#include "sources/decodedaudiocache.h"
+#include "sources/seekindexcache.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
@@ -234,6 +237,17 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    mixxx::SeekIndexCache::setRootPath(
+            mixxx::SeekIndexCache::defaultRootPath(pConfig->getSettingsPath()),
+            pConfig->getValue(ConfigKey("[Library]", "SeekIndexCacheSizeMB"), 256) *
+                    qint64{1024 * 1024});
+    // Disabled by default, because the decoded audio data of a single
+    // track occupies about 50 MB.
+    mixxx::DecodedAudioCache::setRootPath(
+            mixxx::DecodedAudioCache::defaultRootPath(pConfig->getSettingsPath()),
+            pConfig->getValue(ConfigKey("[Library]", "DecodedAudioCacheSizeMB"), 0) *
+                    qint64{1024 * 1024});
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -331,7 +345,11 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    CoverArtCache::createInstance()->setThumbnailCache(
+            std::make_shared<const CoverArtThumbnailCache>(
+                    CoverArtThumbnailCache::defaultRootPath(
+                            pConfig->getSettingsPath()),
+                    CoverArtThumbnailCache::maxSizeInBytes(pConfig)));
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
             this,
@@ -573,6 +591,9 @@ void CoreServices::finalize() {
     // or samplers when PlayerManager was destroyed!
     PlayerInfo::destroy();
 
+    // Close all files that are still kept open for reuse
+    mixxx::SoundSourcePool::clear();
+
     // Delete the library after the view so there are no dangling pointers to
     // the data models.
     // Depends on RecordingManager and PlayerManager
@@ -30,6 +30,26 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// Write-ahead logging allows concurrent readers while writing, e.g.
+// for library queries that are executed on a separate connection, and
+// reduces the number of costly fsync() calls when committing. The mode
+// is persistent and applies to all subsequent connections.
+// https://www.sqlite.org/wal.html
+//
+// Synchronizing only at checkpoints is safe in WAL mode, i.e. the
+// database will not be corrupted. Only the most recently committed
+// transactions might be lost on a power failure.
+// https://www.sqlite.org/pragma.html#pragma_synchronous
+//
+// Memory mapped I/O avoids copying pages between kernel and user space
+// when reading. Each connection maps up to 256 MiB.
+// https://www.sqlite.org/mmap.html
+const QStringList kFilePragmas = {
+        QStringLiteral("journal_mode = WAL"),
+        QStringLiteral("synchronous = NORMAL"),
+        QStringLiteral("mmap_size = 268435456"),
+};
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -55,6 +75,8 @@ mixxx::DbConnection::Params dbConnectionParams(
     // https://www.sqlite.org/inmemorydb.html
     if (inMemoryConnection) {
         params.filePath += QStringLiteral("?mode=memory&cache=shared");
+    } else {
+        params.pragmas = kFilePragmas;
     }
     params.userName = kUserName;
     params.password = kPassword;
@@ -1,13 +1,21 @@
 #include "dialog/dlgdevelopertools.h"
 
 #include <QDateTime>
+#include <QTableWidgetItem>
 
 #include "control/control.h"
+#include "controllers/scripting/controllerscriptprofiler.h"
 #include "moc_dlgdevelopertools.cpp"
 #include "util/cmdlineargs.h"
 #include "util/logging.h"
 #include "util/statsmanager.h"
 
+namespace {
+
+constexpr int kControllerScriptsColumnCount = 6;
+
+} // anonymous namespace
+
 DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
                                      UserSettingsPointer pConfig)
         : QDialog(pParent),
@@ -59,6 +67,30 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    // Set up the controller script profiler
+    controllerScriptsTable->setColumnCount(kControllerScriptsColumnCount);
+    controllerScriptsTable->setHorizontalHeaderLabels({
+            tr("Function"),
+            tr("Calls"),
+            tr("Total [ms]"),
+            tr("Self [ms]"),
+            tr("Average [ms]"),
+            tr("Max [ms]"),
+    });
+    controllerScriptsProfile->setChecked(ControllerScriptProfiler::isEnabled());
+    connect(controllerScriptsProfile,
+            &QCheckBox::toggled,
+            this,
+            &DlgDeveloperTools::slotControllerScriptsProfile);
+    connect(controllerScriptsReset,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotControllerScriptsReset);
+    connect(controllerScriptsDump,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotControllerScriptsDump);
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -98,6 +130,52 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == controllerScriptsTab) {
+        updateControllerScriptsTable();
+    }
+}
+
+void DlgDeveloperTools::updateControllerScriptsTable() {
+    QList<ControllerScriptProfiler::FunctionStats> functionStats =
+            ControllerScriptProfiler::functionStats();
+
+    // Sorting while inserting would shuffle the rows
+    controllerScriptsTable->setSortingEnabled(false);
+    controllerScriptsTable->setRowCount(functionStats.size());
+    int row = 0;
+    for (const auto& stats : qAsConst(functionStats)) {
+        const auto setItem = [this, row](int column, const QVariant& value) {
+            auto* pItem = new QTableWidgetItem();
+            pItem->setData(Qt::DisplayRole, value);
+            controllerScriptsTable->setItem(row, column, pItem);
+        };
+        setItem(0, stats.label);
+        setItem(1, stats.callCount);
+        setItem(2, stats.totalDuration.toDoubleMillis());
+        setItem(3, stats.selfDuration.toDoubleMillis());
+        setItem(4, stats.totalDuration.toDoubleMillis() / stats.callCount);
+        setItem(5, stats.maxDuration.toDoubleMillis());
+        ++row;
+    }
+    controllerScriptsTable->setSortingEnabled(true);
+}
+
+void DlgDeveloperTools::slotControllerScriptsProfile(bool enabled) {
+    ControllerScriptProfiler::setEnabled(enabled);
+}
+
+void DlgDeveloperTools::slotControllerScriptsReset() {
+    ControllerScriptProfiler::reset();
+    controllerScriptsTable->setRowCount(0);
+}
+
+void DlgDeveloperTools::slotControllerScriptsDump() {
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString dumpFileName = m_pConfig->getSettingsPath() +
+            "/controller_script_profile_" + timestamp + ".folded";
+    if (ControllerScriptProfiler::writeFlameGraph(dumpFileName)) {
+        qInfo() << "Controller script profile written to" << dumpFileName;
     }
 }
 
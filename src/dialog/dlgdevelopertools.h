@@ -23,8 +23,13 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotControllerScriptsProfile(bool enabled);
+    void slotControllerScriptsReset();
+    void slotControllerScriptsDump();
 
   private:
+    void updateControllerScriptsTable();
+
     UserSettingsPointer m_pConfig;
     ControlSortFilterModel m_controlProxyModel;
 
@@ -85,6 +85,9 @@ CachingReader::CachingReader(const QString& group,
     connect(&m_worker, &CachingReaderWorker::trackLoaded,
             this, &CachingReader::trackLoaded,
             Qt::DirectConnection);
+    connect(&m_worker, &CachingReaderWorker::trackLengthRefined,
+            this, &CachingReader::trackLengthRefined,
+            Qt::DirectConnection);
     connect(&m_worker, &CachingReaderWorker::trackLoadFailed,
             this, &CachingReader::trackLoadFailed,
             Qt::DirectConnection);
@@ -276,6 +279,20 @@ void CachingReader::process() {
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
                 m_state.storeRelease(STATE_TRACK_LOADED);
+            } else if (update.status == TRACK_LENGTH_REFINED) {
+                // The complete track has replaced a preview. This message
+                // is obsolete if a new track is already loading.
+                if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
+                    continue;
+                }
+                // The chunk at the end of the preview might contain
+                // only some of its frames.
+                auto* pChunk = lookupChunk(CachingReaderChunk::indexForFrame(
+                        m_readableFrameIndexRange.end()));
+                if (pChunk && pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                    freeChunk(pChunk);
+                }
+                m_readableFrameIndexRange = update.readableFrameIndexRange();
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
                 // This message could be processed later when a new
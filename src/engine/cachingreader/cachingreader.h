@@ -124,6 +124,7 @@ class CachingReader : public QObject {
     void trackLoaded(TrackPointer pTrack,
             mixxx::audio::SampleRate trackSampleRate,
             double trackNumSamples);
+    void trackLengthRefined(TrackPointer pTrack, double trackNumSamples);
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
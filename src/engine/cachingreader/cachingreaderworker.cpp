@@ -2,7 +2,9 @@
 
 #include <QAtomicInt>
 #include <QFileInfo>
+#include <QtConcurrentRun>
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/analyzersilence.h"
 #include "control/controlobject.h"
@@ -12,6 +14,7 @@
 #include "util/compatibility/qmutex.h"
 #include "util/event.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/span.h"
 
 namespace {
@@ -21,6 +24,25 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// The preview of a track covers the main cue position and the
+// following duration. Only the preview needs to be scanned before
+// the track is ready to play.
+constexpr double kPreviewDurationSeconds = 30.0;
+
+// Used if the sample rate of the track is still unknown
+constexpr SINT kPreviewFallbackSampleRate = 48000;
+
+SINT previewFrameCount(const Track& track) {
+    const auto sampleRate = track.getSampleRate();
+    SINT frameCount = static_cast<SINT>(kPreviewDurationSeconds *
+            (sampleRate.isValid() ? sampleRate.value() : kPreviewFallbackSampleRate));
+    const auto mainCuePosition = track.getMainCuePosition();
+    if (mainCuePosition.isValid() && mainCuePosition > mixxx::audio::kStartFramePos) {
+        frameCount += static_cast<SINT>(mainCuePosition.toUpperFrameBoundary().value());
+    }
+    return frameCount;
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
@@ -30,7 +52,8 @@ CachingReaderWorker::CachingReaderWorker(
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_completeAudioSourceGeneration(0) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -126,6 +149,15 @@ void CachingReaderWorker::run() {
                 // here, the engine is already stopped
                 unloadTrack();
             }
+        } else if (m_completeAudioSourceAvailable.loadAcquire()) {
+            mixxx::AudioSourcePointer pAudioSource;
+            { // locking scope
+                const auto locker = lockMutex(&m_completeAudioSourceMutex);
+                pAudioSource = std::move(m_pCompleteAudioSource);
+                m_pCompleteAudioSource.reset();
+                m_completeAudioSourceAvailable.storeRelease(0);
+            } // implicitly unlocks the mutex
+            refineTrackLength(std::move(pAudioSource));
         } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
@@ -146,8 +178,37 @@ void CachingReaderWorker::discardAllPendingRequests() {
     }
 }
 
+void CachingReaderWorker::discardCompleteAudioSource() {
+    // Forget the futures that have already finished
+    m_openCompleteAudioSourceFutures.erase(
+            std::remove_if(m_openCompleteAudioSourceFutures.begin(),
+                    m_openCompleteAudioSourceFutures.end(),
+                    [](const QFuture<void>& future) {
+                        return future.isFinished();
+                    }),
+            m_openCompleteAudioSourceFutures.end());
+    if (!m_pPreviewTrack) {
+        return;
+    }
+    mixxx::AudioSourcePointer pAudioSource;
+    { // locking scope
+        const auto locker = lockMutex(&m_completeAudioSourceMutex);
+        // Audio sources that are still being opened for the
+        // discarded preview will be dropped
+        ++m_completeAudioSourceGeneration;
+        pAudioSource = std::move(m_pCompleteAudioSource);
+        m_pCompleteAudioSource.reset();
+        m_completeAudioSourceAvailable.storeRelease(0);
+    } // implicitly unlocks the mutex
+    if (pAudioSource) {
+        pAudioSource->close();
+    }
+    m_pPreviewTrack.reset();
+}
+
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
+    discardCompleteAudioSource();
 
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
@@ -189,6 +250,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     mixxx::AudioSource::OpenParams config;
     config.setChannelCount(CachingReaderChunk::kChannels);
+    config.setAccessPattern(mixxx::AudioSource::AccessPattern::Playback);
+    config.setPreviewFrameCount(previewFrameCount(*pTrack));
     m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
     if (!m_pAudioSource) {
         kLogger.warning()
@@ -234,10 +297,44 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 
     // Emit that the track is loaded.
-    const double sampleCount =
+    double sampleCount =
             CachingReaderChunk::dFrames2samples(
                     m_pAudioSource->frameLength());
 
+    if (m_pAudioSource->isPreview()) {
+        // The track is ready to play with the preview while the complete
+        // file is opened in the background. Until then the length is
+        // estimated from the metadata of the track.
+        sampleCount = math_max(sampleCount,
+                CachingReaderChunk::dFrames2samples(static_cast<SINT>(
+                        pTrack->getDuration() *
+                        m_pAudioSource->getSignalInfo().getSampleRate().value())));
+        config.setPreviewFrameCount(0);
+        m_pPreviewTrack = pTrack;
+        int generation;
+        { // locking scope
+            const auto locker = lockMutex(&m_completeAudioSourceMutex);
+            generation = m_completeAudioSourceGeneration;
+        } // implicitly unlocks the mutex
+        m_openCompleteAudioSourceFutures.append(QtConcurrent::run(
+                [this, pTrack, config, generation] {
+                    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+                    { // locking scope
+                        const auto locker = lockMutex(&m_completeAudioSourceMutex);
+                        if (generation == m_completeAudioSourceGeneration) {
+                            m_pCompleteAudioSource = std::move(pAudioSource);
+                            m_completeAudioSourceAvailable.storeRelease(1);
+                        }
+                    } // implicitly unlocks the mutex
+                    if (pAudioSource) {
+                        // Another track has been loaded in the meantime
+                        pAudioSource->close();
+                        return;
+                    }
+                    workReady();
+                }));
+    }
+
     // This code is a workaround until we have found a better solution to
     // verify and correct offsets.
     CuePointer pN60dBSound =
@@ -256,10 +353,60 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             sampleCount);
 }
 
+void CachingReaderWorker::refineTrackLength(
+        mixxx::AudioSourcePointer pAudioSource) {
+    const TrackPointer pTrack = std::move(m_pPreviewTrack);
+    m_pPreviewTrack.reset();
+    VERIFY_OR_DEBUG_ASSERT(pTrack && m_pAudioSource && m_pAudioSource->isPreview()) {
+        if (pAudioSource) {
+            pAudioSource->close();
+        }
+        return;
+    }
+    if (!pAudioSource) {
+        kLogger.warning()
+                << m_group
+                << "Failed to open complete file, continuing with preview"
+                << pTrack->getFileInfo();
+    } else if (pAudioSource->frameIndexRange().empty() ||
+            pAudioSource->getSignalInfo() != m_pAudioSource->getSignalInfo() ||
+            pAudioSource->frameIndexRange().start() !=
+                    m_pAudioSource->frameIndexRange().start()) {
+        kLogger.warning()
+                << m_group
+                << "Complete file differs from preview, continuing with preview"
+                << pTrack->getFileInfo();
+        pAudioSource->close();
+        pAudioSource.reset();
+    }
+    if (pAudioSource) {
+        DEBUG_ASSERT(!pAudioSource->isPreview());
+        m_pAudioSource->close();
+        m_pAudioSource = std::move(pAudioSource);
+
+        const auto update =
+                ReaderStatusUpdate::trackLengthRefined(
+                        m_pAudioSource->frameIndexRange());
+        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    }
+
+    // Replaces the estimated length, even when continuing with the preview
+    emit trackLengthRefined(
+            pTrack,
+            CachingReaderChunk::dFrames2samples(
+                    m_pAudioSource->frameLength()));
+}
+
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
     m_semaRun.release();
     wait();
+    discardCompleteAudioSource();
+    // The pending tasks access this worker
+    for (auto& future : m_openCompleteAudioSourceFutures) {
+        future.waitForFinished();
+    }
+    m_openCompleteAudioSourceFutures.clear();
 }
 
 void CachingReaderWorker::verifyFirstSound(const CachingReaderChunk* pChunk) {
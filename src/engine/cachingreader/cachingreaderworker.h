@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QFuture>
+#include <QList>
 #include <QMutex>
 #include <QSemaphore>
 #include <QString>
@@ -27,6 +29,7 @@ typedef struct CachingReaderChunkReadRequest {
 
 enum ReaderStatus {
     TRACK_LOADED,
+    TRACK_LENGTH_REFINED,
     TRACK_UNLOADED,
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
@@ -69,6 +72,14 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    static ReaderStatusUpdate trackLengthRefined(
+            const mixxx::IndexRange& readableFrameIndexRange) {
+        DEBUG_ASSERT(!readableFrameIndexRange.empty());
+        ReaderStatusUpdate update;
+        update.init(TRACK_LENGTH_REFINED, nullptr, readableFrameIndexRange);
+        return update;
+    }
+
     static ReaderStatusUpdate trackUnloaded() {
         ReaderStatusUpdate update;
         update.init(TRACK_UNLOADED, nullptr, mixxx::IndexRange());
@@ -116,6 +127,8 @@ class CachingReaderWorker : public EngineWorker {
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
     void trackLoaded(TrackPointer pTrack, mixxx::audio::SampleRate sampleRate, double numSamples);
+    // Emitted when the complete track has replaced a preview.
+    void trackLengthRefined(TrackPointer pTrack, double numSamples);
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
@@ -133,6 +146,21 @@ class CachingReaderWorker : public EngineWorker {
     QAtomicInt m_newTrackAvailable;
     TrackPointer m_pNewTrack;
 
+    // The complete audio source that is opened in the background
+    // after the preview of a track has been loaded, and the
+    // corresponding lock. Must acquire the lock to touch. The
+    // generation is incremented whenever the preview is discarded,
+    // i.e. audio sources that are opened for a previous generation
+    // are closed and dropped when finished.
+    QMutex m_completeAudioSourceMutex;
+    QAtomicInt m_completeAudioSourceAvailable;
+    mixxx::AudioSourcePointer m_pCompleteAudioSource;
+    int m_completeAudioSourceGeneration;
+    // Opening in the background cannot be aborted. Pending results
+    // are only awaited when shutting down.
+    QList<QFuture<void>> m_openCompleteAudioSourceFutures;
+    TrackPointer m_pPreviewTrack;
+
     void discardAllPendingRequests();
 
     /// call to be prepare for new tracks
@@ -146,6 +174,15 @@ class CachingReaderWorker : public EngineWorker {
     /// Internal method to load a track. Emits trackLoaded when finished.
     void loadTrack(const TrackPointer& pTrack);
 
+    /// Replaces the preview of the loaded track with the complete
+    /// audio source. Emits trackLengthRefined when finished.
+    void refineTrackLength(mixxx::AudioSourcePointer pAudioSource);
+
+    /// Closes the complete audio source if it has already been opened
+    /// in the background. Otherwise it is closed and dropped as soon as
+    /// opening has finished, without waiting for it.
+    void discardCompleteAudioSource();
+
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
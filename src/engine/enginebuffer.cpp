@@ -119,6 +119,9 @@ EngineBuffer::EngineBuffer(const QString& group,
     connect(m_pReader, &CachingReader::trackLoaded,
             this, &EngineBuffer::slotTrackLoaded,
             Qt::DirectConnection);
+    connect(m_pReader, &CachingReader::trackLengthRefined,
+            this, &EngineBuffer::slotTrackLengthRefined,
+            Qt::DirectConnection);
     connect(m_pReader, &CachingReader::trackLoadFailed,
             this, &EngineBuffer::slotTrackLoadFailed,
             Qt::DirectConnection);
@@ -571,6 +574,22 @@ void EngineBuffer::slotTrackLoaded(TrackPointer pTrack,
     m_iTrackLoading = 0;
 }
 
+// WARNING: Always called from the EngineWorker thread pool
+void EngineBuffer::slotTrackLengthRefined(TrackPointer pTrack,
+        double trackNumSamples) {
+    if (kLogger.traceEnabled()) {
+        kLogger.trace() << getGroup() << "EngineBuffer::slotTrackLengthRefined";
+    }
+    m_pause.lock();
+    // The length of a preview has been estimated when loading the track.
+    // The engine controls receive the exact track end position with the
+    // next callback.
+    if (m_pCurrentTrack == pTrack) {
+        m_pTrackSamples->set(trackNumSamples);
+    }
+    m_pause.unlock();
+}
+
 // WARNING: Always called from the EngineWorker thread pool
 void EngineBuffer::slotTrackLoadFailed(TrackPointer pTrack,
         const QString& reason) {
@@ -221,6 +221,8 @@ class EngineBuffer : public EngineObject {
             TrackPointer pTrack,
             mixxx::audio::SampleRate trackSampleRate,
             double trackNumSamples);
+    void slotTrackLengthRefined(TrackPointer pTrack,
+            double trackNumSamples);
     void slotTrackLoadFailed(TrackPointer pTrack,
             const QString& reason);
     // Fired when passthrough mode is enabled or disabled.
@@ -403,6 +405,7 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(EngineBufferTest, ReadFadeOut);
     FRIEND_TEST(EngineBufferTest, RateTempTest);
     FRIEND_TEST(EngineBufferTest, RatePermTest);
+    FRIEND_TEST(EngineBufferTest, TrackLengthRefined);
     EngineBufferScale* m_pScaleVinyl;
     // The keylock engine is configurable, so it could flip flop between
     // ScaleST and ScaleRB during a single callback.
@@ -18,6 +18,7 @@
 #include "util/datetime.h"
 #include "util/db/dbconnection.h"
 #include "util/duration.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
 
@@ -45,10 +46,22 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_trackIdToRowsValid(false),
+          m_bInitialized(false),
+          m_pQueryExecutor(pTrackCollectionManager->queryExecutor()),
+          m_queryChannel(-1),
+          m_asyncSelectGeneration(0) {
+    if (m_pQueryExecutor) {
+        m_queryChannel = m_pQueryExecutor->createChannel();
+        connect(m_pQueryExecutor,
+                &LibraryQueryExecutor::queryFinished,
+                this,
+                &BaseSqlTableModel::slotQueryFinished);
+    }
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    cancelAsyncSelect();
 }
 
 void BaseSqlTableModel::initHeaderProperties() {
@@ -158,40 +171,150 @@ void BaseSqlTableModel::initSortColumnMapping() {
 }
 
 void BaseSqlTableModel::clearRows() {
-    DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
-    DEBUG_ASSERT(m_rowInfo.size() >= m_trackIdToRows.size());
     if (!m_rowInfo.isEmpty()) {
         beginRemoveRows(QModelIndex(), 0, m_rowInfo.size() - 1);
         m_rowInfo.clear();
         m_trackIdToRows.clear();
+        m_trackIdToRowsValid = false;
         endRemoveRows();
     }
+    // Pages must never outlive the rows they have been fetched for
+    clearRowMetadataPages();
     DEBUG_ASSERT(m_rowInfo.isEmpty());
     DEBUG_ASSERT(m_trackIdToRows.isEmpty());
 }
 
 void BaseSqlTableModel::replaceRows(
-        QVector<RowInfo>&& rows,
-        TrackId2Rows&& trackIdToRows) {
-    // NOTE(uklotzde): Use r-value references for parameters here, because
-    // conceptually those parameters should replace the corresponding internal
-    // member variables. Currently Qt4/5 doesn't support move semantics and
-    // instead prevents unnecessary deep copying by implicit sharing (COW)
-    // behind the scenes. Moving would be more efficient, although implicit
-    // sharing meets all requirements. If Qt will ever add move support for
-    // its container types in the future this code becomes even more efficient.
-    DEBUG_ASSERT(rows.empty() == trackIdToRows.empty());
-    DEBUG_ASSERT(rows.size() >= trackIdToRows.size());
+        QVector<RowInfo>&& rows) {
     if (rows.isEmpty()) {
         clearRows();
     } else {
         beginInsertRows(QModelIndex(), 0, rows.size() - 1);
-        m_rowInfo = rows;
-        m_trackIdToRows = trackIdToRows;
+        m_rowInfo = std::move(rows);
+        m_trackIdToRows.clear();
+        m_trackIdToRowsValid = false;
+        clearRowMetadataPages();
         endInsertRows();
     }
 }
 
+const QVector<int> BaseSqlTableModel::getTrackRows(TrackId trackId) const {
+    if (!m_trackIdToRowsValid) {
+        // We expect almost all rows to be valid and that only a few tracks
+        // are contained multiple times (e.g. in history playlists)
+        m_trackIdToRows.reserve(m_rowInfo.size());
+        for (int i = 0; i < m_rowInfo.size(); ++i) {
+            m_trackIdToRows[m_rowInfo[i].trackId].push_back(i);
+        }
+        m_trackIdToRowsValid = true;
+    }
+    return m_trackIdToRows.value(trackId);
+}
+
+void BaseSqlTableModel::clearRowMetadataPages() const {
+    m_rowMetadataPages.clear();
+    m_rowMetadataPageLru.clear();
+}
+
+const BaseSqlTableModel::RowMetadataPage& BaseSqlTableModel::fetchRowMetadataPage(
+        int page) const {
+    const auto it = m_rowMetadataPages.constFind(page);
+    if (it != m_rowMetadataPages.constEnd()) {
+        // Move the page to the back of the LRU list
+        const int lruIndex = m_rowMetadataPageLru.indexOf(page);
+        DEBUG_ASSERT(lruIndex >= 0);
+        if (lruIndex < m_rowMetadataPageLru.size() - 1) {
+            m_rowMetadataPageLru.remove(lruIndex);
+            m_rowMetadataPageLru.append(page);
+        }
+        return it.value();
+    }
+
+    const int firstRow = page * kRowsPerMetadataPage;
+    const int endRow = math_min(
+            firstRow + kRowsPerMetadataPage,
+            static_cast<int>(m_rowInfo.size()));
+    DEBUG_ASSERT(firstRow < endRow);
+
+    QSet<TrackId> pageTrackIds;
+    QStringList idStrings;
+    for (int row = firstRow; row < endRow; ++row) {
+        const TrackId trackId = m_rowInfo[row].trackId;
+        if (!pageTrackIds.contains(trackId)) {
+            pageTrackIds.insert(trackId);
+            idStrings << trackId.toString();
+        }
+    }
+
+    // The order of multiple rows for the same track must match the order
+    // in which they have been counted by select(). A random order is not
+    // reproducible and any order of those rows is fine then.
+    QString orderBy;
+    if (!m_tableOrderBy.contains(QStringLiteral("RANDOM()"))) {
+        orderBy = m_tableOrderBy;
+    }
+    const QString queryString =
+            QStringLiteral("SELECT %1 FROM %2 WHERE %3 IN (%4) %5")
+                    .arg(m_tableColumns.join(","),
+                            m_tableName,
+                            m_idColumn,
+                            idStrings.join(","),
+                            orderBy);
+    if (sDebug) {
+        qDebug() << this << "fetchRowMetadataPage() executing:" << queryString;
+    }
+
+    QHash<TrackId, RowMetadataPage> metadataByTrackId;
+    metadataByTrackId.reserve(idStrings.size());
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (query.prepare(queryString) && query.exec()) {
+        const int numColumns = m_tableColumns.size();
+        while (query.next()) {
+            const TrackId trackId(query.value(kIdColumn));
+            QVector<QVariant> metadata;
+            metadata.reserve(numColumns);
+            for (int i = 0; i < numColumns; ++i) {
+                metadata.push_back(query.value(i));
+            }
+            metadataByTrackId[trackId].push_back(std::move(metadata));
+        }
+    } else {
+        LOG_FAILED_QUERY(query);
+    }
+
+    RowMetadataPage rowMetadataPage;
+    rowMetadataPage.reserve(endRow - firstRow);
+    for (int row = firstRow; row < endRow; ++row) {
+        const RowInfo& rowInfo = m_rowInfo[row];
+        rowMetadataPage.push_back(
+                metadataByTrackId.value(rowInfo.trackId)
+                        .value(rowInfo.occurrence));
+    }
+
+    while (m_rowMetadataPageLru.size() >= kMaxCachedMetadataPages) {
+        m_rowMetadataPages.remove(m_rowMetadataPageLru.takeFirst());
+    }
+    m_rowMetadataPageLru.append(page);
+    return m_rowMetadataPages.insert(page, std::move(rowMetadataPage)).value();
+}
+
+QVariant BaseSqlTableModel::tableColumnValue(int row, int column) const {
+    DEBUG_ASSERT(row >= 0);
+    DEBUG_ASSERT(row < m_rowInfo.size());
+    if (column == kIdColumn) {
+        // No need to fetch anything
+        return m_rowInfo[row].trackId.toVariant();
+    }
+    const RowMetadataPage& rowMetadataPage =
+            fetchRowMetadataPage(row / kRowsPerMetadataPage);
+    const int pageRow = row % kRowsPerMetadataPage;
+    if (pageRow >= rowMetadataPage.size()) {
+        return QVariant();
+    }
+    return rowMetadataPage[pageRow].value(column);
+}
+
 void BaseSqlTableModel::select() {
     if (!m_bInitialized) {
         return;
@@ -211,12 +334,16 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    // A synchronous select supersedes all pending asynchronous selects
+    cancelAsyncSelect();
+
     PerformanceTimer time;
     time.start();
 
-    // Prepare query for id and all columns not in m_trackSource
+    // Only the ids are needed for filtering and sorting. All other
+    // table columns are fetched on demand for the visible rows.
     QString queryString = QString("SELECT %1 FROM %2 %3")
-                                  .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+                                  .arg(m_idColumn, m_tableName, m_tableOrderBy);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -235,62 +362,181 @@ void BaseSqlTableModel::select() {
         return;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
-    int idColumn = -1;
+    QVector<TrackId> tableTrackIds;
     while (query.next()) {
-        QSqlRecord sqlRecord = query.record();
-
-        if (idColumn < 0) {
-            idColumn = sqlRecord.indexOf(m_idColumn);
-        }
-
-        // TODO(XXX): Can we get rid of the hard-coded assumption that
-        // the the first column always contains the id?
-        DEBUG_ASSERT(idColumn == kIdColumn);
-
-        VERIFY_OR_DEBUG_ASSERT(idColumn >= 0) {
-            qCritical()
-                    << "ID column not available in database query results:"
-                    << m_idColumn;
-            return;
-        }
-
-        TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
-
-        RowInfo rowInfo;
-        rowInfo.trackId = trackId;
-        // current position defines the ordering
-        rowInfo.order = rowInfos.size();
-        rowInfo.metadata.reserve(sqlRecord.count());
-        for (int i = 0; i < m_tableColumns.size(); ++i) {
-            rowInfo.metadata.push_back(sqlRecord.value(i));
-        }
-        rowInfos.push_back(rowInfo);
+        tableTrackIds.push_back(TrackId(query.value(kIdColumn)));
     }
 
     if (sDebug) {
-        qDebug() << "Rows actually received:" << rowInfos.size();
+        qDebug() << "Rows actually received:" << tableTrackIds.size();
     }
 
+    QSet<TrackId> trackIds;
+    QVector<RowInfo> rowInfos = createRows(tableTrackIds, &trackIds);
+
     if (m_trackSource) {
+        QHash<TrackId, int> trackSortOrder;
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
                 m_currentSearchFilter,
                 m_trackSourceOrderBy,
                 m_sortColumns,
                 m_tableColumns.size() - 1, // exclude the 1st column with the id
-                &m_trackSortOrder);
+                &trackSortOrder);
+        sortAndReplaceRows(std::move(rowInfos), &trackSortOrder);
+    } else {
+        sortAndReplaceRows(std::move(rowInfos), nullptr);
+    }
+
+    qDebug() << this << "select() returned" << m_rowInfo.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+}
+
+bool BaseSqlTableModel::selectAsync(
+        const std::function<void()>& onSelectFinished) {
+    if (!m_bInitialized || !m_pQueryExecutor || !m_trackSource) {
+        return false;
+    }
+    LibraryQueryExecutor::Request request;
+    if (!temporaryViews(&request.temporaryViews)) {
+        // The table is not accessible from other database connections
+        return false;
+    }
+    request.queries
+            << QString("SELECT %1 FROM %2 %3")
+                       .arg(m_idColumn, m_tableName, m_tableOrderBy)
+            << m_trackSource->filterAndSortQuery(
+                       QString("%1 IN (SELECT %2 FROM %3)")
+                               .arg(m_trackSource->idColumn(),
+                                       m_idColumn,
+                                       m_tableName),
+                       m_currentSearch,
+                       m_currentSearchFilter,
+                       m_trackSourceOrderBy);
+    if (sDebug) {
+        qDebug() << this << "selectAsync() submitting:" << request.queries;
+    }
+    m_asyncSelectGeneration = m_pQueryExecutor->submit(
+            m_queryChannel, std::move(request));
+    m_onAsyncSelectFinished = onSelectFinished;
+    m_asyncSelectTimer.start();
+    return true;
+}
 
+void BaseSqlTableModel::cancelAsyncSelect() {
+    if (m_asyncSelectGeneration == 0) {
+        return;
+    }
+    DEBUG_ASSERT(m_pQueryExecutor);
+    m_pQueryExecutor->cancel(m_queryChannel);
+    m_asyncSelectGeneration = 0;
+    m_onAsyncSelectFinished = nullptr;
+}
+
+void BaseSqlTableModel::slotQueryFinished(
+        int channel,
+        quint64 generation,
+        const LibraryQueryExecutor::Results& results) {
+    if (channel != m_queryChannel ||
+            generation != m_asyncSelectGeneration) {
+        // Superseded
+        return;
+    }
+    m_asyncSelectGeneration = 0;
+    const auto onSelectFinished = std::move(m_onAsyncSelectFinished);
+    m_onAsyncSelectFinished = nullptr;
+    VERIFY_OR_DEBUG_ASSERT(results.size() == 2 && m_trackSource) {
+        return;
+    }
+
+    QSet<TrackId> trackIds;
+    QVector<RowInfo> rowInfos = createRows(results[0], &trackIds);
+    QHash<TrackId, int> trackSortOrder;
+    m_trackSource->filterAndSortSelected(trackIds,
+            results[1],
+            m_currentSearch,
+            m_currentSearchFilter,
+            m_sortColumns,
+            m_tableColumns.size() - 1, // exclude the 1st column with the id
+            &trackSortOrder);
+    sortAndReplaceRows(std::move(rowInfos), &trackSortOrder);
+
+    qDebug() << this << "selectAsync() returned" << m_rowInfo.size()
+             << "results in" << m_asyncSelectTimer.elapsed().debugMillisWithUnit();
+
+    if (onSelectFinished) {
+        onSelectFinished();
+    }
+}
+
+bool BaseSqlTableModel::temporaryViews(
+        QList<LibraryQueryExecutor::TemporaryView>* pTemporaryViews) const {
+    QStringList tableNames;
+    tableNames << m_tableName;
+    if (m_trackSource) {
+        tableNames << m_trackSource->tableName();
+    }
+    for (const auto& tableName : tableNames) {
+        // The original statement is stored in a normalized form, i.e.
+        // "CREATE VIEW <name> ..." without TEMPORARY and IF NOT EXISTS.
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral(
+                "SELECT type,sql FROM sqlite_temp_master WHERE name=:name"));
+        query.bindValue(QStringLiteral(":name"), tableName);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        if (!query.next()) {
+            // Not a temporary object
+            continue;
+        }
+        const QString createViewPrefix = QStringLiteral("CREATE VIEW ");
+        const QString sql = query.value(1).toString();
+        if (query.value(0).toString() != QStringLiteral("view") ||
+                !sql.startsWith(createViewPrefix)) {
+            // The contents of temporary tables are not accessible
+            return false;
+        }
+        pTemporaryViews->append(LibraryQueryExecutor::TemporaryView{
+                tableName,
+                QStringLiteral("CREATE TEMPORARY VIEW ") +
+                        sql.mid(createViewPrefix.size())});
+    }
+    return true;
+}
+
+QVector<BaseSqlTableModel::RowInfo> BaseSqlTableModel::createRows(
+        const QVector<TrackId>& tableTrackIds,
+        QSet<TrackId>* pTrackIds) const {
+    QVector<RowInfo> rowInfos;
+    rowInfos.reserve(tableTrackIds.size());
+    pTrackIds->reserve(tableTrackIds.size());
+    // Only tracks that appear multiple times are counted here
+    QHash<TrackId, int> trackIdOccurrences;
+    for (const auto& trackId : tableTrackIds) {
+        RowInfo rowInfo;
+        rowInfo.trackId = trackId;
+        // current position defines the ordering
+        rowInfo.order = rowInfos.size();
+        if (pTrackIds->contains(trackId)) {
+            rowInfo.occurrence = ++trackIdOccurrences[trackId];
+        } else {
+            pTrackIds->insert(trackId);
+            rowInfo.occurrence = 0;
+        }
+        rowInfos.push_back(rowInfo);
+    }
+    return rowInfos;
+}
+
+void BaseSqlTableModel::sortAndReplaceRows(
+        QVector<RowInfo>&& rowInfos,
+        const QHash<TrackId, int>* pTrackSortOrder) {
+    if (pTrackSortOrder) {
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
         for (auto& rowInfo : rowInfos) {
@@ -298,9 +544,9 @@ void BaseSqlTableModel::select() {
             // separate removed tracks (order == -1) from present tracks (order ==
             // 0). Otherwise we sort by the order that filterAndSort returned to us.
             if (m_trackSourceOrderBy.isEmpty()) {
-                rowInfo.order = m_trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
+                rowInfo.order = pTrackSortOrder->contains(rowInfo.trackId) ? 0 : -1;
             } else {
-                rowInfo.order = m_trackSortOrder.value(rowInfo.trackId, -1);
+                rowInfo.order = pTrackSortOrder->value(rowInfo.trackId, -1);
             }
         }
     }
@@ -311,34 +557,22 @@ void BaseSqlTableModel::select() {
     // should not disturb that if we are only removing tracks.
     std::stable_sort(rowInfos.begin(), rowInfos.end());
 
-    TrackId2Rows trackIdToRows;
-    // We expect almost all rows to be valid and that only a few tracks
-    // are contained multiple times in rowInfos (e.g. in history playlists)
-    trackIdToRows.reserve(rowInfos.size());
-    for (int i = 0; i < rowInfos.size(); ++i) {
-        const RowInfo& rowInfo = rowInfos[i];
-
-        if (rowInfo.order == -1) {
-            // We've reached the end of valid rows. Resize rowInfo to cut off
-            // this and all further elements.
-            rowInfos.resize(i);
-            break;
-        }
-        trackIdToRows[rowInfo.trackId].push_back(i);
-    }
-    // The number of unique tracks cannot be greater than the
-    // number of total rows returned by the query
-    DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
+    // Cut off all rows that are no longer present
+    const auto firstRemoved = std::find_if(rowInfos.cbegin(),
+            rowInfos.cend(),
+            [](const RowInfo& rowInfo) {
+                return rowInfo.order == -1;
+            });
+    rowInfos.resize(static_cast<int>(firstRemoved - rowInfos.cbegin()));
 
-    // We're done! Issue the update signals and replace the main maps.
-    replaceRows(
-            std::move(rowInfos),
-            std::move(trackIdToRows));
-    // Both rowInfo and trackIdToRows (might) have been moved and
-    // must not be used afterwards!
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
 
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
+    // We're done! Issue the update signals and replace the rows.
+    replaceRows(std::move(rowInfos));
+    // rowInfos (might) have been moved and must not be used afterwards!
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -348,6 +582,7 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    cancelAsyncSelect();
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
@@ -422,6 +657,18 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
     select();
 }
 
+void BaseSqlTableModel::searchAsync(const QString& searchText,
+        const std::function<void()>& onSearchFinished) {
+    if (sDebug) {
+        qDebug() << this << "searchAsync" << searchText;
+    }
+    setSearch(searchText);
+    if (!selectAsync(onSearchFinished)) {
+        select();
+        onSearchFinished();
+    }
+}
+
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
     if (sDebug) {
         qDebug() << this << "setSort()" << column << order << m_tableColumns;
@@ -640,8 +887,7 @@ QVariant BaseSqlTableModel::rawValue(
     DEBUG_ASSERT(column >= 0);
     // TODO(rryan) check range on column
 
-    const RowInfo& rowInfo = m_rowInfo[row];
-    const TrackId trackId = rowInfo.trackId;
+    const TrackId trackId = m_rowInfo[row].trackId;
 
     // If the row info has the row-specific column, return that.
     if (column < m_tableColumns.size()) {
@@ -651,13 +897,7 @@ QVariant BaseSqlTableModel::rawValue(
             return previewDeckTrackId() == trackId;
         }
 
-        const QVector<QVariant>& columns = rowInfo.metadata;
-        if (sDebug) {
-            qDebug() << "Returning table-column value"
-                    << columns.at(column)
-                    << "for column" << column;
-        }
-        return columns[column];
+        return tableColumnValue(row, column);
     }
 
     // Otherwise, return the information from the track record cache for the
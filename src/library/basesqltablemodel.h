@@ -1,18 +1,26 @@
 #pragma once
 
+#include <gtest/gtest_prod.h>
+
 #include <QHash>
 #include <QtSql>
+#include <functional>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
+#include "library/libraryqueryexecutor.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
-// BaseSqlTableModel is a custom-written SQL-backed table which aggressively
-// caches the contents of the table and supports lightweight updates.
+// BaseSqlTableModel is a custom-written SQL-backed table which supports
+// lightweight updates. Only the track ids of the result set are kept for
+// all rows. The row-specific table columns are fetched lazily in pages of
+// consecutive rows when they are accessed, i.e. for the rows around the
+// visible viewport, and only a limited number of those pages is cached.
 class BaseSqlTableModel : public BaseTrackTableModel {
     Q_OBJECT
   public:
@@ -22,6 +30,11 @@ class BaseSqlTableModel : public BaseTrackTableModel {
             const char* settingsNamespace);
     ~BaseSqlTableModel() override;
 
+    // Row-specific table columns are fetched and cached in pages
+    // of consecutive rows, i.e. for the visible rows of the view.
+    static constexpr int kRowsPerMetadataPage = 256;
+    static constexpr int kMaxCachedMetadataPages = 16;
+
     // Returns true if the BaseSqlTableModel has been initialized. Calling data
     // access methods on a BaseSqlTableModel which is not initialized is likely
     // to cause instability / crashes.
@@ -53,11 +66,11 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     CoverInfo getCoverInfo(const QModelIndex& index) const override;
 
-    const QVector<int> getTrackRows(TrackId trackId) const override {
-        return m_trackIdToRows.value(trackId);
-    }
+    const QVector<int> getTrackRows(TrackId trackId) const override;
 
     void search(const QString& searchText, const QString& extraFilter = QString()) override;
+    void searchAsync(const QString& searchText,
+            const std::function<void()>& onSearchFinished) override;
     const QString currentSearch() const override;
 
     TrackModel::SortColumnId sortColumnIdFromColumnIndex(int column) const override;
@@ -109,6 +122,10 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void slotQueryFinished(
+            int channel,
+            quint64 generation,
+            const LibraryQueryExecutor::Results& results);
 
   private:
     void setTrackValueForColumn(
@@ -122,7 +139,10 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     struct RowInfo {
         TrackId trackId;
         int order;
-        QVector<QVariant> metadata;
+        // Tracks might appear multiple times in a table, e.g. in
+        // playlists. The n-th row of a track in the table is used
+        // for looking up the corresponding row-specific columns.
+        int occurrence;
 
         bool operator<(const RowInfo& other) const {
             // -1 is greater than anything
@@ -137,24 +157,59 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
 
+    typedef QVector<QVector<QVariant>> RowMetadataPage;
+
     void clearRows();
     void replaceRows(
+            QVector<RowInfo>&& rows);
+    QVector<RowInfo> createRows(
+            const QVector<TrackId>& tableTrackIds,
+            QSet<TrackId>* pTrackIds) const;
+    void sortAndReplaceRows(
             QVector<RowInfo>&& rows,
-            TrackId2Rows&& trackIdToRows);
+            const QHash<TrackId, int>* pTrackSortOrder);
+
+    // Executes the queries of select() on the worker thread of the
+    // query executor. Returns false if not supported, e.g. if the
+    // table is not accessible from other database connections.
+    bool selectAsync(const std::function<void()>& onSelectFinished);
+    void cancelAsyncSelect();
+    bool temporaryViews(
+            QList<LibraryQueryExecutor::TemporaryView>* pTemporaryViews) const;
+
+    QVariant tableColumnValue(int row, int column) const;
+    const RowMetadataPage& fetchRowMetadataPage(int page) const;
+    void clearRowMetadataPages() const;
 
     QVector<RowInfo> m_rowInfo;
 
+    // Both the reverse lookup of rows and the pages with the row-specific
+    // table columns are populated lazily on demand.
+    mutable TrackId2Rows m_trackIdToRows;
+    mutable bool m_trackIdToRowsValid;
+    mutable QHash<int, RowMetadataPage> m_rowMetadataPages;
+    // Least recently used page first
+    mutable QVector<int> m_rowMetadataPageLru;
+
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
     QStringList m_tableColumns;
     QList<SortColumn> m_sortColumns;
     bool m_bInitialized;
-    QHash<TrackId, int> m_trackSortOrder;
-    TrackId2Rows m_trackIdToRows;
     QString m_currentSearch;
     QString m_currentSearchFilter;
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    LibraryQueryExecutor* const m_pQueryExecutor;
+    int m_queryChannel;
+    // 0 if no asynchronous select is pending
+    quint64 m_asyncSelectGeneration;
+    std::function<void()> m_onAsyncSelectFinished;
+    PerformanceTimer m_asyncSelectTimer;
+
+    FRIEND_TEST(BaseSqlTableModelTest, evictLeastRecentlyUsedMetadataPages);
+    FRIEND_TEST(BaseSqlTableModelTest, dropMetadataPagesOnSelect);
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
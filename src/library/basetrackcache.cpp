@@ -119,7 +119,7 @@ const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCacheLookup::lookupTrackById(trackId);
             replaceRecentTrack(
                     std::move(trackId),
                     std::move(trackPtr));
@@ -453,37 +453,16 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 
     QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
+    idStrings.reserve(trackIds.size());
     for (const auto& trackId: trackIds) {
         idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
     }
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            QString("%1 in (%2)").arg(m_idColumn, idStrings.join(",")),
+            searchQuery,
+            extraFilter);
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    QString queryString = filterAndSortQueryString(*pQuery, orderByClause);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -519,6 +498,96 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         m_trackOrder.append(trackId);
     }
 
+    updateDirtyTracksInOrder(trackIds,
+            *pQuery,
+            searchQuery,
+            sortColumns,
+            columnOffset,
+            trackToIndex);
+}
+
+QString BaseTrackCache::filterAndSortQuery(
+        const QString& trackIdsFilter,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause) {
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            trackIdsFilter,
+            searchQuery,
+            extraFilter);
+    return filterAndSortQueryString(*pQuery, orderByClause);
+}
+
+void BaseTrackCache::filterAndSortSelected(const QSet<TrackId>& trackIds,
+        const QVector<TrackId>& selectedTrackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
+    m_trackOrder.resize(0); // keeps allocated memory
+    m_trackOrder.reserve(selectedTrackIds.size());
+    trackToIndex->clear();
+    trackToIndex->reserve(selectedTrackIds.size());
+    for (const auto& trackId : selectedTrackIds) {
+        (*trackToIndex)[trackId] = m_trackOrder.size();
+        m_trackOrder.append(trackId);
+    }
+
+    if (!m_bIsCaching || trackIds.isEmpty()) {
+        return;
+    }
+
+    // The filter for the track ids has already been applied by the
+    // query. Only the search query is needed for matching dirty tracks.
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            QString(),
+            searchQuery,
+            extraFilter);
+    updateDirtyTracksInOrder(trackIds,
+            *pQuery,
+            searchQuery,
+            sortColumns,
+            columnOffset,
+            trackToIndex);
+}
+
+std::unique_ptr<QueryNode> BaseTrackCache::parseFilterQuery(
+        const QString& trackIdsFilter,
+        const QString& searchQuery,
+        const QString& extraFilter) const {
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (!trackIdsFilter.isEmpty()) {
+        queryFragments << trackIdsFilter;
+    }
+    return m_pQueryParser->parseQuery(
+            searchQuery,
+            queryFragments.join(" AND "));
+}
+
+QString BaseTrackCache::filterAndSortQueryString(
+        const QueryNode& query,
+        const QString& orderByClause) const {
+    QString filter = query.toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+}
+
+void BaseTrackCache::updateDirtyTracksInOrder(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& searchQuery,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
     // At this point, the original set of tracks have been divided into two
     // pieces: those that should be in the result set and those that should
     // not. Unfortunately, due to TrackDAO caching, there may be tracks in
@@ -528,7 +597,17 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     // membership of tracks in either set, we must then insertion-sort the
     // missing tracks into the resulting index list.
 
-    if (!m_bIsCaching || dirtyTracks.isEmpty()) {
+    if (!m_bIsCaching) {
+        return;
+    }
+
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId : qAsConst(m_dirtyTracks)) {
+        if (trackIds.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
+    }
+    if (dirtyTracks.isEmpty()) {
         return;
     }
 
@@ -544,7 +623,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         // The track should be in the result set if the search is empty or the
         // track matches the search.
         bool shouldBeInResultSet = searchQuery.isEmpty() ||
-                pQuery->match(pTrack);
+                query.match(pTrack);
 
         // If the track is in this result set.
         bool isInResultSet = trackToIndex->contains(trackId);
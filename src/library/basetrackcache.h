@@ -16,6 +16,7 @@
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -71,6 +72,30 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+
+    /// Split filterAndSort() into two steps for executing the query on a
+    /// different thread and database connection. The returned query selects
+    /// the ids of all matching tracks in sort order. Its results must then
+    /// be passed to filterAndSortSelected() on the thread of this cache.
+    QString filterAndSortQuery(const QString& trackIdsFilter,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& orderByClause);
+    void filterAndSortSelected(const QSet<TrackId>& trackIds,
+            const QVector<TrackId>& selectedTrackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+
+    const QString& tableName() const {
+        return m_tableName;
+    }
+    const QString& idColumn() const {
+        return m_idColumn;
+    }
+
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
@@ -99,6 +124,20 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    std::unique_ptr<QueryNode> parseFilterQuery(
+            const QString& trackIdsFilter,
+            const QString& searchQuery,
+            const QString& extraFilter) const;
+    QString filterAndSortQueryString(
+            const QueryNode& query,
+            const QString& orderByClause) const;
+    void updateDirtyTracksInOrder(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& searchQuery,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
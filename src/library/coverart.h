@@ -163,7 +163,8 @@ class CoverInfo : public CoverInfoRelative {
         QImage image;
 
         /// Either the track location if the image was embedded in
-        /// the metadata or the location of the image file.
+        /// the metadata, the location of the image file, or the
+        /// location of the thumbnail file if loaded from disk cache.
         QString location;
 
         /// The result of the operation.
@@ -171,6 +172,7 @@ class CoverInfo : public CoverInfoRelative {
 
       private:
         friend class CoverArt;
+        friend class CoverArtCache;
         friend class CoverInfo;
         LoadedImage(Result result)
                 : result(result) {
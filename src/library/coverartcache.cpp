@@ -148,7 +148,8 @@ QPixmap CoverArtCache::tryLoadCover(
             pTrack,
             coverInfo,
             desiredWidth,
-            loading == Loading::Default);
+            loading == Loading::Default,
+            m_pThumbnailCache);
     connect(watcher,
             &QFutureWatcher<FutureResult>::finished,
             this,
@@ -163,7 +164,8 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
         int desiredWidth,
-        bool signalWhenDone) {
+        bool signalWhenDone,
+        CoverArtThumbnailCachePointer pThumbnailCache) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -180,6 +182,37 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             signalWhenDone);
     DEBUG_ASSERT(!res.coverInfoUpdated);
 
+    const int thumbnailWidth = pThumbnailCache
+            ? CoverArtThumbnailCache::thumbnailWidth(desiredWidth)
+            : 0;
+    if (thumbnailWidth > 0 && !coverInfo.imageDigest().isEmpty()) {
+        // The thumbnail is keyed by the digest of the original image.
+        // It is served without accessing the audio or image file.
+        QImage thumbnail = pThumbnailCache->loadThumbnail(
+                coverInfo.imageDigest(), thumbnailWidth);
+        if (!thumbnail.isNull()) {
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << "loadCover thumbnail hit"
+                        << coverInfo
+                        << thumbnailWidth;
+            }
+            auto loadedImage = CoverInfo::LoadedImage(
+                    CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.location = pThumbnailCache->thumbnailFilePath(
+                    coverInfo.imageDigest(), thumbnailWidth);
+            if (thumbnail.width() > desiredWidth) {
+                thumbnail = resizeImageWidth(thumbnail, desiredWidth);
+            }
+            loadedImage.image = std::move(thumbnail);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     auto loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
         // Refresh hash before resizing the original image!
@@ -191,6 +224,13 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             pTrack->setCoverInfo(coverInfo);
         }
 
+        // Populate the thumbnail cache from the original image
+        // while it is available.
+        if (thumbnailWidth > 0 && !coverInfo.imageDigest().isEmpty()) {
+            pThumbnailCache->storeAllThumbnails(
+                    coverInfo.imageDigest(), loadedImage.image);
+        }
+
         // Resize image to requested size
         if (desiredWidth > 0) {
             // Adjust the cover size according to the request
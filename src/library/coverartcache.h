@@ -7,6 +7,7 @@
 #include <QtDebug>
 
 #include "library/coverart.h"
+#include "library/coverartthumbnailcache.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
@@ -52,6 +53,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
                 loading);
     }
 
+    /// Enable the persistent thumbnail cache on disk. Covers that are
+    /// requested with a width that fits into one of the thumbnails are
+    /// then loaded from the thumbnail instead of the original image.
+    void setThumbnailCache(
+            CoverArtThumbnailCachePointer pThumbnailCache) {
+        m_pThumbnailCache = std::move(pThumbnailCache);
+    }
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -84,7 +93,8 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             TrackPointer pTrack,
             CoverInfo coverInfo,
             int desiredWidth,
-            bool emitSignals);
+            bool emitSignals,
+            CoverArtThumbnailCachePointer pThumbnailCache = nullptr);
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -117,6 +127,8 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             Loading loading);
 
     QSet<QPair<const QObject*, mixxx::cache_key_t>> m_runningRequests;
+
+    CoverArtThumbnailCachePointer m_pThumbnailCache;
 };
 
 inline
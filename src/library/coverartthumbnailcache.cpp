@@ -0,0 +1,209 @@
+#include "library/coverartthumbnailcache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <array>
+
+#include "util/assert.h"
+#include "util/disklrueviction.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtThumbnailCache");
+
+// Covers the typical widths of the cover art column in the library
+// table, the cover art widgets of the decks, and the cover art
+// sidebar, including high DPI screens.
+constexpr std::array<int, 4> kThumbnailWidths = {64, 128, 256, 512};
+
+// Opaque images are stored as JPEG, which is much smaller than PNG
+// for photographic content. PNG is only used for preserving the
+// alpha channel. The format is detected when loading the data.
+const char* const kOpaqueImageFormat = "JPG";
+const char* const kAlphaImageFormat = "PNG";
+constexpr int kJpegQuality = 90;
+
+// The transformation mode when scaling images
+const Qt::TransformationMode kTransformationMode = Qt::SmoothTransformation;
+
+const ConfigKey kMaxSizeConfigKey =
+        ConfigKey(QStringLiteral("[Library]"),
+                QStringLiteral("CoverArtThumbnailCacheSizeMB"));
+
+// About 10k covers with thumbnails for all widths
+constexpr int kDefaultMaxSizeMB = 1024;
+
+} // anonymous namespace
+
+CoverArtThumbnailCache::CoverArtThumbnailCache(
+        QString rootPath,
+        qint64 maxSizeInBytes)
+        : m_pEviction(std::make_shared<mixxx::DiskLruEviction>(
+                  std::move(rootPath),
+                  // Thumbnails are stored without a suffix
+                  QString(),
+                  maxSizeInBytes)) {
+}
+
+const QString& CoverArtThumbnailCache::rootPath() const {
+    return m_pEviction->rootPath();
+}
+
+//static
+QString CoverArtThumbnailCache::defaultRootPath(
+        const QString& settingsPath) {
+    return QDir(settingsPath).filePath(QStringLiteral("covers"));
+}
+
+//static
+qint64 CoverArtThumbnailCache::maxSizeInBytes(
+        const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(kMaxSizeConfigKey, kDefaultMaxSizeMB) *
+            qint64{1024 * 1024};
+}
+
+//static
+int CoverArtThumbnailCache::thumbnailWidth(int desiredWidth) {
+    if (desiredWidth <= 0) {
+        // Original size
+        return 0;
+    }
+    for (const int width : kThumbnailWidths) {
+        if (desiredWidth <= width) {
+            return width;
+        }
+    }
+    return 0;
+}
+
+QString CoverArtThumbnailCache::thumbnailFilePath(
+        const QByteArray& imageDigest,
+        int thumbnailWidth) const {
+    DEBUG_ASSERT(!imageDigest.isEmpty());
+    DEBUG_ASSERT(thumbnailWidth > 0);
+    const auto fileName = QString::fromLatin1(imageDigest.toHex());
+    // Spread the files among subdirectories to keep the number of
+    // entries per directory small
+    return QStringLiteral("%1/%2/%3/%4")
+            .arg(rootPath(),
+                    QString::number(thumbnailWidth),
+                    fileName.left(2),
+                    fileName);
+}
+
+QImage CoverArtThumbnailCache::loadThumbnail(
+        const QByteArray& imageDigest,
+        int thumbnailWidth) const {
+    if (imageDigest.isEmpty() || thumbnailWidth <= 0) {
+        return QImage();
+    }
+    const auto filePath = thumbnailFilePath(imageDigest, thumbnailWidth);
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not available yet
+        return QImage();
+    }
+    mixxx::DiskLruEviction::touch(filePath);
+    const qint64 size = file.size();
+    if (size <= 0) {
+        return QImage();
+    }
+    // Decode directly from the mapped file without copying its
+    // contents into an intermediate buffer
+    QImage thumbnail;
+    uchar* pData = file.map(0, size);
+    if (pData) {
+        thumbnail.loadFromData(pData, static_cast<int>(size));
+        file.unmap(pData);
+    } else {
+        thumbnail.loadFromData(file.readAll());
+    }
+    if (thumbnail.isNull()) {
+        kLogger.warning()
+                << "Failed to decode thumbnail"
+                << file.fileName();
+    }
+    return thumbnail;
+}
+
+bool CoverArtThumbnailCache::containsAllThumbnails(
+        const QByteArray& imageDigest) const {
+    if (imageDigest.isEmpty()) {
+        return false;
+    }
+    for (const int width : kThumbnailWidths) {
+        if (!QFileInfo::exists(thumbnailFilePath(imageDigest, width))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CoverArtThumbnailCache::storeAllThumbnails(
+        const QByteArray& imageDigest,
+        const QImage& originalImage) const {
+    VERIFY_OR_DEBUG_ASSERT(!imageDigest.isEmpty()) {
+        return false;
+    }
+    if (originalImage.isNull()) {
+        return false;
+    }
+    // Scale down successively starting with the largest thumbnail,
+    // which is much faster than scaling the original image for
+    // each width and results in the same quality.
+    bool success = true;
+    QImage thumbnail = originalImage;
+    for (auto it = kThumbnailWidths.rbegin(); it != kThumbnailWidths.rend(); ++it) {
+        const int width = *it;
+        if (thumbnail.width() > width) {
+            thumbnail = thumbnail.scaledToWidth(width, kTransformationMode);
+        }
+        const auto filePath = thumbnailFilePath(imageDigest, width);
+        if (QFileInfo::exists(filePath)) {
+            continue;
+        }
+        if (!storeThumbnail(filePath, thumbnail)) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+void CoverArtThumbnailCache::evictLeastRecentlyUsed() const {
+    m_pEviction->evict();
+}
+
+bool CoverArtThumbnailCache::storeThumbnail(
+        const QString& filePath,
+        const QImage& thumbnail) const {
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory for thumbnail"
+                << filePath;
+        return false;
+    }
+    // Concurrent readers will either see the previous or the
+    // complete file, but never a partially written file.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open thumbnail file for writing"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    const bool saved = thumbnail.hasAlphaChannel()
+            ? thumbnail.save(&file, kAlphaImageFormat)
+            : thumbnail.save(&file, kOpaqueImageFormat, kJpegQuality);
+    if (!saved || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write thumbnail file"
+                << filePath;
+        return false;
+    }
+    m_pEviction->fileStored(QFileInfo(filePath).size());
+    return true;
+}
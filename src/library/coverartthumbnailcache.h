@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <memory>
+
+#include "preferences/usersettings.h"
+
+namespace mixxx {
+class DiskLruEviction;
+} // namespace mixxx
+
+/// Persistent store for downscaled cover art images on disk.
+///
+/// Thumbnails are keyed by the digest of the original image content
+/// and are generated for a few standard widths. Requests for other
+/// widths are served from the next larger thumbnail. The files are
+/// written atomically and could be shared between concurrent readers
+/// and writers, i.e. all operations are thread-safe.
+///
+/// Thumbnails are stored compressed. Uncompressed pixel data could be
+/// mapped directly into memory, but would require about 10 GB for the
+/// largest thumbnail size of a library with 40k tracks.
+///
+/// The least recently used thumbnails are evicted when the total size
+/// exceeds the limit. Evicted thumbnails are generated again when needed.
+class CoverArtThumbnailCache final {
+  public:
+    CoverArtThumbnailCache(
+            QString rootPath,
+            qint64 maxSizeInBytes);
+
+    /// The default location of the thumbnails within the settings
+    /// directory.
+    static QString defaultRootPath(
+            const QString& settingsPath);
+
+    /// The configured size limit of the thumbnails
+    static qint64 maxSizeInBytes(
+            const UserSettingsPointer& pConfig);
+
+    const QString& rootPath() const;
+
+    /// Returns the width of the smallest thumbnail that is at least
+    /// as wide as the desired width or 0 if the desired width exceeds
+    /// the largest thumbnail.
+    static int thumbnailWidth(int desiredWidth);
+
+    /// Returns a null image if the thumbnail is not available.
+    QImage loadThumbnail(
+            const QByteArray& imageDigest,
+            int thumbnailWidth) const;
+
+    /// Check if thumbnails for all standard widths are available.
+    bool containsAllThumbnails(
+            const QByteArray& imageDigest) const;
+
+    /// Downscale the original image and store the thumbnails for
+    /// all standard widths that are missing.
+    bool storeAllThumbnails(
+            const QByteArray& imageDigest,
+            const QImage& originalImage) const;
+
+    QString thumbnailFilePath(
+            const QByteArray& imageDigest,
+            int thumbnailWidth) const;
+
+    /// Delete the least recently used thumbnails until the total size
+    /// no longer exceeds the limit. This is done implicitly when storing
+    /// thumbnails exceeds the limit.
+    void evictLeastRecentlyUsed() const;
+
+  private:
+    bool storeThumbnail(
+            const QString& filePath,
+            const QImage& thumbnail) const;
+
+    const std::shared_ptr<mixxx::DiskLruEviction> m_pEviction;
+};
+
+typedef std::shared_ptr<const CoverArtThumbnailCache> CoverArtThumbnailCachePointer;
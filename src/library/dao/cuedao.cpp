@@ -149,33 +149,56 @@ bool CueDAO::deleteCuesForTracks(const QList<TrackId>& trackIds) const {
     return false;
 }
 
+void CueDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+    finish();
+}
+
+void CueDAO::finish() {
+    m_pQueryCueUpdate.reset();
+    m_pQueryCueInsert.reset();
+}
+
 bool CueDAO::saveCue(TrackId trackId, Cue* cue) const {
     //qDebug() << "CueDAO::saveCue" << QThread::currentThread() << m_database.connectionName();
     VERIFY_OR_DEBUG_ASSERT(cue) {
         return false;
     }
 
-    // Prepare query
-    QSqlQuery query(m_database);
+    // Prepare query only once
+    std::unique_ptr<QSqlQuery>& pQuery =
+            cue->getId().isValid() ? m_pQueryCueUpdate : m_pQueryCueInsert;
+    if (!pQuery) {
+        pQuery = std::make_unique<QSqlQuery>(m_database);
+        bool prepared;
+        if (cue->getId().isValid()) {
+            // Update cue
+            prepared = pQuery->prepare(QStringLiteral("UPDATE " CUE_TABLE " SET "
+                                                      "track_id=:track_id,"
+                                                      "type=:type,"
+                                                      "position=:position,"
+                                                      "length=:length,"
+                                                      "hotcue=:hotcue,"
+                                                      "label=:label,"
+                                                      "color=:color"
+                                                      " WHERE id=:id"));
+        } else {
+            // New cue
+            prepared = pQuery->prepare(
+                    QStringLiteral("INSERT INTO " CUE_TABLE
+                                   " (track_id, type, position, length, hotcue, "
+                                   "label, color) VALUES (:track_id, :type, "
+                                   ":position, :length, :hotcue, :label, :color)"));
+        }
+        if (!prepared) {
+            LOG_FAILED_QUERY(*pQuery);
+            pQuery.reset();
+            return false;
+        }
+    }
+    QSqlQuery& query = *pQuery;
     if (cue->getId().isValid()) {
-        // Update cue
-        query.prepare(QStringLiteral("UPDATE " CUE_TABLE " SET "
-                        "track_id=:track_id,"
-                        "type=:type,"
-                        "position=:position,"
-                        "length=:length,"
-                        "hotcue=:hotcue,"
-                        "label=:label,"
-                        "color=:color"
-                        " WHERE id=:id"));
         query.bindValue(":id", cue->getId().toVariant());
-    } else {
-        // New cue
-        query.prepare(
-                QStringLiteral("INSERT INTO " CUE_TABLE
-                               " (track_id, type, position, length, hotcue, "
-                               "label, color) VALUES (:track_id, :type, "
-                               ":position, :length, :hotcue, :label, :color)"));
     }
 
     // Bind values and execute query
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <memory>
 
 #include "library/dao/dao.h"
 #include "track/cue.h"
@@ -14,6 +16,9 @@ class CueDAO : public DAO {
   public:
     ~CueDAO() override = default;
 
+    void initialize(const QSqlDatabase& database) override;
+    void finish();
+
     QList<CuePointer> getCuesForTrack(TrackId trackId) const;
 
     void saveTrackCues(TrackId trackId, const QList<CuePointer>& cueList) const;
@@ -22,4 +27,8 @@ class CueDAO : public DAO {
 
   private:
     bool saveCue(TrackId trackId, Cue* pCue) const;
+
+    // Reused for saving cues, prepared on first use
+    mutable std::unique_ptr<QSqlQuery> m_pQueryCueUpdate;
+    mutable std::unique_ptr<QSqlQuery> m_pQueryCueInsert;
 };
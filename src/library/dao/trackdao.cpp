@@ -7,6 +7,7 @@
 #include <QImage>
 #include <QtDebug>
 #include <QtSql>
+#include <optional>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -39,6 +40,7 @@
 #include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/performancetimer.h"
 #include "util/qt.h"
 #include "util/timer.h"
 
@@ -48,6 +50,19 @@ mixxx::Logger kLogger("TrackDAO");
 
 enum { UndefinedRecordIndex = -2 };
 
+// Evicted tracks are usually saved in bursts, e.g. after editing
+// or analyzing many tracks at once. Wait a moment for collecting
+// them before writing all of them in a single transaction.
+constexpr int kPendingTrackUpdatesDelayMillis = 200;
+
+// Limits both the memory consumption and the duration of a
+// single write transaction.
+constexpr int kMaxPendingTrackUpdates = 500;
+
+// Failed updates are retried with the next batch, e.g. if the
+// database has been locked temporarily.
+constexpr int kMaxTrackUpdateAttempts = 3;
+
 void markTrackLocationsAsDeleted(const QSqlDatabase& database, const QString& directory) {
     //qDebug() << "TrackDAO::markTrackLocationsAsDeleted" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(database);
@@ -94,6 +109,12 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
           m_queryLibraryMixxxDeletedColumn(UndefinedRecordIndex) {
+    m_pendingTrackUpdatesTimer.setSingleShot(true);
+    m_pendingTrackUpdatesTimer.setInterval(kPendingTrackUpdatesDelayMillis);
+    connect(&m_pendingTrackUpdatesTimer,
+            &QTimer::timeout,
+            this,
+            &TrackDAO::flushPendingTrackUpdates);
     connect(&m_playlistDao,
             &PlaylistDAO::tracksRemovedFromPlayedHistory,
             this,
@@ -110,13 +131,28 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
 
 TrackDAO::~TrackDAO() {
     qDebug() << "~TrackDAO()";
+    DEBUG_ASSERT(m_pendingTrackUpdates.isEmpty());
     //clear all leftover Transactions and rollback the db
     addTracksFinish(true);
 }
 
+void TrackDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+    m_pQueryLibraryUpdateTrack.reset();
+}
+
 void TrackDAO::finish() {
     qDebug() << "TrackDAO::finish()";
 
+    // All evicted tracks must have been written before closing
+    // the database. This includes the tracks that have been evicted
+    // when deactivating the GlobalTrackCache on shutdown. Failed
+    // updates are retried immediately, the timer won't fire anymore.
+    while (!m_pendingTrackUpdates.isEmpty()) {
+        flushPendingTrackUpdates();
+    }
+    m_pQueryLibraryUpdateTrack.reset();
+
     // clear out played information on exit
     // crash prevention: if mixxx crashes, played information will be maintained
     qDebug() << "Clearing played information for this session";
@@ -332,6 +368,114 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
     return true;
 }
 
+bool TrackDAO::saveEvictedTrack(Track* pTrack) const {
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return false;
+    }
+    DEBUG_ASSERT(pTrack->isDirty());
+
+    const TrackId trackId = pTrack->getId();
+    DEBUG_ASSERT(trackId.isValid());
+    qDebug() << "TrackDAO: Deferring save of evicted track"
+             << trackId
+             << pTrack->getLocation();
+    // Replaces a pending update of the same track, because
+    // it contains all properties of the latest version.
+    m_pendingTrackUpdates.insert(trackId, TrackUpdate(*pTrack));
+    pTrack->markClean();
+
+    if (m_pendingTrackUpdates.size() >= kMaxPendingTrackUpdates) {
+        flushPendingTrackUpdates();
+    } else if (!m_pendingTrackUpdatesTimer.isActive()) {
+        m_pendingTrackUpdatesTimer.start();
+    }
+    return true;
+}
+
+void TrackDAO::flushPendingTrackUpdates() const {
+    m_pendingTrackUpdatesTimer.stop();
+    if (m_pendingTrackUpdates.isEmpty()) {
+        return;
+    }
+    // Detach the pending updates before writing them, because
+    // signal receivers might evict and save tracks again.
+    const auto pendingTrackUpdates = std::move(m_pendingTrackUpdates);
+    m_pendingTrackUpdates.clear();
+
+    PerformanceTimer timer;
+    timer.start();
+
+    // While adding tracks the updates become part of the
+    // ongoing transaction. Nested transactions are not supported.
+    std::optional<SqlTransaction> transaction;
+    if (!m_pTransaction) {
+        transaction.emplace(m_database);
+    }
+    QList<TrackId> savedTrackIds;
+    savedTrackIds.reserve(pendingTrackUpdates.size());
+    for (auto i = pendingTrackUpdates.constBegin();
+            i != pendingTrackUpdates.constEnd();
+            ++i) {
+        // A single failed update doesn't abort the transaction
+        // and must not discard the remaining updates.
+        if (writeTrackUpdate(i.key(), i.value())) {
+            savedTrackIds.append(i.key());
+        } else {
+            kLogger.warning()
+                    << "Failed to save evicted track"
+                    << i.key()
+                    << i.value().location;
+            retryTrackUpdate(i.key(), i.value());
+        }
+    }
+    if (transaction && !transaction->commit()) {
+        kLogger.warning()
+                << "Failed to save"
+                << pendingTrackUpdates.size()
+                << "evicted track(s)";
+        // All updates have been rolled back
+        for (const auto& trackId : std::as_const(savedTrackIds)) {
+            retryTrackUpdate(trackId, *pendingTrackUpdates.constFind(trackId));
+        }
+        return;
+    }
+    kLogger.debug()
+            << "Saved"
+            << savedTrackIds.size()
+            << "evicted track(s) in"
+            << timer.elapsed().debugMillisWithUnit();
+
+    // BaseTrackCache must be informed separately, because the
+    // tracks have already been disconnected. See also: saveTrack()
+    for (const auto& trackId : std::as_const(savedTrackIds)) {
+        emit mixxx::thisAsNonConst(this)->trackClean(trackId);
+    }
+}
+
+void TrackDAO::retryTrackUpdate(
+        TrackId trackId,
+        TrackUpdate trackUpdate) const {
+    if (++trackUpdate.failedAttempts >= kMaxTrackUpdateAttempts) {
+        kLogger.warning()
+                << "Discarding changes of evicted track"
+                << trackId
+                << trackUpdate.location
+                << "after"
+                << trackUpdate.failedAttempts
+                << "failed attempts";
+        return;
+    }
+    // A newer update of the same track that has been deferred
+    // in the meantime contains all changes
+    if (m_pendingTrackUpdates.contains(trackId)) {
+        return;
+    }
+    m_pendingTrackUpdates.insert(trackId, std::move(trackUpdate));
+    if (!m_pendingTrackUpdatesTimer.isActive()) {
+        m_pendingTrackUpdatesTimer.start();
+    }
+}
+
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
     if (!changedTrackIds.isEmpty()) {
         emit tracksChanged(changedTrackIds);
@@ -363,6 +507,8 @@ void TrackDAO::slotDatabaseTracksRelocated(const QList<RelocatedTrack>& relocate
 }
 
 void TrackDAO::addTracksPrepare() {
+    // Must be written before starting the transaction
+    flushPendingTrackUpdates();
     if (m_pQueryLibraryInsert || m_pQueryTrackLocationInsert ||
             m_pQueryLibrarySelect || m_pQueryTrackLocationSelect ||
             m_pTransaction) {
@@ -994,6 +1140,8 @@ bool TrackDAO::onPurgingTracks(
     if (trackIds.empty()) {
         return true; // nothing to do
     }
+    // Prevent that pending updates of purged tracks fail afterwards
+    flushPendingTrackUpdates();
 
     QStringList idList;
     idList.reserve(trackIds.size());
@@ -1303,12 +1451,16 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return nullptr;
     }
 
-    // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    // The GlobalTrackCache is not locked if the track is cached.
+    TrackPointer pTrack = GlobalTrackCacheLookup::lookupTrackById(trackId);
     if (pTrack) {
         return pTrack;
     }
 
+    // The track might have been evicted recently and the database
+    // must be up-to-date before restoring it.
+    flushPendingTrackUpdates();
+
     constexpr ColumnPopulator columns[] = {
             // Location must be first and is populated manually!
             {"track_locations.location", nullptr},
@@ -1573,7 +1725,7 @@ TrackId TrackDAO::getTrackIdByRef(
     if (trackRef.getId().isValid()) {
         return trackRef.getId();
     }
-    const auto pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    const auto pTrack = GlobalTrackCacheLookup::lookupTrackByRef(trackRef);
     if (pTrack) {
         const auto trackId = pTrack->getId();
         DEBUG_ASSERT(trackId.isValid());
@@ -1587,7 +1739,7 @@ TrackPointer TrackDAO::getTrackByRef(
     if (!trackRef.isValid()) {
         return nullptr;
     }
-    const auto pTrack = GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+    const auto pTrack = GlobalTrackCacheLookup::lookupTrackByRef(trackRef);
     if (pTrack) {
         return pTrack;
     }
@@ -1602,6 +1754,15 @@ TrackPointer TrackDAO::getTrackByRef(
     return getTrackById(trackId);
 }
 
+TrackDAO::TrackUpdate::TrackUpdate(const Track& track)
+        : location(track.getLocation()),
+          trackRecord(track.getRecord()),
+          pBeats(track.getBeats()),
+          pWaveform(track.getWaveform()),
+          pWaveformSummary(track.getWaveformSummary()),
+          cuePoints(track.getCuePoints()) {
+}
+
 // Saves a track's info back to the database
 bool TrackDAO::updateTrack(const Track& track) const {
     const TrackId trackId = track.getId();
@@ -1613,67 +1774,80 @@ bool TrackDAO::updateTrack(const Track& track) const {
              << track.getLocation();
 
     SqlTransaction transaction(m_database);
-    // PerformanceTimer time;
-    // time.start();
+    if (!writeTrackUpdate(trackId, TrackUpdate(track))) {
+        return false;
+    }
+    transaction.commit();
+    return true;
+}
 
-    QSqlQuery query(m_database);
+bool TrackDAO::writeTrackUpdate(
+        TrackId trackId,
+        const TrackUpdate& trackUpdate) const {
+    DEBUG_ASSERT(trackId.isValid());
 
-    // Update everything but "location", since that's what we identify the track by.
-    query.prepare(
-            "UPDATE library SET "
-            "artist=:artist,"
-            "title=:title,"
-            "album=:album,"
-            "album_artist=:album_artist,"
-            "year=:year,"
-            "genre=:genre,"
-            "composer=:composer,"
-            "grouping=:grouping,"
-            "filetype=:filetype,"
-            "tracknumber=:tracknumber,"
-            "tracktotal=:tracktotal,"
-            "color=:color,"
-            "comment=:comment,"
-            "url=:url,"
-            "rating=:rating,"
-            "key=:key,"
-            "key_id=:key_id,"
-            "cuepoint=:cuepoint,"
-            "bpm=:bpm,"
-            "replaygain=:replaygain,"
-            "replaygain_peak=:replaygain_peak,"
-            "timesplayed=:timesplayed,"
-            "last_played_at=:last_played_at,"
-            "played=:played,"
-            "header_parsed=:header_parsed,"
-            "source_synchronized_ms=:source_synchronized_ms,"
-            "channels=:channels,"
-            "bitrate=:bitrate,"
-            "samplerate=:samplerate,"
-            "bitrate=:bitrate,"
-            "duration=:duration,"
-            "beats_version=:beats_version,"
-            "beats_sub_version=:beats_sub_version,"
-            "beats=:beats,"
-            "bpm_lock=:bpm_lock,"
-            "keys_version=:keys_version,"
-            "keys_sub_version=:keys_sub_version,"
-            "keys=:keys,"
-            "coverart_source=:coverart_source,"
-            "coverart_type=:coverart_type,"
-            "coverart_location=:coverart_location,"
-            "coverart_color=:coverart_color,"
-            "coverart_digest=:coverart_digest,"
-            "coverart_hash=:coverart_hash "
-            "WHERE id=:track_id");
+    if (!m_pQueryLibraryUpdateTrack) {
+        m_pQueryLibraryUpdateTrack = std::make_unique<QSqlQuery>(m_database);
+        // Update everything but "location", since that's what we identify the track by.
+        if (!m_pQueryLibraryUpdateTrack->prepare(
+                    "UPDATE library SET "
+                    "artist=:artist,"
+                    "title=:title,"
+                    "album=:album,"
+                    "album_artist=:album_artist,"
+                    "year=:year,"
+                    "genre=:genre,"
+                    "composer=:composer,"
+                    "grouping=:grouping,"
+                    "filetype=:filetype,"
+                    "tracknumber=:tracknumber,"
+                    "tracktotal=:tracktotal,"
+                    "color=:color,"
+                    "comment=:comment,"
+                    "url=:url,"
+                    "rating=:rating,"
+                    "key=:key,"
+                    "key_id=:key_id,"
+                    "cuepoint=:cuepoint,"
+                    "bpm=:bpm,"
+                    "replaygain=:replaygain,"
+                    "replaygain_peak=:replaygain_peak,"
+                    "timesplayed=:timesplayed,"
+                    "last_played_at=:last_played_at,"
+                    "played=:played,"
+                    "header_parsed=:header_parsed,"
+                    "source_synchronized_ms=:source_synchronized_ms,"
+                    "channels=:channels,"
+                    "bitrate=:bitrate,"
+                    "samplerate=:samplerate,"
+                    "bitrate=:bitrate,"
+                    "duration=:duration,"
+                    "beats_version=:beats_version,"
+                    "beats_sub_version=:beats_sub_version,"
+                    "beats=:beats,"
+                    "bpm_lock=:bpm_lock,"
+                    "keys_version=:keys_version,"
+                    "keys_sub_version=:keys_sub_version,"
+                    "keys=:keys,"
+                    "coverart_source=:coverart_source,"
+                    "coverart_type=:coverart_type,"
+                    "coverart_location=:coverart_location,"
+                    "coverart_color=:coverart_color,"
+                    "coverart_digest=:coverart_digest,"
+                    "coverart_hash=:coverart_hash "
+                    "WHERE id=:track_id");)) {
+            LOG_FAILED_QUERY(*m_pQueryLibraryUpdateTrack);
+            m_pQueryLibraryUpdateTrack.reset();
+            return false;
+        }
+    }
+    QSqlQuery& query = *m_pQueryLibraryUpdateTrack;
 
     query.bindValue(":track_id", trackId.toVariant());
-
-    const auto trackRecord = track.getRecord();
     bindTrackLibraryValues(
             &query,
-            trackRecord,
-            track.getBeats());
+            trackUpdate.trackRecord,
+            trackUpdate.pBeats);
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -1686,18 +1860,12 @@ bool TrackDAO::updateTrack(const Track& track) const {
         return false;
     }
 
-    //qDebug() << "Update track took : " << time.elapsed().formatMillisWithUnit() << "Now updating cues";
-    //time.start();
     m_analysisDao.saveTrackAnalyses(
             trackId,
-            track.getWaveform(),
-            track.getWaveformSummary());
+            trackUpdate.pWaveform,
+            trackUpdate.pWaveformSummary);
     m_cueDao.saveTrackCues(
-            trackId, track.getCuePoints());
-    transaction.commit();
-
-    //qDebug() << "Update track in database took: " << time.elapsed().formatMillisWithUnit();
-    //time.start();
+            trackId, trackUpdate.cuePoints);
     return true;
 }
 
@@ -2183,6 +2351,50 @@ void TrackDAO::detectCoverArtForTracksWithoutCover(volatile const bool* pCancel,
     }
 }
 
+QList<CoverInfo> TrackDAO::getDistinctCoverInfosWithImage() const {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral(
+            "SELECT "
+            "track_locations.location," // 0
+            "coverart_type,"            // 1
+            "coverart_source,"          // 2
+            "coverart_location,"        // 3
+            "coverart_digest,"          // 4
+            "coverart_hash "            // 5
+            "FROM library "
+            "INNER JOIN track_locations "
+            "ON library.location = track_locations.id "
+            "WHERE mixxx_deleted=0 "
+            "AND coverart_type IN (%1,%2) "
+            "AND coverart_digest IS NOT NULL "
+            "GROUP BY coverart_digest")
+                          .arg(QString::number(CoverInfo::METADATA),
+                                  QString::number(CoverInfo::FILE)));
+
+    QList<CoverInfo> coverInfos;
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "failed looking for tracks with cover art";
+        return coverInfos;
+    }
+    while (query.next()) {
+        CoverInfo coverInfo;
+        coverInfo.trackLocation = query.value(0).toString();
+        coverInfo.type = static_cast<CoverInfo::Type>(query.value(1).toInt());
+        coverInfo.source = static_cast<CoverInfo::Source>(query.value(2).toInt());
+        coverInfo.coverLocation = query.value(3).toString();
+        coverInfo.setImageDigest(
+                query.value(4).toByteArray(),
+                static_cast<quint16>(query.value(5).toUInt()));
+        if (coverInfo.imageDigest().isEmpty()) {
+            continue;
+        }
+        coverInfos.append(std::move(coverInfo));
+    }
+    return coverInfos;
+}
+
 TrackPointer TrackDAO::getOrAddTrack(
         const TrackRef& trackRef,
         bool* pAlreadyInLibrary) {
@@ -2252,6 +2464,8 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
     VERIFY_OR_DEBUG_ASSERT(!trackIds.isEmpty()) {
         return false;
     }
+    // Pending updates would overwrite the play counter afterwards
+    flushPendingTrackUpdates();
     // Update both timesplay and last_played_at according to the
     // corresponding aggregated properties from the played history,
     // i.e. COUNT for the number of times a track has been played
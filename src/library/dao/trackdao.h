@@ -1,16 +1,19 @@
 #pragma once
 
 #include <QFileInfo>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QSet>
 #include <QSqlDatabase>
 #include <QString>
+#include <QTimer>
 
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
 #include "track/globaltrackcache.h"
+#include "track/track.h"
 #include "util/class.h"
 #include "util/memory.h"
 
@@ -49,6 +52,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             UserSettingsPointer pConfig);
     ~TrackDAO() override;
 
+    void initialize(const QSqlDatabase& database) override;
+
     void finish();
 
     QList<TrackId> resolveTrackIds(
@@ -76,6 +81,20 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    /// Save a track that has been evicted from GlobalTrackCache.
+    ///
+    /// The modified properties are captured immediately and the track
+    /// is marked as clean. Writing them into the database is deferred
+    /// and coalesced with other evicted tracks into a single transaction.
+    /// Pending writes are flushed before any track is loaded from the
+    /// database, i.e. a track is never restored from outdated data.
+    ///
+    /// Only used by friend class TrackCollection, but public for testing!
+    bool saveEvictedTrack(Track* pTrack) const;
+
+    /// Write all deferred saves of evicted tracks into the database.
+    void flushPendingTrackUpdates() const;
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
@@ -165,6 +184,27 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     bool updateTrack(const Track& track) const;
 
+    /// All properties of a track that are stored in the database
+    struct TrackUpdate {
+        explicit TrackUpdate(const Track& track);
+
+        QString location;
+        mixxx::TrackRecord trackRecord;
+        mixxx::BeatsPointer pBeats;
+        ConstWaveformPointer pWaveform;
+        ConstWaveformPointer pWaveformSummary;
+        QList<CuePointer> cuePoints;
+        int failedAttempts = 0;
+    };
+    bool writeTrackUpdate(
+            TrackId trackId,
+            const TrackUpdate& trackUpdate) const;
+    /// Defers a failed update again until the maximum number of
+    /// attempts has been reached
+    void retryTrackUpdate(
+            TrackId trackId,
+            TrackUpdate trackUpdate) const;
+
     void hideAllTracks(const QDir& rootDir) const;
 
     bool hideTracks(
@@ -195,6 +235,10 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void detectCoverArtForTracksWithoutCover(volatile const bool* pCancel,
                                         QSet<TrackId>* pTracksChanged);
 
+    /// Returns the cover infos of all tracks with a known cover image.
+    /// Tracks that share the same image are only reported once.
+    QList<CoverInfo> getDistinctCoverInfosWithImage() const;
+
     // Callback for GlobalTrackCache
     mixxx::FileAccess relocateCachedTrack(TrackId trackId) override;
 
@@ -217,6 +261,14 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     QSet<TrackId> m_tracksAddedSet;
 
+    // Reused for updating tracks, prepared on first use
+    mutable std::unique_ptr<QSqlQuery> m_pQueryLibraryUpdateTrack;
+
+    // Deferred saves of evicted tracks. Multiple saves of the
+    // same track are coalesced and only the latest one is kept.
+    mutable QHash<TrackId, TrackUpdate> m_pendingTrackUpdates;
+    mutable QTimer m_pendingTrackUpdatesTimer;
+
     DISALLOW_COPY_AND_ASSIGN(TrackDAO);
 };
 
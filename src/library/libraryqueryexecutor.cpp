@@ -0,0 +1,224 @@
+#include "library/libraryqueryexecutor.h"
+
+#include <QSqlDriver>
+#include <QSqlQuery>
+
+#include "library/queryutil.h"
+#include "moc_libraryqueryexecutor.cpp"
+#include "util/compatibility/qmutex.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryQueryExecutor");
+
+// Superseded requests are detected while iterating over the
+// results. Checking after each row would be too expensive.
+constexpr int kRowsBetweenCancellationChecks = 1024;
+
+bool setQueryOnly(const QSqlDatabase& database, bool queryOnly) {
+    QSqlQuery query(database);
+    if (!query.exec(queryOnly
+                    ? QStringLiteral("PRAGMA query_only = ON")
+                    : QStringLiteral("PRAGMA query_only = OFF"))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+LibraryQueryExecutor::LibraryQueryExecutor(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_nextGeneration(1),
+          m_nextChannel(0),
+          m_quit(false) {
+    qRegisterMetaType<LibraryQueryExecutor::Results>(
+            "LibraryQueryExecutor::Results");
+}
+
+LibraryQueryExecutor::~LibraryQueryExecutor() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_quit = true;
+        m_pendingRequests.clear();
+        m_requestAvailable.wakeAll();
+    }
+    wait();
+}
+
+int LibraryQueryExecutor::createChannel() {
+    const auto locker = lockMutex(&m_mutex);
+    return m_nextChannel++;
+}
+
+quint64 LibraryQueryExecutor::submit(int channel, Request request) {
+    const auto locker = lockMutex(&m_mutex);
+    const quint64 generation = m_nextGeneration++;
+    m_latestGenerations.insert(channel, generation);
+    // Drop all pending requests of this channel that have not
+    // been started yet. They are superseded by the new request.
+    for (int i = m_pendingRequests.size() - 1; i >= 0; --i) {
+        if (m_pendingRequests[i].channel == channel) {
+            m_pendingRequests.removeAt(i);
+        }
+    }
+    m_pendingRequests.append(PendingRequest{
+            channel,
+            generation,
+            std::move(request)});
+    m_requestAvailable.wakeOne();
+    return generation;
+}
+
+void LibraryQueryExecutor::cancel(int channel) {
+    const auto locker = lockMutex(&m_mutex);
+    // Start a new generation without any request
+    m_latestGenerations.insert(channel, m_nextGeneration++);
+    for (int i = m_pendingRequests.size() - 1; i >= 0; --i) {
+        if (m_pendingRequests[i].channel == channel) {
+            m_pendingRequests.removeAt(i);
+        }
+    }
+}
+
+bool LibraryQueryExecutor::takePendingRequest(PendingRequest* pPendingRequest) {
+    auto locker = lockMutex(&m_mutex);
+    while (!m_quit && m_pendingRequests.isEmpty()) {
+        m_requestAvailable.wait(&m_mutex);
+    }
+    if (m_quit) {
+        return false;
+    }
+    *pPendingRequest = m_pendingRequests.takeFirst();
+    return true;
+}
+
+bool LibraryQueryExecutor::isSuperseded(int channel, quint64 generation) const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_quit || m_latestGenerations.value(channel) != generation;
+}
+
+void LibraryQueryExecutor::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        if (!database.isOpen()) {
+            kLogger.warning()
+                    << "Failed to open database connection for library queries";
+            kLogger.debug() << "Exiting thread";
+            return;
+        }
+        // All queries are read-only. Modifications are only permitted
+        // through the connection of the GUI thread.
+        setQueryOnly(database, true);
+
+        PendingRequest pendingRequest;
+        while (takePendingRequest(&pendingRequest)) {
+            Results results;
+            if (executeRequest(database, pendingRequest, &results)) {
+                emit queryFinished(
+                        pendingRequest.channel,
+                        pendingRequest.generation,
+                        results);
+            }
+        }
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+bool LibraryQueryExecutor::createTemporaryView(
+        const QSqlDatabase& database,
+        const TemporaryView& temporaryView) {
+    const auto it = m_createdTemporaryViews.constFind(temporaryView.name);
+    if (it != m_createdTemporaryViews.constEnd() &&
+            it.value() == temporaryView.createStatement) {
+        return true;
+    }
+    // The view might have been redefined since it has been created
+    m_createdTemporaryViews.remove(temporaryView.name);
+    // Even temporary schema changes are rejected while the
+    // connection is restricted to queries. They only affect
+    // this connection and don't modify the database file.
+    setQueryOnly(database, false);
+    QSqlQuery dropQuery(database);
+    bool created = dropQuery.exec(
+            QStringLiteral("DROP VIEW IF EXISTS temp.%1")
+                    .arg(database.driver()->escapeIdentifier(
+                            temporaryView.name, QSqlDriver::TableName)));
+    if (!created) {
+        LOG_FAILED_QUERY(dropQuery);
+    }
+    QSqlQuery createQuery(database);
+    if (created) {
+        created = createQuery.exec(temporaryView.createStatement);
+        if (!created) {
+            LOG_FAILED_QUERY(createQuery);
+        }
+    }
+    setQueryOnly(database, true);
+    if (!created) {
+        return false;
+    }
+    m_createdTemporaryViews.insert(
+            temporaryView.name, temporaryView.createStatement);
+    return true;
+}
+
+bool LibraryQueryExecutor::executeRequest(
+        const QSqlDatabase& database,
+        const PendingRequest& pendingRequest,
+        Results* pResults) {
+    PerformanceTimer timer;
+    timer.start();
+
+    for (const auto& temporaryView : pendingRequest.request.temporaryViews) {
+        if (!createTemporaryView(database, temporaryView)) {
+            return false;
+        }
+    }
+
+    pResults->reserve(pendingRequest.request.queries.size());
+    for (const auto& queryString : pendingRequest.request.queries) {
+        if (isSuperseded(pendingRequest.channel, pendingRequest.generation)) {
+            kLogger.debug()
+                    << "Skipping superseded request"
+                    << pendingRequest.generation;
+            return false;
+        }
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.prepare(queryString) || !query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        QVector<TrackId> trackIds;
+        while (query.next()) {
+            trackIds.append(TrackId(query.value(0)));
+            if (trackIds.size() % kRowsBetweenCancellationChecks == 0 &&
+                    isSuperseded(pendingRequest.channel,
+                            pendingRequest.generation)) {
+                kLogger.debug()
+                        << "Aborting superseded request"
+                        << pendingRequest.generation;
+                return false;
+            }
+        }
+        pResults->append(std::move(trackIds));
+    }
+
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Executed request"
+                << pendingRequest.generation
+                << "in"
+                << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+/// Executes read-only library queries on a dedicated worker thread with
+/// its own database connection from the pool, i.e. without blocking the
+/// GUI thread.
+///
+/// Queries are submitted through channels, usually one channel per
+/// table model. Each submitted request starts a new generation and
+/// supersedes all previous requests of the same channel. Superseded
+/// requests are skipped or aborted and their results are never delivered.
+class LibraryQueryExecutor : public QThread {
+    Q_OBJECT
+  public:
+    /// Temporary views are only visible to the database connection
+    /// that created them.
+    struct TemporaryView {
+        QString name;
+        /// "CREATE TEMPORARY VIEW <name> ..."
+        QString createStatement;
+    };
+    struct Request {
+        /// All temporary views that are referenced by the queries are
+        /// created on the worker connection before executing the queries.
+        /// Views that have been created with a different statement before
+        /// are replaced.
+        QList<TemporaryView> temporaryViews;
+        /// Each query must select the track ids in the first column.
+        QStringList queries;
+    };
+    /// One list of track ids per query in the order of the request
+    typedef QList<QVector<TrackId>> Results;
+
+    explicit LibraryQueryExecutor(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~LibraryQueryExecutor() override;
+
+    /// Allocate a new, unique channel for submitting requests.
+    int createChannel();
+
+    /// Submit a new request and return its generation. Might be
+    /// called from any thread.
+    quint64 submit(int channel, Request request);
+
+    /// Cancel all pending or running requests of the channel. Might be
+    /// called from any thread.
+    void cancel(int channel);
+
+  signals:
+    void queryFinished(
+            int channel,
+            quint64 generation,
+            const LibraryQueryExecutor::Results& results);
+
+  protected:
+    void run() override;
+
+  private:
+    struct PendingRequest {
+        int channel;
+        quint64 generation;
+        Request request;
+    };
+
+    bool takePendingRequest(PendingRequest* pPendingRequest);
+    bool isSuperseded(int channel, quint64 generation) const;
+
+    bool createTemporaryView(
+            const QSqlDatabase& database,
+            const TemporaryView& temporaryView);
+    bool executeRequest(
+            const QSqlDatabase& database,
+            const PendingRequest& pendingRequest,
+            Results* pResults);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_requestAvailable;
+    QList<PendingRequest> m_pendingRequests;
+    QHash<int, quint64> m_latestGenerations;
+    quint64 m_nextGeneration;
+    int m_nextChannel;
+    bool m_quit;
+
+    // The statements of the created temporary views by name.
+    // Only accessed by the worker thread.
+    QHash<QString, QString> m_createdTemporaryViews;
+};
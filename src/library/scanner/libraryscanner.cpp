@@ -102,6 +102,10 @@ LibraryScanner::LibraryScanner(
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
                   pConfig),
+          m_coverArtThumbnailCache(
+                  CoverArtThumbnailCache::defaultRootPath(
+                          pConfig->getSettingsPath()),
+                  CoverArtThumbnailCache::maxSizeInBytes(pConfig)),
           m_stateSema(1), // only one transaction is possible at a time
           m_state(IDLE) {
     // Move LibraryScanner to its own thread so that our signals/slots will
@@ -434,11 +438,58 @@ void LibraryScanner::slotFinishUnhashedScan() {
             static_cast<int>(m_scannerGlobal->verifiedTracks().size()),
             static_cast<int>(m_scannerGlobal->addedTracks().size()));
 
+    const bool generateThumbnails =
+            !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly;
     m_scannerGlobal.clear();
     changeScannerState(FINISHED);
     // now we may accept new scan commands
 
     emit scanFinished();
+
+    if (generateThumbnails) {
+        generateCoverArtThumbnails();
+    }
+}
+
+void LibraryScanner::generateCoverArtThumbnails() {
+    PerformanceTimer timer;
+    timer.start();
+    const QList<CoverInfo> coverInfos =
+            m_trackDao.getDistinctCoverInfosWithImage();
+    int generatedCount = 0;
+    for (const auto& coverInfo : coverInfos) {
+        // The scanner thread is idle now. Any state transition indicates
+        // that a new scan has been requested or that we need to quit.
+        if (m_state != IDLE) {
+            kLogger.debug()
+                    << "Aborting generation of cover art thumbnails";
+            return;
+        }
+        if (m_coverArtThumbnailCache.containsAllThumbnails(
+                    coverInfo.imageDigest())) {
+            continue;
+        }
+        const QImage image = coverInfo.loadImage().image;
+        if (image.isNull()) {
+            continue;
+        }
+        // Never store thumbnails for a stale digest. The digest will
+        // be fixed when the cover is displayed or on the next rescan.
+        if (CoverImageUtils::calculateDigest(image) != coverInfo.imageDigest()) {
+            continue;
+        }
+        if (m_coverArtThumbnailCache.storeAllThumbnails(
+                    coverInfo.imageDigest(), image)) {
+            ++generatedCount;
+        }
+    }
+    kLogger.info()
+            << "Generated cover art thumbnails for"
+            << generatedCount
+            << "of"
+            << coverInfos.size()
+            << "images in"
+            << timer.elapsed().debugMillisWithUnit();
 }
 
 void LibraryScanner::scan() {
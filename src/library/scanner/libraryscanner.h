@@ -9,6 +9,7 @@
 #include <QThread>
 #include <QThreadPool>
 
+#include "library/coverartthumbnailcache.h"
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
 #include "library/dao/directorydao.h"
@@ -96,6 +97,11 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    // Pre-generate the cover art thumbnails after the scan has finished
+    // to avoid decoding the original images when scrolling through the
+    // library. Aborts when a new scan is started.
+    void generateCoverArtThumbnails();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
     // The pool of threads used for worker tasks.
@@ -109,6 +115,8 @@ class LibraryScanner : public QThread {
     AnalysisDao m_analysisDao;
     TrackDAO m_trackDao;
 
+    const CoverArtThumbnailCache m_coverArtThumbnailCache;
+
     // Global scanner state for scan currently in progress.
     ScannerGlobalPointer m_scannerGlobal;
 
@@ -4,6 +4,7 @@
 
 #include "library/basetrackcache.h"
 #include "moc_trackcollection.cpp"
+#include "sources/soundsourcepool.h"
 #include "track/globaltrackcache.h"
 #include "util/assert.h"
 #include "util/db/sqltransaction.h"
@@ -92,6 +93,7 @@ void TrackCollection::disconnectDatabase() {
     kLogger.info() << "Disconnecting database";
     m_database = QSqlDatabase();
     m_trackDao.finish();
+    m_cueDao.finish();
     m_crates.disconnectDatabase();
 }
 
@@ -194,6 +196,10 @@ void TrackCollection::relocateDirectory(const QString& oldDir, const QString& ne
     // QDir.
     Sandbox::createSecurityTokenForDir(QDir(newDir));
 
+    // Pooled sources still keep files of the old directory open, which
+    // prevents moving or deleting them on Windows.
+    mixxx::SoundSourcePool::clear();
+
     SqlTransaction transaction(m_database);
     QList<RelocatedTrack> relocatedTracks =
             m_directoryDao.relocateDirectory(oldDir, newDir);
@@ -538,6 +544,12 @@ bool TrackCollection::saveTrack(Track* pTrack) const {
     return m_trackDao.saveTrack(pTrack);
 }
 
+bool TrackCollection::saveEvictedTrack(Track* pTrack) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    return m_trackDao.saveEvictedTrack(pTrack);
+}
+
 TrackPointer TrackCollection::getTrackById(
         TrackId trackId) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
@@ -164,6 +164,7 @@ class TrackCollection : public QObject,
     void relocateDirectory(const QString& oldDir, const QString& newDir);
 
     bool saveTrack(Track* pTrack) const;
+    bool saveEvictedTrack(Track* pTrack) const;
 
     QSqlDatabase m_database;
 
@@ -4,6 +4,7 @@
 
 #include "library/externaltrackcollection.h"
 #include "library/library_prefs.h"
+#include "library/libraryqueryexecutor.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
 #include "moc_trackcollectionmanager.cpp"
@@ -126,9 +127,24 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    if (deleteTrackForTestingFn) {
+        // Library queries are executed synchronously in tests
+        kLogger.info() << "Asynchronous library queries are disabled in test mode";
+    } else {
+        m_pQueryExecutor = std::make_unique<LibraryQueryExecutor>(pDbConnectionPool);
+        kLogger.info() << "Starting library query thread";
+        m_pQueryExecutor->start();
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    if (m_pQueryExecutor) {
+        kLogger.info() << "Stopping library query thread";
+        // Blocks until the thread has finished
+        m_pQueryExecutor.reset();
+    }
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -192,12 +208,15 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 // Export metadata and save the track in both the internal database
 // and external libraries.
 void TrackCollectionManager::saveEvictedTrack(Track* pTrack) noexcept {
-    saveTrack(pTrack, TrackMetadataExportMode::Immediate);
+    saveTrack(pTrack,
+            TrackMetadataExportMode::Immediate,
+            TrackDatabaseSaveMode::Batched);
 }
 
 TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
         Track* pTrack,
-        TrackMetadataExportMode mode) const {
+        TrackMetadataExportMode metadataExportMode,
+        TrackDatabaseSaveMode databaseSaveMode) const {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return SaveTrackResult::Skipped;
@@ -209,7 +228,7 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
     // export by the user or export of metadata was deferred during a
     // previous invocation.
     const auto exportTrackMetadataResult =
-            exportTrackMetadataBeforeSaving(pTrack, mode);
+            exportTrackMetadataBeforeSaving(pTrack, metadataExportMode);
     DEBUG_ASSERT(
             exportTrackMetadataResult != ExportTrackMetadataResult::Succeeded ||
             pTrack->getSourceSynchronizedAt().isValid());
@@ -250,12 +269,17 @@ TrackCollectionManager::SaveTrackResult TrackCollectionManager::saveTrack(
 
     // This operation must be executed synchronously while the cache is
     // locked to prevent that a new track is created from outdated
-    // metadata in the database before saving has finished.
+    // metadata in the database before saving has finished. Batched
+    // saves capture the track's properties synchronously and are
+    // written before any track is loaded from the database.
     kLogger.debug()
             << "Saving track"
             << pTrack->getLocation()
             << "in internal collection";
-    if (!m_pInternalCollection->saveTrack(pTrack)) {
+    const bool saved = databaseSaveMode == TrackDatabaseSaveMode::Batched
+            ? m_pInternalCollection->saveEvictedTrack(pTrack)
+            : m_pInternalCollection->saveTrack(pTrack);
+    if (!saved) {
         // The dirty flag is not reset when saving fails
         DEBUG_ASSERT(pTrack->isDirty());
         return SaveTrackResult::Failed;
@@ -13,6 +13,7 @@
 #include "util/parented_ptr.h"
 #include "util/thread_affinity.h"
 
+class LibraryQueryExecutor;
 class LibraryScanner;
 class TrackCollection;
 class ExternalTrackCollection;
@@ -47,6 +48,12 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    // Executes library queries asynchronously on a separate database
+    // connection. Might be null, e.g. in tests.
+    LibraryQueryExecutor* queryExecutor() const {
+        return m_pQueryExecutor.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -112,9 +119,16 @@ class TrackCollectionManager: public QObject,
         Immediate,
         Deferred,
     };
+    // Evicted tracks are written into the database in batches
+    enum class TrackDatabaseSaveMode {
+        Immediate,
+        Batched,
+    };
     SaveTrackResult saveTrack(
             Track* pTrack,
-            TrackMetadataExportMode mode) const;
+            TrackMetadataExportMode metadataExportMode,
+            TrackDatabaseSaveMode databaseSaveMode =
+                    TrackDatabaseSaveMode::Immediate) const;
     ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
             Track* pTrack,
             TrackMetadataExportMode mode) const;
@@ -127,4 +141,6 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<LibraryQueryExecutor> m_pQueryExecutor;
 };
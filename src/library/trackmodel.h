@@ -5,6 +5,7 @@
 #include <QUrl>
 #include <QVector>
 #include <QtSql>
+#include <functional>
 
 #include "library/coverart.h"
 #include "library/dao/settingsdao.h"
@@ -130,6 +131,14 @@ class TrackModel {
     virtual const QVector<int> getTrackRows(TrackId trackId) const = 0;
 
     virtual void search(const QString& searchText, const QString& extraFilter=QString()) = 0;
+    // Searches asynchronously if supported by the model. The rows are
+    // replaced later and the callback is invoked afterwards, unless
+    // the search has been superseded by another search or select.
+    virtual void searchAsync(const QString& searchText,
+            const std::function<void()>& onSearchFinished) {
+        search(searchText);
+        onSearchFinished();
+    }
     virtual const QString currentSearch() const = 0;
     virtual bool isColumnInternal(int column) = 0;
     // if no header state exists, we may hide some columns so that the user can
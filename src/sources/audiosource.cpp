@@ -17,7 +17,8 @@ constexpr SINT kVerifyReadableMaxFrameCount = 1;
 } // anonymous namespace
 
 AudioSource::AudioSource(const QUrl& url)
-        : UrlResource(url) {
+        : UrlResource(url),
+          m_preview(false) {
 }
 
 AudioSource::AudioSource(
@@ -26,7 +27,8 @@ AudioSource::AudioSource(
         : UrlResource(inner),
           m_signalInfo(signalInfo),
           m_bitrate(inner.m_bitrate),
-          m_frameIndexRange(inner.m_frameIndexRange) {
+          m_frameIndexRange(inner.m_frameIndexRange),
+          m_preview(inner.m_preview) {
     DEBUG_ASSERT(m_frameIndexRange.orientation() != IndexRange::Orientation::Backward);
 }
 
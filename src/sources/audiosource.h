@@ -189,16 +189,35 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
         Failed,
     };
 
+    /// Hint about how the audio stream will be read. Decoders that
+    /// map the file into memory pass it on to the operating system
+    /// for controlling read-ahead and caching.
+    enum class AccessPattern {
+        /// Playback in a deck: Mostly sequential with occasional
+        /// jumps, e.g. when seeking or triggering hot cues.
+        Playback,
+        /// Reading the whole stream once from start to end, e.g.
+        /// for analysis. Data that has been read is not needed again.
+        Sequential,
+        /// Frequent jumps between arbitrary positions.
+        Random,
+    };
+
     // Parameters for opening audio sources
     class OpenParams {
       public:
-        OpenParams() = default;
+        OpenParams()
+                : m_accessPattern(AccessPattern::Playback),
+                  m_previewFrameCount(0) {
+        }
         OpenParams(
                 audio::ChannelCount channelCount,
                 audio::SampleRate sampleRate)
                 : m_signalInfo(
                           channelCount,
-                          sampleRate) {
+                          sampleRate),
+                  m_accessPattern(AccessPattern::Playback),
+                  m_previewFrameCount(0) {
         }
 
         const audio::SignalInfo& getSignalInfo() const {
@@ -215,8 +234,34 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
             m_signalInfo.setSampleRate(sampleRate);
         }
 
+        AccessPattern getAccessPattern() const {
+            return m_accessPattern;
+        }
+
+        void setAccessPattern(
+                AccessPattern accessPattern) {
+            m_accessPattern = accessPattern;
+        }
+
+        SINT getPreviewFrameCount() const {
+            return m_previewFrameCount;
+        }
+
+        /// Decoders that need to scan the whole stream for determining
+        /// its exact length may stop after the given number of sample
+        /// frames and only provide this preview. 0 = disabled (default)
+        ///
+        /// See also: isPreview()
+        void setPreviewFrameCount(
+                SINT previewFrameCount) {
+            DEBUG_ASSERT(previewFrameCount >= 0);
+            m_previewFrameCount = previewFrameCount;
+        }
+
       private:
         audio::SignalInfo m_signalInfo;
+        AccessPattern m_accessPattern;
+        SINT m_previewFrameCount;
     };
 
     // Opens the AudioSource for reading audio data.
@@ -282,6 +327,15 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
         return m_frameIndexRange.clampIndex(frameIndex) == frameIndex;
     }
 
+    /// A preview only provides the beginning of the audio stream,
+    /// i.e. the frame index range is shorter than the actual length.
+    /// The audio data within this range is exact.
+    ///
+    /// See also: OpenParams::setPreviewFrameCount()
+    bool isPreview() const {
+        return m_preview;
+    }
+
     // The actual duration in seconds.
     // Well defined only for valid files!
     inline bool hasDuration() const {
@@ -323,6 +377,9 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
 
     bool initFrameIndexRangeOnce(
             IndexRange frameIndexRange);
+    void initPreview() {
+        m_preview = true;
+    }
     // The frame index range needs to be adjusted while
     // reading. This virtual function is an ugly hack!!!
     // It needs to be overridden in derived proxy classes
@@ -382,6 +439,8 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     audio::Bitrate m_bitrate;
 
     IndexRange m_frameIndexRange;
+
+    bool m_preview;
 };
 
 typedef std::shared_ptr<AudioSource> AudioSourcePointer;
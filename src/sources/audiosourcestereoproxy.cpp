@@ -1,5 +1,7 @@
 #include "sources/audiosourcestereoproxy.h"
 
+#include <cstring>
+
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -27,8 +29,9 @@ AudioSourceStereoProxy::AudioSourceStereoProxy(
         : AudioSourceProxy(
                 std::move(pAudioSource),
                 proxySignalInfo(pAudioSource->getSignalInfo())),
+          // Mono sources are decoded directly into the output buffer
           m_tempSampleBuffer(
-                  (m_pAudioSource->getSignalInfo().getChannelCount() != kChannelCount) ?
+                  (m_pAudioSource->getSignalInfo().getChannelCount() > kChannelCount) ?
                   m_pAudioSource->getSignalInfo().frames2samples(maxReadableFrames) :
                   0),
           m_tempWritableSlice(m_tempSampleBuffer) {
@@ -68,6 +71,9 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
     if (m_pAudioSource->getSignalInfo().getChannelCount() == kChannelCount) {
         return readSampleFramesClampedOn(*m_pAudioSource, sampleFrames);
     }
+    if (m_pAudioSource->getSignalInfo().getChannelCount() == 1) {
+        return readMonoSampleFramesClamped(sampleFrames);
+    }
 
     // Check location and capacity of temporary buffer
     VERIFY_OR_DEBUG_ASSERT(isDisjunct(
@@ -113,18 +119,11 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
     SampleBuffer::WritableSlice writableSlice(
             sampleFrames.writableData(getSignalInfo().frames2samples(frameOffset)),
             getSignalInfo().frames2samples(readableSampleFrames.frameLength()));
-    if (m_pAudioSource->getSignalInfo().getChannelCount() == 1) {
-        SampleUtil::copyMonoToDualMono(
-                writableSlice.data(),
-                readableSampleFrames.readableData(),
-                readableSampleFrames.frameLength());
-    } else {
-        SampleUtil::copyMultiToStereo(
-                writableSlice.data(),
-                readableSampleFrames.readableData(),
-                readableSampleFrames.frameLength(),
-                m_pAudioSource->getSignalInfo().getChannelCount());
-    }
+    SampleUtil::copyMultiToStereo(
+            writableSlice.data(),
+            readableSampleFrames.readableData(),
+            readableSampleFrames.frameLength(),
+            m_pAudioSource->getSignalInfo().getChannelCount());
     return ReadableSampleFrames(
             readableSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
@@ -132,4 +131,45 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
                     writableSlice.length()));
 }
 
+ReadableSampleFrames AudioSourceStereoProxy::readMonoSampleFramesClamped(
+        const WritableSampleFrames& sampleFrames) {
+    DEBUG_ASSERT(m_pAudioSource->getSignalInfo().getChannelCount() == 1);
+    // The mono samples fit into the first half of the output buffer
+    // and are expanded in-place afterwards. This avoids both an extra
+    // copy and the temporary buffer.
+    const auto readableSampleFrames =
+            readSampleFramesClampedOn(
+                    *m_pAudioSource,
+                    WritableSampleFrames(
+                            sampleFrames.frameIndexRange(),
+                            SampleBuffer::WritableSlice(
+                                    sampleFrames.writableData(),
+                                    sampleFrames.frameLength())));
+    if (readableSampleFrames.frameIndexRange().empty()) {
+        return readableSampleFrames;
+    }
+    DEBUG_ASSERT(
+            readableSampleFrames.frameIndexRange().isSubrangeOf(sampleFrames.frameIndexRange()));
+    const SINT frameOffset =
+            readableSampleFrames.frameIndexRange().start() -
+            sampleFrames.frameIndexRange().start();
+    CSAMPLE* pStereoData =
+            sampleFrames.writableData(getSignalInfo().frames2samples(frameOffset));
+    if (readableSampleFrames.readableData() != pStereoData) {
+        // The mono samples are not necessarily located at the start
+        // of the stereo range, e.g. if some frames were skipped
+        std::memmove(pStereoData,
+                readableSampleFrames.readableData(),
+                readableSampleFrames.frameLength() * sizeof(CSAMPLE));
+    }
+    SampleUtil::doubleMonoToDualMono(
+            pStereoData,
+            readableSampleFrames.frameLength());
+    return ReadableSampleFrames(
+            readableSampleFrames.frameIndexRange(),
+            SampleBuffer::ReadableSlice(
+                    pStereoData,
+                    getSignalInfo().frames2samples(readableSampleFrames.frameLength())));
+}
+
 } // namespace mixxx
@@ -30,6 +30,9 @@ class AudioSourceStereoProxy : public AudioSourceProxy {
             const WritableSampleFrames& writableSampleFrames) override;
 
   private:
+    ReadableSampleFrames readMonoSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames);
+
     SampleBuffer m_tempSampleBuffer;
     SampleBuffer::WritableSlice m_tempWritableSlice;
 };
@@ -0,0 +1,406 @@
+#include "sources/decodedaudiocache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QSaveFile>
+#include <cstring>
+#include <memory>
+
+#include "sources/audiosourceproxy.h"
+#include "sources/mappedfileinput.h"
+#include "sources/seekindexcache.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/disklrueviction.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DecodedAudioCache");
+
+const QString kFileSuffix = QStringLiteral("pcm");
+
+constexpr quint32 kFileMagic = 0x4D584441; // "MXDA"
+constexpr quint32 kFileVersion = 1;
+
+// Samples are stored in native byte order as 32-bit floats,
+// exactly as they have been decoded. The header is padded to
+// keep the mapped sample data properly aligned.
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    quint32 reserved;
+    qint64 frameIndexStart;
+    qint64 frameCount;
+};
+
+constexpr qint64 kFileHeaderSize = 64;
+static_assert(sizeof(FileHeader) <= kFileHeaderSize);
+
+QMutex s_mutex;
+std::shared_ptr<DiskLruEviction> s_pEviction;
+
+std::shared_ptr<DiskLruEviction> eviction() {
+    const auto locker = lockMutex(&s_mutex);
+    return s_pEviction;
+}
+
+QString decodedAudioFilePath(
+        const QString& rootPath,
+        const QByteArray& contentKey) {
+    return QStringLiteral("%1/%2.%3")
+            .arg(rootPath,
+                    QString::fromLatin1(contentKey.toHex()),
+                    kFileSuffix);
+}
+
+/// Reads the decoded samples from a mapped file.
+class CachedAudioSource : public AudioSource {
+  public:
+    CachedAudioSource(
+            const QUrl& url,
+            const QString& filePath)
+            : AudioSource(url),
+              m_input(filePath),
+              m_pSampleData(nullptr) {
+    }
+    ~CachedAudioSource() override {
+        close();
+    }
+
+    void close() override {
+        m_pSampleData = nullptr;
+        m_input.close();
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& params) override {
+        if (!m_input.open(params.getAccessPattern(), MappedFileInput::Mapping::Always) ||
+                !m_input.data() ||
+                m_input.size() < kFileHeaderSize) {
+            return OpenResult::Aborted;
+        }
+        FileHeader header;
+        std::memcpy(&header, m_input.data(), sizeof(header));
+        if (header.magic != kFileMagic ||
+                header.version != kFileVersion ||
+                header.frameIndexStart < 0 ||
+                header.frameCount < 0) {
+            kLogger.warning()
+                    << "Ignoring decoded audio data with unsupported format"
+                    << m_input.fileName();
+            return OpenResult::Aborted;
+        }
+        if (!initChannelCountOnce(static_cast<int>(header.channelCount)) ||
+                !initSampleRateOnce(static_cast<SINT>(header.sampleRate)) ||
+                !initBitrateOnce(static_cast<SINT>(header.bitrate)) ||
+                !initFrameIndexRangeOnce(IndexRange::forward(
+                        static_cast<SINT>(header.frameIndexStart),
+                        static_cast<SINT>(header.frameCount)))) {
+            return OpenResult::Aborted;
+        }
+        const qint64 sampleDataSize = static_cast<qint64>(sizeof(CSAMPLE)) *
+                getSignalInfo().frames2samples(frameLength());
+        if (m_input.size() != kFileHeaderSize + sampleDataSize) {
+            kLogger.warning()
+                    << "Ignoring truncated decoded audio data"
+                    << m_input.fileName();
+            return OpenResult::Aborted;
+        }
+        m_pSampleData = reinterpret_cast<const CSAMPLE*>(
+                m_input.data() + kFileHeaderSize);
+        return OpenResult::Succeeded;
+    }
+
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames) override {
+        DEBUG_ASSERT(m_pSampleData);
+        const SINT readOffset = getSignalInfo().frames2samples(
+                writableSampleFrames.frameIndexRange().start() - frameIndexMin());
+        const SINT readSamples = getSignalInfo().frames2samples(
+                writableSampleFrames.frameLength());
+        if (writableSampleFrames.writableData()) {
+            DEBUG_ASSERT(writableSampleFrames.writableLength() >= readSamples);
+            SampleUtil::copy(
+                    writableSampleFrames.writableData(),
+                    m_pSampleData + readOffset,
+                    readSamples);
+        }
+        return ReadableSampleFrames(
+                writableSampleFrames.frameIndexRange(),
+                SampleBuffer::ReadableSlice(
+                        writableSampleFrames.writableData(),
+                        math_min(writableSampleFrames.writableLength(), readSamples)));
+    }
+
+  private:
+    MappedFileInput m_input;
+    const CSAMPLE* m_pSampleData;
+};
+
+/// Records the decoded samples while reading them from the
+/// beginning to the end in order.
+class DecodedAudioRecorder : public AudioSourceProxy {
+  public:
+    DecodedAudioRecorder(
+            AudioSourcePointer&& pAudioSource,
+            std::shared_ptr<DiskLruEviction> pEviction,
+            const QString& filePath)
+            : AudioSourceProxy(std::move(pAudioSource)),
+              m_pEviction(std::move(pEviction)),
+              m_filePath(filePath),
+              m_nextFrameIndex(frameIndexMin()),
+              m_recording(true) {
+        DEBUG_ASSERT(m_pEviction);
+    }
+    ~DecodedAudioRecorder() override {
+        finishRecording();
+    }
+
+    void close() override {
+        finishRecording();
+        AudioSourceProxy::close();
+    }
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override {
+        const auto readableSampleFrames =
+                AudioSourceProxy::readSampleFramesClamped(sampleFrames);
+        if (m_recording) {
+            recordSampleFrames(readableSampleFrames);
+        }
+        return readableSampleFrames;
+    }
+
+  private:
+    /// The file is only created when actually starting to read from
+    /// the beginning.
+    bool startRecording() {
+        DEBUG_ASSERT(!m_pFile);
+        if (!QDir().mkpath(m_pEviction->rootPath())) {
+            kLogger.warning()
+                    << "Failed to create directory for decoded audio data"
+                    << m_pEviction->rootPath();
+            return false;
+        }
+        m_pFile = std::make_unique<QSaveFile>(m_filePath);
+        if (!m_pFile->open(QIODevice::WriteOnly)) {
+            kLogger.warning()
+                    << "Failed to open file for decoded audio data"
+                    << m_filePath
+                    << m_pFile->errorString();
+            return false;
+        }
+        // The header is written after all samples have been recorded
+        const QByteArray placeholder(static_cast<int>(kFileHeaderSize), '\0');
+        return m_pFile->write(placeholder) == kFileHeaderSize;
+    }
+
+    void recordSampleFrames(
+            const ReadableSampleFrames& readableSampleFrames) {
+        if (readableSampleFrames.frameIndexRange().empty()) {
+            return;
+        }
+        const SINT sampleCount = getSignalInfo().frames2samples(
+                readableSampleFrames.frameLength());
+        if (readableSampleFrames.frameIndexRange().start() != m_nextFrameIndex ||
+                readableSampleFrames.readableLength() != sampleCount) {
+            // Not reading in order or no sample data available
+            cancelRecording();
+            return;
+        }
+        if (!m_pFile && !startRecording()) {
+            cancelRecording();
+            return;
+        }
+        const qint64 byteCount = static_cast<qint64>(sizeof(CSAMPLE)) * sampleCount;
+        if (m_pFile->write(
+                    reinterpret_cast<const char*>(
+                            readableSampleFrames.readableData()),
+                    byteCount) != byteCount) {
+            kLogger.warning()
+                    << "Failed to write decoded audio data"
+                    << m_filePath
+                    << m_pFile->errorString();
+            cancelRecording();
+            return;
+        }
+        m_nextFrameIndex = readableSampleFrames.frameIndexRange().end();
+    }
+
+    void cancelRecording() {
+        m_recording = false;
+        if (m_pFile) {
+            m_pFile->cancelWriting();
+        }
+    }
+
+    void finishRecording() {
+        if (!m_recording) {
+            return;
+        }
+        m_recording = false;
+        if (!m_pFile) {
+            // Nothing has been read
+            return;
+        }
+        // The frame index range might have been adjusted while reading
+        if (m_nextFrameIndex != frameIndexMax()) {
+            // Incomplete, e.g. if the analysis has been aborted
+            m_pFile->cancelWriting();
+            return;
+        }
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = kFileMagic;
+        header.version = kFileVersion;
+        header.channelCount = getSignalInfo().getChannelCount();
+        header.sampleRate = getSignalInfo().getSampleRate();
+        header.bitrate = getBitrate();
+        header.frameIndexStart = frameIndexMin();
+        header.frameCount = frameLength();
+        const qint64 sizeInBytes = m_pFile->size();
+        if (!m_pFile->seek(0) ||
+                m_pFile->write(reinterpret_cast<const char*>(&header),
+                        sizeof(header)) != static_cast<qint64>(sizeof(header)) ||
+                !m_pFile->commit()) {
+            kLogger.warning()
+                    << "Failed to store decoded audio data"
+                    << m_filePath;
+            return;
+        }
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Stored decoded audio data"
+                    << m_filePath;
+        }
+        m_pEviction->fileStored(sizeInBytes);
+    }
+
+    const std::shared_ptr<DiskLruEviction> m_pEviction;
+    const QString m_filePath;
+    std::unique_ptr<QSaveFile> m_pFile;
+    SINT m_nextFrameIndex;
+    bool m_recording;
+};
+
+} // anonymous namespace
+
+//static
+void DecodedAudioCache::setRootPath(
+        const QString& rootPath,
+        qint64 maxSizeInBytes) {
+    auto pEviction = !rootPath.isEmpty() && maxSizeInBytes > 0
+            ? std::make_shared<DiskLruEviction>(rootPath, kFileSuffix, maxSizeInBytes)
+            : nullptr;
+    const auto locker = lockMutex(&s_mutex);
+    s_pEviction = std::move(pEviction);
+}
+
+//static
+QString DecodedAudioCache::rootPath() {
+    const auto pEviction = eviction();
+    return pEviction ? pEviction->rootPath() : QString();
+}
+
+//static
+QString DecodedAudioCache::defaultRootPath(
+        const QString& settingsPath) {
+    return QDir(settingsPath).filePath(QStringLiteral("decodedaudio"));
+}
+
+//static
+bool DecodedAudioCache::isSupportedFileType(
+        const QString& fileType) {
+    // Decoding these formats requires much more CPU time than reading
+    // the decoded samples. Tracker modules are even rendered completely
+    // when opening them.
+    return fileType == QLatin1String("opus") ||
+            fileType == QLatin1String("m4a") ||
+            fileType == QLatin1String("mp4") ||
+            fileType == QLatin1String("aac") ||
+            fileType == QLatin1String("mod") ||
+            fileType == QLatin1String("okt") ||
+            fileType == QLatin1String("s3m") ||
+            fileType == QLatin1String("stm") ||
+            fileType == QLatin1String("xm") ||
+            fileType == QLatin1String("it");
+}
+
+//static
+QByteArray DecodedAudioCache::contentKey(
+        const QUrl& url,
+        const AudioSource::OpenParams& params) {
+    if (rootPath().isEmpty() || !url.isLocalFile()) {
+        return QByteArray();
+    }
+    // The decoded samples depend on the requested signal properties
+    const auto formatVersion = QStringLiteral("decoded-f32-1/%1/%2")
+                                       .arg(params.getSignalInfo().getChannelCount().value())
+                                       .arg(params.getSignalInfo().getSampleRate().value());
+    return SeekIndexCache::contentKey(formatVersion, url.toLocalFile());
+}
+
+//static
+AudioSourcePointer DecodedAudioCache::openCachedSource(
+        const QByteArray& contentKey,
+        const QUrl& url,
+        const AudioSource::OpenParams& params) {
+    const auto pEviction = eviction();
+    if (contentKey.isEmpty() || !pEviction) {
+        return nullptr;
+    }
+    const auto filePath = decodedAudioFilePath(pEviction->rootPath(), contentKey);
+    if (!QFile::exists(filePath)) {
+        // Not available yet
+        return nullptr;
+    }
+    DiskLruEviction::touch(filePath);
+    auto pAudioSource = std::make_shared<CachedAudioSource>(url, filePath);
+    if (pAudioSource->open(AudioSource::OpenMode::Strict, params) !=
+            AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Reading decoded audio data for"
+                << url.toLocalFile();
+    }
+    return pAudioSource;
+}
+
+//static
+AudioSourcePointer DecodedAudioCache::recordDecodedSource(
+        const QByteArray& contentKey,
+        AudioSourcePointer pAudioSource) {
+    DEBUG_ASSERT(pAudioSource);
+    auto pEviction = eviction();
+    if (contentKey.isEmpty() || !pEviction) {
+        return pAudioSource;
+    }
+    const qint64 sizeInBytes = kFileHeaderSize +
+            static_cast<qint64>(sizeof(CSAMPLE)) *
+                    pAudioSource->getSignalInfo().frames2samples(
+                            pAudioSource->frameLength());
+    if (sizeInBytes > pEviction->maxSizeInBytes()) {
+        return pAudioSource;
+    }
+    const auto filePath = decodedAudioFilePath(pEviction->rootPath(), contentKey);
+    return std::make_shared<DecodedAudioRecorder>(
+            std::move(pAudioSource),
+            std::move(pEviction),
+            filePath);
+}
+
+} // namespace mixxx
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+/// Persistent store for the decoded audio data of formats that are
+/// expensive to decode or to seek in, e.g. Opus, AAC, or tracker
+/// modules that need to be rendered completely when opening them.
+///
+/// The decoded samples are stored uncompressed and are mapped into
+/// memory when reading them again, which is much faster than decoding.
+/// The files are keyed by the contents of the audio file and the
+/// requested signal properties. The least recently used files are
+/// evicted when the total size exceeds the configured limit.
+///
+/// Decoded audio data is only recorded when a source that has been
+/// opened for sequential access, i.e. for analysis, has been read
+/// completely from start to end.
+///
+/// The store is disabled until a root directory has been set. All
+/// functions are thread-safe.
+class DecodedAudioCache final {
+  public:
+    DecodedAudioCache() = delete;
+
+    /// An empty path or a size limit of 0 disables the store.
+    static void setRootPath(
+            const QString& rootPath,
+            qint64 maxSizeInBytes);
+    static QString rootPath();
+
+    static QString defaultRootPath(
+            const QString& settingsPath);
+
+    static bool isSupportedFileType(
+            const QString& fileType);
+
+    /// Returns an empty key if the store is disabled or if the file
+    /// could not be read.
+    static QByteArray contentKey(
+            const QUrl& url,
+            const AudioSource::OpenParams& params);
+
+    /// Returns nullptr if no decoded audio data is available.
+    static AudioSourcePointer openCachedSource(
+            const QByteArray& contentKey,
+            const QUrl& url,
+            const AudioSource::OpenParams& params);
+
+    /// Wraps an opened decoder for recording the decoded audio data
+    /// while reading. The recorded data is stored when closing the
+    /// returned source after all sample frames have been read in order.
+    static AudioSourcePointer recordDecodedSource(
+            const QByteArray& contentKey,
+            AudioSourcePointer pAudioSource);
+};
+
+} // namespace mixxx
@@ -0,0 +1,225 @@
+#include "sources/mappedfileinput.h"
+
+#include <QDir>
+#include <QStorageInfo>
+#include <cstring>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("MappedFileInput");
+
+#ifdef Q_OS_UNIX
+qint64 pageSize() {
+    static const qint64 kPageSize = sysconf(_SC_PAGESIZE);
+    return kPageSize;
+}
+
+int posixAdvice(AudioSource::AccessPattern accessPattern) {
+    switch (accessPattern) {
+    case AudioSource::AccessPattern::Sequential:
+        return POSIX_MADV_SEQUENTIAL;
+    case AudioSource::AccessPattern::Random:
+        return POSIX_MADV_RANDOM;
+    case AudioSource::AccessPattern::Playback:
+        break;
+    }
+    return POSIX_MADV_NORMAL;
+}
+#endif
+
+#ifndef Q_OS_WIN
+// File system types as reported by QStorageInfo on Linux and macOS
+const QList<QByteArray> kNetworkFileSystemTypes = {
+        QByteArrayLiteral("9p"),
+        QByteArrayLiteral("afpfs"),
+        QByteArrayLiteral("afs"),
+        QByteArrayLiteral("ceph"),
+        QByteArrayLiteral("cifs"),
+        QByteArrayLiteral("davfs"),
+        QByteArrayLiteral("fuse.sshfs"),
+        QByteArrayLiteral("glusterfs"),
+        QByteArrayLiteral("nfs"),
+        QByteArrayLiteral("nfs4"),
+        QByteArrayLiteral("smb3"),
+        QByteArrayLiteral("smbfs"),
+        QByteArrayLiteral("webdav"),
+};
+#endif
+
+bool isOnNetworkFileSystem(const QString& fileName) {
+    const QStorageInfo storageInfo(fileName);
+#ifdef Q_OS_WIN
+    const auto rootPath = QDir::toNativeSeparators(storageInfo.rootPath());
+    return rootPath.startsWith(QStringLiteral("\\\\")) ||
+            GetDriveTypeW(reinterpret_cast<LPCWSTR>(rootPath.utf16())) ==
+            DRIVE_REMOTE;
+#else
+    return kNetworkFileSystemTypes.contains(storageInfo.fileSystemType());
+#endif
+}
+
+} // anonymous namespace
+
+MappedFileInput::MappedFileInput(
+        const QString& fileName)
+        : m_fileName(fileName),
+          m_file(fileName),
+          m_pData(nullptr),
+          m_size(0),
+          m_pos(0),
+          m_accessPattern(AudioSource::AccessPattern::Playback) {
+}
+
+MappedFileInput::~MappedFileInput() {
+    close();
+}
+
+bool MappedFileInput::open(
+        AudioSource::AccessPattern accessPattern,
+        Mapping mapping) {
+    DEBUG_ASSERT(!isOpen());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open file:"
+                << m_fileName
+                << m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    m_pos = 0;
+    m_accessPattern = accessPattern;
+    if (m_size <= 0) {
+        // Empty files cannot be mapped
+        return true;
+    }
+    if (mapping == Mapping::LocalOnly && isOnNetworkFileSystem(m_fileName)) {
+        kLogger.debug()
+                << "Reading file on network file system:"
+                << m_fileName;
+        return true;
+    }
+    m_pData = m_file.map(0, m_size);
+    if (m_pData) {
+        advise(m_accessPattern);
+    } else {
+        kLogger.info()
+                << "Reading file that could not be mapped into memory:"
+                << m_fileName
+                << m_file.errorString();
+    }
+    return true;
+}
+
+void MappedFileInput::close() {
+    if (m_pData) {
+        m_file.unmap(m_pData);
+        m_pData = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+}
+
+void MappedFileInput::advise(
+        AudioSource::AccessPattern accessPattern) const {
+    DEBUG_ASSERT(m_pData);
+#ifdef Q_OS_UNIX
+    const int result = posix_madvise(m_pData, m_size, posixAdvice(accessPattern));
+    if (result != 0) {
+        kLogger.debug()
+                << "posix_madvise() failed:"
+                << result;
+    }
+#else
+    Q_UNUSED(accessPattern);
+#endif
+}
+
+void MappedFileInput::prefetch(
+        qint64 offset,
+        qint64 length) const {
+    if (!m_pData || m_accessPattern == AudioSource::AccessPattern::Sequential) {
+        return;
+    }
+    if (offset < 0 || offset >= m_size || length <= 0) {
+        return;
+    }
+#ifdef Q_OS_UNIX
+    // The address must be aligned to a page boundary
+    const qint64 alignedOffset = offset - offset % pageSize();
+    const qint64 alignedLength =
+            math_min(offset + length, m_size) - alignedOffset;
+    posix_madvise(m_pData + alignedOffset, alignedLength, POSIX_MADV_WILLNEED);
+#else
+    Q_UNUSED(length);
+#endif
+}
+
+void MappedFileInput::unmapIfTruncated() {
+    DEBUG_ASSERT(m_pData);
+    if (m_file.size() >= m_size) {
+        return;
+    }
+    kLogger.warning()
+            << "File has been truncated while reading:"
+            << m_fileName;
+    m_file.unmap(m_pData);
+    m_pData = nullptr;
+}
+
+qint64 MappedFileInput::read(
+        void* pBuffer,
+        qint64 maxBytes) {
+    DEBUG_ASSERT(isOpen());
+    DEBUG_ASSERT(maxBytes >= 0);
+    if (!m_pData) {
+        const qint64 bytes = m_file.read(static_cast<char*>(pBuffer), maxBytes);
+        if (bytes > 0) {
+            m_pos += bytes;
+        }
+        return bytes;
+    }
+    const qint64 bytes = math_min(maxBytes, m_size - m_pos);
+    if (bytes <= 0) {
+        return 0;
+    }
+    std::memcpy(pBuffer, m_pData + m_pos, bytes);
+    m_pos += bytes;
+    return bytes;
+}
+
+bool MappedFileInput::seek(
+        qint64 pos) {
+    DEBUG_ASSERT(isOpen());
+    if (pos < 0 || pos > m_size) {
+        return false;
+    }
+    if (m_pData) {
+        // Accessing pages beyond the end of a truncated file would
+        // raise SIGBUS. Checking the size requires a system call,
+        // which is only acceptable when seeking and not for each read.
+        unmapIfTruncated();
+    }
+    if (!m_pData && !m_file.seek(pos)) {
+        return false;
+    }
+    m_pos = pos;
+    return true;
+}
+
+} // namespace mixxx
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QFile>
+
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+/// Read-only input for decoders that maps the whole file into memory.
+///
+/// Decoders could either access the mapped data directly or read it
+/// through the stream functions for callback based APIs. The access
+/// pattern is passed on to the operating system to control read-ahead
+/// and caching of the mapped pages. Files on network file systems are
+/// not mapped, because the connection might be lost at any time. If
+/// the file is not mapped the stream functions fall back to reading
+/// the file.
+///
+/// If the file is truncated unexpectedly while mapped a SIGBUS error
+/// might occur that is not handled and terminates Mixxx immediately,
+/// see also: https://github.com/mixxxdj/mixxx/issues/8011
+/// This risk is accepted for local files, checking the size before
+/// each read would require the system call that mapping the file is
+/// supposed to avoid. The size is only validated again when seeking,
+/// which falls back to reading the file after it has been truncated.
+/// Decoders that access the mapped data directly are not protected.
+class MappedFileInput final {
+  public:
+    explicit MappedFileInput(
+            const QString& fileName);
+    ~MappedFileInput();
+
+    const QString& fileName() const {
+        return m_fileName;
+    }
+
+    enum class Mapping {
+        /// Only map files on local file systems
+        LocalOnly,
+        /// Always try to map the file, i.e. for decoders that access
+        /// the mapped data directly
+        Always,
+    };
+
+    bool open(
+            AudioSource::AccessPattern accessPattern,
+            Mapping mapping = Mapping::LocalOnly);
+    void close();
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    /// Returns nullptr if the file has not been mapped into memory.
+    const uchar* data() const {
+        return m_pData;
+    }
+    qint64 size() const {
+        return m_size;
+    }
+
+    /// Announce that the given range will be read soon, e.g. after
+    /// seeking. Does nothing when reading sequentially, because
+    /// the operating system already reads ahead aggressively.
+    void prefetch(
+            qint64 offset,
+            qint64 length) const;
+
+    /// Stream functions for callback based decoder APIs that need
+    /// to copy the data into their own buffers.
+    qint64 read(
+            void* pBuffer,
+            qint64 maxBytes);
+    bool seek(
+            qint64 pos);
+    qint64 pos() const {
+        return m_pos;
+    }
+    bool atEnd() const {
+        return m_pos >= m_size;
+    }
+
+  private:
+    void advise(
+            AudioSource::AccessPattern accessPattern) const;
+
+    /// Unmaps the file if it has been truncated and continues
+    /// reading from the file.
+    void unmapIfTruncated();
+
+    const QString m_fileName;
+    QFile m_file;
+    uchar* m_pData;
+    qint64 m_size;
+    qint64 m_pos;
+    AudioSource::AccessPattern m_accessPattern;
+};
+
+} // namespace mixxx
@@ -18,6 +18,13 @@ namespace {
 
 Logger kLogger("MetadataSourceTagLib");
 
+// The audio properties that are imported from the file are only
+// preliminary and will be replaced by the actual stream properties
+// when the file is opened for decoding. Avoid any additional I/O
+// for calculating more accurate values, e.g. by scanning the stream
+// or reading the last page of Ogg files.
+constexpr auto kAudioPropertiesReadStyle = TagLib::AudioProperties::Fast;
+
 // Workaround for missing functionality in TagLib 1.11.x that
 // doesn't support to read text chunks from AIFF files.
 // See also:
@@ -27,8 +34,10 @@ Logger kLogger("MetadataSourceTagLib");
 //
 class AiffFile : public TagLib::RIFF::AIFF::File {
   public:
-    explicit AiffFile(TagLib::FileName fileName)
-            : TagLib::RIFF::AIFF::File(fileName) {
+    AiffFile(TagLib::FileName fileName,
+            bool readProperties,
+            TagLib::AudioProperties::ReadStyle propertiesStyle)
+            : TagLib::RIFF::AIFF::File(fileName, readProperties, propertiesStyle) {
     }
 
     bool importTrackMetadataFromTextChunks(TrackMetadata* pTrackMetadata) /*non-const*/ {
@@ -102,6 +111,11 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
                         << "with type" << m_fileType;
     }
 
+    // Audio properties are not needed when only importing the cover
+    // image, e.g. for displaying it. Tags are always parsed and cover
+    // images are only decoded if requested.
+    const bool readAudioProperties = pTrackMetadata != nullptr;
+
     // Rationale: If a file contains different types of tags only
     // a single type of tag will be read. Tag types are read in a
     // fixed order. Both track metadata and cover art will be read
@@ -110,7 +124,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
 
     switch (m_fileType) {
     case taglib::FileType::MP3: {
-        TagLib::MPEG::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::MPEG::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -142,7 +158,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::MP4: {
-        TagLib::MP4::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::MP4::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -156,7 +174,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::FLAC: {
-        TagLib::FLAC::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::FLAC::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -197,7 +217,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::OGG: {
-        TagLib::Ogg::Vorbis::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::Ogg::Vorbis::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -213,7 +235,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::OPUS: {
-        TagLib::Ogg::Opus::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::Ogg::Opus::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -229,7 +253,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::WV: {
-        TagLib::WavPack::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::WavPack::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -243,7 +269,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::WAV: {
-        TagLib::RIFF::WAV::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        TagLib::RIFF::WAV::File file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
@@ -263,7 +291,9 @@ MetadataSourceTagLib::importTrackMetadataAndCoverImage(
         break;
     }
     case taglib::FileType::AIFF: {
-        AiffFile file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName));
+        AiffFile file(TAGLIB_FILENAME_FROM_QSTRING(m_fileName),
+                readAudioProperties,
+                kAudioPropertiesReadStyle);
         if (!taglib::readAudioPropertiesFromFile(pTrackMetadata, file)) {
             break;
         }
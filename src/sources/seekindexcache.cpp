@@ -0,0 +1,302 @@
+#include "sources/seekindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/disklrueviction.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndexCache");
+
+// Both the head and the tail of a file contain the metadata tags
+// and they are most likely to be modified. Together with the file
+// size this is sufficient for detecting modified files without
+// reading the whole file.
+constexpr qint64 kContentKeyHeadBytes = 64 * 1024;
+constexpr qint64 kContentKeyTailBytes = 64 * 1024;
+
+constexpr quint32 kFileMagic = 0x4D585349; // "MXSI"
+constexpr quint32 kFileVersion = 1;
+
+// Content keys of recently opened files are remembered until the
+// file is modified. This avoids reading and hashing the file
+// contents again when reopening a file.
+constexpr int kContentKeyCacheCapacity = 1024;
+
+struct CachedContentKey {
+    qint64 fileSize;
+    QDateTime lastModified;
+    QByteArray contentKey;
+};
+
+QMutex s_contentKeyMutex;
+QHash<QString, CachedContentKey> s_contentKeys;
+
+QMutex s_evictionMutex;
+std::shared_ptr<DiskLruEviction> s_pEviction;
+
+std::shared_ptr<DiskLruEviction> eviction() {
+    const auto locker = lockMutex(&s_evictionMutex);
+    return s_pEviction;
+}
+
+QString seekIndexFilePath(
+        const QString& rootPath,
+        const QByteArray& contentKey) {
+    const auto fileName = QString::fromLatin1(contentKey.toHex());
+    return QStringLiteral("%1/%2/%3")
+            .arg(rootPath,
+                    fileName.left(2),
+                    fileName);
+}
+
+} // anonymous namespace
+
+//static
+void SeekIndexCache::setRootPath(
+        const QString& rootPath,
+        qint64 maxSizeInBytes) {
+    // Seek indexes are stored without a suffix
+    auto pEviction = !rootPath.isEmpty() && maxSizeInBytes > 0
+            ? std::make_shared<DiskLruEviction>(rootPath, QString(), maxSizeInBytes)
+            : nullptr;
+    const auto locker = lockMutex(&s_evictionMutex);
+    s_pEviction = std::move(pEviction);
+}
+
+//static
+QString SeekIndexCache::rootPath() {
+    const auto pEviction = eviction();
+    return pEviction ? pEviction->rootPath() : QString();
+}
+
+//static
+QString SeekIndexCache::defaultRootPath(
+        const QString& settingsPath) {
+    return QDir(settingsPath).filePath(QStringLiteral("seekindex"));
+}
+
+//static
+QByteArray SeekIndexCache::contentKey(
+        const QString& formatVersion,
+        const uchar* pFileData,
+        qint64 fileSize) {
+    DEBUG_ASSERT(pFileData || fileSize == 0);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(formatVersion.toUtf8());
+    hash.addData(QByteArray::number(fileSize));
+    const qint64 headBytes = qMin(fileSize, kContentKeyHeadBytes);
+    hash.addData(reinterpret_cast<const char*>(pFileData),
+            static_cast<int>(headBytes));
+    const qint64 tailBytes = qMin(fileSize - headBytes, kContentKeyTailBytes);
+    hash.addData(reinterpret_cast<const char*>(pFileData + fileSize - tailBytes),
+            static_cast<int>(tailBytes));
+    return hash.result();
+}
+
+//static
+QByteArray SeekIndexCache::contentKey(
+        const QString& formatVersion,
+        const QString& fileName) {
+    const QFileInfo fileInfo(fileName);
+    const QDateTime lastModified = fileInfo.lastModified();
+    const QString cacheKey = formatVersion + QChar('\n') + fileName;
+    {
+        const auto locker = lockMutex(&s_contentKeyMutex);
+        const auto it = s_contentKeys.constFind(cacheKey);
+        if (it != s_contentKeys.constEnd() &&
+                it->fileSize == fileInfo.size() &&
+                it->lastModified == lastModified) {
+            return it->contentKey;
+        }
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    const qint64 fileSize = file.size();
+    const qint64 headBytes = qMin(fileSize, kContentKeyHeadBytes);
+    const qint64 tailBytes = qMin(fileSize - headBytes, kContentKeyTailBytes);
+    // Same input for the hash as when calculated from the mapped file
+    const QByteArray head = file.read(headBytes);
+    if (head.size() != headBytes ||
+            !file.seek(fileSize - tailBytes)) {
+        return QByteArray();
+    }
+    const QByteArray tail = file.read(tailBytes);
+    if (tail.size() != tailBytes) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(formatVersion.toUtf8());
+    hash.addData(QByteArray::number(fileSize));
+    hash.addData(head);
+    hash.addData(tail);
+    const QByteArray contentKey = hash.result();
+    {
+        const auto locker = lockMutex(&s_contentKeyMutex);
+        if (s_contentKeys.size() >= kContentKeyCacheCapacity) {
+            s_contentKeys.clear();
+        }
+        s_contentKeys.insert(cacheKey,
+                CachedContentKey{fileSize, lastModified, contentKey});
+    }
+    return contentKey;
+}
+
+//static
+bool SeekIndexCache::load(
+        const QByteArray& contentKey,
+        qint64 fileSize,
+        SeekIndex* pSeekIndex) {
+    DEBUG_ASSERT(pSeekIndex);
+    const auto rootPath = SeekIndexCache::rootPath();
+    if (rootPath.isEmpty()) {
+        return false;
+    }
+    const auto filePath = seekIndexFilePath(rootPath, contentKey);
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not available yet
+        return false;
+    }
+    DiskLruEviction::touch(filePath);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != kFileMagic || version != kFileVersion) {
+        kLogger.info()
+                << "Ignoring seek index with unsupported format"
+                << file.fileName();
+        return false;
+    }
+    qint32 channelCount;
+    qint32 sampleRate;
+    qint32 bitrate;
+    qint64 frameCount;
+    qint64 paddedTailOffset;
+    quint32 seekPointCount;
+    stream >> channelCount >> sampleRate >> bitrate >> frameCount >>
+            paddedTailOffset >> seekPointCount;
+    if (stream.status() != QDataStream::Ok ||
+            seekPointCount == 0 ||
+            // Each seek point occupies 8 bytes in the file
+            seekPointCount > static_cast<quint64>(file.size()) / 8) {
+        kLogger.warning()
+                << "Ignoring corrupt seek index"
+                << file.fileName();
+        return false;
+    }
+    SeekIndex seekIndex;
+    seekIndex.channelCount = channelCount;
+    seekIndex.sampleRate = sampleRate;
+    seekIndex.bitrate = bitrate;
+    seekIndex.frameCount = static_cast<SINT>(frameCount);
+    seekIndex.paddedTailOffset = paddedTailOffset;
+    seekIndex.seekPoints.reserve(seekPointCount);
+    // Seek points are delta encoded
+    SeekPoint seekPoint{0, 0};
+    for (quint32 i = 0; i < seekPointCount; ++i) {
+        quint32 frameDelta;
+        quint32 byteDelta;
+        stream >> frameDelta >> byteDelta;
+        seekPoint.frameIndex += frameDelta;
+        seekPoint.byteOffset += byteDelta;
+        seekIndex.seekPoints.push_back(seekPoint);
+    }
+    if (stream.status() != QDataStream::Ok ||
+            seekIndex.seekPoints.back().frameIndex >= seekIndex.frameCount ||
+            seekIndex.seekPoints.back().byteOffset >= fileSize ||
+            seekIndex.paddedTailOffset >= fileSize) {
+        kLogger.warning()
+                << "Ignoring corrupt seek index"
+                << file.fileName();
+        return false;
+    }
+    *pSeekIndex = std::move(seekIndex);
+    return true;
+}
+
+//static
+bool SeekIndexCache::store(
+        const QByteArray& contentKey,
+        const SeekIndex& seekIndex) {
+    const auto pEviction = eviction();
+    if (!pEviction) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(!seekIndex.seekPoints.empty()) {
+        return false;
+    }
+    const auto filePath = seekIndexFilePath(pEviction->rootPath(), contentKey);
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory for seek index"
+                << filePath;
+        return false;
+    }
+    // Concurrent readers will either see the previous or the
+    // complete file, but never a partially written file.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open seek index file for writing"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << kFileMagic
+           << kFileVersion
+           << static_cast<qint32>(seekIndex.channelCount)
+           << static_cast<qint32>(seekIndex.sampleRate)
+           << static_cast<qint32>(seekIndex.bitrate)
+           << static_cast<qint64>(seekIndex.frameCount)
+           << static_cast<qint64>(seekIndex.paddedTailOffset)
+           << static_cast<quint32>(seekIndex.seekPoints.size());
+    SeekPoint prevSeekPoint{0, 0};
+    for (const auto& seekPoint : seekIndex.seekPoints) {
+        VERIFY_OR_DEBUG_ASSERT(seekPoint.frameIndex >= prevSeekPoint.frameIndex &&
+                seekPoint.byteOffset >= prevSeekPoint.byteOffset) {
+            return false;
+        }
+        stream << static_cast<quint32>(seekPoint.frameIndex - prevSeekPoint.frameIndex)
+               << static_cast<quint32>(seekPoint.byteOffset - prevSeekPoint.byteOffset);
+        prevSeekPoint = seekPoint;
+    }
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write seek index file"
+                << filePath;
+        return false;
+    }
+    pEviction->fileStored(QFileInfo(filePath).size());
+    return true;
+}
+
+//static
+void SeekIndexCache::evictLeastRecentlyUsed() {
+    const auto pEviction = eviction();
+    if (pEviction) {
+        pEviction->evict();
+    }
+}
+
+} // namespace mixxx
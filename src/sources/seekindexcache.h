@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+#include "util/types.h"
+
+namespace mixxx {
+
+/// Persistent store for the seek tables of formats that can only be
+/// seeked accurately after scanning all frames of a file, e.g. MP3,
+/// or for the packet indexes that are collected while reading a file.
+///
+/// The seek tables are stored in separate files next to each other
+/// and are keyed by the contents of the audio file. The least recently
+/// used files are evicted when the total size exceeds the configured
+/// limit. The store is disabled until a root directory has been set.
+class SeekIndexCache final {
+  public:
+    struct SeekPoint {
+        SINT frameIndex;
+        qint64 byteOffset;
+    };
+
+    struct SeekIndex {
+        SeekIndex()
+                : channelCount(0),
+                  sampleRate(0),
+                  bitrate(0),
+                  frameCount(0),
+                  paddedTailOffset(-1) {
+        }
+
+        int channelCount;
+        int sampleRate;
+        /// kbit/s or 0 if unknown
+        int bitrate;
+        /// The exact number of sample frames
+        SINT frameCount;
+        /// Byte offset from which the decoder reads a copy of the
+        /// remaining contents of the file padded with 0 bytes or
+        /// -1 if not needed.
+        qint64 paddedTailOffset;
+        /// Ordered by both frame index and byte offset
+        std::vector<SeekPoint> seekPoints;
+    };
+
+    SeekIndexCache() = delete;
+
+    /// Thread-safe. An empty path or a size limit of 0 disables the
+    /// store.
+    static void setRootPath(
+            const QString& rootPath,
+            qint64 maxSizeInBytes);
+    static QString rootPath();
+
+    static QString defaultRootPath(
+            const QString& settingsPath);
+
+    /// Calculates the key from the size and from both the head and
+    /// the tail of the file contents. Reading the whole file would
+    /// be as expensive as scanning it. The format version must be
+    /// changed whenever the scanning of the format changes.
+    static QByteArray contentKey(
+            const QString& formatVersion,
+            const uchar* pFileData,
+            qint64 fileSize);
+    /// Reads the required parts of the file. The key is remembered
+    /// until the size or the modification time of the file changes.
+    /// Returns an empty key if the file could not be read.
+    static QByteArray contentKey(
+            const QString& formatVersion,
+            const QString& fileName);
+
+    /// Returns false if no valid seek index is available.
+    static bool load(
+            const QByteArray& contentKey,
+            qint64 fileSize,
+            SeekIndex* pSeekIndex);
+
+    static bool store(
+            const QByteArray& contentKey,
+            const SeekIndex& seekIndex);
+
+    /// Deletes the least recently used files until the total size no
+    /// longer exceeds the limit. This is done implicitly after storing
+    /// seek indexes from time to time.
+    static void evictLeastRecentlyUsed();
+};
+
+} // namespace mixxx
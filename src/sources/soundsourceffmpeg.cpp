@@ -4,6 +4,9 @@
 #include <libavutil/channel_layout.h>
 #endif
 
+#include <algorithm>
+#include <iterator>
+
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -63,6 +66,15 @@ constexpr int64_t kavStreamDecoderFrameDelayAAC = 2112;
 
 constexpr SINT kMaxSamplesPerMP3Frame = 1152;
 
+// Must be changed whenever the collection of packet index entries
+// is modified in an incompatible way.
+const QString kPacketIndexFormatVersion = QStringLiteral("ffmpeg-packets-1");
+
+// Limits the size of the packet index for codecs with small
+// packets. The decoding window after seeking is extended by
+// at most this distance.
+constexpr SINT kMinPacketIndexFrameDistance = 1024;
+
 const Logger kLogger("SoundSourceFFmpeg");
 
 // FFmpeg API Changes:
@@ -476,6 +488,9 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
           m_pavDecodedFrame(nullptr),
           m_pavResampledFrame(nullptr),
           m_seekPrerollFrameCount(0),
+          m_packetIndexEnabled(false),
+          m_packetIndexModified(false),
+          m_packetIndexMinFrameDistance(kMinPacketIndexFrameDistance),
           m_avutilVersion(avutil_version()) {
     DEBUG_ASSERT(m_pavPacket);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
@@ -726,9 +741,142 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
 
+    // Demuxers that support a generic index collect the index entries
+    // while reading and otherwise need to search the file when seeking.
+    // Demuxers that load a complete index from the file, e.g. for MP4,
+    // must not be touched.
+    m_packetIndexEnabled =
+            (m_pavInputFormatContext->iformat->flags & AVFMT_GENERIC_INDEX) != 0;
+    if (m_packetIndexEnabled) {
+        m_packetIndexMinFrameDistance = math_max(
+                static_cast<SINT>(m_seekPrerollFrameCount / 2),
+                kMinPacketIndexFrameDistance);
+        restorePacketIndex();
+    }
+
     return OpenResult::Succeeded;
 }
 
+void SoundSourceFFmpeg::restorePacketIndex() {
+    DEBUG_ASSERT(m_packetIndexEnabled);
+    DEBUG_ASSERT(m_packetIndex.empty());
+    // Don't read the file contents for the key if the store has been
+    // disabled, e.g. by a size limit of 0. The stored packet indexes
+    // are evicted together with the MP3 seek indexes.
+    if (SeekIndexCache::rootPath().isEmpty()) {
+        return;
+    }
+    m_packetIndexKey = SeekIndexCache::contentKey(
+            kPacketIndexFormatVersion, getLocalFileName());
+    if (m_packetIndexKey.isEmpty()) {
+        return;
+    }
+    SeekIndexCache::SeekIndex seekIndex;
+    if (!SeekIndexCache::load(
+                m_packetIndexKey,
+                m_pavInputFormatContext->pb
+                        ? avio_size(m_pavInputFormatContext->pb)
+                        : 0,
+                &seekIndex)) {
+        return;
+    }
+    if (seekIndex.channelCount != getSignalInfo().getChannelCount() ||
+            seekIndex.sampleRate != getSignalInfo().getSampleRate() ||
+            seekIndex.frameCount != frameIndexRange().length()) {
+        kLogger.info()
+                << "Ignoring packet index with mismatching properties for file"
+                << getLocalFileName();
+        return;
+    }
+    m_packetIndex = std::move(seekIndex.seekPoints);
+    // Populate the index of the demuxer that is used for seeking
+    for (const auto& seekPoint : m_packetIndex) {
+        av_add_index_entry(
+                m_pavStream,
+                seekPoint.byteOffset,
+                convertFrameIndexToStreamTime(*m_pavStream, seekPoint.frameIndex),
+                0,
+                0,
+                AVINDEX_KEYFRAME);
+    }
+#if VERBOSE_DEBUG_LOG
+    kLogger.debug()
+            << "Restored packet index with"
+            << m_packetIndex.size()
+            << "entries";
+#endif
+}
+
+void SoundSourceFFmpeg::storePacketIndex() {
+    if (!m_packetIndexModified) {
+        return;
+    }
+    m_packetIndexModified = false;
+    if (m_packetIndexKey.isEmpty() || m_packetIndex.empty()) {
+        return;
+    }
+    SeekIndexCache::SeekIndex seekIndex;
+    seekIndex.channelCount = getSignalInfo().getChannelCount();
+    seekIndex.sampleRate = getSignalInfo().getSampleRate();
+    seekIndex.frameCount = frameIndexRange().length();
+    seekIndex.seekPoints = m_packetIndex;
+    SeekIndexCache::store(m_packetIndexKey, seekIndex);
+}
+
+void SoundSourceFFmpeg::addPacketIndexEntry(
+        const AVPacket& avPacket,
+        SINT frameIndex) {
+    DEBUG_ASSERT(m_packetIndexEnabled);
+    if (!avPacket.data ||
+            avPacket.pos < 0 ||
+            (avPacket.flags & AV_PKT_FLAG_KEY) == 0 ||
+            frameIndex == ReadAheadFrameBuffer::kUnknownFrameIndex) {
+        return;
+    }
+    // Lead-in and lead-out packets are not needed for seeking
+    if (!frameIndexRange().containsIndex(frameIndex)) {
+        return;
+    }
+    const auto nextIter = std::upper_bound(
+            m_packetIndex.begin(),
+            m_packetIndex.end(),
+            frameIndex,
+            [](SINT frameIndex, const SeekIndexCache::SeekPoint& seekPoint) {
+                return frameIndex < seekPoint.frameIndex;
+            });
+    // Both neighbors must be sufficiently far away
+    if (nextIter != m_packetIndex.end() &&
+            (nextIter->frameIndex - frameIndex < m_packetIndexMinFrameDistance ||
+                    nextIter->byteOffset <= avPacket.pos)) {
+        return;
+    }
+    if (nextIter != m_packetIndex.begin()) {
+        const auto prevIter = std::prev(nextIter);
+        if (frameIndex - prevIter->frameIndex < m_packetIndexMinFrameDistance ||
+                prevIter->byteOffset >= avPacket.pos) {
+            return;
+        }
+    }
+    m_packetIndex.insert(nextIter,
+            SeekIndexCache::SeekPoint{frameIndex, avPacket.pos});
+    m_packetIndexModified = true;
+}
+
+const SeekIndexCache::SeekPoint* SoundSourceFFmpeg::findPacketIndexEntry(
+        SINT frameIndex) const {
+    const auto nextIter = std::upper_bound(
+            m_packetIndex.begin(),
+            m_packetIndex.end(),
+            frameIndex,
+            [](SINT frameIndex, const SeekIndexCache::SeekPoint& seekPoint) {
+                return frameIndex < seekPoint.frameIndex;
+            });
+    if (nextIter == m_packetIndex.begin()) {
+        return nullptr;
+    }
+    return &*std::prev(nextIter);
+}
+
 bool SoundSourceFFmpeg::initResampling(
         audio::ChannelCount* pResampledChannelCount,
         audio::SampleRate* pResampledSampleRate) {
@@ -861,6 +1009,10 @@ bool SoundSourceFFmpeg::initResampling(
 }
 
 void SoundSourceFFmpeg::close() {
+    storePacketIndex();
+    m_packetIndex.clear();
+    m_packetIndexKey.clear();
+    m_packetIndexEnabled = false;
     av_frame_free(&m_pavResampledFrame);
     DEBUG_ASSERT(!m_pavResampledFrame);
     av_frame_free(&m_pavDecodedFrame);
@@ -948,6 +1100,23 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
         return true;
     }
 
+    if (m_packetIndexEnabled) {
+        // The demuxer might have discarded index entries to limit its
+        // memory consumption. Make sure that the closest packet before
+        // the seek position is known for landing on it directly instead
+        // of searching the file or decoding from a distant position.
+        const auto* pSeekPoint = findPacketIndexEntry(seekIndex);
+        if (pSeekPoint) {
+            av_add_index_entry(
+                    m_pavStream,
+                    pSeekPoint->byteOffset,
+                    convertFrameIndexToStreamTime(*m_pavStream, pSeekPoint->frameIndex),
+                    0,
+                    0,
+                    AVINDEX_KEYFRAME);
+        }
+    }
+
     // Flush internal decoder state before seeking
     avcodec_flush_buffers(m_pavCodecContext);
 
@@ -990,6 +1159,9 @@ bool SoundSourceFFmpeg::consumeNextAVPacket(
             m_frameBuffer.invalidate();
             return false;
         }
+        if (m_packetIndexEnabled) {
+            addPacketIndexEntry(*m_pavPacket, packetFrameIndex);
+        }
         *ppavNextPacket = m_pavPacket;
     }
     auto* pavNextPacket = *ppavNextPacket;
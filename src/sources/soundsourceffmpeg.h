@@ -9,6 +9,7 @@ extern "C" {
 } // extern "C"
 
 #include "sources/readaheadframebuffer.h"
+#include "sources/seekindexcache.h"
 #include "sources/soundsourceprovider.h"
 
 namespace mixxx {
@@ -42,6 +43,20 @@ class SoundSourceFFmpeg : public SoundSource {
     bool consumeNextAVPacket(
             AVPacket** ppavNextPacket);
 
+    // The packet index maps frame indexes onto the byte offsets of
+    // the packets in the file. It is only maintained for demuxers
+    // that depend on index entries collected while reading for
+    // seeking, i.e. that would otherwise need to search or read the
+    // file from the last known position up to the seek position.
+    void restorePacketIndex();
+    void storePacketIndex();
+    void addPacketIndexEntry(
+            const AVPacket& avPacket,
+            SINT frameIndex);
+    // Returns nullptr if no packet starts at or before the given index
+    const SeekIndexCache::SeekPoint* findPacketIndexEntry(
+            SINT frameIndex) const;
+
     // Takes ownership of an input format context and ensures that
     // the corresponding AVFormatContext is closed, either explicitly
     // or implicitly by the destructor. The wrapper can only be
@@ -189,6 +204,12 @@ class SoundSourceFFmpeg : public SoundSource {
 
     FrameCount m_seekPrerollFrameCount;
 
+    bool m_packetIndexEnabled;
+    bool m_packetIndexModified;
+    SINT m_packetIndexMinFrameDistance;
+    QByteArray m_packetIndexKey;
+    std::vector<SeekIndexCache::SeekPoint> m_packetIndex;
+
     ReadAheadFrameBuffer m_frameBuffer;
 
     const unsigned int m_avutilVersion;
@@ -89,7 +89,7 @@ SoundSourceProviderPriority SoundSourceProviderFLAC::getPriorityHint(
 
 SoundSourceFLAC::SoundSourceFLAC(const QUrl& url)
         : SoundSource(url),
-          m_file(getLocalFileName()),
+          m_input(getLocalFileName()),
           m_decoder(nullptr),
           m_maxBlocksize(0),
           m_bitsPerSample(kBitsPerSampleDefault),
@@ -102,12 +102,12 @@ SoundSourceFLAC::~SoundSourceFLAC() {
 
 SoundSource::OpenResult SoundSourceFLAC::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
-    DEBUG_ASSERT(!m_file.isOpen());
-    if (!m_file.open(QIODevice::ReadOnly)) {
+        const OpenParams& params) {
+    DEBUG_ASSERT(!m_input.isOpen());
+    if (!m_input.open(params.getAccessPattern())) {
         kLogger.warning()
                 << "Failed to open FLAC file:"
-                << m_file.fileName();
+                << m_input.fileName();
         return OpenResult::Failed;
     }
 
@@ -155,7 +155,7 @@ void SoundSourceFLAC::close() {
         m_decoder = nullptr;
     }
 
-    m_file.close();
+    m_input.close();
 }
 
 ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
@@ -185,14 +185,14 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                 // Failure
                 kLogger.warning()
                         << "Seek error at" << seekFrameIndex
-                        << "in file" << m_file.fileName();
+                        << "in file" << m_input.fileName();
                 if (FLAC__STREAM_DECODER_SEEK_ERROR == FLAC__stream_decoder_get_state(m_decoder)) {
                     // Flush the input stream of the decoder according to the
                     // documentation of FLAC__stream_decoder_seek_absolute()
                     if (!FLAC__stream_decoder_flush(m_decoder)) {
                         kLogger.warning()
                                 << "Failed to flush input buffer of the FLAC decoder after seek failure"
-                                << "in file" << m_file.fileName();
+                                << "in file" << m_input.fileName();
                         invalidateCurFrameIndex();
                         // ...and abort
                         return ReadableSampleFrames(
@@ -268,7 +268,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
             if (!FLAC__stream_decoder_process_single(m_decoder)) {
                 kLogger.warning()
                         << "Failed to decode FLAC file"
-                        << m_file.fileName();
+                        << m_input.fileName();
                 break; // abort
             }
             // After decoding we might first need to skip some samples if the
@@ -280,7 +280,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                             << "Trying to adjust frame index"
                             << m_curFrameIndex << "<" << curFrameIndexBeforeProcessing
                             << "while decoding FLAC file"
-                            << m_file.fileName();
+                            << m_input.fileName();
                     const auto skipFrames =
                             IndexRange::between(m_curFrameIndex, curFrameIndexBeforeProcessing);
                     if (skipFrames != readSampleFramesClamped(WritableSampleFrames(skipFrames)).frameIndexRange()) {
@@ -288,7 +288,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                                 << "Failed to skip sample frames"
                                 << skipFrames
                                 << "while decoding FLAC file"
-                                << m_file.fileName();
+                                << m_input.fileName();
                         break; // abort
                     }
                 } else {
@@ -296,7 +296,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                             << "Unexpected frame index"
                             << m_curFrameIndex << ">" << curFrameIndexBeforeProcessing
                             << "while decoding FLAC file"
-                            << m_file.fileName();
+                            << m_input.fileName();
                     break; // abort
                 }
             }
@@ -341,7 +341,7 @@ FLAC__StreamDecoderReadStatus SoundSourceFLAC::flacRead(FLAC__byte buffer[],
         return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
     }
 
-    const qint64 readlen = m_file.read((char*)buffer, maxlen);
+    const qint64 readlen = m_input.read(buffer, maxlen);
 
     if (0 < readlen) {
         *bytes = readlen;
@@ -357,38 +357,29 @@ FLAC__StreamDecoderReadStatus SoundSourceFLAC::flacRead(FLAC__byte buffer[],
 }
 
 FLAC__StreamDecoderSeekStatus SoundSourceFLAC::flacSeek(FLAC__uint64 absolute_byte_offset) {
-    if (m_file.seek(absolute_byte_offset)) {
+    if (m_input.seek(absolute_byte_offset)) {
         return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
     } else {
         kLogger.warning()
                 << "SoundSourceFLAC: An unrecoverable error occurred ("
-                << m_file.fileName() << ")";
+                << m_input.fileName() << ")";
         return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
     }
 }
 
 FLAC__StreamDecoderTellStatus SoundSourceFLAC::flacTell(FLAC__uint64* offset) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_TELL_STATUS_UNSUPPORTED;
-    }
-    *offset = m_file.pos();
+    *offset = m_input.pos();
     return FLAC__STREAM_DECODER_TELL_STATUS_OK;
 }
 
 FLAC__StreamDecoderLengthStatus SoundSourceFLAC::flacLength(
         FLAC__uint64* length) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_LENGTH_STATUS_UNSUPPORTED;
-    }
-    *length = m_file.size();
+    *length = m_input.size();
     return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 }
 
 FLAC__bool SoundSourceFLAC::flacEOF() {
-    if (m_file.isSequential()) {
-        return false;
-    }
-    return m_file.atEnd();
+    return m_input.atEnd();
 }
 
 namespace {
@@ -589,7 +580,7 @@ void SoundSourceFLAC::flacError(FLAC__StreamDecoderErrorStatus status) {
     }
     kLogger.warning()
             << "FLAC decoding error" << error
-            << "in file" << m_file.fileName();
+            << "in file" << m_input.fileName();
     // not much else to do here... whatever function that initiated whatever
     // decoder method resulted in this error will return an error, and the caller
     // will bail. libFLAC docs say to not close the decoder here -- bkgood
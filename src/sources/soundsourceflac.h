@@ -2,8 +2,7 @@
 
 #include <FLAC/stream_decoder.h>
 
-#include <QFile>
-
+#include "sources/mappedfileinput.h"
 #include "sources/soundsourceprovider.h"
 #include "util/readaheadsamplebuffer.h"
 
@@ -36,7 +35,7 @@ class SoundSourceFLAC final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
-    QFile m_file;
+    MappedFileInput m_input;
 
     FLAC__StreamDecoder* m_decoder;
     // misc bits about the flac format:
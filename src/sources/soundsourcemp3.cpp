@@ -6,6 +6,8 @@
 
 #include <id3tag.h>
 
+#include <algorithm>
+
 namespace mixxx {
 
 namespace {
@@ -90,6 +92,23 @@ constexpr SINT kMaxMp3FramesPerSecond = 39; // fixed: 1 MP3 frame = 26 ms -> ~ 1
 constexpr SINT kSeekFrameListCapacity =
         kMinutesPerFile * kSecondsPerMinute * kMaxMp3FramesPerSecond;
 
+// Must be changed whenever the scanning of frame headers in tryOpen()
+// changes to invalidate all stored seek indexes
+const QString kSeekIndexFormatVersion = QStringLiteral("mp3-mad-1");
+
+// The amount of input data that is requested from the operating system
+// in advance after seeking, i.e. more than 5 seconds for 320 kbps
+constexpr qint64 kSeekPrefetchBytes = 256 * 1024;
+
+// Restored seek points are verified by sampling instead of checking
+// all of them to avoid touching each page of the memory mapped file
+constexpr SINT kSeekIndexVerificationCount = 64;
+
+inline bool isFrameSync(const unsigned char* pInputData) {
+    // 11 bits frame sync
+    return pInputData[0] == 0xFF && (pInputData[1] & 0xE0) == 0xE0;
+}
+
 inline QString formatHeaderFlags(int headerFlags) {
     return QString("0x%1").arg(headerFlags, 4, 16, QLatin1Char('0'));
 }
@@ -174,10 +193,11 @@ QString SoundSourceProviderMp3::getVersionString() const {
 
 SoundSourceMp3::SoundSourceMp3(const QUrl& url)
         : SoundSource(url),
-          m_file(getLocalFileName()),
+          m_input(getLocalFileName()),
           m_fileSize(0),
           m_pFileData(nullptr),
           m_avgSeekFrameCount(0),
+          m_paddedTailOffset(-1),
           m_curFrameIndex(0),
           m_madSynthCount(0),
           m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
@@ -205,22 +225,18 @@ void SoundSourceMp3::finishDecoding() {
 
 SoundSource::OpenResult SoundSourceMp3::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
-    DEBUG_ASSERT(!m_file.isOpen());
-    if (!m_file.open(QIODevice::ReadOnly)) {
-        kLogger.warning() << "Failed to open file:" << m_file.fileName();
+        const OpenParams& params) {
+    DEBUG_ASSERT(!m_input.isOpen());
+    // Get a pointer to the file using memory mapped IO
+    if (!m_input.open(params.getAccessPattern(), MappedFileInput::Mapping::Always)) {
         return OpenResult::Failed;
     }
-
-    // Get a pointer to the file using memory mapped IO
-    m_fileSize = m_file.size();
-    m_pFileData = m_file.map(0, m_fileSize);
-    // NOTE(uklotzde): If the file disappears unexpectedly while mapped
-    // a SIGBUS error might occur that is not handled and will terminate
-    // Mixxx immediately. This behavior is documented in the manpage of
-    // mmap(). It has already appeared due to hardware errors and is
-    // described in the following bug report:
-    // https://github.com/mixxxdj/mixxx/issues/8011
+    if (!m_input.data()) {
+        kLogger.warning() << "Failed to map file:" << m_input.fileName();
+        return OpenResult::Failed;
+    }
+    m_fileSize = m_input.size();
+    m_pFileData = m_input.data();
 
     // Transfer it to the mad stream-buffer:
     mad_stream_options(&m_madStream, MAD_OPTION_IGNORECRC);
@@ -229,7 +245,25 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
 
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
+    m_paddedTailOffset = -1;
     m_curFrameIndex = 0;
+
+    const QByteArray seekIndexKey = SeekIndexCache::contentKey(
+            kSeekIndexFormatVersion, m_pFileData, m_fileSize);
+    {
+        SeekIndexCache::SeekIndex seekIndex;
+        if (SeekIndexCache::load(seekIndexKey, m_fileSize, &seekIndex)) {
+            if (restoreSeekIndex(seekIndex)) {
+                return OpenResult::Succeeded;
+            }
+            kLogger.info()
+                    << "Rescanning MP3 file with outdated seek index:"
+                    << m_input.fileName();
+            m_seekFrameList.clear();
+            m_paddedTailOffset = -1;
+        }
+    }
+
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -258,6 +292,10 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     // https://github.com/mixxxdj/mixxx/pull/411
     bool mp3InfoTagSkipped = false;
 
+    // Scanning stops early when opening only a preview
+    const SINT previewFrameCount = params.getPreviewFrameCount();
+    bool preview = false;
+
     mad_header madHeader;
     mad_header_init(&madHeader);
 
@@ -266,7 +304,9 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         if (!decodeFrameHeader(&madHeader, &m_madStream, true)) {
             if (MAD_ERROR_BUFLEN == m_madStream.error) {
                 // try again with the copy and MAD_BUFFER_GUARD bytes
+                const unsigned char* pNextFrame = m_madStream.next_frame;
                 if (copyLeftoverFrame()) {
+                    m_paddedTailOffset = pNextFrame - m_pFileData;
                     continue;
                 }
             }
@@ -290,7 +330,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         if (0 >= madFrameLength) {
             kLogger.warning() << "Skipping MP3 frame with invalid length"
                               << madFrameLength
-                              << "in:" << m_file.fileName();
+                              << "in:" << m_input.fileName();
             // Skip frame
             continue;
         }
@@ -337,18 +377,18 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
                         << "Differing number of channels"
                         << madChannelCount << "<>" << maxChannelCount
                         << "in MP3 frame headers:"
-                        << m_file.fileName();
+                        << m_input.fileName();
             }
             maxChannelCount = math_max(madChannelCount, maxChannelCount);
         } else {
             kLogger.warning()
                     << "Missing number of channels in MP3 frame header:"
-                    << m_file.fileName();
+                    << m_input.fileName();
         }
 
         const int sampleRateIndex = getIndexBySampleRate(madSampleRate);
         if (sampleRateIndex >= kSampleRateCount) {
-            kLogger.warning() << "Invalid sample rate:" << m_file.fileName()
+            kLogger.warning() << "Invalid sample rate:" << m_input.fileName()
                               << madSampleRate;
             // Abort
             mad_header_finish(&madHeader);
@@ -373,6 +413,13 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         DEBUG_ASSERT(m_madStream.this_frame);
         DEBUG_ASSERT(0 <= (m_madStream.this_frame - m_pFileData) ||
                 m_madStream.this_frame == &*m_leftoverBuffer.begin());
+
+        if (previewFrameCount > 0 &&
+                m_curFrameIndex >= previewFrameCount &&
+                m_paddedTailOffset < 0) {
+            preview = true;
+            break;
+        }
     } while (m_madStream.next_frame < m_madStream.bufend);
 
     mad_header_finish(&madHeader);
@@ -391,7 +438,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     if (m_seekFrameList.empty()) {
         // This is not a working MP3 file.
         kLogger.warning() << "This is not a working MP3 file:"
-                          << m_file.fileName();
+                          << m_input.fileName();
         // Abort
         return OpenResult::Failed;
     }
@@ -411,7 +458,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
 
     if (differentRates > 1) {
         kLogger.warning() << "Differing sample rate in some headers:"
-                          << m_file.fileName();
+                          << m_input.fileName();
         for (int i = 0; i < kSampleRateCount; ++i) {
             if (0 < headerPerSampleRate[i]) {
                 kLogger.warning() << headerPerSampleRate[i] << "MP3 headers with sample rate" << getSampleRateByIndex(i);
@@ -429,7 +476,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
                 << "Invalid number of channels"
                 << maxChannelCount
                 << "in MP3 file:"
-                << m_file.fileName();
+                << m_input.fileName();
         // Abort
         return OpenResult::Failed;
     }
@@ -437,7 +484,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     if (mostCommonSampleRateIndex > kSampleRateCount) {
         kLogger.warning()
                 << "Unknown sample rate in MP3 file:"
-                << m_file.fileName();
+                << m_input.fileName();
         // Abort
         return OpenResult::Failed;
     }
@@ -462,25 +509,150 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     restartDecoding(m_seekFrameList.front());
 
     if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        kLogger.warning() << "Failed to start decoding:" << m_input.fileName();
         // Abort
         return OpenResult::Failed;
     }
 
+    if (preview) {
+        // The incomplete seek index must not be stored
+        kLogger.debug()
+                << "Opened preview with"
+                << frameLength()
+                << "sample frames:"
+                << m_input.fileName();
+        initPreview();
+        return OpenResult::Succeeded;
+    }
+
+    SeekIndexCache::store(seekIndexKey, createSeekIndex());
+
     return OpenResult::Succeeded;
 }
 
-void SoundSourceMp3::close() {
-    finishDecoding();
+bool SoundSourceMp3::restoreSeekIndex(
+        const SeekIndexCache::SeekIndex& seekIndex) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    const auto channelCount = audio::ChannelCount(seekIndex.channelCount);
+    const auto sampleRate = audio::SampleRate(seekIndex.sampleRate);
+    if (!channelCount.isValid() ||
+            channelCount > kChannelCountMax ||
+            getIndexBySampleRate(sampleRate) >= kSampleRateCount ||
+            seekIndex.seekPoints.empty() ||
+            seekIndex.seekPoints.front().frameIndex != 0) {
+        return false;
+    }
 
-    if (m_pFileData) {
-        m_file.unmap(m_pFileData);
-        m_pFileData = nullptr;
+    // Restore the padded copy of the last MP3 frame(s)
+    unsigned char* pLeftoverBuffer = &*m_leftoverBuffer.begin();
+    if (seekIndex.paddedTailOffset >= 0) {
+        const SINT remainingBytes =
+                static_cast<SINT>(m_fileSize - seekIndex.paddedTailOffset);
+        const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
+        if ((remainingBytes <= 0) || (leftoverBytes > SINT(m_leftoverBuffer.size()))) {
+            return false;
+        }
+        std::copy(m_pFileData + seekIndex.paddedTailOffset,
+                m_pFileData + m_fileSize,
+                pLeftoverBuffer);
+        std::fill(pLeftoverBuffer + remainingBytes, pLeftoverBuffer + leftoverBytes, 0);
     }
 
-    m_file.close();
+    SeekFrameList seekFrameList;
+    seekFrameList.reserve(seekIndex.seekPoints.size() + 1);
+    const SINT verificationStride = math_max(SINT(1),
+            static_cast<SINT>(seekIndex.seekPoints.size()) /
+                    kSeekIndexVerificationCount);
+    for (const auto& seekPoint : seekIndex.seekPoints) {
+        if (!seekFrameList.empty() &&
+                (seekFrameList.back().frameIndex >= seekPoint.frameIndex)) {
+            return false;
+        }
+        if ((seekPoint.byteOffset < 0) ||
+                (seekPoint.byteOffset + 1 >= static_cast<qint64>(m_fileSize))) {
+            return false;
+        }
+        SeekFrameType seekFrame;
+        seekFrame.frameIndex = seekPoint.frameIndex;
+        if ((seekIndex.paddedTailOffset >= 0) &&
+                (seekPoint.byteOffset >= seekIndex.paddedTailOffset)) {
+            seekFrame.pInputData = pLeftoverBuffer +
+                    (seekPoint.byteOffset - seekIndex.paddedTailOffset);
+        } else {
+            seekFrame.pInputData = m_pFileData + seekPoint.byteOffset;
+        }
+        // Each seek frame must start with a frame header
+        const SINT seekFrameIndex = static_cast<SINT>(seekFrameList.size());
+        if ((seekFrameIndex % verificationStride == 0 ||
+                    seekFrameIndex + 1 ==
+                            static_cast<SINT>(seekIndex.seekPoints.size())) &&
+                !isFrameSync(seekFrame.pInputData)) {
+            return false;
+        }
+        seekFrameList.push_back(seekFrame);
+    }
+
+    m_seekFrameList = std::move(seekFrameList);
+    m_paddedTailOffset = seekIndex.paddedTailOffset;
+    initChannelCountOnce(channelCount);
+    initSampleRateOnce(sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, seekIndex.frameCount));
+    if (seekIndex.bitrate > 0) {
+        initBitrateOnce(seekIndex.bitrate);
+    }
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+
+    // Terminate m_seekFrameList
+    addSeekFrame(seekIndex.frameCount, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+    DEBUG_ASSERT(m_curFrameIndex == frameIndexMin());
+
+    return true;
+}
+
+SeekIndexCache::SeekIndex SoundSourceMp3::createSeekIndex() const {
+    DEBUG_ASSERT(!m_seekFrameList.empty());
+    DEBUG_ASSERT(m_seekFrameList.back().pInputData == nullptr);
+    SeekIndexCache::SeekIndex seekIndex;
+    seekIndex.channelCount = getSignalInfo().getChannelCount();
+    seekIndex.sampleRate = getSignalInfo().getSampleRate();
+    seekIndex.bitrate = getBitrate().isValid() ? getBitrate().value() : 0;
+    seekIndex.frameCount = frameLength();
+    seekIndex.paddedTailOffset = m_paddedTailOffset;
+    // Omit the terminating seek frame
+    seekIndex.seekPoints.reserve(m_seekFrameList.size() - 1);
+    for (auto it = m_seekFrameList.begin(); it + 1 != m_seekFrameList.end(); ++it) {
+        seekIndex.seekPoints.push_back(SeekIndexCache::SeekPoint{
+                it->frameIndex,
+                inputDataOffset(it->pInputData)});
+    }
+    return seekIndex;
+}
+
+qint64 SoundSourceMp3::inputDataOffset(
+        const unsigned char* pInputData) const {
+    DEBUG_ASSERT(pInputData);
+    const unsigned char* pLeftoverBuffer = &*m_leftoverBuffer.begin();
+    if ((m_paddedTailOffset >= 0) &&
+            (pInputData >= pLeftoverBuffer) &&
+            (pInputData < pLeftoverBuffer + m_leftoverBuffer.size())) {
+        return m_paddedTailOffset + (pInputData - pLeftoverBuffer);
+    }
+    return pInputData - m_pFileData;
+}
+
+void SoundSourceMp3::close() {
+    finishDecoding();
+
+    m_input.close();
+    m_pFileData = nullptr;
+    m_fileSize = 0;
 
     m_seekFrameList.clear();
+    m_paddedTailOffset = -1;
 
     // Re-init the decoder, because the SoundSource might be reopened and
     // the destructor calls finishDecoding() after close().
@@ -512,6 +684,7 @@ void SoundSourceMp3::restartDecoding(
 
     // Fill input buffer
     mad_stream_buffer(&m_madStream, seekFrame.pInputData, m_fileSize - (seekFrame.pInputData - m_pFileData));
+    m_input.prefetch(inputDataOffset(seekFrame.pInputData), kSeekPrefetchBytes);
 
     if (frameIndexMin() < seekFrame.frameIndex) {
         // Muting is done here to eliminate potential pops/clicks
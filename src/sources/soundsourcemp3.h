@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sources/mappedfileinput.h"
+#include "sources/seekindexcache.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef _MSC_VER
@@ -10,8 +12,6 @@
 #endif
 #include <mad.h>
 
-#include <QFile>
-
 #include <vector>
 
 namespace mixxx {
@@ -32,9 +32,9 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
-    QFile m_file;
+    MappedFileInput m_input;
     quint64 m_fileSize;
-    unsigned char* m_pFileData;
+    const unsigned char* m_pFileData;
 
     /** Struct used to store mad frames for seeking */
     struct SeekFrameType {
@@ -58,6 +58,17 @@ class SoundSourceMp3 final : public SoundSource {
 
     bool copyLeftoverFrame();
 
+    /** Scanning all MP3 frame headers of a large file is expensive. The
+     * resulting seek frame list is stored in a persistent cache and
+     * restored when the same file is opened again.
+     */
+    bool restoreSeekIndex(const SeekIndexCache::SeekIndex& seekIndex);
+    SeekIndexCache::SeekIndex createSeekIndex() const;
+    qint64 inputDataOffset(const unsigned char* pInputData) const;
+
+    // The file offset of the data in m_leftoverBuffer or -1 if unused
+    qint64 m_paddedTailOffset;
+
     SINT m_curFrameIndex;
 
     // NOTE(uklotzde): Each invocation of initDecoding() must be
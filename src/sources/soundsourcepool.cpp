@@ -0,0 +1,212 @@
+#include "sources/soundsourcepool.h"
+
+#include <QCache>
+#include <QFileInfo>
+#include <QMutex>
+#include <list>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePool");
+
+// Each pooled source keeps its file open. The pool only needs to
+// cover the tracks that are reloaded frequently, e.g. in the
+// preview deck or by Auto DJ.
+constexpr std::size_t kPoolCapacity = 8;
+
+constexpr int kProviderCacheCapacity = 1024;
+
+QMutex s_mutex;
+
+// Most recently used entries first
+std::list<std::pair<SoundSourcePool::Key, SoundSourcePool::Entry>> s_entries;
+
+QCache<QString, QString> s_providerDisplayNames(kProviderCacheCapacity);
+
+void closeAll(const std::vector<SoundSourcePool::Entry>& entries) {
+    for (const auto& entry : entries) {
+        entry.pSoundSource->close();
+    }
+}
+
+} // anonymous namespace
+
+SoundSourcePool::Key::Key(
+        const QUrl& url,
+        const AudioSource::OpenParams& params)
+        : m_sizeInBytes(0),
+          m_signalInfo(params.getSignalInfo()),
+          m_accessPattern(params.getAccessPattern()) {
+    if (!url.isLocalFile()) {
+        return;
+    }
+    // Detect modified files
+    const QFileInfo fileInfo(url.toLocalFile());
+    if (!fileInfo.exists()) {
+        return;
+    }
+    m_location = fileInfo.absoluteFilePath();
+    m_sizeInBytes = fileInfo.size();
+    m_lastModified = fileInfo.lastModified();
+}
+
+bool operator==(
+        const SoundSourcePool::Key& lhs,
+        const SoundSourcePool::Key& rhs) {
+    return lhs.m_location == rhs.m_location &&
+            lhs.m_sizeInBytes == rhs.m_sizeInBytes &&
+            lhs.m_lastModified == rhs.m_lastModified &&
+            lhs.m_signalInfo == rhs.m_signalInfo &&
+            lhs.m_accessPattern == rhs.m_accessPattern;
+}
+
+//static
+SoundSourcePool::Entry SoundSourcePool::take(
+        const Key& key) {
+    if (!key.isValid()) {
+        return Entry{};
+    }
+    std::vector<Entry> staleEntries;
+    Entry entry;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        for (auto it = s_entries.begin(); it != s_entries.end();) {
+            if (it->first.location() != key.location()) {
+                ++it;
+                continue;
+            }
+            if (!entry.pSoundSource && it->first == key) {
+                entry = std::move(it->second);
+            } else if (!(it->first == key)) {
+                // The file has been modified in the meantime
+                staleEntries.push_back(std::move(it->second));
+            } else {
+                ++it;
+                continue;
+            }
+            it = s_entries.erase(it);
+        }
+    }
+    closeAll(staleEntries);
+    if (entry.pSoundSource && kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Reusing open source for"
+                << key.location();
+    }
+    return entry;
+}
+
+//static
+AudioSourcePointer SoundSourcePool::wrap(
+        Key key,
+        Entry entry) {
+    DEBUG_ASSERT(entry.pProvider);
+    DEBUG_ASSERT(entry.pSoundSource);
+    return std::make_shared<PooledAudioSource>(
+            std::move(key),
+            std::move(entry));
+}
+
+//static
+void SoundSourcePool::put(
+        Key key,
+        Entry entry) {
+    DEBUG_ASSERT(key.isValid());
+    DEBUG_ASSERT(entry.pSoundSource);
+    std::vector<Entry> evictedEntries;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        s_entries.emplace_front(std::move(key), std::move(entry));
+        while (s_entries.size() > kPoolCapacity) {
+            evictedEntries.push_back(std::move(s_entries.back().second));
+            s_entries.pop_back();
+        }
+    }
+    // Close files outside of the critical section
+    closeAll(evictedEntries);
+}
+
+//static
+void SoundSourcePool::evict(
+        const QString& location) {
+    // Same as Key::location()
+    const QString absoluteLocation = QFileInfo(location).absoluteFilePath();
+    std::vector<Entry> evictedEntries;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        for (auto it = s_entries.begin(); it != s_entries.end();) {
+            if (it->first.location() == absoluteLocation) {
+                evictedEntries.push_back(std::move(it->second));
+                it = s_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    closeAll(evictedEntries);
+}
+
+//static
+void SoundSourcePool::clear() {
+    std::vector<Entry> evictedEntries;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        for (auto& entry : s_entries) {
+            evictedEntries.push_back(std::move(entry.second));
+        }
+        s_entries.clear();
+    }
+    closeAll(evictedEntries);
+}
+
+//static
+void SoundSourcePool::rememberProvider(
+        const QString& location,
+        const QString& providerDisplayName) {
+    if (location.isEmpty()) {
+        return;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    s_providerDisplayNames.insert(location, new QString(providerDisplayName));
+}
+
+//static
+QString SoundSourcePool::lookupProvider(
+        const QString& location) {
+    const auto locker = lockMutex(&s_mutex);
+    const QString* pProviderDisplayName = s_providerDisplayNames.object(location);
+    if (!pProviderDisplayName) {
+        return QString();
+    }
+    return *pProviderDisplayName;
+}
+
+PooledAudioSource::PooledAudioSource(
+        SoundSourcePool::Key key,
+        SoundSourcePool::Entry entry)
+        : AudioSourceProxy(AudioSourcePointer(entry.pSoundSource)),
+          m_key(std::move(key)),
+          m_entry(std::move(entry)) {
+}
+
+void PooledAudioSource::close() {
+    if (!m_entry.pSoundSource) {
+        // Already closed
+        return;
+    }
+    if (m_key.isValid()) {
+        SoundSourcePool::put(m_key, std::move(m_entry));
+    } else {
+        m_entry.pSoundSource->close();
+    }
+    m_entry = SoundSourcePool::Entry{};
+}
+
+} // namespace mixxx
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QDateTime>
+#include <QString>
+#include <QUrl>
+
+#include "sources/audiosourceproxy.h"
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// Keeps recently closed sound sources open for reuse.
+///
+/// Opening a file requires probing the available providers and
+/// parsing the stream headers, which is expensive for some decoders.
+/// Sources that are closed by their consumer are parked in a small
+/// LRU pool instead and are handed out again when the same, unmodified
+/// file is opened with the same parameters. Each pooled source is
+/// owned exclusively by at most one consumer at a time.
+///
+/// Additionally the provider that has finally been used for opening
+/// a file is remembered, even after the source has been evicted from
+/// the pool. This avoids probing providers that are known to fail.
+///
+/// All functions are thread-safe.
+class SoundSourcePool final {
+  public:
+    class Key {
+      public:
+        Key() = default;
+        Key(const QUrl& url,
+                const AudioSource::OpenParams& params);
+
+        bool isValid() const {
+            return !m_location.isEmpty();
+        }
+
+        const QString& location() const {
+            return m_location;
+        }
+
+        friend bool operator==(const Key& lhs, const Key& rhs);
+
+      private:
+        QString m_location;
+        qint64 m_sizeInBytes = 0;
+        QDateTime m_lastModified;
+        audio::SignalInfo m_signalInfo;
+        AudioSource::AccessPattern m_accessPattern =
+                AudioSource::AccessPattern::Playback;
+    };
+
+    struct Entry {
+        SoundSourceProviderPointer pProvider;
+        SoundSourcePointer pSoundSource;
+    };
+
+    SoundSourcePool() = delete;
+
+    /// Removes and returns a pooled, still open source if available.
+    static Entry take(
+            const Key& key);
+
+    /// Wrap an open source for a consumer. Closing the returned
+    /// source puts it back into the pool instead of closing it.
+    static AudioSourcePointer wrap(
+            Key key,
+            Entry entry);
+
+    /// Closes all pooled sources of the given file. Must be called
+    /// before writing, moving or deleting the file, because open files
+    /// can't be modified on Windows.
+    static void evict(
+            const QString& location);
+
+    /// Closes all pooled sources.
+    static void clear();
+
+    static void rememberProvider(
+            const QString& location,
+            const QString& providerDisplayName);
+    /// Returns an empty string if unknown.
+    static QString lookupProvider(
+            const QString& location);
+
+  private:
+    static void put(
+            Key key,
+            Entry entry);
+
+    friend class PooledAudioSource;
+};
+
+/// The source that is handed out to consumers.
+class PooledAudioSource : public AudioSourceProxy {
+  public:
+    PooledAudioSource(
+            SoundSourcePool::Key key,
+            SoundSourcePool::Entry entry);
+
+    void close() override;
+
+  private:
+    const SoundSourcePool::Key m_key;
+    SoundSourcePool::Entry m_entry;
+};
+
+} // namespace mixxx
@@ -1,12 +1,15 @@
 #include "sources/soundsourceproxy.h"
 
 #include <QApplication>
+#include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
 
 #include "sources/audiosourcetrackproxy.h"
+#include "sources/decodedaudiocache.h"
+#include "sources/soundsourcepool.h"
 
 #ifdef __MAD__
 #include "sources/soundsourcemp3.h"
@@ -374,6 +377,9 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         const SyncTrackMetadataParams& syncParams) {
     DEBUG_ASSERT(pTrack);
     const auto fileInfo = pTrack->getFileInfo();
+    // Pooled sources keep the file open, which would prevent
+    // writing into the file on some platforms.
+    mixxx::SoundSourcePool::evict(fileInfo.location());
     mixxx::SoundSourcePointer pSoundSource;
     {
         auto proxy = SoundSourceProxy(fileInfo.toQUrl());
@@ -487,6 +493,31 @@ SoundSourceProxy::nextProviderWithOpenMode(
 void SoundSourceProxy::findProviderAndInitSoundSource() {
     DEBUG_ASSERT(!m_pProvider);
     DEBUG_ASSERT(!m_pSoundSource);
+    // Start with the provider that has been used for opening the
+    // file before instead of probing all providers again. If this
+    // provider fails the remaining providers are tried in turn and
+    // all providers are considered again in the permissive round.
+    const QString hintedProviderDisplayName = m_url.isLocalFile()
+            ? mixxx::SoundSourcePool::lookupProvider(
+                      QFileInfo(m_url.toLocalFile()).absoluteFilePath())
+            : QString();
+    if (!hintedProviderDisplayName.isEmpty()) {
+        for (m_providerRegistrationIndex = 0;
+                m_providerRegistrationIndex < m_providerRegistrations.size();
+                ++m_providerRegistrationIndex) {
+            mixxx::SoundSourceProviderPointer pProvider =
+                    m_providerRegistrations[m_providerRegistrationIndex]
+                            .getProvider();
+            if (!pProvider ||
+                    pProvider->getDisplayName() != hintedProviderDisplayName) {
+                continue;
+            }
+            if (initSoundSourceWithProvider(std::move(pProvider))) {
+                return; // Success
+            }
+            break;
+        }
+    }
     for (m_providerRegistrationIndex = 0;
             m_providerRegistrationIndex < m_providerRegistrations.size();
             ++m_providerRegistrationIndex) {
@@ -553,12 +584,20 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
         // https://github.com/mixxxdj/mixxx/issues/9944
         return importTrackMetadataAndCoverImageUnavailable();
     }
-    TrackPointer pTrack;
+    const auto trackRef = TrackRef::fromFileInfo(trackFileAccess.info());
+    // The cache doesn't need to be locked if the track object is already cached.
+    TrackPointer pTrack = GlobalTrackCacheLookup::lookupTrackByRef(trackRef);
+    if (pTrack) {
+        return SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                pTrackMetadata,
+                pCoverImage,
+                resetMissingTagMetadata);
+    }
     // Lock the global track cache while accessing the file to ensure
     // that no metadata is written. Since locking individual files
     // is not possible the whole cache has to be locked.
     GlobalTrackCacheLocker locker;
-    pTrack = locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()));
+    pTrack = locker.lookupTrackByRef(trackRef);
     if (pTrack) {
         // We can safely unlock the cache if the track object is already cached.
         locker.unlockCache();
@@ -927,11 +966,56 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
-    if (!openSoundSource(params)) {
-        return nullptr;
+    // Decoding of expensive formats is avoided if the decoded audio
+    // data is available.
+    const bool decodedAudioCacheEnabled = m_providerRegistrationIndex >= 0 &&
+            mixxx::DecodedAudioCache::isSupportedFileType(m_pTrack->getType());
+    const auto decodedAudioKey = decodedAudioCacheEnabled
+            ? mixxx::DecodedAudioCache::contentKey(m_url, params)
+            : QByteArray();
+    auto pCachedAudioSource = mixxx::DecodedAudioCache::openCachedSource(
+            decodedAudioKey, m_url, params);
+    if (pCachedAudioSource) {
+        m_pTrack->updateStreamInfoFromSource(
+                pCachedAudioSource->getStreamInfo());
+        return mixxx::AudioSourceTrackProxy::create(
+                m_pTrack, std::move(pCachedAudioSource));
+    }
+    auto poolKey = mixxx::SoundSourcePool::Key(m_url, params);
+    // Sources that have been opened with a different provider must
+    // not be reused if the provider has been selected explicitly.
+    auto pooledEntry = m_providerRegistrationIndex >= 0
+            ? mixxx::SoundSourcePool::take(poolKey)
+            : mixxx::SoundSourcePool::Entry{};
+    if (pooledEntry.pSoundSource) {
+        m_pProvider = std::move(pooledEntry.pProvider);
+        m_pSoundSource = std::move(pooledEntry.pSoundSource);
+    } else {
+        if (!openSoundSource(params)) {
+            return nullptr;
+        }
+        mixxx::SoundSourcePool::rememberProvider(
+                poolKey.location(),
+                m_pProvider->getDisplayName());
+    }
+    if (m_pSoundSource->isPreview()) {
+        // Neither the duration of a preview is correct nor must it
+        // be reused instead of the complete source.
+        return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
     }
     // Overwrite metadata with actual audio properties
     m_pTrack->updateStreamInfoFromSource(
             m_pSoundSource->getStreamInfo());
-    return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+    mixxx::AudioSourcePointer pAudioSource = m_pSoundSource;
+    if (poolKey.isValid()) {
+        pAudioSource = mixxx::SoundSourcePool::wrap(
+                std::move(poolKey),
+                mixxx::SoundSourcePool::Entry{m_pProvider, m_pSoundSource});
+    }
+    if (params.getAccessPattern() ==
+            mixxx::AudioSource::AccessPattern::Sequential) {
+        pAudioSource = mixxx::DecodedAudioCache::recordDecodedSource(
+                decodedAudioKey, std::move(pAudioSource));
+    }
+    return mixxx::AudioSourceTrackProxy::create(m_pTrack, std::move(pAudioSource));
 }
@@ -179,7 +179,8 @@ class SoundSourceProxy {
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
-    /// a null pointer on failure.
+    /// a null pointer on failure. The audio properties of a preview
+    /// (see AudioSource::isPreview()) are not applied to the track.
     ///
     /// The caller is responsible for invoking AudioSource::close().
     /// Otherwise the underlying files will remain open until the
@@ -1,8 +1,7 @@
 #include "sources/soundsourcesndfile.h"
 
-#include <QDir>
-
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/semanticversion.h"
 
 namespace mixxx {
@@ -40,6 +39,51 @@ QStringList getSupportedFileTypesFiltered() {
     return supportedFileTypes;
 };
 
+// Virtual I/O callbacks for reading from MappedFileInput
+sf_count_t sfGetFileLength(void* pUserData) {
+    return static_cast<MappedFileInput*>(pUserData)->size();
+}
+
+sf_count_t sfSeek(sf_count_t offset, int whence, void* pUserData) {
+    auto* pInput = static_cast<MappedFileInput*>(pUserData);
+    switch (whence) {
+    case SEEK_CUR:
+        offset += pInput->pos();
+        break;
+    case SEEK_END:
+        offset += pInput->size();
+        break;
+    default:
+        DEBUG_ASSERT(whence == SEEK_SET);
+    }
+    if (!pInput->seek(offset)) {
+        return -1;
+    }
+    return pInput->pos();
+}
+
+sf_count_t sfRead(void* pBuffer, sf_count_t count, void* pUserData) {
+    const qint64 bytes = static_cast<MappedFileInput*>(pUserData)->read(pBuffer, count);
+    return math_max(bytes, qint64(0));
+}
+
+sf_count_t sfWrite(const void* /*pBuffer*/, sf_count_t /*count*/, void* /*pUserData*/) {
+    // read-only
+    return 0;
+}
+
+sf_count_t sfTell(void* pUserData) {
+    return static_cast<MappedFileInput*>(pUserData)->pos();
+}
+
+SF_VIRTUAL_IO sfVirtualIO = {
+        sfGetFileLength,
+        sfSeek,
+        sfRead,
+        sfWrite,
+        sfTell,
+};
+
 } // anonymous namespace
 
 //static
@@ -67,6 +111,7 @@ SoundSourceProviderPriority SoundSourceProviderSndFile::getPriorityHint(
 
 SoundSourceSndFile::SoundSourceSndFile(const QUrl& url)
         : SoundSource(url),
+          m_input(getLocalFileName()),
           m_pSndFile(nullptr),
           m_curFrameIndex(0) {
 }
@@ -77,23 +122,16 @@ SoundSourceSndFile::~SoundSourceSndFile() {
 
 SoundSource::OpenResult SoundSourceSndFile::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!m_pSndFile);
+    if (!m_input.open(params.getAccessPattern())) {
+        return OpenResult::Failed;
+    }
     SF_INFO sfInfo;
     memset(&sfInfo, 0, sizeof(sfInfo));
-#ifdef __WINDOWS__
-    // Note: we cannot use QString::toStdWString since QT 4 is compiled with
-    // '/Zc:wchar_t-' flag and QT 5 not
-    const QString localFileName(QDir::toNativeSeparators(getLocalFileName()));
-    const ushort* const fileNameUtf16 = localFileName.utf16();
-    static_assert(sizeof(wchar_t) == sizeof(ushort), "QString::utf16(): wchar_t and ushort have different sizes");
-    m_pSndFile = sf_wchar_open(
-            reinterpret_cast<wchar_t*>(const_cast<ushort*>(fileNameUtf16)),
-            SFM_READ,
-            &sfInfo);
-#else
-    m_pSndFile = sf_open(QFile::encodeName(getLocalFileName()), SFM_READ, &sfInfo);
-#endif
+    // Read from the memory mapped file instead of letting libsndfile
+    // issue a system call for each read
+    m_pSndFile = sf_open_virtual(&sfVirtualIO, SFM_READ, &sfInfo, &m_input);
 
     switch (sf_error(m_pSndFile)) {
     case SF_ERR_NO_ERROR:
@@ -137,6 +175,10 @@ void SoundSourceSndFile::close() {
                               << getUrlString();
         }
     }
+    if (m_pSndFile == nullptr) {
+        // The input must outlive the libsndfile handle
+        m_input.close();
+    }
 }
 
 ReadableSampleFrames SoundSourceSndFile::readSampleFramesClamped(
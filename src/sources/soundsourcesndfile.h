@@ -1,13 +1,8 @@
 #pragma once
 
+#include "sources/mappedfileinput.h"
 #include "sources/soundsourceprovider.h"
 
-#ifdef Q_OS_WIN
-//Enable unicode in libsndfile on Windows
-//(sf_open uses UTF-8 otherwise)
-#include <windows.h>
-#define ENABLE_SNDFILE_WINDOWS_PROTOTYPES 1
-#endif
 #include <sndfile.h>
 
 namespace mixxx {
@@ -28,6 +23,7 @@ class SoundSourceSndFile final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    MappedFileInput m_input;
     SNDFILE* m_pSndFile;
 
     SINT m_curFrameIndex;
@@ -0,0 +1,171 @@
+#include "analyzer/analyzerchunkdecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QUrl>
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr SINT kFramesPerStripe = AnalyzerChunkDecoder::kFramesPerStripe;
+
+constexpr SINT kFrameLength = 5 * kFramesPerStripe + 1000;
+
+constexpr int kHelperThreadCount = 3;
+
+/// Generates distinct samples. All reads of chunks that contain
+/// corruptFrameIndex end before this frame, i.e. the file appears to
+/// be truncated.
+class FakeAudioSource : public mixxx::AudioSource {
+  public:
+    explicit FakeAudioSource(SINT corruptFrameIndex)
+            : AudioSource(QUrl()),
+              m_corruptFrameIndex(corruptFrameIndex) {
+    }
+
+    void close() override {
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!initChannelCountOnce(mixxx::kAnalysisChannels) ||
+                !initSampleRateOnce(mixxx::audio::SampleRate(44100)) ||
+                !initFrameIndexRangeOnce(mixxx::IndexRange::forward(0, kFrameLength))) {
+            return OpenResult::Aborted;
+        }
+        return OpenResult::Succeeded;
+    }
+
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override {
+        auto frameIndexRange = sampleFrames.frameIndexRange();
+        if (frameIndexRange.start() <= m_corruptFrameIndex &&
+                frameIndexRange.end() > m_corruptFrameIndex) {
+            frameIndexRange.shrinkBack(frameIndexRange.end() - m_corruptFrameIndex);
+        }
+        const SINT firstSampleIndex =
+                getSignalInfo().frames2samples(frameIndexRange.start());
+        const SINT sampleCount =
+                getSignalInfo().frames2samples(frameIndexRange.length());
+        for (SINT i = 0; i < sampleCount; ++i) {
+            sampleFrames.writableData()[i] =
+                    static_cast<CSAMPLE>((firstSampleIndex + i) % 65536);
+        }
+        return mixxx::ReadableSampleFrames(
+                frameIndexRange,
+                mixxx::SampleBuffer::ReadableSlice(
+                        sampleFrames.writableData(),
+                        sampleCount));
+    }
+
+  private:
+    const SINT m_corruptFrameIndex;
+};
+
+mixxx::AudioSourcePointer openFakeAudioSource(SINT corruptFrameIndex) {
+    auto pAudioSource = std::make_shared<FakeAudioSource>(corruptFrameIndex);
+    if (pAudioSource->open(mixxx::AudioSource::OpenMode::Strict) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    return pAudioSource;
+}
+
+/// Same as AnalyzerThread::analyzeAudioSource()
+void readSequentially(
+        std::vector<CSAMPLE>* pSamples,
+        mixxx::AudioSource* pAudioSource,
+        mixxx::IndexRange remainingFrameRange) {
+    mixxx::SampleBuffer sampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+    while (!remainingFrameRange.empty()) {
+        const auto chunkFrameRange = remainingFrameRange.splitAndShrinkFront(
+                math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        chunkFrameRange,
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        remainingFrameRange = intersect(remainingFrameRange, pAudioSource->frameIndexRange());
+        pSamples->insert(pSamples->end(),
+                readableSampleFrames.readableData(),
+                readableSampleFrames.readableData() +
+                        readableSampleFrames.readableLength());
+    }
+}
+
+std::vector<CSAMPLE> decodeSequentially(SINT corruptFrameIndex) {
+    std::vector<CSAMPLE> samples;
+    const auto pAudioSource = openFakeAudioSource(corruptFrameIndex);
+    readSequentially(&samples, pAudioSource.get(), pAudioSource->frameIndexRange());
+    return samples;
+}
+
+/// Same as AnalyzerThread::analyzeDecodedChunks(), continues
+/// sequentially after decoding failed
+std::vector<CSAMPLE> decodeInParallel(SINT corruptFrameIndex, bool* pFailed) {
+    std::vector<CSAMPLE> samples;
+    auto remainingFrameRange = mixxx::IndexRange::forward(0, kFrameLength);
+    {
+        AnalyzerChunkDecoder decoder(
+                [corruptFrameIndex] {
+                    return openFakeAudioSource(corruptFrameIndex);
+                },
+                remainingFrameRange,
+                kHelperThreadCount);
+        while (true) {
+            const auto readableSampleFrames = decoder.nextChunk();
+            if (readableSampleFrames.frameIndexRange().empty()) {
+                break;
+            }
+            EXPECT_EQ(remainingFrameRange.start(),
+                    readableSampleFrames.frameIndexRange().start());
+            remainingFrameRange.shrinkFront(readableSampleFrames.frameLength());
+            samples.insert(samples.end(),
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableData() +
+                            readableSampleFrames.readableLength());
+        }
+        *pFailed = decoder.hasFailed();
+    }
+    if (!remainingFrameRange.empty()) {
+        const auto pAudioSource = openFakeAudioSource(corruptFrameIndex);
+        readSequentially(&samples, pAudioSource.get(), remainingFrameRange);
+    }
+    return samples;
+}
+
+TEST(AnalyzerChunkDecoderTest, sameAsSequential) {
+    bool failed = true;
+    const auto samples = decodeInParallel(kFrameLength, &failed);
+    EXPECT_FALSE(failed);
+    ASSERT_EQ(static_cast<size_t>(kFrameLength * mixxx::kAnalysisChannels), samples.size());
+    EXPECT_EQ(decodeSequentially(kFrameLength), samples);
+}
+
+TEST(AnalyzerChunkDecoderTest, shortReadSameAsSequential) {
+    // Within a chunk of the 4th stripe
+    constexpr SINT kCorruptFrameIndex = 3 * kFramesPerStripe + 5000;
+    bool failed = false;
+    const auto samples = decodeInParallel(kCorruptFrameIndex, &failed);
+    EXPECT_TRUE(failed);
+    ASSERT_EQ(static_cast<size_t>(kCorruptFrameIndex * mixxx::kAnalysisChannels),
+            samples.size());
+    EXPECT_EQ(decodeSequentially(kCorruptFrameIndex), samples);
+}
+
+TEST(AnalyzerChunkDecoderTest, openFailed) {
+    AnalyzerChunkDecoder decoder(
+            [] {
+                return mixxx::AudioSourcePointer();
+            },
+            mixxx::IndexRange::forward(0, kFrameLength),
+            kHelperThreadCount);
+    EXPECT_TRUE(decoder.nextChunk().frameIndexRange().empty());
+    EXPECT_TRUE(decoder.hasFailed());
+}
+
+} // anonymous namespace
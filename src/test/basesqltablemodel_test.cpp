@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "library/basesqltablemodel.h"
+#include "library/trackcollection.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QString kTableName = QStringLiteral("row_metadata_test");
+
+constexpr int kScoreColumn = 1;
+
+/// Provides a row-specific score column for each row in a table
+/// that is independent of the library.
+class RowMetadataTableModel : public BaseSqlTableModel {
+  public:
+    explicit RowMetadataTableModel(TrackCollectionManager* pTrackCollectionManager)
+            : BaseSqlTableModel(nullptr,
+                      pTrackCollectionManager,
+                      "mixxx.db.model.test.rowmetadata") {
+        setTable(kTableName,
+                QStringLiteral("id"),
+                QStringList{QStringLiteral("id"), QStringLiteral("score")},
+                nullptr);
+    }
+
+    bool isColumnInternal(int column) override {
+        Q_UNUSED(column);
+        return false;
+    }
+};
+
+} // anonymous namespace
+
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    /// One more page than can be cached
+    static constexpr int kRowCount =
+            (BaseSqlTableModel::kMaxCachedMetadataPages + 1) *
+            BaseSqlTableModel::kRowsPerMetadataPage;
+
+    BaseSqlTableModelTest() {
+        // Temporary tables are only visible to the connection of the model
+        QSqlQuery query(internalCollection()->database());
+        EXPECT_TRUE(query.exec(
+                QStringLiteral("CREATE TEMPORARY TABLE %1 "
+                               "(id INTEGER PRIMARY KEY, score INTEGER)")
+                        .arg(kTableName)));
+        EXPECT_TRUE(query.exec(
+                QStringLiteral("WITH RECURSIVE ids(id) AS "
+                               "(SELECT 1 UNION ALL SELECT id + 1 FROM ids "
+                               "WHERE id < %1) "
+                               "INSERT INTO %2 SELECT id, id * 10 FROM ids")
+                        .arg(QString::number(kRowCount), kTableName)));
+    }
+
+    static int firstRowOnPage(int page) {
+        return page * BaseSqlTableModel::kRowsPerMetadataPage;
+    }
+};
+
+TEST_F(BaseSqlTableModelTest, evictLeastRecentlyUsedMetadataPages) {
+    RowMetadataTableModel model(trackCollectionManager());
+    model.select();
+    ASSERT_EQ(kRowCount, model.rowCount());
+
+    for (int page = 0; page < BaseSqlTableModel::kMaxCachedMetadataPages; ++page) {
+        const int row = firstRowOnPage(page);
+        EXPECT_EQ((row + 1) * 10,
+                model.tableColumnValue(row, kScoreColumn).toInt());
+    }
+    EXPECT_EQ(BaseSqlTableModel::kMaxCachedMetadataPages,
+            model.m_rowMetadataPages.size());
+    EXPECT_EQ(0, model.m_rowMetadataPageLru.first());
+
+    // Accessing a cached page makes it the most recently used page
+    model.tableColumnValue(firstRowOnPage(0), kScoreColumn);
+    EXPECT_EQ(BaseSqlTableModel::kMaxCachedMetadataPages,
+            model.m_rowMetadataPages.size());
+    EXPECT_EQ(1, model.m_rowMetadataPageLru.first());
+    EXPECT_EQ(0, model.m_rowMetadataPageLru.last());
+
+    // Fetching another page evicts the least recently used page
+    const int lastPage = BaseSqlTableModel::kMaxCachedMetadataPages;
+    EXPECT_EQ(kRowCount * 10,
+            model.tableColumnValue(kRowCount - 1, kScoreColumn).toInt());
+    EXPECT_EQ(BaseSqlTableModel::kMaxCachedMetadataPages,
+            model.m_rowMetadataPages.size());
+    EXPECT_EQ(BaseSqlTableModel::kMaxCachedMetadataPages,
+            model.m_rowMetadataPageLru.size());
+    EXPECT_FALSE(model.m_rowMetadataPages.contains(1));
+    EXPECT_TRUE(model.m_rowMetadataPages.contains(0));
+    EXPECT_TRUE(model.m_rowMetadataPages.contains(lastPage));
+    EXPECT_EQ(lastPage, model.m_rowMetadataPageLru.last());
+}
+
+TEST_F(BaseSqlTableModelTest, dropMetadataPagesOnSelect) {
+    RowMetadataTableModel model(trackCollectionManager());
+    model.select();
+    EXPECT_EQ(10,
+            model.tableColumnValue(firstRowOnPage(0), kScoreColumn).toInt());
+    EXPECT_EQ(2570,
+            model.tableColumnValue(firstRowOnPage(1), kScoreColumn).toInt());
+    EXPECT_EQ(2, model.m_rowMetadataPages.size());
+
+    QSqlQuery query(internalCollection()->database());
+    ASSERT_TRUE(query.exec(
+            QStringLiteral("UPDATE %1 SET score = score + 1").arg(kTableName)));
+    // Still cached
+    EXPECT_EQ(10,
+            model.tableColumnValue(firstRowOnPage(0), kScoreColumn).toInt());
+
+    // Re-selecting replaces all rows and drops all cached pages
+    model.select();
+    EXPECT_TRUE(model.m_rowMetadataPages.isEmpty());
+    EXPECT_TRUE(model.m_rowMetadataPageLru.isEmpty());
+    EXPECT_EQ(11,
+            model.tableColumnValue(firstRowOnPage(0), kScoreColumn).toInt());
+    EXPECT_EQ(1, model.m_rowMetadataPages.size());
+
+    // Also if no rows are left
+    ASSERT_TRUE(query.exec(
+            QStringLiteral("DELETE FROM %1").arg(kTableName)));
+    model.select();
+    EXPECT_EQ(0, model.rowCount());
+    EXPECT_TRUE(model.m_rowMetadataPages.isEmpty());
+    EXPECT_TRUE(model.m_rowMetadataPageLru.isEmpty());
+}
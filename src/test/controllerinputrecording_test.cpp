@@ -0,0 +1,47 @@
+#include "controllers/controllerinputrecording.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+namespace {
+
+TEST(ControllerInputRecordingTest, recordAndLoad) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("test.controllerinput"));
+    const QByteArray shortMessage = QByteArray::fromHex("b02241");
+    const QByteArray sysexMessage = QByteArray::fromHex("f000207f03f7");
+    {
+        ControllerInputRecorder recorder(filePath,
+                QStringLiteral("My Controller"),
+                QStringLiteral("My-Controller.midi.xml"));
+        ASSERT_TRUE(recorder.isOpen());
+        recorder.record(shortMessage, mixxx::Duration::fromMillis(1000));
+        recorder.record(sysexMessage, mixxx::Duration::fromMicros(1001500));
+    }
+
+    const auto recording = ControllerInputRecording::load(filePath);
+    ASSERT_TRUE(recording);
+    EXPECT_EQ(QStringLiteral("My Controller"), recording->controllerName);
+    EXPECT_EQ(QStringLiteral("My-Controller.midi.xml"), recording->mappingFileName);
+    ASSERT_EQ(2, recording->events.size());
+    // Timestamps are relative to the first event
+    EXPECT_EQ(mixxx::Duration::empty(), recording->events[0].timestamp);
+    EXPECT_EQ(shortMessage, recording->events[0].data);
+    EXPECT_EQ(mixxx::Duration::fromMicros(1500), recording->events[1].timestamp);
+    EXPECT_EQ(sysexMessage, recording->events[1].data);
+}
+
+TEST(ControllerInputRecordingTest, loadInvalidFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("invalid.controllerinput"));
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("# Mixxx controller input recording\nabc b0 22 41\n");
+    file.close();
+    EXPECT_FALSE(ControllerInputRecording::load(filePath));
+}
+
+} // namespace
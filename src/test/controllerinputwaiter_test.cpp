@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "controllers/controllerinputwaiter.h"
+
+#ifdef __LINUX__
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr mixxx::Duration kTimeout = mixxx::Duration::fromMillis(10);
+
+class ControllerInputWaiterTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(0, pipe2(m_pipeFds, O_NONBLOCK | O_CLOEXEC));
+    }
+
+    void TearDown() override {
+        ::close(m_pipeFds[0]);
+        if (m_pipeFds[1] >= 0) {
+            ::close(m_pipeFds[1]);
+        }
+    }
+
+    /// Simulates unplugging the device
+    void closeWriteFd() {
+        ::close(m_pipeFds[1]);
+        m_pipeFds[1] = -1;
+    }
+
+    int readFd() const {
+        return m_pipeFds[0];
+    }
+
+    int writeFd() const {
+        return m_pipeFds[1];
+    }
+
+  private:
+    int m_pipeFds[2];
+};
+
+TEST_F(ControllerInputWaiterTest, timedOut) {
+    ControllerInputWaiter waiter;
+    ASSERT_TRUE(waiter.isValid());
+    ASSERT_TRUE(waiter.addInput(readFd()));
+
+    EXPECT_EQ(ControllerInputWaiter::Result::TimedOut, waiter.wait(kTimeout));
+}
+
+TEST_F(ControllerInputWaiterTest, inputAvailable) {
+    ControllerInputWaiter waiter;
+    ASSERT_TRUE(waiter.isValid());
+    ASSERT_TRUE(waiter.addInput(readFd()));
+
+    const char data = 0x42;
+    ASSERT_EQ(1, ::write(writeFd(), &data, 1));
+    // Input is reported until it has been consumed
+    EXPECT_EQ(ControllerInputWaiter::Result::InputAvailable, waiter.wait(kTimeout));
+    EXPECT_EQ(ControllerInputWaiter::Result::InputAvailable, waiter.wait(kTimeout));
+
+    char readData = 0;
+    ASSERT_EQ(1, ::read(readFd(), &readData, 1));
+    EXPECT_EQ(data, readData);
+    EXPECT_EQ(ControllerInputWaiter::Result::TimedOut, waiter.wait(kTimeout));
+}
+
+TEST_F(ControllerInputWaiterTest, wokenUp) {
+    ControllerInputWaiter waiter;
+    ASSERT_TRUE(waiter.isValid());
+    ASSERT_TRUE(waiter.addInput(readFd()));
+
+    // Multiple pending wake-ups are merged into a single one
+    waiter.wakeUp();
+    waiter.wakeUp();
+    EXPECT_EQ(ControllerInputWaiter::Result::WokenUp, waiter.wait(kTimeout));
+    EXPECT_EQ(ControllerInputWaiter::Result::TimedOut, waiter.wait(kTimeout));
+}
+
+TEST_F(ControllerInputWaiterTest, inputClosed) {
+    ControllerInputWaiter waiter;
+    ASSERT_TRUE(waiter.isValid());
+    ASSERT_TRUE(waiter.addInput(readFd()));
+
+    closeWriteFd();
+    // Reported until the input is removed
+    EXPECT_EQ(ControllerInputWaiter::Result::InputClosed, waiter.wait(kTimeout));
+    EXPECT_EQ(ControllerInputWaiter::Result::InputClosed, waiter.wait(kTimeout));
+
+    waiter.removeInput(readFd());
+    EXPECT_EQ(ControllerInputWaiter::Result::TimedOut, waiter.wait(kTimeout));
+}
+
+} // anonymous namespace
+
+#endif // __LINUX__
@@ -0,0 +1,353 @@
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "controllers/controllerinputrecording.h"
+#ifdef __HID__
+#include "controllers/hid/hidinputreportdecoder.h"
+#endif
+#include "controllers/midi/midicontroller.h"
+#include "test/controller_mapping_validation_test.h"
+#include "test/signalpathtest.h"
+#include "util/time.h"
+
+// Benchmarks for replaying recorded controller input into the bundled
+// mapping that was active during the recording. Recordings are created
+// by starting Mixxx with --controller-record-path. The recordings in
+// src/test/controller-input-recordings are always replayed, additional
+// recordings are read from the directory in the environment variable
+// MIXXX_CONTROLLER_RECORDINGS. Both benchmarks are registered once for each
+// recording when the benchmarks are started.
+//
+// Each message is delivered synchronously like by the controller thread,
+// i.e. the reported latency is the time needed by the mapping and the
+// script engine to process a single message. Pending events, e.g. script
+// timers, are processed in between.
+//
+// The bundled DDJ-400 recording is a short synthesized session that is
+// generated by tools/generate_controller_input_recording.py. Longer
+// sessions can be generated with the same script.
+
+/// A MIDI controller without a device that receives the recorded messages
+class ReplayMidiController : public MidiController {
+  public:
+    ReplayMidiController()
+            : MidiController(QStringLiteral("Replay")) {
+    }
+    ~ReplayMidiController() override {
+        close();
+    }
+
+    int open() override {
+        setOpen(true);
+        startEngine();
+        getScriptEngine()->setTesting(true);
+        return 0;
+    }
+
+    int close() override {
+        if (!isOpen()) {
+            return 0;
+        }
+        MidiController::close();
+        stopEngine();
+        setOpen(false);
+        return 0;
+    }
+
+    bool applyMapping() override {
+        return MidiController::applyMapping();
+    }
+
+    void replay(const QByteArray& data, mixxx::Duration timestamp) {
+        // Sysex messages are recorded as is and short messages with
+        // 3 bytes, see MidiController::receivedShortMessage()
+        if (data.size() == 3 && static_cast<unsigned char>(data.at(0)) != 0xF0) {
+            receivedShortMessage(static_cast<unsigned char>(data.at(0)),
+                    static_cast<unsigned char>(data.at(1)),
+                    static_cast<unsigned char>(data.at(2)),
+                    timestamp);
+        } else {
+            receive(data, timestamp);
+        }
+    }
+
+  protected:
+    void sendShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2) override {
+        Q_UNUSED(status);
+        Q_UNUSED(byte1);
+        Q_UNUSED(byte2);
+    }
+
+    void sendBytes(const QByteArray& data) override {
+        Q_UNUSED(data);
+    }
+
+  private:
+    bool isPolling() const override {
+        return false;
+    }
+};
+
+namespace {
+
+/// A HID or bulk controller without a device that receives the recorded
+/// packets. Like HidController, the input report fields declared by HID
+/// mappings are decoded natively and all other packets are passed to the
+/// incomingData function of the mapping.
+class ReplayController : public FakeController {
+  public:
+    void setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) override {
+#ifdef __HID__
+        const auto pHidMapping =
+                std::dynamic_pointer_cast<LegacyHidControllerMapping>(pMapping);
+        if (pHidMapping) {
+            m_inputReportDecoder.compile(pHidMapping->getInputFields());
+        } else {
+            m_inputReportDecoder.clear();
+        }
+#endif
+        FakeController::setMapping(std::move(pMapping));
+    }
+
+    bool applyMapping() override {
+        const bool result = FakeController::applyMapping();
+#ifdef __HID__
+        m_inputReportDecoder.reset();
+        m_inputReportDecoder.resolveScriptFunctions(getScriptEngine());
+#endif
+        return result;
+    }
+
+    void replay(const QByteArray& data, mixxx::Duration timestamp) {
+#ifdef __HID__
+        // Same as HidController::receive()
+        if (!m_inputReportDecoder.isEmpty() && getScriptEngine()) {
+            m_inputFieldChanges.clear();
+            if (m_inputReportDecoder.decode(data, &m_inputFieldChanges)) {
+                for (const auto& change : m_inputFieldChanges) {
+                    HidInputReportDecoder::apply(getScriptEngine(), change);
+                }
+                return;
+            }
+        }
+#endif
+        receive(data, timestamp);
+    }
+
+#ifdef __HID__
+  private:
+    HidInputReportDecoder m_inputReportDecoder;
+    std::vector<HidInputReportDecoder::Change> m_inputFieldChanges;
+#endif
+};
+
+const QString kRecordingFileNameFilter = QStringLiteral("*.controllerinput");
+
+QStringList recordingFilePaths(const QDir& testDir) {
+    QStringList filePaths;
+    QList<QDir> recordingDirs = {
+            QDir(testDir.filePath(QStringLiteral("controller-input-recordings")))};
+    const QString userRecordingPath =
+            qEnvironmentVariable("MIXXX_CONTROLLER_RECORDINGS");
+    if (!userRecordingPath.isEmpty()) {
+        recordingDirs.append(QDir(userRecordingPath));
+    }
+    for (const auto& recordingDir : qAsConst(recordingDirs)) {
+        const auto fileNames = recordingDir.entryList(
+                {kRecordingFileNameFilter}, QDir::Files, QDir::Name);
+        for (const auto& fileName : fileNames) {
+            filePaths.append(recordingDir.filePath(fileName));
+        }
+    }
+    return filePaths;
+}
+
+/// Loads the recording together with its mapping into a new controller
+/// and sets pReplay to a function that delivers a single event to it.
+/// Returns nullptr and skips the benchmark on failure.
+std::unique_ptr<Controller> openController(
+        benchmark::State& state,
+        const QString& filePath,
+        ControllerInputRecording* pRecording,
+        std::function<void(const QByteArray&, mixxx::Duration)>* pReplay) {
+    auto recording = ControllerInputRecording::load(filePath);
+    if (!recording || recording->events.isEmpty()) {
+        state.SkipWithError("Failed to load recording");
+        return nullptr;
+    }
+    *pRecording = std::move(*recording);
+    state.SetLabel(QStringLiteral("%1 %2")
+                           .arg(QFileInfo(filePath).fileName(),
+                                   pRecording->mappingFileName)
+                           .toStdString());
+
+    QDir mappingDir = QDir::current();
+    mappingDir.cd(QStringLiteral("res/controllers"));
+    const QFileInfo mappingFile(mappingDir.filePath(pRecording->mappingFileName));
+    if (pRecording->mappingFileName.isEmpty() || !mappingFile.exists()) {
+        state.SkipWithError("Mapping is not bundled");
+        return nullptr;
+    }
+    auto pMapping = LegacyControllerMappingFileHandler::loadMapping(
+            mappingFile, mappingDir);
+    if (!pMapping) {
+        state.SkipWithError("Failed to load mapping");
+        return nullptr;
+    }
+
+    // The controllers take exclusive ownership of the mapping
+    if (std::dynamic_pointer_cast<LegacyMidiControllerMapping>(pMapping)) {
+        auto pController = std::make_unique<ReplayMidiController>();
+        pController->setMapping(std::move(pMapping));
+        pController->open();
+        if (!pController->applyMapping()) {
+            state.SkipWithError("Failed to apply mapping");
+            return nullptr;
+        }
+        ReplayMidiController* pMidiController = pController.get();
+        *pReplay = [pMidiController](const QByteArray& data, mixxx::Duration timestamp) {
+            pMidiController->replay(data, timestamp);
+        };
+        return pController;
+    }
+    auto pController = std::make_unique<ReplayController>();
+    pController->setMapping(std::move(pMapping));
+    if (!pController->applyMapping()) {
+        state.SkipWithError("Failed to apply mapping");
+        return nullptr;
+    }
+    ReplayController* pRawController = pController.get();
+    *pReplay = [pRawController](const QByteArray& data, mixxx::Duration timestamp) {
+        pRawController->replay(data, timestamp);
+    };
+    return pController;
+}
+
+void setLatencyCounters(benchmark::State& state, std::vector<double>* pLatencies) {
+    if (pLatencies->empty()) {
+        return;
+    }
+    std::sort(pLatencies->begin(), pLatencies->end());
+    const auto percentileMicros = [pLatencies](double percentile) {
+        const auto index = static_cast<std::size_t>(
+                percentile * static_cast<double>(pLatencies->size() - 1));
+        return (*pLatencies)[index] * 1e6;
+    };
+    state.counters["p50_us"] = percentileMicros(0.5);
+    state.counters["p99_us"] = percentileMicros(0.99);
+    state.counters["max_us"] = pLatencies->back() * 1e6;
+}
+
+/// Replays all events of the recording and returns the time spent in
+/// processing them. If realtime is set the original timing of the
+/// events is preserved.
+mixxx::Duration replayRecording(const ControllerInputRecording& recording,
+        const std::function<void(const QByteArray&, mixxx::Duration)>& replay,
+        bool realtime,
+        std::vector<double>* pLatencies) {
+    mixxx::Duration processingDuration;
+    const mixxx::Duration started = mixxx::Time::elapsed();
+    for (const auto& event : recording.events) {
+        QCoreApplication::processEvents();
+        if (realtime) {
+            for (mixxx::Duration now = mixxx::Time::elapsed();
+                    now - started < event.timestamp;
+                    now = mixxx::Time::elapsed()) {
+                const auto remaining = event.timestamp - (now - started);
+                QThread::usleep(static_cast<unsigned long>(std::min(
+                        remaining.toIntegerMicros(), qint64{1000})));
+                QCoreApplication::processEvents();
+            }
+        }
+        const mixxx::Duration timestamp = mixxx::Time::elapsed();
+        replay(event.data, timestamp);
+        const mixxx::Duration latency = mixxx::Time::elapsed() - timestamp;
+        processingDuration += latency;
+        pLatencies->push_back(latency.toDoubleSeconds());
+    }
+    QCoreApplication::processEvents();
+    return processingDuration;
+}
+
+// Replays the recordings as fast as possible. The "events_per_second"
+// counter reports the maximum throughput of the mapping.
+void BM_ControllerReplay(benchmark::State& state, const QString& filePath) {
+    // Sets up the decks
+    mixxxtest::BenchmarkFixture<BaseSignalPathTest> fixture;
+    ControllerInputRecording recording;
+    std::function<void(const QByteArray&, mixxx::Duration)> replay;
+    const auto pController = openController(state, filePath, &recording, &replay);
+    if (!pController) {
+        return;
+    }
+    std::vector<double> latencies;
+    for (auto _ : state) {
+        replayRecording(recording, replay, false, &latencies);
+    }
+    const auto eventCount = static_cast<int64_t>(latencies.size());
+    state.SetItemsProcessed(eventCount);
+    state.counters["events_per_second"] = benchmark::Counter(
+            static_cast<double>(eventCount), benchmark::Counter::kIsRate);
+    setLatencyCounters(state, &latencies);
+}
+// Replays the recordings once with their original timing, i.e. with the
+// script timers and the engine interleaved like in the recorded session.
+// The "load" counter reports the fraction of the time spent in
+// processing the messages.
+void BM_ControllerReplayRealtime(benchmark::State& state, const QString& filePath) {
+    // Sets up the decks
+    mixxxtest::BenchmarkFixture<BaseSignalPathTest> fixture;
+    ControllerInputRecording recording;
+    std::function<void(const QByteArray&, mixxx::Duration)> replay;
+    const auto pController = openController(state, filePath, &recording, &replay);
+    if (!pController) {
+        return;
+    }
+    std::vector<double> latencies;
+    mixxx::Duration processingDuration;
+    for (auto _ : state) {
+        processingDuration += replayRecording(recording, replay, true, &latencies);
+    }
+    const auto eventCount = static_cast<int64_t>(latencies.size());
+    state.SetItemsProcessed(eventCount);
+    state.counters["events_per_second"] = benchmark::Counter(
+            static_cast<double>(eventCount), benchmark::Counter::kIsRate);
+    state.counters["load"] = benchmark::Counter(
+            processingDuration.toDoubleSeconds(), benchmark::Counter::kIsRate);
+    setLatencyCounters(state, &latencies);
+}
+
+/// Registers both benchmarks once for each available recording
+void registerControllerReplayBenchmarks() {
+    const QStringList filePaths = recordingFilePaths(MixxxTest::getOrInitTestDir());
+    for (const auto& filePath : filePaths) {
+        const std::string fileName = QFileInfo(filePath).fileName().toStdString();
+        benchmark::RegisterBenchmark(
+                ("BM_ControllerReplay/" + fileName).c_str(),
+                BM_ControllerReplay,
+                filePath)
+                ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(
+                ("BM_ControllerReplayRealtime/" + fileName).c_str(),
+                BM_ControllerReplayRealtime,
+                filePath)
+                ->Iterations(1)
+                ->UseRealTime()
+                ->Unit(benchmark::kMillisecond);
+    }
+}
+
+[[maybe_unused]] const bool s_controllerReplayBenchmarksAdded =
+        mixxxtest::addBenchmarkRegistration(registerControllerReplayBenchmarks);
+
+} // anonymous namespace
@@ -0,0 +1,136 @@
+#include "controllers/controllerscreen.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+ControllerScreen::Config makeConfig(int width, int height) {
+    ControllerScreen::Config config;
+    config.width = width;
+    config.height = height;
+    config.tileSize = 4;
+    return config;
+}
+
+TEST(ControllerScreenTest, firstUpdateSendsEverything) {
+    ControllerScreen screen(makeConfig(10, 6));
+    EXPECT_EQ(QList<QRect>{QRect(0, 0, 10, 6)}, screen.takeDirtyRects());
+    EXPECT_TRUE(screen.takeDirtyRects().isEmpty());
+
+    screen.invalidate();
+    EXPECT_EQ(QList<QRect>{QRect(0, 0, 10, 6)}, screen.takeDirtyRects());
+}
+
+TEST(ControllerScreenTest, onlyChangedTiles) {
+    ControllerScreen screen(makeConfig(16, 16));
+    screen.takeDirtyRects();
+
+    // Unchanged content
+    screen.fillRect(QRect(0, 0, 16, 16), qRgb(0, 0, 0));
+    EXPECT_TRUE(screen.takeDirtyRects().isEmpty());
+
+    // Spans two tiles horizontally and vertically
+    screen.fillRect(QRect(3, 3, 2, 2), qRgb(255, 0, 0));
+    EXPECT_EQ(QList<QRect>{QRect(0, 0, 8, 8)}, screen.takeDirtyRects());
+
+    // Tiles in different columns are separate rectangles
+    screen.fillRect(QRect(0, 12, 1, 1), qRgb(0, 255, 0));
+    screen.fillRect(QRect(15, 12, 1, 1), qRgb(0, 255, 0));
+    const QList<QRect> expected = {QRect(0, 12, 4, 4), QRect(12, 12, 4, 4)};
+    EXPECT_EQ(expected, screen.takeDirtyRects());
+}
+
+TEST(ControllerScreenTest, tilesAreClippedAtTheBorder) {
+    ControllerScreen screen(makeConfig(6, 6));
+    screen.takeDirtyRects();
+    screen.fillRect(QRect(5, 5, 10, 10), qRgb(255, 255, 255));
+    EXPECT_EQ(QList<QRect>{QRect(4, 4, 2, 2)}, screen.takeDirtyRects());
+}
+
+TEST(ControllerScreenTest, encodeRgb565) {
+    auto config = makeConfig(2, 1);
+    ControllerScreen screen(config);
+    screen.setPixels(QRect(0, 0, 2, 1), QByteArray::fromHex("ff000000" "0000ffff"));
+    EXPECT_EQ(QByteArray::fromHex("00f8" "1f00"), screen.encode(QRect(0, 0, 2, 1)));
+
+    config.bigEndian = true;
+    ControllerScreen bigEndianScreen(config);
+    bigEndianScreen.setPixels(QRect(0, 0, 2, 1), QByteArray::fromHex("ff000000" "00ff00ff"));
+    EXPECT_EQ(QByteArray::fromHex("f800" "07e0"), bigEndianScreen.encode(QRect(0, 0, 2, 1)));
+}
+
+TEST(ControllerScreenTest, encodeRgb888) {
+    auto config = makeConfig(2, 1);
+    config.pixelFormat = ControllerScreen::PixelFormat::RGB888;
+    ControllerScreen screen(config);
+    EXPECT_EQ(3, screen.bytesPerPixel());
+    screen.setPixels(QRect(0, 0, 2, 1), QByteArray::fromHex("ff000000" "00ff80ff"));
+    // Little-endian stores blue first
+    EXPECT_EQ(QByteArray::fromHex("0000ff" "80ff00"), screen.encode(QRect(0, 0, 2, 1)));
+
+    config.bigEndian = true;
+    ControllerScreen bigEndianScreen(config);
+    bigEndianScreen.setPixels(QRect(0, 0, 2, 1), QByteArray::fromHex("ff000000" "00ff80ff"));
+    EXPECT_EQ(QByteArray::fromHex("ff0000" "00ff80"), bigEndianScreen.encode(QRect(0, 0, 2, 1)));
+}
+
+TEST(ControllerScreenTest, keepDirtyRectsUntilSent) {
+    ControllerScreen screen(makeConfig(16, 16));
+    screen.takeDirtyRects();
+
+    screen.fillRect(QRect(0, 0, 1, 1), qRgb(255, 0, 0));
+    const QList<QRect> dirtyRects = screen.dirtyRects();
+    EXPECT_EQ(QList<QRect>{QRect(0, 0, 4, 4)}, dirtyRects);
+
+    // A dropped update doesn't mark anything as sent and the next
+    // update contains both changes, but not the complete framebuffer
+    screen.fillRect(QRect(15, 15, 1, 1), qRgb(0, 255, 0));
+    const QList<QRect> expected = {QRect(0, 0, 4, 4), QRect(12, 12, 4, 4)};
+    EXPECT_EQ(expected, screen.dirtyRects());
+
+    screen.markSent(expected);
+    EXPECT_TRUE(screen.dirtyRects().isEmpty());
+}
+
+TEST(ControllerScreenTest, packetsAreSplit) {
+    auto config = makeConfig(4, 4);
+    config.header = QByteArray::fromHex("84");
+    // Header, coordinates and 2 rows of 4 pixels
+    config.maxPacketSize = 1 + 8 + 2 * 4 * 2;
+    ControllerScreen screen(config);
+
+    const auto packets = screen.takeUpdatePackets();
+    ASSERT_EQ(2, packets.size());
+    EXPECT_EQ(QByteArray::fromHex("84" "0000" "0000" "0400" "0200") + QByteArray(16, '\0'),
+            packets[0]);
+    EXPECT_EQ(QByteArray::fromHex("84" "0000" "0200" "0400" "0200") + QByteArray(16, '\0'),
+            packets[1]);
+    EXPECT_EQ(packets[0].size() + packets[1].size(),
+            ControllerScreen::fullFrameBytes(config));
+}
+
+TEST(ControllerScreenTest, outputQueueIsLimited) {
+    ControllerScreenOutputQueue queue(10);
+    EXPECT_TRUE(queue.push({QByteArray(4, 'a'), QByteArray(4, 'b')}));
+    // All or nothing
+    EXPECT_FALSE(queue.push({QByteArray(1, 'c'), QByteArray(2, 'd')}));
+
+    QByteArray packet;
+    ASSERT_TRUE(queue.pop(&packet));
+    EXPECT_EQ(QByteArray(4, 'a'), packet);
+    EXPECT_TRUE(queue.push({QByteArray(1, 'c'), QByteArray(2, 'd')}));
+    ASSERT_TRUE(queue.pop(&packet));
+    EXPECT_EQ(QByteArray(4, 'b'), packet);
+    ASSERT_TRUE(queue.pop(&packet));
+    ASSERT_TRUE(queue.pop(&packet));
+    EXPECT_EQ(QByteArray(2, 'd'), packet);
+    EXPECT_FALSE(queue.pop(&packet));
+    EXPECT_TRUE(queue.isEmpty());
+
+    EXPECT_TRUE(queue.push({QByteArray(10, 'e')}));
+    queue.clear();
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_TRUE(queue.push({QByteArray(10, 'f')}));
+}
+
+} // namespace
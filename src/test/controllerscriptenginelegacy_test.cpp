@@ -4,10 +4,12 @@
 #include <QTemporaryFile>
 #include <QThread>
 #include <QtDebug>
+#include <limits>
 #include <memory>
 
 #include "control/controlobject.h"
 #include "control/controlpotmeter.h"
+#include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
 #include "controllers/softtakeover.h"
 #include "preferences/usersettings.h"
 #include "test/mixxxtest.h"
@@ -65,6 +67,23 @@ class ControllerScriptEngineLegacyTest : public MixxxTest {
         application()->processEvents();
     }
 
+    ControllerScriptInterfaceLegacy* scriptInterface() const {
+        return qobject_cast<ControllerScriptInterfaceLegacy*>(
+                cEngine->jsEngine()->globalObject().property("engine").toQObject());
+    }
+
+    /// Executes a controller tick of the polled connections
+    void pollConnections() {
+        auto* pInterface = scriptInterface();
+        ASSERT_TRUE(pInterface);
+        pInterface->pollConnections();
+    }
+
+    bool isPollTimerActive() const {
+        auto* pInterface = scriptInterface();
+        return pInterface && pInterface->m_pollTimer.isActive();
+    }
+
     ControllerScriptEngineLegacy* cEngine;
 };
 
@@ -596,6 +615,95 @@ TEST_F(ControllerScriptEngineLegacyTest, connectionObject_trigger) {
     EXPECT_DOUBLE_EQ(1.0, counter->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, polledConnection) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto counter = std::make_unique<ControlObject>(ConfigKey("[Test]", "counter"));
+    auto last = std::make_unique<ControlObject>(ConfigKey("[Test]", "last"));
+
+    EXPECT_TRUE(evaluateAndAssert(
+            "var reaction = function(value) {"
+            "  var counter = engine.getValue('[Test]', 'counter');"
+            "  engine.setValue('[Test]', 'counter', counter + 1);"
+            "  engine.setValue('[Test]', 'last', value);"
+            "};"
+            "var connection = engine.makePolledConnection('[Test]', 'co', reaction);"));
+
+    // No events are queued for polled connections
+    co->set(1.0);
+    co->set(2.0);
+    co->set(3.0);
+    processEvents();
+    EXPECT_DOUBLE_EQ(0.0, counter->get());
+
+    // Intermediate values are skipped
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+    EXPECT_DOUBLE_EQ(3.0, last->get());
+
+    // Unchanged
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+
+    // Executed immediately
+    EXPECT_TRUE(evaluateAndAssert("engine.trigger('[Test]', 'co');"));
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+    pollConnections();
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+
+    EXPECT_TRUE(evaluateAndAssert("engine.setPollInterval(40);"));
+
+    EXPECT_TRUE(evaluateAndAssert("connection.disconnect();"));
+    co->set(4.0);
+    pollConnections();
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, polledConnectionWithNaN) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto counter = std::make_unique<ControlObject>(ConfigKey("[Test]", "counter"));
+
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.makePolledConnection('[Test]', 'co', function(value) {"
+            "  var counter = engine.getValue('[Test]', 'counter');"
+            "  engine.setValue('[Test]', 'counter', counter + 1);"
+            "});"));
+
+    co->set(std::numeric_limits<double>::quiet_NaN());
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+
+    // NaN is unchanged
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+
+    co->set(1.0);
+    pollConnections();
+    EXPECT_DOUBLE_EQ(2.0, counter->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, polledConnectionDisconnectsItself) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto counter = std::make_unique<ControlObject>(ConfigKey("[Test]", "counter"));
+
+    EXPECT_TRUE(evaluateAndAssert(
+            "var connection = engine.makePolledConnection('[Test]', 'co', function(value) {"
+            "  var counter = engine.getValue('[Test]', 'counter');"
+            "  engine.setValue('[Test]', 'counter', counter + 1);"
+            "  connection.disconnect();"
+            "});"));
+    EXPECT_TRUE(isPollTimerActive());
+
+    co->set(1.0);
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+    // No polled connections are left
+    EXPECT_FALSE(isPollTimerActive());
+
+    co->set(2.0);
+    pollConnections();
+    EXPECT_DOUBLE_EQ(1.0, counter->get());
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, connectionExecutesWithCorrectThisObject) {
     // Test that callback functions are executed with JavaScript's
     // 'this' keyword referring to the object in which the connection
@@ -0,0 +1,62 @@
+#include "controllers/scripting/controllerscriptfilecache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class ControllerScriptFileCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("script.js"));
+    }
+
+    void TearDown() override {
+        ControllerScriptFileCache::clear();
+    }
+
+    void writeScript(const QByteArray& code) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(code);
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(ControllerScriptFileCacheTest, readIsCached) {
+    writeScript("var a = 1;");
+    QString errorString;
+    bool cached = true;
+    EXPECT_EQ(QStringLiteral("var a = 1;\n"),
+            ControllerScriptFileCache::read(m_filePath, &errorString, &cached));
+    EXPECT_FALSE(cached);
+    EXPECT_EQ(QStringLiteral("var a = 1;\n"),
+            ControllerScriptFileCache::read(m_filePath, &errorString, &cached));
+    EXPECT_TRUE(cached);
+
+    // A different size is detected even with the same modification time
+    writeScript("var a = 12;");
+    EXPECT_EQ(QStringLiteral("var a = 12;\n"),
+            ControllerScriptFileCache::read(m_filePath, &errorString, &cached));
+    EXPECT_FALSE(cached);
+
+    // Same size and possibly the same modification time
+    writeScript("var b = 12;");
+    ControllerScriptFileCache::invalidate(m_filePath);
+    EXPECT_EQ(QStringLiteral("var b = 12;\n"),
+            ControllerScriptFileCache::read(m_filePath, &errorString, &cached));
+    EXPECT_FALSE(cached);
+}
+
+TEST_F(ControllerScriptFileCacheTest, missingFile) {
+    QString errorString;
+    EXPECT_TRUE(ControllerScriptFileCache::read(m_filePath, &errorString).isNull());
+    EXPECT_FALSE(errorString.isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+#include "controllers/scripting/controllerscriptprofiler.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QJSEngine>
+#include <QTemporaryDir>
+
+namespace {
+
+class ControllerScriptProfilerTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ControllerScriptProfiler::reset();
+        ControllerScriptProfiler::setEnabled(true);
+    }
+
+    void TearDown() override {
+        ControllerScriptProfiler::setEnabled(false);
+        ControllerScriptProfiler::reset();
+    }
+
+    static ControllerScriptProfiler::FunctionStats findStats(const QString& label) {
+        const auto functionStats = ControllerScriptProfiler::functionStats();
+        for (const auto& stats : functionStats) {
+            if (stats.label == label) {
+                return stats;
+            }
+        }
+        return {};
+    }
+};
+
+TEST_F(ControllerScriptProfilerTest, nestedInvocations) {
+    {
+        ControllerScriptProfiler::Scope outer(QStringLiteral("Controller"),
+                QStringLiteral("outer"));
+        for (int i = 0; i < 2; ++i) {
+            ControllerScriptProfiler::Scope inner(QStringLiteral("Controller"),
+                    QStringLiteral("inner"));
+        }
+    }
+
+    const auto outerStats = findStats(QStringLiteral("outer"));
+    const auto innerStats = findStats(QStringLiteral("inner"));
+    EXPECT_EQ(1, outerStats.callCount);
+    EXPECT_EQ(2, innerStats.callCount);
+    // The time of the nested invocations is not accounted to the outer self time
+    EXPECT_EQ(outerStats.totalDuration,
+            outerStats.selfDuration + innerStats.totalDuration);
+    EXPECT_EQ(innerStats.totalDuration, innerStats.selfDuration);
+    EXPECT_LE(innerStats.maxDuration, innerStats.totalDuration);
+}
+
+TEST_F(ControllerScriptProfilerTest, writeFlameGraph) {
+    {
+        ControllerScriptProfiler::Scope outer(QStringLiteral("My Controller"),
+                QStringLiteral("outer"));
+        // Semicolons separate the frames and must not appear in labels
+        ControllerScriptProfiler::Scope inner(QStringLiteral("My Controller"),
+                QStringLiteral("a;b"));
+    }
+
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("profile.folded"));
+    ASSERT_TRUE(ControllerScriptProfiler::writeFlameGraph(filePath));
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QStringList stacks;
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        const int separator = line.lastIndexOf(QChar(' '));
+        ASSERT_GT(separator, 0);
+        bool ok = false;
+        line.mid(separator + 1).toLongLong(&ok);
+        EXPECT_TRUE(ok);
+        stacks.append(line.left(separator));
+    }
+    stacks.sort();
+    EXPECT_EQ(QStringList({
+                      QStringLiteral("My Controller;outer"),
+                      QStringLiteral("My Controller;outer;a,b"),
+              }),
+            stacks);
+}
+
+TEST_F(ControllerScriptProfilerTest, reset) {
+    {
+        ControllerScriptProfiler::Scope scope(QStringLiteral("Controller"),
+                QStringLiteral("function"));
+    }
+    EXPECT_EQ(1, ControllerScriptProfiler::functionStats().size());
+    ControllerScriptProfiler::reset();
+    EXPECT_TRUE(ControllerScriptProfiler::functionStats().isEmpty());
+}
+
+TEST_F(ControllerScriptProfilerTest, functionLabel) {
+    QJSEngine jsEngine;
+    EXPECT_EQ(QStringLiteral("namedFunction"),
+            ControllerScriptProfiler::functionLabel(jsEngine.evaluate(
+                    QStringLiteral("(function namedFunction(value) {})"))));
+
+    // Anonymous functions are labeled with their abbreviated source code
+    const QString label = ControllerScriptProfiler::functionLabel(jsEngine.evaluate(
+            QStringLiteral("(() => { engine.setValue('[Channel1]', "
+                           "'play', 1); engine.setValue('[Channel2]', 'play', 1); })")));
+    EXPECT_TRUE(label.startsWith(QStringLiteral("() => { engine.setValue(")));
+    EXPECT_TRUE(label.endsWith(QStringLiteral("...")));
+}
+
+} // namespace
@@ -0,0 +1,221 @@
+#include "controllers/controllerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+#include "controllers/controller.h"
+#include "controllers/controllermanager.h"
+#include "test/mixxxtest.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+constexpr unsigned long kTimeoutMillis = 10000;
+
+/// Records on which thread and in which state it has been accessed
+class ThreadTestController : public Controller {
+  public:
+    ThreadTestController()
+            : Controller(QStringLiteral("Thread Test Controller")),
+              m_pOpenThread(nullptr),
+              m_pCloseThread(nullptr),
+              m_polling(false),
+              m_pollCount(0) {
+    }
+    ~ThreadTestController() override {
+        if (isOpen()) {
+            close();
+        }
+    }
+
+    QString mappingExtension() override {
+        return QStringLiteral(".test.xml");
+    }
+    std::shared_ptr<LegacyControllerMapping> cloneMapping() override {
+        return nullptr;
+    }
+    void setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) override {
+        Q_UNUSED(pMapping);
+    }
+    bool isMappable() const override {
+        return false;
+    }
+    bool matchMapping(const MappingInfo& mapping) override {
+        Q_UNUSED(mapping);
+        return false;
+    }
+
+    int open() override {
+        m_pOpenThread = QThread::currentThread();
+        setOpen(true);
+        return 0;
+    }
+    int close() override {
+        m_pCloseThread = QThread::currentThread();
+        setOpen(false);
+        return 0;
+    }
+
+    void setPolling(bool polling) {
+        m_polling = polling;
+    }
+    bool isPolling() const override {
+        return m_polling;
+    }
+    bool poll() override {
+        const auto locker = lockMutex(&m_mutex);
+        ++m_pollCount;
+        m_polled.wakeAll();
+        return false;
+    }
+
+    /// Waits until poll() has been called the given number of times
+    int waitForPolls(int count) {
+        auto locker = lockMutex(&m_mutex);
+        while (m_pollCount < count) {
+            if (!m_polled.wait(&m_mutex, kTimeoutMillis)) {
+                break;
+            }
+        }
+        return m_pollCount;
+    }
+
+    int pollCount() {
+        const auto locker = lockMutex(&m_mutex);
+        return m_pollCount;
+    }
+
+    QThread* m_pOpenThread;
+    QThread* m_pCloseThread;
+
+  protected:
+    void sendBytes(const QByteArray& data) override {
+        Q_UNUSED(data);
+    }
+
+  private:
+    std::atomic<bool> m_polling;
+
+    QMutex m_mutex;
+    QWaitCondition m_polled;
+    int m_pollCount;
+};
+
+} // anonymous namespace
+
+class ControllerThreadTest : public MixxxTest {
+  protected:
+    ControllerThreadTest()
+            : m_pController(std::make_unique<ThreadTestController>()) {
+    }
+
+    ~ControllerThreadTest() override {
+        // The thread must be shut down before it is destroyed and the
+        // controller is destroyed last on its original thread
+        if (m_pControllerThread && m_pControllerThread->isRunning()) {
+            m_pControllerThread->shutdown(QThread::currentThread());
+        }
+        m_pControllerThread.reset();
+        m_pController.reset();
+    }
+
+    void startControllerThread() {
+        m_pControllerThread = std::make_unique<ControllerThread>(m_pController.get());
+        m_pControllerThread->start();
+    }
+
+    std::unique_ptr<ThreadTestController> m_pController;
+    std::unique_ptr<ControllerThread> m_pControllerThread;
+};
+
+TEST_F(ControllerThreadTest, openAndShutdownOnControllerThread) {
+    QThread* const pMainThread = QThread::currentThread();
+    startControllerThread();
+    ThreadTestController* const pController = m_pController.get();
+    EXPECT_EQ(m_pControllerThread.get(), pController->thread());
+
+    const int result = m_pControllerThread->invoke([pController] {
+        return pController->open() + 1;
+    });
+    EXPECT_EQ(1, result);
+    EXPECT_EQ(m_pControllerThread.get(), pController->m_pOpenThread);
+    EXPECT_TRUE(pController->isOpen());
+
+    m_pControllerThread->shutdown(pMainThread);
+    EXPECT_FALSE(m_pControllerThread->isRunning());
+    EXPECT_FALSE(pController->isOpen());
+    EXPECT_EQ(m_pControllerThread.get(), pController->m_pCloseThread);
+    // The controller is usable on its original thread again
+    EXPECT_EQ(pMainThread, pController->thread());
+    m_pControllerThread.reset();
+    EXPECT_EQ(0, pController->open());
+    EXPECT_EQ(pMainThread, pController->m_pOpenThread);
+}
+
+TEST_F(ControllerThreadTest, startAndStopPolling) {
+    startControllerThread();
+    ThreadTestController* const pController = m_pController.get();
+    pController->setPolling(true);
+
+    // Not polled while closed
+    m_pControllerThread->updatePolling();
+    m_pControllerThread->invoke([] {});
+    EXPECT_EQ(0, pController->pollCount());
+
+    m_pControllerThread->invoke([pController] {
+        pController->open();
+    });
+    m_pControllerThread->updatePolling();
+    EXPECT_LE(3, pController->waitForPolls(3));
+
+    m_pControllerThread->invoke([pController] {
+        pController->close();
+    });
+    m_pControllerThread->updatePolling();
+    const int pollCount = pController->pollCount();
+    // Wait for at least one poll interval on the controller thread
+    m_pControllerThread->invoke([] {
+        QThread::msleep(
+                2 * ControllerManager::kPollInterval.toIntegerMillis());
+    });
+    m_pControllerThread->invoke([] {});
+    EXPECT_EQ(pollCount, pController->pollCount());
+}
+
+TEST_F(ControllerThreadTest, shutdownWhileCallbacksInFlight) {
+    startControllerThread();
+    ThreadTestController* const pController = m_pController.get();
+    m_pControllerThread->invoke([pController] {
+        pController->open();
+    });
+
+    // Callbacks that are queued before the shutdown are executed
+    // before the controller is closed
+    constexpr int kCallbackCount = 10;
+    QSemaphore started;
+    std::atomic<int> openCallbackCount(0);
+    for (int i = 0; i < kCallbackCount; ++i) {
+        QMetaObject::invokeMethod(
+                pController,
+                [pController, &started, &openCallbackCount] {
+                    started.release();
+                    QThread::msleep(5);
+                    if (pController->isOpen()) {
+                        ++openCallbackCount;
+                    }
+                },
+                Qt::QueuedConnection);
+    }
+    ASSERT_TRUE(started.tryAcquire(1, static_cast<int>(kTimeoutMillis)));
+
+    m_pControllerThread->shutdown(QThread::currentThread());
+    EXPECT_FALSE(m_pControllerThread->isRunning());
+    EXPECT_EQ(kCallbackCount, openCallbackCount.load());
+    EXPECT_FALSE(pController->isOpen());
+    EXPECT_EQ(m_pControllerThread.get(), pController->m_pCloseThread);
+}
@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
+#include <QDateTime>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
 #include "sources/soundsourceproxy.h"
+#include "util/disklrueviction.h"
 
 // first inherit from MixxxTest to construct a QApplication to be able to
 // construct the default QPixmap in CoverArtCache
@@ -92,3 +95,78 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnail) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const auto pThumbnailCache =
+            std::make_shared<const CoverArtThumbnailCache>(tempDir.path(), qint64{1} << 30);
+
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = getTestDir().filePath(kCoverLocationTest);
+    const QImage img = QImage(info.coverLocation);
+    ASSERT_FALSE(img.isNull());
+    info.setImage(img);
+    constexpr int kDesiredWidth = 100;
+    ASSERT_LT(kDesiredWidth, img.width());
+
+    // The first request populates the thumbnail cache
+    auto res = CoverArtCache::loadCover(
+            nullptr, TrackPointer(), info, kDesiredWidth, false, pThumbnailCache);
+    EXPECT_FALSE(res.coverInfoUpdated);
+    EXPECT_EQ(kDesiredWidth, res.coverArt.loadedImage.image.width());
+    EXPECT_TRUE(pThumbnailCache->containsAllThumbnails(info.imageDigest()));
+
+    // The second request is served from the thumbnail, i.e. even
+    // if the original image is no longer accessible
+    info.coverLocation = tempDir.filePath(kCoverFileTest);
+    res = CoverArtCache::loadCover(
+            nullptr, TrackPointer(), info, kDesiredWidth, false, pThumbnailCache);
+    EXPECT_FALSE(res.coverInfoUpdated);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_EQ(kDesiredWidth, res.coverArt.loadedImage.image.width());
+    EXPECT_EQ(info.imageDigest(), res.coverArt.imageDigest());
+}
+
+TEST_F(CoverArtCacheTest, evictLeastRecentlyUsedThumbnails) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QImage img = QImage(getTestDir().filePath(kCoverLocationTest));
+    ASSERT_FALSE(img.isNull());
+    const QByteArray oldDigest = QByteArray(20, '\x01');
+    const QByteArray newDigest = QByteArray(20, '\x02');
+
+    // Determine the size of all thumbnails of a single image
+    qint64 thumbnailsSize = 0;
+    {
+        const CoverArtThumbnailCache unlimitedCache(tempDir.path(), qint64{1} << 30);
+        ASSERT_TRUE(unlimitedCache.storeAllThumbnails(oldDigest, img));
+        for (const int width : {64, 128, 256, 512}) {
+            const QString filePath = unlimitedCache.thumbnailFilePath(oldDigest, width);
+            thumbnailsSize += QFileInfo(filePath).size();
+            ASSERT_TRUE(mixxx::DiskLruEviction::setLastUsed(
+                    filePath,
+                    QDateTime::currentDateTimeUtc().addSecs(-3600)));
+        }
+    }
+    ASSERT_LT(0, thumbnailsSize);
+
+    // Only the thumbnails of the most recently stored image fit.
+    // Storing them evicts the least recently used thumbnails
+    // until some room is left.
+    const CoverArtThumbnailCache cache(tempDir.path(), thumbnailsSize);
+    ASSERT_TRUE(cache.storeAllThumbnails(newDigest, img));
+    EXPECT_TRUE(cache.containsAllThumbnails(newDigest));
+    EXPECT_FALSE(cache.containsAllThumbnails(oldDigest));
+    EXPECT_FALSE(QFileInfo::exists(cache.thumbnailFilePath(oldDigest, 512)));
+
+    // Loading a thumbnail marks it as recently used
+    ASSERT_TRUE(mixxx::DiskLruEviction::setLastUsed(
+            cache.thumbnailFilePath(newDigest, 64),
+            QDateTime::currentDateTimeUtc().addSecs(-3600)));
+    EXPECT_FALSE(cache.loadThumbnail(newDigest, 64).isNull());
+    EXPECT_LT(QDateTime::currentDateTimeUtc().addSecs(-60),
+            QFileInfo(cache.thumbnailFilePath(newDigest, 64)).lastModified());
+}
@@ -8,6 +8,7 @@
 #include <QtDebug>
 
 #include "control/controlobject.h"
+#include "engine/cachingreader/cachingreader.h"
 #include "engine/controls/ratecontrol.h"
 #include "mixer/basetrackplayer.h"
 #include "preferences/usersettings.h"
@@ -549,3 +550,22 @@ TEST_F(EngineBufferTest, RatePermTest) {
     ControlObject::set(ConfigKey(m_sGroup1, "rate_perm_up_small"), 0);
     EXPECT_EQ(1.06, m_pChannel1->getEngineBuffer()->m_speed_old);
 }
+
+TEST_F(EngineBufferTest, TrackLengthRefined) {
+    EngineBuffer* pEngineBuffer = m_pChannel1->getEngineBuffer();
+    ASSERT_EQ(m_pTrack1, pEngineBuffer->getLoadedTrack());
+    const ConfigKey trackSamplesKey(m_sGroup1, "track_samples");
+    const double estimatedTrackSamples = ControlObject::get(trackSamplesKey);
+    ASSERT_LT(0.0, estimatedTrackSamples);
+
+    // The exact length of the complete track replaces the length that
+    // has been estimated while playing the preview
+    const double refinedTrackSamples = estimatedTrackSamples - 1000;
+    emit pEngineBuffer->m_pReader->trackLengthRefined(m_pTrack1, refinedTrackSamples);
+    EXPECT_EQ(refinedTrackSamples, ControlObject::get(trackSamplesKey));
+
+    // Obsolete after another track has been loaded
+    emit pEngineBuffer->m_pReader->trackLengthRefined(
+            m_pTrack2, estimatedTrackSamples + 1000);
+    EXPECT_EQ(refinedTrackSamples, ControlObject::get(trackSamplesKey));
+}
@@ -30,7 +30,10 @@ class TrackTitleThread: public QThread {
             m_recentTrackPtr.reset();
             // Try to resolve the next track by guessing the id
             const TrackId trackId(loopCount % 2);
-            auto track = GlobalTrackCacheLocker().lookupTrackById(trackId);
+            // Alternate between lookups with and without locking the cache
+            auto track = (loopCount / 2) % 2 == 0
+                    ? GlobalTrackCacheLocker().lookupTrackById(trackId)
+                    : GlobalTrackCacheLookup::lookupTrackById(trackId);
             if (track) {
                 ASSERT_EQ(trackId, track->getId());
                 // #9097: Accessing the track from multiple threads is
@@ -139,6 +142,31 @@ TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
     }
 }
 
+TEST_F(GlobalTrackCacheTest, lookupWithoutLock) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId(1);
+    const auto testFile = mixxx::FileInfo(getTestDir().filePath(kTestFile));
+
+    TrackPointer track;
+    {
+        GlobalTrackCacheResolver resolver(mixxx::FileAccess(testFile));
+        track = resolver.getTrack();
+        EXPECT_TRUE(static_cast<bool>(track));
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+
+    EXPECT_EQ(track, GlobalTrackCacheLookup::lookupTrackById(trackId));
+    EXPECT_EQ(track, GlobalTrackCacheLookup::lookupTrackByRef(TrackRef::fromFileInfo(testFile)));
+    EXPECT_EQ(track, GlobalTrackCacheLookup::lookupTrackByRef(TrackRef::fromFileInfo(testFile, trackId)));
+    EXPECT_EQ(TrackPointer(), GlobalTrackCacheLookup::lookupTrackById(TrackId(2)));
+    EXPECT_EQ(1, track.use_count());
+
+    track.reset();
+    EXPECT_EQ(TrackPointer(), GlobalTrackCacheLookup::lookupTrackById(trackId));
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
 TEST_F(GlobalTrackCacheTest, concurrentDelete) {
     ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
 
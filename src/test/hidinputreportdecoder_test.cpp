@@ -0,0 +1,223 @@
+#include "controllers/hid/hidinputreportdecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "controllers/hid/legacyhidcontrollermapping.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class HidInputReportDecoderTest : public MixxxTest {
+  protected:
+    static HidInputField makeField(const QString& item,
+            int offset,
+            HidInputFieldType type = HidInputFieldType::UInt8,
+            uint32_t bitmask = 0,
+            HidInputFieldOptions options = HidInputFieldOption::Script) {
+        HidInputField field;
+        field.offset = offset;
+        field.type = type;
+        field.bitmask = bitmask;
+        field.options = options;
+        field.control = ConfigKey(QStringLiteral("[Channel1]"), item);
+        return field;
+    }
+
+    /// The changed fields by name and their values
+    QList<QPair<QString, double>> decode(const QByteArray& report) {
+        std::vector<HidInputReportDecoder::Change> changes;
+        EXPECT_TRUE(m_decoder.decode(report, &changes));
+        QList<QPair<QString, double>> result;
+        for (const auto& change : changes) {
+            result.append({change.pEntry->field().control.item, change.value});
+        }
+        return result;
+    }
+
+    HidInputReportDecoder m_decoder;
+};
+
+TEST_F(HidInputReportDecoderTest, onlyChangedFields) {
+    m_decoder.compile({
+            makeField(QStringLiteral("play"), 1, HidInputFieldType::UInt8, 0x01),
+            makeField(QStringLiteral("cue"), 1, HidInputFieldType::UInt8, 0x02),
+            makeField(QStringLiteral("rate"), 2, HidInputFieldType::UInt16),
+    });
+
+    // The first report contains all fields
+    const QList<QPair<QString, double>> expected = {
+            {QStringLiteral("play"), 1.0},
+            {QStringLiteral("cue"), 0.0},
+            {QStringLiteral("rate"), 0x1234},
+    };
+    EXPECT_EQ(expected, decode(QByteArray::fromHex("00013412")));
+
+    EXPECT_TRUE(decode(QByteArray::fromHex("00013412")).isEmpty());
+    // Unmapped bits and bytes are ignored
+    EXPECT_TRUE(decode(QByteArray::fromHex("ff053412")).isEmpty());
+
+    const QList<QPair<QString, double>> expectedCue = {
+            {QStringLiteral("cue"), 1.0},
+    };
+    EXPECT_EQ(expectedCue, decode(QByteArray::fromHex("00033412")));
+}
+
+TEST_F(HidInputReportDecoderTest, signedAndNormalized) {
+    m_decoder.compile({
+            makeField(QStringLiteral("signed"), 0, HidInputFieldType::Int16),
+            makeField(QStringLiteral("normalized"),
+                    2,
+                    HidInputFieldType::UInt8,
+                    0xF0,
+                    HidInputFieldOption::Normalize),
+    });
+
+    const QList<QPair<QString, double>> expected = {
+            {QStringLiteral("signed"), -2.0},
+            {QStringLiteral("normalized"), 1.0},
+    };
+    EXPECT_EQ(expected, decode(QByteArray::fromHex("feffff")));
+    const QList<QPair<QString, double>> expectedZero = {
+            {QStringLiteral("normalized"), 0.0},
+    };
+    EXPECT_EQ(expectedZero, decode(QByteArray::fromHex("feff0f")));
+}
+
+TEST_F(HidInputReportDecoderTest, encoderWrapsAround) {
+    m_decoder.compile({
+            makeField(QStringLiteral("jog"),
+                    0,
+                    HidInputFieldType::UInt8,
+                    0,
+                    HidInputFieldOption::Script | HidInputFieldOption::Encoder),
+    });
+
+    // The first report is only the reference
+    EXPECT_TRUE(decode(QByteArray::fromHex("fe")).isEmpty());
+    const QList<QPair<QString, double>> expectedForward = {
+            {QStringLiteral("jog"), 3.0},
+    };
+    EXPECT_EQ(expectedForward, decode(QByteArray::fromHex("01")));
+    const QList<QPair<QString, double>> expectedBackward = {
+            {QStringLiteral("jog"), -2.0},
+    };
+    EXPECT_EQ(expectedBackward, decode(QByteArray::fromHex("ff")));
+
+    // After a reset the next report is the reference again
+    m_decoder.reset();
+    EXPECT_TRUE(decode(QByteArray::fromHex("10")).isEmpty());
+}
+
+TEST_F(HidInputReportDecoderTest, reportIds) {
+    HidInputField first = makeField(QStringLiteral("first"), 1);
+    first.reportId = 0x01;
+    HidInputField second = makeField(QStringLiteral("second"), 1);
+    second.reportId = 0x02;
+    m_decoder.compile({first, second});
+
+    const QList<QPair<QString, double>> expectedFirst = {
+            {QStringLiteral("first"), 5.0},
+    };
+    EXPECT_EQ(expectedFirst, decode(QByteArray::fromHex("0105")));
+    const QList<QPair<QString, double>> expectedSecond = {
+            {QStringLiteral("second"), 5.0},
+    };
+    EXPECT_EQ(expectedSecond, decode(QByteArray::fromHex("0205")));
+
+    // Reports without declared fields are not decoded
+    std::vector<HidInputReportDecoder::Change> changes;
+    EXPECT_FALSE(m_decoder.decode(QByteArray::fromHex("0305"), &changes));
+    EXPECT_TRUE(changes.empty());
+}
+
+TEST_F(HidInputReportDecoderTest, reportIdZeroIsNotMixed) {
+    HidInputField numbered = makeField(QStringLiteral("numbered"), 1);
+    numbered.reportId = 0x01;
+    m_decoder.compile({makeField(QStringLiteral("unnumbered"), 1), numbered});
+
+    const QList<QPair<QString, double>> expected = {
+            {QStringLiteral("numbered"), 5.0},
+    };
+    EXPECT_EQ(expected, decode(QByteArray::fromHex("0105")));
+
+    // No catch-all for other report IDs
+    std::vector<HidInputReportDecoder::Change> changes;
+    EXPECT_FALSE(m_decoder.decode(QByteArray::fromHex("0205"), &changes));
+    EXPECT_TRUE(changes.empty());
+}
+
+TEST_F(HidInputReportDecoderTest, shortReport) {
+    m_decoder.compile({
+            makeField(QStringLiteral("first"), 0),
+            makeField(QStringLiteral("last"), 4, HidInputFieldType::UInt32),
+    });
+    const QList<QPair<QString, double>> expected = {
+            {QStringLiteral("first"), 1.0},
+    };
+    EXPECT_EQ(expected, decode(QByteArray::fromHex("01020304")));
+}
+
+TEST_F(HidInputReportDecoderTest, loadMapping) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("Test.hid.xml"));
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write(R"(<?xml version="1.0" encoding="utf-8"?>
+<MixxxControllerPreset schemaVersion="1" mixxxVersion="2.4.0+">
+    <info><name>Test</name></info>
+    <controller id="Test">
+        <controls>
+            <control>
+                <group>[Channel1]</group>
+                <key>Test.jogWheel</key>
+                <reportid>0x01</reportid>
+                <offset>3</offset>
+                <type>uint16</type>
+                <bitmask>0x0FFF</bitmask>
+                <options>
+                    <script-binding/>
+                    <encoder/>
+                </options>
+            </control>
+            <control>
+                <group>[Channel1]</group>
+                <key>play</key>
+                <reportid>0x100</reportid>
+                <offset>1</offset>
+            </control>
+            <control>
+                <group>[Channel1]</group>
+                <key>pfl</key>
+                <reportid>0x01</reportid>
+                <offset>2</offset>
+                <type>float</type>
+            </control>
+        </controls>
+    </controller>
+</MixxxControllerPreset>
+)");
+    file.close();
+
+    const auto pMapping = std::dynamic_pointer_cast<LegacyHidControllerMapping>(
+            LegacyControllerMappingFileHandler::loadMapping(
+                    QFileInfo(filePath), QDir(tempDir.path())));
+    ASSERT_TRUE(pMapping);
+    // The fields with the invalid report ID and the unknown type are ignored
+    ASSERT_EQ(1, pMapping->getInputFields().size());
+    const HidInputField& field = pMapping->getInputFields().first();
+    EXPECT_EQ(0x01, field.reportId);
+    EXPECT_EQ(3, field.offset);
+    EXPECT_EQ(HidInputFieldType::UInt16, field.type);
+    EXPECT_EQ(0x0FFFu, field.bitmask);
+    EXPECT_EQ(HidInputFieldOption::Script | HidInputFieldOption::Encoder, field.options);
+    EXPECT_EQ(ConfigKey(QStringLiteral("[Channel1]"), QStringLiteral("Test.jogWheel")),
+            field.control);
+}
+
+} // namespace
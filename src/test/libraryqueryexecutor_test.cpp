@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "library/libraryqueryexecutor.h"
+#include "test/mixxxdbtest.h"
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+constexpr unsigned long kTimeoutMillis = 10000;
+
+const QString kViewName = QStringLiteral("executor_test_view");
+
+QString createViewStatement(int id) {
+    return QStringLiteral("CREATE TEMPORARY VIEW %1 AS SELECT %2 AS id")
+            .arg(kViewName, QString::number(id));
+}
+
+const QString kSelectFromView =
+        QStringLiteral("SELECT id FROM ") + kViewName;
+
+} // anonymous namespace
+
+class LibraryQueryExecutorTest : public MixxxDbTest {
+  protected:
+    struct Delivery {
+        int channel;
+        quint64 generation;
+        LibraryQueryExecutor::Results results;
+    };
+
+    LibraryQueryExecutorTest()
+            : m_executor(dbConnectionPooler()) {
+        // Results are collected on the worker thread
+        QObject::connect(&m_executor,
+                &LibraryQueryExecutor::queryFinished,
+                [this](int channel,
+                        quint64 generation,
+                        const LibraryQueryExecutor::Results& results) {
+                    const auto locker = lockMutex(&m_mutex);
+                    m_deliveries.append(Delivery{channel, generation, results});
+                    m_delivered.wakeAll();
+                });
+    }
+
+    static LibraryQueryExecutor::Request request(
+            const QString& query,
+            const QString& createViewStatement = QString()) {
+        LibraryQueryExecutor::Request request;
+        if (!createViewStatement.isEmpty()) {
+            request.temporaryViews.append(LibraryQueryExecutor::TemporaryView{
+                    kViewName, createViewStatement});
+        }
+        request.queries << query;
+        return request;
+    }
+
+    /// Waits until the given number of requests has been delivered in
+    /// total. Requests are executed in the order of their submission.
+    QList<Delivery> waitForDeliveries(int count) {
+        auto locker = lockMutex(&m_mutex);
+        while (m_deliveries.size() < count) {
+            if (!m_delivered.wait(&m_mutex, kTimeoutMillis)) {
+                break;
+            }
+        }
+        return m_deliveries;
+    }
+
+    LibraryQueryExecutor m_executor;
+
+  private:
+    QMutex m_mutex;
+    QWaitCondition m_delivered;
+    QList<Delivery> m_deliveries;
+};
+
+TEST_F(LibraryQueryExecutorTest, skipSupersededRequests) {
+    const int channel = m_executor.createChannel();
+    const int cancelledChannel = m_executor.createChannel();
+    const int otherChannel = m_executor.createChannel();
+
+    // All requests are submitted before the worker thread starts
+    m_executor.submit(channel, request(QStringLiteral("SELECT 1")));
+    const quint64 latestGeneration =
+            m_executor.submit(channel, request(QStringLiteral("SELECT 2")));
+    m_executor.submit(cancelledChannel, request(QStringLiteral("SELECT 3")));
+    m_executor.cancel(cancelledChannel);
+    const quint64 otherGeneration =
+            m_executor.submit(otherChannel, request(QStringLiteral("SELECT 4")));
+    m_executor.start();
+
+    const auto deliveries = waitForDeliveries(2);
+    ASSERT_EQ(2, deliveries.size());
+    EXPECT_EQ(channel, deliveries[0].channel);
+    EXPECT_EQ(latestGeneration, deliveries[0].generation);
+    ASSERT_EQ(1, deliveries[0].results.size());
+    EXPECT_EQ(QVector<TrackId>{TrackId(2)}, deliveries[0].results[0]);
+    EXPECT_EQ(otherChannel, deliveries[1].channel);
+    EXPECT_EQ(otherGeneration, deliveries[1].generation);
+}
+
+TEST_F(LibraryQueryExecutorTest, replicateTemporaryViews) {
+    const int channel = m_executor.createChannel();
+    m_executor.start();
+
+    m_executor.submit(channel, request(kSelectFromView, createViewStatement(1)));
+    auto deliveries = waitForDeliveries(1);
+    ASSERT_EQ(1, deliveries.size());
+    ASSERT_EQ(1, deliveries[0].results.size());
+    EXPECT_EQ(QVector<TrackId>{TrackId(1)}, deliveries[0].results[0]);
+
+    // The view is only created once
+    m_executor.submit(channel, request(kSelectFromView, createViewStatement(1)));
+    deliveries = waitForDeliveries(2);
+    ASSERT_EQ(2, deliveries.size());
+    ASSERT_EQ(1, deliveries[1].results.size());
+    EXPECT_EQ(QVector<TrackId>{TrackId(1)}, deliveries[1].results[0]);
+
+    // A redefined view replaces the stale view with the same name
+    m_executor.submit(channel, request(kSelectFromView, createViewStatement(2)));
+    deliveries = waitForDeliveries(3);
+    ASSERT_EQ(3, deliveries.size());
+    ASSERT_EQ(1, deliveries[2].results.size());
+    EXPECT_EQ(QVector<TrackId>{TrackId(2)}, deliveries[2].results[0]);
+}
+
+TEST_F(LibraryQueryExecutorTest, failedRequestsAreNotDelivered) {
+    const int failedQueryChannel = m_executor.createChannel();
+    const int failedViewChannel = m_executor.createChannel();
+    const int channel = m_executor.createChannel();
+    m_executor.start();
+
+    m_executor.submit(failedQueryChannel,
+            request(QStringLiteral("SELECT id FROM executor_test_missing_table")));
+    m_executor.submit(failedViewChannel,
+            request(kSelectFromView,
+                    QStringLiteral("CREATE TEMPORARY VIEW %1 AS SELECT")
+                            .arg(kViewName)));
+    // Both failed requests have been executed before this one
+    const quint64 generation =
+            m_executor.submit(channel, request(kSelectFromView, createViewStatement(3)));
+
+    const auto deliveries = waitForDeliveries(1);
+    ASSERT_EQ(1, deliveries.size());
+    EXPECT_EQ(channel, deliveries[0].channel);
+    EXPECT_EQ(generation, deliveries[0].generation);
+    ASSERT_EQ(1, deliveries[0].results.size());
+    EXPECT_EQ(QVector<TrackId>{TrackId(3)}, deliveries[0].results[0]);
+}
@@ -13,7 +13,9 @@
 
 class LibraryTest : public MixxxDbTest, SoundSourceProviderRegistration {
   protected:
-    LibraryTest();
+    /// The database is file-backed instead of in-memory if requested,
+    /// e.g. for benchmarks that depend on the journal and sync settings
+    explicit LibraryTest(bool inMemoryDbConnection = true);
     ~LibraryTest() override = default;
 
     TrackCollectionManager* trackCollectionManager() const {
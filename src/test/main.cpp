@@ -28,6 +28,7 @@ int main(int argc, char **argv) {
     MixxxTest::ApplicationScope applicationScope(argc, argv);
 
     if (run_benchmarks) {
+        mixxxtest::registerBenchmarks();
         benchmark::RunSpecifiedBenchmarks();
         return 0;
     } else {
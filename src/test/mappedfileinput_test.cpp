@@ -0,0 +1,55 @@
+#include "sources/mappedfileinput.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+constexpr qint64 kFileSize = 1024 * 1024;
+
+QString createFile(const QTemporaryDir& tempDir) {
+    const QString filePath = tempDir.filePath(QStringLiteral("input.bin"));
+    QFile file(filePath);
+    EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+    EXPECT_EQ(kFileSize, file.write(QByteArray(kFileSize, 'x')));
+    return filePath;
+}
+
+TEST(MappedFileInputTest, readMappedFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    mixxx::MappedFileInput input(createFile(tempDir));
+    ASSERT_TRUE(input.open(mixxx::AudioSource::AccessPattern::Sequential));
+    EXPECT_NE(nullptr, input.data());
+    EXPECT_EQ(kFileSize, input.size());
+
+    QByteArray buffer(1000, '\0');
+    ASSERT_TRUE(input.seek(kFileSize - 500));
+    EXPECT_EQ(500, input.read(buffer.data(), buffer.size()));
+    EXPECT_TRUE(input.atEnd());
+    EXPECT_EQ(0, input.read(buffer.data(), buffer.size()));
+}
+
+// Windows does not allow truncating files while they are mapped
+#ifndef Q_OS_WIN
+TEST(MappedFileInputTest, readTruncatedFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = createFile(tempDir);
+    mixxx::MappedFileInput input(filePath);
+    ASSERT_TRUE(input.open(mixxx::AudioSource::AccessPattern::Sequential));
+    ASSERT_NE(nullptr, input.data());
+
+    QByteArray buffer(1000, '\0');
+    ASSERT_TRUE(QFile::resize(filePath, kFileSize / 4));
+    // Continues by reading the file after seeking instead of accessing
+    // the pages beyond the end of the file
+    ASSERT_TRUE(input.seek(kFileSize / 2));
+    EXPECT_EQ(0, input.read(buffer.data(), buffer.size()));
+    EXPECT_EQ(nullptr, input.data());
+}
+#endif
+
+} // namespace
@@ -596,3 +596,29 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receivedShortMessage(MidiOpCode::PitchBendChange, channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, ReceiveMessage_ControlCreatedAfterMapping) {
+    ConfigKey key("[Channel1]", "hotcue_1_activate");
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    addMapping(MidiInputMapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                                MidiOpCode::NoteOn, channel),
+                                        control),
+            MidiOptions(),
+            key));
+    m_pController->setMapping(m_pMapping->clone());
+
+    // The control doesn't exist yet when the mapping is compiled
+    {
+        ControlPushButton cpb(key);
+        receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x7F);
+        EXPECT_LT(0.0, cpb.get());
+    }
+
+    // The binding is resolved again after the control has been re-created
+    ControlPushButton cpb(key);
+    EXPECT_DOUBLE_EQ(0.0, cpb.get());
+    receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x7F);
+    EXPECT_LT(0.0, cpb.get());
+}
@@ -0,0 +1,82 @@
+#include "controllers/midi/midioutputcoalescer.h"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+#include "controllers/midi/midiutils.h"
+
+namespace {
+
+using ShortMsg = std::tuple<unsigned char, unsigned char, unsigned char>;
+
+class MidiOutputCoalescerTest : public testing::Test {
+  protected:
+    MidiOutputCoalescerTest()
+            : m_coalescer(QStringLiteral("test")) {
+    }
+
+    std::vector<ShortMsg> flush() {
+        std::vector<ShortMsg> sent;
+        m_coalescer.flush([&sent](unsigned char status,
+                                  unsigned char byte1,
+                                  unsigned char byte2) {
+            sent.emplace_back(status, byte1, byte2);
+        });
+        return sent;
+    }
+
+    MidiOutputCoalescer m_coalescer;
+};
+
+TEST_F(MidiOutputCoalescerTest, replacePendingMessages) {
+    const unsigned char cc = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::ControlChange, 0x01);
+    EXPECT_TRUE(m_coalescer.queue(cc, 0x10, 0x01));
+    EXPECT_TRUE(m_coalescer.queue(cc, 0x11, 0x02));
+    EXPECT_TRUE(m_coalescer.queue(cc, 0x10, 0x03));
+
+    // The replaced message keeps its original position
+    const auto sent = flush();
+    ASSERT_EQ(2u, sent.size());
+    EXPECT_EQ(ShortMsg(cc, 0x10, 0x03), sent[0]);
+    EXPECT_EQ(ShortMsg(cc, 0x11, 0x02), sent[1]);
+    EXPECT_TRUE(m_coalescer.isEmpty());
+    EXPECT_TRUE(flush().empty());
+}
+
+TEST_F(MidiOutputCoalescerTest, noteOnAndNoteOffAddressSameNote) {
+    const unsigned char noteOn = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::NoteOn, 0x02);
+    const unsigned char noteOff = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::NoteOff, 0x02);
+    const unsigned char noteOnOtherChannel = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::NoteOn, 0x03);
+    EXPECT_TRUE(m_coalescer.queue(noteOn, 0x30, 0x7F));
+    EXPECT_TRUE(m_coalescer.queue(noteOff, 0x30, 0x00));
+    EXPECT_TRUE(m_coalescer.queue(noteOnOtherChannel, 0x30, 0x7F));
+
+    const auto sent = flush();
+    ASSERT_EQ(2u, sent.size());
+    EXPECT_EQ(ShortMsg(noteOff, 0x30, 0x00), sent[0]);
+    EXPECT_EQ(ShortMsg(noteOnOtherChannel, 0x30, 0x7F), sent[1]);
+}
+
+TEST_F(MidiOutputCoalescerTest, rejectMessagesWithoutState) {
+    const unsigned char cc = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::ControlChange, 0x00);
+    // NRPN sequence
+    EXPECT_FALSE(m_coalescer.queue(cc, 0x63, 0x01));
+    EXPECT_FALSE(m_coalescer.queue(cc, 0x62, 0x02));
+    EXPECT_FALSE(m_coalescer.queue(cc, 0x06, 0x03));
+    // All Notes Off
+    EXPECT_FALSE(m_coalescer.queue(cc, 0x7B, 0x00));
+    EXPECT_FALSE(m_coalescer.queue(
+            MidiUtils::statusFromOpCodeAndChannel(MidiOpCode::ProgramChange, 0x00),
+            0x05,
+            0x00));
+    EXPECT_TRUE(m_coalescer.isEmpty());
+}
+
+} // anonymous namespace
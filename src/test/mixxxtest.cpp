@@ -1,6 +1,7 @@
 #include "test/mixxxtest.h"
 
 #include <QTemporaryFile>
+#include <vector>
 
 #include "control/control.h"
 #include "library/coverartutils.h"
@@ -87,4 +88,24 @@ void copyFile(const QString& srcFileName, const QString& dstFileName) {
     ASSERT_EQ(dstFile.size(), srcFile.size());
 }
 
+namespace {
+
+std::vector<void (*)()>& benchmarkRegistrations() {
+    static std::vector<void (*)()> s_registrations;
+    return s_registrations;
+}
+
+} // namespace
+
+bool addBenchmarkRegistration(void (*registerBenchmarks)()) {
+    benchmarkRegistrations().push_back(registerBenchmarks);
+    return true;
+}
+
+void registerBenchmarks() {
+    for (const auto registerBenchmarks : benchmarkRegistrations()) {
+        registerBenchmarks();
+    }
+}
+
 } // namespace mixxxtest
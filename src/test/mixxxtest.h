@@ -5,6 +5,7 @@
 #include <QDir>
 #include <QScopedPointer>
 #include <QTemporaryDir>
+#include <utility>
 
 #include "mixxxapplication.h"
 #include "preferences/usersettings.h"
@@ -76,4 +77,30 @@ namespace mixxxtest {
 
 void copyFile(const QString& srcFileName, const QString& dstFileName);
 
+/// Adds a function that registers benchmarks depending on the test
+/// environment with benchmark::RegisterBenchmark(), e.g. one for each
+/// available test file. Returns true for initializing a static variable.
+bool addBenchmarkRegistration(void (*registerBenchmarks)());
+
+/// Invokes all added registration functions. The application must have
+/// been created.
+void registerBenchmarks();
+
+/// Instantiates a test fixture outside of a test for reusing its setup
+/// and teardown in a benchmark, e.g. the database of LibraryTest. Members
+/// that are needed by the benchmark must be made accessible by the fixture.
+template<typename Fixture>
+class BenchmarkFixture final : public Fixture {
+  public:
+    template<typename... Args>
+    explicit BenchmarkFixture(Args&&... args)
+            : Fixture(std::forward<Args>(args)...) {
+    }
+
+  private:
+    // Never invoked, the benchmark takes the place of the test
+    void TestBody() override {
+    }
+};
+
 } // namespace mixxxtest
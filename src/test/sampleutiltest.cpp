@@ -397,6 +397,23 @@ TEST_F(SampleUtilTest, copyReverse) {
     }
 }
 
+TEST_F(SampleUtilTest, doubleMonoToDualMono) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        const int numFrames = sizes[i] / 2;
+        for (int j = 0; j < numFrames; ++j) {
+            buffer[j] = j * 0.001f;
+        }
+
+        SampleUtil::doubleMonoToDualMono(buffer, numFrames);
+
+        for (int j = 0; j < numFrames; ++j) {
+            EXPECT_FLOAT_EQ(buffer[j * 2], j * 0.001f);
+            EXPECT_FLOAT_EQ(buffer[j * 2 + 1], j * 0.001f);
+        }
+    }
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -445,6 +462,19 @@ static void BM_SampleUtilCopy(benchmark::State& state) {
 }
 BENCHMARK(BM_SampleUtilCopy)->Range(64, 4096);
 
+static void BM_DoubleMonoToDualMono(benchmark::State& state) {
+    SINT numFrames = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.0f, numFrames * 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::doubleMonoToDualMono(buffer, numFrames);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_DoubleMonoToDualMono)->Range(64, 4096);
+
 
 /*
 TEST_F(SampleUtilTest, copy3WithGainSpeed) {
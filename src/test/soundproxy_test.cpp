@@ -1,14 +1,21 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/decodedaudiocache.h"
+#include "sources/seekindexcache.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
 #include "track/trackmetadata.h"
+#include "util/disklrueviction.h"
 #include "util/samplebuffer.h"
 
 namespace {
@@ -1069,3 +1076,266 @@ TEST_F(SoundSourceProxyTest, fileSuffixWithDifferingType) {
                 SoundSourceProxy::isFileSuffixSupported(fileSuffix));
     }
 }
+
+TEST_F(SoundSourceProxyTest, restoreSeekIndex) {
+    QTemporaryDir seekIndexDir;
+    ASSERT_TRUE(seekIndexDir.isValid());
+    mixxx::SeekIndexCache::setRootPath(seekIndexDir.path(), qint64{1} << 30);
+
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        if (!filePath.endsWith(QStringLiteral(".mp3"))) {
+            continue;
+        }
+        const auto fileUrl = QUrl::fromLocalFile(filePath);
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(fileUrl);
+        for (const auto& providerRegistration : providerRegistrations) {
+            // The first source scans the file and stores the seek index
+            mixxx::AudioSourcePointer pScannedSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            ASSERT_FALSE(!pScannedSource);
+            // The second source restores the seek index if supported
+            mixxx::AudioSourcePointer pRestoredSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            ASSERT_FALSE(!pRestoredSource);
+            ASSERT_EQ(pScannedSource->getSignalInfo(), pRestoredSource->getSignalInfo());
+            ASSERT_EQ(pScannedSource->frameIndexRange(), pRestoredSource->frameIndexRange());
+
+            // Read backwards to force seeking
+            const SINT sampleCount =
+                    pScannedSource->getSignalInfo().frames2samples(kMaxReadFrameCount);
+            mixxx::SampleBuffer scannedData(sampleCount);
+            mixxx::SampleBuffer restoredData(sampleCount);
+            SINT frameIndex = pScannedSource->frameIndexMax();
+            while (frameIndex > pScannedSource->frameIndexMin()) {
+                const auto readFrameIndexRange = mixxx::IndexRange::between(
+                        math_max(pScannedSource->frameIndexMin(),
+                                frameIndex - kMaxReadFrameCount),
+                        frameIndex);
+                const auto scannedFrames = pScannedSource->readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                readFrameIndexRange,
+                                mixxx::SampleBuffer::WritableSlice(scannedData)));
+                const auto restoredFrames = pRestoredSource->readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                readFrameIndexRange,
+                                mixxx::SampleBuffer::WritableSlice(restoredData)));
+                ASSERT_EQ(scannedFrames.frameIndexRange(), restoredFrames.frameIndexRange());
+                expectDecodedSamplesEqual(
+                        pScannedSource->getSignalInfo().frames2samples(
+                                scannedFrames.frameLength()),
+                        &scannedData[0],
+                        &restoredData[0],
+                        "Decoding mismatch with restored seek index");
+                frameIndex = readFrameIndexRange.start();
+            }
+        }
+    }
+
+#ifdef __MAD__
+    EXPECT_FALSE(QDir(seekIndexDir.path()).isEmpty());
+#endif
+    mixxx::SeekIndexCache::setRootPath(QString(), 0);
+}
+
+TEST_F(SoundSourceProxyTest, evictSeekIndex) {
+    QTemporaryDir seekIndexDir;
+    ASSERT_TRUE(seekIndexDir.isValid());
+    mixxx::SeekIndexCache::setRootPath(seekIndexDir.path(), qint64{1} << 30);
+
+    mixxx::SeekIndexCache::SeekIndex seekIndex;
+    seekIndex.channelCount = 2;
+    seekIndex.sampleRate = 44100;
+    seekIndex.frameCount = 1000 * 1152;
+    for (SINT i = 0; i < 1000; ++i) {
+        seekIndex.seekPoints.push_back(
+                mixxx::SeekIndexCache::SeekPoint{i * 1152, i * 418});
+    }
+    constexpr qint64 kFileSize = 1000 * 418;
+    const QByteArray oldKey = QByteArray(32, '\x01');
+    const QByteArray newKey = QByteArray(32, '\x02');
+    mixxx::SeekIndexCache::SeekIndex loadedSeekIndex;
+    ASSERT_TRUE(mixxx::SeekIndexCache::store(oldKey, seekIndex));
+    ASSERT_TRUE(mixxx::SeekIndexCache::store(newKey, seekIndex));
+    ASSERT_TRUE(mixxx::SeekIndexCache::load(oldKey, kFileSize, &loadedSeekIndex));
+    ASSERT_TRUE(mixxx::SeekIndexCache::load(newKey, kFileSize, &loadedSeekIndex));
+
+    // Mark the first seek index as least recently used
+    const QString oldFilePath = QStringLiteral("%1/01/%2").arg(
+            seekIndexDir.path(), QString::fromLatin1(oldKey.toHex()));
+    ASSERT_TRUE(mixxx::DiskLruEviction::setLastUsed(
+            oldFilePath,
+            QDateTime::currentDateTimeUtc().addSecs(-3600)));
+
+    // Only a single seek index fits
+    mixxx::SeekIndexCache::setRootPath(
+            seekIndexDir.path(), QFileInfo(oldFilePath).size());
+    mixxx::SeekIndexCache::evictLeastRecentlyUsed();
+    EXPECT_FALSE(mixxx::SeekIndexCache::load(oldKey, kFileSize, &loadedSeekIndex));
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(newKey, kFileSize, &loadedSeekIndex));
+    EXPECT_EQ(seekIndex.seekPoints.size(), loadedSeekIndex.seekPoints.size());
+
+    mixxx::SeekIndexCache::setRootPath(QString(), 0);
+}
+
+TEST_F(SoundSourceProxyTest, reopenPooledSource) {
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        auto pTrack = Track::newTemporary(filePath);
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::audio::ChannelCount(2));
+        const auto poolKey = mixxx::SoundSourcePool::Key(
+                QUrl::fromLocalFile(filePath), openParams);
+        ASSERT_TRUE(poolKey.isValid());
+
+        auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        ASSERT_FALSE(!pAudioSource);
+        const auto frameIndexRange = pAudioSource->frameIndexRange();
+        // Closing puts the still open source into the pool
+        pAudioSource->close();
+        pAudioSource.reset();
+
+        // Reopening the same file reuses the pooled source
+        auto pReopenedSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        ASSERT_FALSE(!pReopenedSource);
+        EXPECT_EQ(frameIndexRange, pReopenedSource->frameIndexRange());
+        EXPECT_FALSE(mixxx::SoundSourcePool::take(poolKey).pSoundSource);
+        pReopenedSource->close();
+        EXPECT_TRUE(mixxx::SoundSourcePool::take(poolKey).pSoundSource);
+
+        // Evicted sources are not reused
+        pReopenedSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        ASSERT_FALSE(!pReopenedSource);
+        pReopenedSource->close();
+        mixxx::SoundSourcePool::evict(poolKey.location());
+        EXPECT_FALSE(mixxx::SoundSourcePool::take(poolKey).pSoundSource);
+    }
+}
+
+TEST_F(SoundSourceProxyTest, restoreDecodedAudio) {
+    QTemporaryDir decodedAudioDir;
+    ASSERT_TRUE(decodedAudioDir.isValid());
+    mixxx::DecodedAudioCache::setRootPath(decodedAudioDir.path(), qint64{1} << 30);
+
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        auto pTrack = Track::newTemporary(filePath);
+        if (!mixxx::DecodedAudioCache::isSupportedFileType(pTrack->getType())) {
+            continue;
+        }
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::audio::ChannelCount(2));
+
+        // Reading the whole file sequentially records the decoded samples
+        openParams.setAccessPattern(mixxx::AudioSource::AccessPattern::Sequential);
+        auto pDecodingSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        ASSERT_FALSE(!pDecodingSource);
+        const auto signalInfo = pDecodingSource->getSignalInfo();
+        const auto frameIndexRange = pDecodingSource->frameIndexRange();
+        mixxx::SampleBuffer decodedData(
+                signalInfo.frames2samples(frameIndexRange.length()));
+        const auto decodedFrames = pDecodingSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        frameIndexRange,
+                        mixxx::SampleBuffer::WritableSlice(decodedData)));
+        ASSERT_EQ(frameIndexRange, decodedFrames.frameIndexRange());
+        pDecodingSource->close();
+        pDecodingSource.reset();
+
+        // Reopening reads the recorded samples
+        openParams.setAccessPattern(mixxx::AudioSource::AccessPattern::Playback);
+        const auto decodedAudioKey = mixxx::DecodedAudioCache::contentKey(
+                QUrl::fromLocalFile(filePath), openParams);
+        ASSERT_FALSE(decodedAudioKey.isEmpty());
+        auto pCachedSource = mixxx::DecodedAudioCache::openCachedSource(
+                decodedAudioKey, QUrl::fromLocalFile(filePath), openParams);
+        ASSERT_FALSE(!pCachedSource);
+        ASSERT_EQ(signalInfo, pCachedSource->getSignalInfo());
+        ASSERT_EQ(frameIndexRange, pCachedSource->frameIndexRange());
+        mixxx::SampleBuffer cachedData(decodedData.size());
+        const auto cachedFrames = pCachedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        frameIndexRange,
+                        mixxx::SampleBuffer::WritableSlice(cachedData)));
+        ASSERT_EQ(frameIndexRange, cachedFrames.frameIndexRange());
+        expectDecodedSamplesEqual(
+                decodedData.size(),
+                &decodedData[0],
+                &cachedData[0],
+                "Decoding mismatch with recorded samples");
+    }
+
+    mixxx::DecodedAudioCache::setRootPath(QString(), 0);
+}
+
+TEST_F(SoundSourceProxyTest, openPreview) {
+    constexpr SINT kPreviewFrameCount = 4096;
+    int previewCount = 0;
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        if (!filePath.endsWith(QStringLiteral(".mp3"))) {
+            continue;
+        }
+        const auto fileUrl = QUrl::fromLocalFile(filePath);
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(fileUrl);
+        for (const auto& providerRegistration : providerRegistrations) {
+            mixxx::AudioSource::OpenParams openParams;
+            openParams.setChannelCount(mixxx::audio::ChannelCount(2));
+            openParams.setPreviewFrameCount(kPreviewFrameCount);
+            auto pTrack = Track::newTemporary(filePath);
+            auto pPreviewSource = SoundSourceProxy(
+                    pTrack, providerRegistration.getProvider())
+                                          .openAudioSource(openParams);
+            ASSERT_FALSE(!pPreviewSource);
+            if (!pPreviewSource->isPreview()) {
+                // Not supported by this provider
+                continue;
+            }
+            ++previewCount;
+            // The duration of the track is only updated from the complete file
+            EXPECT_EQ(0.0, pTrack->getDuration());
+
+            openParams.setPreviewFrameCount(0);
+            auto pCompleteSource = SoundSourceProxy(
+                    pTrack, providerRegistration.getProvider())
+                                           .openAudioSource(openParams);
+            ASSERT_FALSE(!pCompleteSource);
+            EXPECT_FALSE(pCompleteSource->isPreview());
+            ASSERT_EQ(pCompleteSource->getSignalInfo(), pPreviewSource->getSignalInfo());
+            EXPECT_LE(kPreviewFrameCount, pPreviewSource->frameLength());
+            ASSERT_TRUE(pPreviewSource->frameIndexRange().isSubrangeOf(
+                    pCompleteSource->frameIndexRange()));
+            EXPECT_LT(pPreviewSource->frameLength(), pCompleteSource->frameLength());
+
+            // The preview decodes exactly the same samples
+            const auto frameIndexRange = pPreviewSource->frameIndexRange();
+            const SINT sampleCount = pPreviewSource->getSignalInfo().frames2samples(
+                    frameIndexRange.length());
+            mixxx::SampleBuffer previewData(sampleCount);
+            mixxx::SampleBuffer completeData(sampleCount);
+            const auto previewFrames = pPreviewSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            frameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(previewData)));
+            const auto completeFrames = pCompleteSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            frameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(completeData)));
+            ASSERT_EQ(frameIndexRange, previewFrames.frameIndexRange());
+            ASSERT_EQ(frameIndexRange, completeFrames.frameIndexRange());
+            expectDecodedSamplesEqual(
+                    sampleCount,
+                    &completeData[0],
+                    &previewData[0],
+                    "Decoding mismatch with preview");
+        }
+    }
+
+#ifdef __MAD__
+    EXPECT_LT(0, previewCount);
+#endif
+}
@@ -0,0 +1,276 @@
+#include <benchmark/benchmark.h>
+
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define MIXXX_HAVE_MALLINFO2
+#endif
+#endif
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+// Benchmarks for all registered SoundSource providers and all test
+// files. Each benchmark is registered once for every provider of each
+// file when the benchmarks are started. The name contains the file name
+// and the priority index of the provider for this file, the name of the
+// provider is reported as the label.
+//
+// Use --benchmark_out=<file> --benchmark_out_format=json for comparing
+// the results of different commits, e.g. with compare.py from Google
+// Benchmark.
+
+namespace {
+
+/// Measures the peak heap usage in between, including the memory that
+/// C libraries like FFmpeg allocate with malloc(). The usage is sampled
+/// explicitly and reported as the "heap_bytes" counter. It is only
+/// available with glibc, no allocation functions are replaced.
+class HeapUsageScope final {
+  public:
+    HeapUsageScope()
+            : m_startBytes(inUseBytes()),
+              m_peakBytes(m_startBytes) {
+    }
+
+    void sample() {
+        m_peakBytes = std::max(m_peakBytes, inUseBytes());
+    }
+
+    void setCounters(benchmark::State& state) const {
+#ifdef MIXXX_HAVE_MALLINFO2
+        state.counters["heap_bytes"] = benchmark::Counter(
+                static_cast<double>(m_peakBytes - m_startBytes),
+                benchmark::Counter::kDefaults,
+                benchmark::Counter::kIs1024);
+#else
+        Q_UNUSED(state);
+#endif
+    }
+
+  private:
+    static std::size_t inUseBytes() {
+#ifdef MIXXX_HAVE_MALLINFO2
+        const auto info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+#else
+        return 0;
+#endif
+    }
+
+    const std::size_t m_startBytes;
+    std::size_t m_peakBytes;
+};
+
+class SoundSourceBenchmarkSetup : public MixxxTest, SoundSourceProviderRegistration {
+};
+
+// Same files as in SoundSourceProxyTest
+const QString kFileNameSuffixes[] = {
+        QStringLiteral(".aiff"),
+        QStringLiteral("-alac.caf"),
+        QStringLiteral(".flac"),
+        QStringLiteral("-itunes-12.3.0-aac.m4a"),
+        QStringLiteral("-itunes-12.7.0-aac.m4a"),
+        QStringLiteral("-ffmpeg-aac.m4a"),
+        QStringLiteral("-itunes-12.7.0-alac.m4a"),
+        QStringLiteral("-png.mp3"),
+        QStringLiteral("-vbr.mp3"),
+        QStringLiteral(".ogg"),
+        QStringLiteral(".opus"),
+        QStringLiteral(".wav"),
+        QStringLiteral(".wma"),
+        QStringLiteral(".wv"),
+};
+
+constexpr SINT kSequentialReadFrameCount = 4096;
+
+constexpr SINT kRandomSeekReadFrameCount = 1024;
+
+mixxx::AudioSourcePointer openAudioSource(
+        const TrackPointer& pTrack,
+        const mixxx::SoundSourceProviderPointer& pProvider) {
+    // Providers that have been selected explicitly are never pooled
+    return SoundSourceProxy(pTrack, pProvider).openAudioSource();
+}
+
+// The time that is needed before the first samples could be decoded,
+// e.g. when loading a track into a deck.
+void BM_SoundSourceOpen(benchmark::State& state,
+        const QString& filePath,
+        const mixxx::SoundSourceProviderPointer& pProvider) {
+    const auto pTrack = Track::newTemporary(filePath);
+    HeapUsageScope heapUsage;
+    {
+        const auto pAudioSource = openAudioSource(pTrack, pProvider);
+        if (!pAudioSource) {
+            state.SkipWithError("Failed to open file");
+            return;
+        }
+        heapUsage.sample();
+        pAudioSource->close();
+    }
+    for (auto _ : state) {
+        auto pAudioSource = openAudioSource(pTrack, pProvider);
+        benchmark::DoNotOptimize(pAudioSource);
+        pAudioSource->close();
+    }
+    heapUsage.setCounters(state);
+}
+
+// Decoding the whole file from start to end, e.g. for analysis. The
+// "realtime" counter reports the decoding speed as a multiple of the
+// playback speed.
+void BM_SoundSourceDecode(benchmark::State& state,
+        const QString& filePath,
+        const mixxx::SoundSourceProviderPointer& pProvider) {
+    const auto pTrack = Track::newTemporary(filePath);
+    HeapUsageScope heapUsage;
+    auto pAudioSource = openAudioSource(pTrack, pProvider);
+    if (!pAudioSource) {
+        state.SkipWithError("Failed to open file");
+        return;
+    }
+    mixxx::SampleBuffer readBuffer(
+            pAudioSource->getSignalInfo().frames2samples(kSequentialReadFrameCount));
+    SINT decodedFrameCount = 0;
+    for (auto _ : state) {
+        auto remainingFrameIndexRange = pAudioSource->frameIndexRange();
+        while (!remainingFrameIndexRange.empty()) {
+            const auto readFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            remainingFrameIndexRange.splitAndShrinkFront(
+                                    math_min(kSequentialReadFrameCount,
+                                            remainingFrameIndexRange.length())),
+                            mixxx::SampleBuffer::WritableSlice(readBuffer)));
+            benchmark::DoNotOptimize(readFrames);
+            decodedFrameCount += readFrames.frameLength();
+        }
+    }
+    // The decoding buffers are still allocated
+    heapUsage.sample();
+    heapUsage.setCounters(state);
+    state.SetItemsProcessed(decodedFrameCount);
+    state.counters["realtime"] = benchmark::Counter(
+            pAudioSource->getSignalInfo().frames2secs(decodedFrameCount),
+            benchmark::Counter::kIsRate);
+    pAudioSource->close();
+}
+
+// Reads short chunks from random positions, e.g. when jumping to
+// hotcues or while scratching backwards. The latency of each seek
+// is measured for reporting percentiles.
+void BM_SoundSourceRandomSeek(benchmark::State& state,
+        const QString& filePath,
+        const mixxx::SoundSourceProviderPointer& pProvider) {
+    const auto pTrack = Track::newTemporary(filePath);
+    HeapUsageScope heapUsage;
+    auto pAudioSource = openAudioSource(pTrack, pProvider);
+    if (!pAudioSource) {
+        state.SkipWithError("Failed to open file");
+        return;
+    }
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    if (frameIndexRange.length() <= kRandomSeekReadFrameCount) {
+        state.SkipWithError("File is too short");
+        return;
+    }
+    mixxx::SampleBuffer readBuffer(
+            pAudioSource->getSignalInfo().frames2samples(kRandomSeekReadFrameCount));
+    // Deterministic positions for comparable results
+    std::mt19937 randomEngine(12345);
+    std::uniform_int_distribution<SINT> frameIndexDistribution(
+            frameIndexRange.start(),
+            frameIndexRange.end() - kRandomSeekReadFrameCount);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    for (auto _ : state) {
+        const SINT frameIndex = frameIndexDistribution(randomEngine);
+        const auto started = std::chrono::steady_clock::now();
+        const auto readFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(frameIndex, kRandomSeekReadFrameCount),
+                        mixxx::SampleBuffer::WritableSlice(readBuffer)));
+        const auto elapsed = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - started);
+        benchmark::DoNotOptimize(readFrames);
+        state.SetIterationTime(elapsed.count());
+        latencies.push_back(elapsed.count());
+    }
+    heapUsage.sample();
+    heapUsage.setCounters(state);
+    state.SetItemsProcessed(state.iterations());
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentileMicros = [&latencies](double percentile) {
+            const auto index = static_cast<std::size_t>(
+                    percentile * static_cast<double>(latencies.size() - 1));
+            return latencies[index] * 1e6;
+        };
+        state.counters["p50_us"] = percentileMicros(0.5);
+        state.counters["p90_us"] = percentileMicros(0.9);
+        state.counters["p99_us"] = percentileMicros(0.99);
+    }
+    pAudioSource->close();
+}
+
+/// Registers all benchmarks once for each provider of each test file
+void registerSoundSourceBenchmarks() {
+    // Registers the providers
+    mixxxtest::BenchmarkFixture<SoundSourceBenchmarkSetup> fixture;
+    for (const auto& fileNameSuffix : kFileNameSuffixes) {
+        const QString filePath = MixxxTest::getOrInitTestDir().filePath(
+                QStringLiteral("id3-test-data/cover-test") + fileNameSuffix);
+        if (!SoundSourceProxy::isFileNameSupported(filePath)) {
+            continue;
+        }
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(
+                        QUrl::fromLocalFile(filePath));
+        for (int i = 0; i < providerRegistrations.size(); ++i) {
+            const auto pProvider = providerRegistrations[i].getProvider();
+            const std::string nameSuffix = QStringLiteral("/%1/%2")
+                                                   .arg(QFileInfo(filePath).fileName())
+                                                   .arg(i)
+                                                   .toStdString();
+            const std::string label = pProvider->getDisplayName().toStdString();
+            benchmark::RegisterBenchmark(
+                    ("BM_SoundSourceOpen" + nameSuffix).c_str(),
+                    [filePath, pProvider, label](benchmark::State& state) {
+                        state.SetLabel(label);
+                        BM_SoundSourceOpen(state, filePath, pProvider);
+                    })
+                    ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(
+                    ("BM_SoundSourceDecode" + nameSuffix).c_str(),
+                    [filePath, pProvider, label](benchmark::State& state) {
+                        state.SetLabel(label);
+                        BM_SoundSourceDecode(state, filePath, pProvider);
+                    })
+                    ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                    ("BM_SoundSourceRandomSeek" + nameSuffix).c_str(),
+                    [filePath, pProvider, label](benchmark::State& state) {
+                        state.SetLabel(label);
+                        BM_SoundSourceRandomSeek(state, filePath, pProvider);
+                    })
+                    ->UseManualTime()
+                    ->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
+
+[[maybe_unused]] const bool s_soundSourceBenchmarksAdded =
+        mixxxtest::addBenchmarkRegistration(registerSoundSourceBenchmarks);
+
+} // anonymous namespace
@@ -1,4 +1,7 @@
+#include <benchmark/benchmark.h>
+
 #include <QDir>
+#include <QImage>
 #include <QtDebug>
 
 #include "sources/metadatasourcetaglib.h"
@@ -70,3 +73,86 @@ TEST_F(TagLibTest, WriteID3v2Tag) {
         EXPECT_FALSE(mixxx::taglib::hasAPETag(mpegFile));
     }
 }
+
+namespace {
+
+const QStringList kImportTestFiles = {
+        QStringLiteral("id3-test-data/cover-test-jpg.mp3"),
+        QStringLiteral("id3-test-data/cover-test-png.mp3"),
+        QStringLiteral("id3-test-data/cover-test-itunes-12.7.0-aac.m4a"),
+        QStringLiteral("id3-test-data/cover-test.flac"),
+        QStringLiteral("id3-test-data/cover-test.ogg"),
+        QStringLiteral("id3-test-data/cover-test.opus"),
+        QStringLiteral("id3-test-data/cover-test.wv"),
+        QStringLiteral("id3-test-data/cover-test.wav"),
+        QStringLiteral("id3-test-data/cover-test.aiff"),
+};
+
+QString importTestFilePath(int index) {
+    return MixxxTest::getOrInitTestDir().filePath(kImportTestFiles[index]);
+}
+
+} // anonymous namespace
+
+TEST_F(TagLibTest, ImportCoverImageWithoutAudioProperties) {
+    for (int i = 0; i < kImportTestFiles.size(); ++i) {
+        const QString fileName = importTestFilePath(i);
+        qDebug() << "Importing from" << fileName;
+        const mixxx::MetadataSourceTagLib metadataSource(fileName);
+
+        // Only the cover image
+        QImage coverImage;
+        EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+                metadataSource
+                        .importTrackMetadataAndCoverImage(
+                                nullptr, &coverImage, false)
+                        .first);
+        EXPECT_FALSE(coverImage.isNull());
+
+        // Only the track metadata, including the audio properties
+        mixxx::TrackMetadata trackMetadata;
+        EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+                metadataSource
+                        .importTrackMetadataAndCoverImage(
+                                &trackMetadata, nullptr, false)
+                        .first);
+        EXPECT_TRUE(trackMetadata.getStreamInfo().getSignalInfo().isValid());
+    }
+}
+
+static void BM_ImportTrackMetadata(benchmark::State& state) {
+    const mixxx::MetadataSourceTagLib metadataSource(
+            importTestFilePath(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        mixxx::TrackMetadata trackMetadata;
+        benchmark::DoNotOptimize(
+                metadataSource.importTrackMetadataAndCoverImage(
+                        &trackMetadata, nullptr, false));
+    }
+}
+BENCHMARK(BM_ImportTrackMetadata)->DenseRange(0, 8);
+
+static void BM_ImportTrackMetadataAndCoverImage(benchmark::State& state) {
+    const mixxx::MetadataSourceTagLib metadataSource(
+            importTestFilePath(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+        benchmark::DoNotOptimize(
+                metadataSource.importTrackMetadataAndCoverImage(
+                        &trackMetadata, &coverImage, false));
+    }
+}
+BENCHMARK(BM_ImportTrackMetadataAndCoverImage)->DenseRange(0, 8);
+
+static void BM_ImportCoverImage(benchmark::State& state) {
+    const mixxx::MetadataSourceTagLib metadataSource(
+            importTestFilePath(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        QImage coverImage;
+        benchmark::DoNotOptimize(
+                metadataSource.importTrackMetadataAndCoverImage(
+                        nullptr, &coverImage, false));
+    }
+}
+BENCHMARK(BM_ImportCoverImage)->DenseRange(0, 8);
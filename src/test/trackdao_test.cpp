@@ -1,6 +1,9 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <QTemporaryDir>
+
 #include "test/librarytest.h"
 #include "track/track.h"
 
@@ -56,3 +59,94 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, saveEvictedTracksDeferred) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    const TrackPointer pTrack = getOrAddTrackByLocation(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+    ASSERT_NE(nullptr, pTrack);
+    const TrackId trackId = pTrack->getId();
+    ASSERT_TRUE(trackId.isValid());
+
+    const QString comment = QStringLiteral("saveEvictedTracksDeferred");
+    pTrack->setComment(comment);
+    ASSERT_TRUE(trackDAO.saveEvictedTrack(pTrack.get()));
+    EXPECT_FALSE(pTrack->isDirty());
+
+    QSqlQuery query(dbConnection());
+    query.prepare("SELECT comment FROM library WHERE id=:id");
+    query.bindValue(":id", trackId.toVariant());
+
+    // Not written yet
+    ASSERT_TRUE(query.exec());
+    ASSERT_TRUE(query.next());
+    EXPECT_NE(comment, query.value(0).toString());
+
+    trackDAO.flushPendingTrackUpdates();
+    ASSERT_TRUE(query.exec());
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(comment, query.value(0).toString());
+}
+
+namespace {
+
+// The in-memory database of the tests is much faster than the
+// journaled database file that is used in production
+constexpr bool kInMemoryDbConnection = false;
+
+class TrackDAOBenchmarkSetup : public LibraryTest {
+  public:
+    TrackDAOBenchmarkSetup()
+            : LibraryTest(kInMemoryDbConnection) {
+    }
+
+    using LibraryTest::getOrAddTrackByLocation;
+    using LibraryTest::internalCollection;
+};
+
+constexpr int kBenchmarkTrackCount = 10000;
+
+// Saves 10k modified tracks either one by one in separate
+// transactions (0) or deferred in batches (1).
+void BM_SaveModifiedTracks(benchmark::State& state) {
+    mixxxtest::BenchmarkFixture<TrackDAOBenchmarkSetup> fixture;
+    TrackDAO& trackDAO = fixture.internalCollection()->getTrackDAO();
+    const bool deferred = state.range(0) != 0;
+
+    // The files only need to exist for adding them
+    QTemporaryDir tempDir;
+    QList<TrackPointer> tracks;
+    tracks.reserve(kBenchmarkTrackCount);
+    for (int i = 0; i < kBenchmarkTrackCount; ++i) {
+        const QString filePath =
+                tempDir.filePath(QStringLiteral("track%1.mp3").arg(i));
+        QFile file(filePath);
+        file.open(QIODevice::WriteOnly);
+        file.close();
+        const auto pTrack = fixture.getOrAddTrackByLocation(filePath);
+        if (!pTrack || !pTrack->getId().isValid()) {
+            state.SkipWithError("Failed to add track");
+            return;
+        }
+        tracks.append(pTrack);
+    }
+
+    int iteration = 0;
+    for (auto _ : state) {
+        const QString comment = QString::number(++iteration);
+        for (const auto& pTrack : std::as_const(tracks)) {
+            pTrack->setComment(comment);
+            if (deferred) {
+                trackDAO.saveEvictedTrack(pTrack.get());
+            } else {
+                trackDAO.saveTrack(pTrack.get());
+            }
+        }
+        trackDAO.flushPendingTrackUpdates();
+    }
+    state.SetItemsProcessed(state.iterations() * kBenchmarkTrackCount);
+}
+BENCHMARK(BM_SaveModifiedTracks)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
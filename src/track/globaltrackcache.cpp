@@ -5,13 +5,34 @@
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
 #include "util/assert.h"
+#include "util/counter.h"
 #include "util/logger.h"
+#include "util/stat.h"
 #include "util/thread_affinity.h"
 
 namespace {
 
 constexpr std::size_t kUnorderedCollectionMinCapacity = 1024;
 
+const QString kStatLockWaitTag =
+        QStringLiteral("GlobalTrackCache lock wait");
+const QString kStatLockHoldTag =
+        QStringLiteral("GlobalTrackCache lock hold");
+const QString kStatLockContendedTag =
+        QStringLiteral("GlobalTrackCache lock contended");
+const QString kStatLookupWithoutLockTag =
+        QStringLiteral("GlobalTrackCache lookup without lock");
+
+constexpr Stat::ComputeFlags kStatDurationComputeFlags =
+        Stat::COUNT | Stat::SUM | Stat::AVERAGE | Stat::MIN | Stat::MAX;
+
+void trackLockDuration(const QString& tag, const PerformanceTimer& timer) {
+    Stat::track(tag,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(kStatDurationComputeFlags),
+            timer.elapsed().toIntegerNanos());
+}
+
 const mixxx::Logger kLogger("GlobalTrackCache");
 
 //static
@@ -99,7 +120,8 @@ GlobalTrackCacheLocker::GlobalTrackCacheLocker()
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker(
         GlobalTrackCacheLocker&& moveable)
-        : m_pInstance(std::move(moveable.m_pInstance)) {
+        : m_pInstance(std::move(moveable.m_pInstance)),
+          m_lockTimer(moveable.m_lockTimer) {
     moveable.m_pInstance = nullptr;
 }
 
@@ -113,7 +135,16 @@ void GlobalTrackCacheLocker::lockCache() {
     if (traceLogEnabled()) {
         kLogger.trace() << "Locking cache";
     }
-    s_pInstance->m_mutex.lock();
+    if (!s_pInstance->m_mutex.tryLock()) {
+        // Only contended locking is measured
+        PerformanceTimer waitTimer;
+        waitTimer.start();
+        s_pInstance->m_mutex.lock();
+        trackLockDuration(kStatLockWaitTag, waitTimer);
+        Counter(kStatLockContendedTag).increment();
+    }
+    ++s_pInstance->m_lockDepth;
+    m_lockTimer.start();
     if (traceLogEnabled()) {
         kLogger.trace() << "Cache is locked";
     }
@@ -128,10 +159,17 @@ void GlobalTrackCacheLocker::unlockCache() {
         if (kLogStats && debugLogEnabled()) {
             kLogger.debug()
                     << "#tracksById ="
-                    << m_pInstance->m_tracksById.size()
+                    << m_pInstance->sizeById()
                     << "/ #tracksByCanonicalLocation ="
-                    << m_pInstance->m_tracksByCanonicalLocation.size();
+                    << m_pInstance->sizeByCanonicalLocation();
+        }
+        DEBUG_ASSERT(m_pInstance->m_lockDepth > 0);
+        if (--m_pInstance->m_lockDepth == 0) {
+            // Newly allocated tracks have been loaded
+            // completely when the cache is unlocked
+            m_pInstance->publishAllocatedEntries();
         }
+        trackLockDuration(kStatLockHoldTag, m_lockTimer);
         m_pInstance->m_mutex.unlock();
         if (traceLogEnabled()) {
             kLogger.trace() << "Cache is unlocked";
@@ -178,6 +216,53 @@ QSet<TrackId> GlobalTrackCacheLocker::getCachedTrackIds() const {
     return m_pInstance->getCachedTrackIds();
 }
 
+//static
+TrackPointer GlobalTrackCacheLookup::lookupTrackById(
+        const TrackId& trackId) {
+    DEBUG_ASSERT(s_pInstance);
+    bool lockRequired = false;
+    auto trackPtr = s_pInstance->lookupAliveById(trackId, &lockRequired);
+    if (trackPtr) {
+        Counter(kStatLookupWithoutLockTag).increment();
+        return trackPtr;
+    }
+    if (!lockRequired) {
+        // Cache miss
+        return trackPtr;
+    }
+    return GlobalTrackCacheLocker().lookupTrackById(trackId);
+}
+
+//static
+TrackPointer GlobalTrackCacheLookup::lookupTrackByRef(
+        const TrackRef& trackRef) {
+    DEBUG_ASSERT(s_pInstance);
+    bool lockRequired = false;
+    if (trackRef.hasId()) {
+        auto trackPtr = s_pInstance->lookupAliveById(trackRef.getId(), &lockRequired);
+        if (trackPtr) {
+            Counter(kStatLookupWithoutLockTag).increment();
+            return trackPtr;
+        }
+    }
+    if (!lockRequired && trackRef.hasCanonicalLocation()) {
+        auto trackPtr = s_pInstance->lookupAliveByCanonicalLocation(
+                trackRef.getCanonicalLocation(), &lockRequired);
+        if (trackPtr) {
+            // Same as GlobalTrackCache::lookupByRef() the track is returned
+            // even if it has a different id due to file system aliasing.
+            validateAndCanonicalizeRequestedTrackRef(trackRef, *trackPtr);
+            Counter(kStatLookupWithoutLockTag).increment();
+            return trackPtr;
+        }
+    }
+    if (!lockRequired) {
+        // Cache miss
+        return TrackPointer();
+    }
+    return GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+}
+
 GlobalTrackCacheResolver::GlobalTrackCacheResolver(
         mixxx::FileAccess fileAccess)
         : m_lookupResult(GlobalTrackCacheLookupResult::None) {
@@ -312,10 +397,15 @@ GlobalTrackCache::GlobalTrackCache(
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
           m_mutex(QMutex::Recursive),
 #endif
+          m_lockDepth(0),
           m_pSaver(pSaver),
-          m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+          m_deleteTrackFn(deleteTrackFn) {
     DEBUG_ASSERT(m_pSaver);
+    for (auto& shard : m_shards) {
+        shard.tracksById = TracksById(
+                kUnorderedCollectionMinCapacity / kShardCount,
+                DbId::hash_fun);
+    }
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
 
@@ -329,49 +419,59 @@ void GlobalTrackCache::relocateTracks(
         kLogger.debug()
                 << "Relocating tracks";
     }
-    TracksByCanonicalLocation relocatedTracksByCanonicalLocation;
-    for (auto&&
-            i = m_tracksByCanonicalLocation.begin();
-            i != m_tracksByCanonicalLocation.end();
-            ++i) {
-        const QString oldCanonicalLocation = i->first;
-        Track* plainPtr = i->second->getPlainPtr();
-        const mixxx::FileInfo fileInfo = plainPtr->getFileInfo();
-        TrackRef trackRef = TrackRef::fromFileInfo(fileInfo, plainPtr->getId());
-        if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
-            auto relocatedFileAccess = pRelocator->relocateCachedTrack(trackRef.getId());
-            if (relocatedFileAccess.info().hasLocation() &&
-                    fileInfo != relocatedFileAccess.info()) {
-                plainPtr->relocate(relocatedFileAccess);
-                trackRef = TrackRef::fromFileInfo(
-                        relocatedFileAccess.info(),
-                        trackRef.getId());
+    std::array<TracksByCanonicalLocation, kShardCount> relocatedTracksByCanonicalLocation;
+    for (const auto& shard : m_shards) {
+        for (auto&&
+                i = shard.tracksByCanonicalLocation.begin();
+                i != shard.tracksByCanonicalLocation.end();
+                ++i) {
+            const QString oldCanonicalLocation = i->first;
+            Track* plainPtr = i->second->getPlainPtr();
+            const mixxx::FileInfo fileInfo = plainPtr->getFileInfo();
+            TrackRef trackRef = TrackRef::fromFileInfo(fileInfo, plainPtr->getId());
+            if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
+                auto relocatedFileAccess = pRelocator->relocateCachedTrack(trackRef.getId());
+                if (relocatedFileAccess.info().hasLocation() &&
+                        fileInfo != relocatedFileAccess.info()) {
+                    plainPtr->relocate(relocatedFileAccess);
+                    trackRef = TrackRef::fromFileInfo(
+                            relocatedFileAccess.info(),
+                            trackRef.getId());
+                }
             }
+            if (!trackRef.hasCanonicalLocation()) {
+                kLogger.warning()
+                        << "Failed to relocate track"
+                        << oldCanonicalLocation
+                        << trackRef;
+                continue;
+            }
+            QString newCanonicalLocation = trackRef.getCanonicalLocation();
+            if (oldCanonicalLocation != newCanonicalLocation && debugLogEnabled()) {
+                kLogger.debug()
+                        << "Relocating track"
+                        << "from" << oldCanonicalLocation
+                        << "to" << newCanonicalLocation;
+            }
+            // The entry might need to be moved into a different shard
+            const auto shardIndex = shardIndexOf(newCanonicalLocation);
+            relocatedTracksByCanonicalLocation[shardIndex].insert(std::make_pair(
+                    std::move(newCanonicalLocation),
+                    i->second));
         }
-        if (!trackRef.hasCanonicalLocation()) {
-            kLogger.warning()
-                    << "Failed to relocate track"
-                    << oldCanonicalLocation
-                    << trackRef;
-            continue;
-        }
-        QString newCanonicalLocation = trackRef.getCanonicalLocation();
-        if (oldCanonicalLocation == newCanonicalLocation) {
-            // Copy the entry unmodified into the new map
-            relocatedTracksByCanonicalLocation.insert(*i);
-            continue;
-        }
-        if (debugLogEnabled()) {
-            kLogger.debug()
-                    << "Relocating track"
-                    << "from" << oldCanonicalLocation
-                    << "to" << newCanonicalLocation;
-        }
-        relocatedTracksByCanonicalLocation.insert(std::make_pair(
-                std::move(newCanonicalLocation),
-                i->second));
     }
-    m_tracksByCanonicalLocation = std::move(relocatedTracksByCanonicalLocation);
+    // Replace the index of all shards at once. Otherwise relocated
+    // tracks might temporarily be invisible for lookups.
+    for (auto& shard : m_shards) {
+        shard.mutex.lock();
+    }
+    for (std::size_t i = 0; i < kShardCount; ++i) {
+        m_shards[i].tracksByCanonicalLocation =
+                std::move(relocatedTracksByCanonicalLocation[i]);
+    }
+    for (auto& shard : m_shards) {
+        shard.mutex.unlock();
+    }
 }
 
 void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
@@ -402,29 +502,43 @@ void GlobalTrackCache::deactivate() {
     // exiting the application.
     kLogger.warning()
             << "Evicting all remaining"
-            << m_tracksById.size()
+            << sizeById()
             << '/'
-            << m_tracksByCanonicalLocation.size()
+            << sizeByCanonicalLocation()
             << "tracks from cache";
 
-    while (!m_tracksById.empty()) {
-        auto i = m_tracksById.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(plainPtr->getFileInfo().canonicalLocation());
-        m_tracksById.erase(i);
+    // The shards must not be locked while saving tracks
+    for (auto& shard : m_shards) {
+        while (!shard.tracksById.empty()) {
+            const auto i = shard.tracksById.begin();
+            const TrackId trackId = i->first;
+            Track* plainPtr = i->second->getPlainPtr();
+            saveEvictedTrack(plainPtr);
+            const QString canonicalLocation =
+                    plainPtr->getFileInfo().canonicalLocation();
+            {
+                Shard& locationShard = shardByCanonicalLocation(canonicalLocation);
+                const auto locker = lockMutex(&locationShard.mutex);
+                locationShard.tracksByCanonicalLocation.erase(canonicalLocation);
+            }
+            const auto locker = lockMutex(&shard.mutex);
+            shard.tracksById.erase(trackId);
+        }
     }
 
-    while (!m_tracksByCanonicalLocation.empty()) {
-        auto i = m_tracksByCanonicalLocation.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(i);
+    for (auto& shard : m_shards) {
+        while (!shard.tracksByCanonicalLocation.empty()) {
+            const auto i = shard.tracksByCanonicalLocation.begin();
+            const QString canonicalLocation = i->first;
+            Track* plainPtr = i->second->getPlainPtr();
+            saveEvictedTrack(plainPtr);
+            const auto locker = lockMutex(&shard.mutex);
+            shard.tracksByCanonicalLocation.erase(canonicalLocation);
+        }
     }
 
     // Verify that all cached tracks have been evicted
-    DEBUG_ASSERT(m_tracksById.empty());
-    DEBUG_ASSERT(m_tracksByCanonicalLocation.empty());
+    DEBUG_ASSERT(isEmpty());
 
     // The singular cache instance is already unavailable and
     // all allocated tracks will simply be deleted when their
@@ -434,22 +548,131 @@ void GlobalTrackCache::deactivate() {
 }
 
 bool GlobalTrackCache::isEmpty() const {
-    return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
+    return sizeById() == 0 && sizeByCanonicalLocation() == 0;
+}
+
+//static
+std::size_t GlobalTrackCache::shardIndexOf(const TrackId& trackId) {
+    return trackId.hash() % kShardCount;
+}
+
+//static
+std::size_t GlobalTrackCache::shardIndexOf(const QString& canonicalLocation) {
+    return qHash(canonicalLocation) % kShardCount;
+}
+
+GlobalTrackCache::Shard& GlobalTrackCache::shardById(
+        const TrackId& trackId) {
+    return m_shards[shardIndexOf(trackId)];
+}
+
+const GlobalTrackCache::Shard& GlobalTrackCache::shardById(
+        const TrackId& trackId) const {
+    return m_shards[shardIndexOf(trackId)];
+}
+
+GlobalTrackCache::Shard& GlobalTrackCache::shardByCanonicalLocation(
+        const QString& canonicalLocation) {
+    return m_shards[shardIndexOf(canonicalLocation)];
+}
+
+const GlobalTrackCache::Shard& GlobalTrackCache::shardByCanonicalLocation(
+        const QString& canonicalLocation) const {
+    return m_shards[shardIndexOf(canonicalLocation)];
+}
+
+GlobalTrackCacheEntryPointer GlobalTrackCache::findById(
+        const TrackId& trackId) const {
+    const Shard& shard = shardById(trackId);
+    const auto locker = lockMutex(&shard.mutex);
+    const auto trackById = shard.tracksById.find(trackId);
+    if (shard.tracksById.end() == trackById) {
+        return nullptr;
+    }
+    return trackById->second;
+}
+
+GlobalTrackCacheEntryPointer GlobalTrackCache::findByCanonicalLocation(
+        const QString& canonicalLocation) const {
+    const Shard& shard = shardByCanonicalLocation(canonicalLocation);
+    const auto locker = lockMutex(&shard.mutex);
+    const auto trackByCanonicalLocation =
+            shard.tracksByCanonicalLocation.find(canonicalLocation);
+    if (shard.tracksByCanonicalLocation.end() == trackByCanonicalLocation) {
+        return nullptr;
+    }
+    return trackByCanonicalLocation->second;
+}
+
+std::size_t GlobalTrackCache::sizeById() const {
+    std::size_t size = 0;
+    for (const auto& shard : m_shards) {
+        size += shard.tracksById.size();
+    }
+    return size;
+}
+
+std::size_t GlobalTrackCache::sizeByCanonicalLocation() const {
+    std::size_t size = 0;
+    for (const auto& shard : m_shards) {
+        size += shard.tracksByCanonicalLocation.size();
+    }
+    return size;
+}
+
+void GlobalTrackCache::publishAllocatedEntries() {
+    for (const auto& cacheEntryWeakPtr : m_allocatedEntries) {
+        const auto cacheEntryPtr = cacheEntryWeakPtr.lock();
+        if (cacheEntryPtr) {
+            cacheEntryPtr->publish();
+        }
+    }
+    m_allocatedEntries.clear();
+}
+
+TrackPointer GlobalTrackCache::lookupAliveById(
+        const TrackId& trackId,
+        bool* pLockRequired) const {
+    DEBUG_ASSERT(pLockRequired);
+    const auto cacheEntryPtr = findById(trackId);
+    if (!cacheEntryPtr) {
+        return nullptr;
+    }
+    auto trackPtr = cacheEntryPtr->lockPublished();
+    if (!trackPtr) {
+        *pLockRequired = true;
+    }
+    return trackPtr;
+}
+
+TrackPointer GlobalTrackCache::lookupAliveByCanonicalLocation(
+        const QString& canonicalLocation,
+        bool* pLockRequired) const {
+    DEBUG_ASSERT(pLockRequired);
+    const auto cacheEntryPtr = findByCanonicalLocation(canonicalLocation);
+    if (!cacheEntryPtr) {
+        return nullptr;
+    }
+    auto trackPtr = cacheEntryPtr->lockPublished();
+    if (!trackPtr) {
+        *pLockRequired = true;
+    }
+    return trackPtr;
 }
 
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
     TrackPointer trackPtr;
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    const auto cacheEntryPtr = findById(trackId);
+    if (cacheEntryPtr) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << trackId
-                    << trackById->second->getPlainPtr();
+                    << cacheEntryPtr->getPlainPtr();
         }
-        trackPtr = revive(trackById->second);
+        trackPtr = revive(cacheEntryPtr);
         DEBUG_ASSERT(trackPtr);
     } else {
         // Cache miss
@@ -488,17 +711,16 @@ TrackPointer GlobalTrackCache::lookupByRef(
 TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
         const QString& canonicalLocation) {
     TrackPointer trackPtr;
-    const auto trackByCanonicalLocation(
-            m_tracksByCanonicalLocation.find(canonicalLocation));
-    if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+    const auto cacheEntryPtr = findByCanonicalLocation(canonicalLocation);
+    if (cacheEntryPtr) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << canonicalLocation
-                    << trackByCanonicalLocation->second->getPlainPtr();
+                    << cacheEntryPtr->getPlainPtr();
         }
-        trackPtr = revive(trackByCanonicalLocation->second);
+        trackPtr = revive(cacheEntryPtr);
         DEBUG_ASSERT(trackPtr);
     } else {
         // Cache miss
@@ -513,8 +735,10 @@ TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
 
 QSet<TrackId> GlobalTrackCache::getCachedTrackIds() const {
     QSet<TrackId> trackIds;
-    for (const auto& entry : m_tracksById) {
-        trackIds << entry.first;
+    for (const auto& shard : m_shards) {
+        for (const auto& entry : shard.tracksById) {
+            trackIds << entry.first;
+        }
     }
     return trackIds;
 }
@@ -652,30 +876,40 @@ void GlobalTrackCache::resolve(
                 << deletingPtr.get();
     }
 
+    // Track objects live together with the cache on the main thread
+    // and will be deleted later within the event loop. But this
+    // function might be called from any thread, even from worker
+    // threads without an event loop. We need to move the newly
+    // created object to the main thread before it becomes visible
+    // for other threads.
+    savingPtr->moveToThread(QCoreApplication::instance()->thread());
+
+    // The new track is still empty and must not be accessed by
+    // lookups without locking the cache until it has been loaded.
+    m_allocatedEntries.push_back(cacheEntryPtr);
+
     if (trackRef.hasId()) {
         // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
+        Shard& shard = shardById(trackRef.getId());
+        const auto locker = lockMutex(&shard.mutex);
+        DEBUG_ASSERT(shard.tracksById.find(
+                trackRef.getId()) == shard.tracksById.end());
+        shard.tracksById.insert(std::make_pair(
                 trackRef.getId(),
                 cacheEntryPtr));
     }
     if (trackRef.hasCanonicalLocation()) {
         // Insert item by track location
-        DEBUG_ASSERT(m_tracksByCanonicalLocation.find(
-                trackRef.getCanonicalLocation()) == m_tracksByCanonicalLocation.end());
-        m_tracksByCanonicalLocation.insert(std::make_pair(
+        Shard& shard = shardByCanonicalLocation(trackRef.getCanonicalLocation());
+        const auto locker = lockMutex(&shard.mutex);
+        DEBUG_ASSERT(shard.tracksByCanonicalLocation.find(
+                trackRef.getCanonicalLocation()) ==
+                shard.tracksByCanonicalLocation.end());
+        shard.tracksByCanonicalLocation.insert(std::make_pair(
                 trackRef.getCanonicalLocation(),
                 cacheEntryPtr));
     }
 
-    // Track objects live together with the cache on the main thread
-    // and will be deleted later within the event loop. But this
-    // function might be called from any thread, even from worker
-    // threads without an event loop. We need to move the newly
-    // created object to the main thread.
-    savingPtr->moveToThread(QCoreApplication::instance()->thread());
-
     pCacheResolver->initLookupResult(
             GlobalTrackCacheLookupResult::Miss,
             std::move(savingPtr),
@@ -695,15 +929,21 @@ TrackRef GlobalTrackCache::initTrackId(
     EvictAndSaveFunctor* pDel = std::get_deleter<EvictAndSaveFunctor>(strongPtr);
     DEBUG_ASSERT(pDel);
 
-    // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
-            trackId,
-            pDel->getCacheEntryPointer()));
-
+    // The id must be initialized before the track becomes
+    // visible for lookups by id without locking the cache.
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
+
+    // Insert item by id
+    {
+        Shard& shard = shardById(trackId);
+        const auto locker = lockMutex(&shard.mutex);
+        DEBUG_ASSERT(shard.tracksById.find(trackId) == shard.tracksById.end());
+        shard.tracksById.insert(std::make_pair(
+                trackId,
+                pDel->getCacheEntryPointer()));
+    }
+    DEBUG_ASSERT(findById(trackId));
 
     return trackRefWithId;
 }
@@ -711,12 +951,18 @@ TrackRef GlobalTrackCache::initTrackId(
 void GlobalTrackCache::purgeTrackId(TrackId trackId) {
     DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
-        Track* track = trackById->second->getPlainPtr();
-        track->resetId();
-        m_tracksById.erase(trackById);
+    Shard& shard = shardById(trackId);
+    GlobalTrackCacheEntryPointer cacheEntryPtr;
+    {
+        const auto locker = lockMutex(&shard.mutex);
+        const auto trackById = shard.tracksById.find(trackId);
+        if (shard.tracksById.end() == trackById) {
+            return;
+        }
+        cacheEntryPtr = trackById->second;
+        shard.tracksById.erase(trackById);
     }
+    cacheEntryPtr->getPlainPtr()->resetId();
 }
 
 void GlobalTrackCache::slotEvictAndSave(
@@ -782,10 +1028,12 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
+        Shard& shard = shardById(trackRef.getId());
+        const auto locker = lockMutex(&shard.mutex);
+        const auto trackById = shard.tracksById.find(trackRef.getId());
+        if (trackById != shard.tracksById.end()) {
             if (trackById->second->getPlainPtr() == plainPtr) {
-                m_tracksById.erase(trackById);
+                shard.tracksById.erase(trackById);
                 evicted = true;
             } else {
                 notEvicted = true;
@@ -793,11 +1041,13 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
         }
     }
     if (trackRef.hasCanonicalLocation()) {
+        Shard& shard = shardByCanonicalLocation(trackRef.getCanonicalLocation());
+        const auto locker = lockMutex(&shard.mutex);
         const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+                shard.tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
+        if (shard.tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
             if (trackByCanonicalLocation->second->getPlainPtr() == plainPtr) {
-                m_tracksByCanonicalLocation.erase(
+                shard.tracksByCanonicalLocation.erase(
                         trackByCanonicalLocation);
                 evicted = true;
             } else {
@@ -812,14 +1062,16 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
 }
 
 bool GlobalTrackCache::isCached(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return true;
+    for (const auto& shard : m_shards) {
+        for (auto&& entry : shard.tracksById) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
-    }
-    for (auto&& entry: m_tracksByCanonicalLocation) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-              return true;
+        for (auto&& entry : shard.tracksByCanonicalLocation) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
     return false;
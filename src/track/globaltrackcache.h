@@ -1,12 +1,16 @@
 #pragma once
 
+#include <QMutex>
+#include <array>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "track/track_decl.h"
 #include "track/trackref.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
+#include "util/performancetimer.h"
 #include "util/sandbox.h"
 
 // forward declaration(s)
@@ -55,31 +59,57 @@ class GlobalTrackCacheEntry final {
 
     explicit GlobalTrackCacheEntry(
             std::unique_ptr<Track, TrackDeleter> deletingPtr)
-        : m_deletingPtr(std::move(deletingPtr)) {
+        : m_deletingPtr(std::move(deletingPtr)),
+          m_published(false) {
     }
     GlobalTrackCacheEntry(const GlobalTrackCacheEntry& other) = delete;
     GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = default;
 
     void init(TrackWeakPointer savingWeakPtr) {
+        const auto locker = lockMutex(&m_mutex);
         // Uninitialized or expired
         DEBUG_ASSERT(!m_savingWeakPtr.lock());
         m_savingWeakPtr = std::move(savingWeakPtr);
     }
 
+    /// Newly allocated tracks are only published after the
+    /// cache has been unlocked and the track has been loaded.
+    void publish() {
+        const auto locker = lockMutex(&m_mutex);
+        m_published = true;
+    }
+
     Track* getPlainPtr() const {
         return m_deletingPtr.get();
     }
 
     TrackPointer lock() const {
+        const auto locker = lockMutex(&m_mutex);
         return m_savingWeakPtr.lock();
     }
     bool expired() const {
+        const auto locker = lockMutex(&m_mutex);
         return m_savingWeakPtr.expired();
     }
 
+    /// Returns nullptr if the track is either expired or not
+    /// published yet.
+    TrackPointer lockPublished() const {
+        const auto locker = lockMutex(&m_mutex);
+        if (!m_published) {
+            return nullptr;
+        }
+        return m_savingWeakPtr.lock();
+    }
+
   private:
     std::unique_ptr<Track, TrackDeleter> m_deletingPtr;
+
+    // Accessed concurrently by lookups that don't lock
+    // the whole cache, see GlobalTrackCacheLookup.
+    mutable QMutex m_mutex;
     TrackWeakPointer m_savingWeakPtr;
+    bool m_published;
 };
 
 typedef std::shared_ptr<GlobalTrackCacheEntry> GlobalTrackCacheEntryPointer;
@@ -127,6 +157,28 @@ protected:
             TrackRef&& trackRef);
 
     GlobalTrackCache* m_pInstance;
+
+    // Measures how long the cache is locked
+    PerformanceTimer m_lockTimer;
+};
+
+/// Lookup of cached tracks without locking the whole cache.
+///
+/// The cache indices are split into shards with separate locks.
+/// Tracks that are currently referenced are found by only locking
+/// a single shard. Otherwise these functions fall back to the
+/// corresponding functions of GlobalTrackCacheLocker, because
+/// reviving a track that is about to be evicted requires exclusive
+/// access to the cache.
+///
+/// Use these functions if the cache doesn't need to remain locked
+/// after the lookup, i.e. instead of GlobalTrackCacheLocker().lookupTrackById().
+class GlobalTrackCacheLookup final {
+  public:
+    static TrackPointer lookupTrackById(
+            const TrackId& trackId);
+    static TrackPointer lookupTrackByRef(
+            const TrackRef& trackRef);
 };
 
 class GlobalTrackCacheResolver final: public GlobalTrackCacheLocker {
@@ -226,6 +278,7 @@ class GlobalTrackCache : public QObject {
 
   private:
     friend class GlobalTrackCacheLocker;
+    friend class GlobalTrackCacheLookup;
     friend class GlobalTrackCacheResolver;
 
     GlobalTrackCache(
@@ -250,6 +303,17 @@ class GlobalTrackCache : public QObject {
 
     QSet<TrackId> getCachedTrackIds() const;
 
+    // Lookup without locking the whole cache. Only returns tracks
+    // that are alive and published. The out parameter is set if
+    // a track has been found that could only be accessed while
+    // the whole cache is locked.
+    TrackPointer lookupAliveById(
+            const TrackId& trackId,
+            bool* pLockRequired) const;
+    TrackPointer lookupAliveByCanonicalLocation(
+            const QString& canonicalLocation,
+            bool* pLockRequired) const;
+
     TrackPointer revive(GlobalTrackCacheEntryPointer entryPtr);
 
     void resolve(
@@ -273,8 +337,14 @@ class GlobalTrackCache : public QObject {
 
     void saveEvictedTrack(Track* pEvictedTrack) const;
 
+    void publishAllocatedEntries();
+
     // Managed by GlobalTrackCacheLocker
     mutable QT_RECURSIVE_MUTEX m_mutex;
+    int m_lockDepth;
+
+    // Entries that have been allocated while the cache is locked
+    std::vector<std::weak_ptr<GlobalTrackCacheEntry>> m_allocatedEntries;
 
     GlobalTrackCacheSaver* m_pSaver;
 
@@ -282,9 +352,37 @@ class GlobalTrackCache : public QObject {
 
     // This caches the unsaved Tracks by ID
     typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
-    TracksById m_tracksById;
 
     // This caches the unsaved Tracks by location
     typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
-    TracksByCanonicalLocation m_tracksByCanonicalLocation;
+
+    // Both indices are split into shards. The shard of an entry is
+    // determined by its key, i.e. the id and the canonical location
+    // of a track are usually stored in different shards.
+    //
+    // Modifying a shard requires to lock both the whole cache and the
+    // shard. Reading a shard requires to lock either the whole cache or
+    // the shard. This allows lookups without locking the whole cache.
+    struct Shard {
+        mutable QMutex mutex;
+        TracksById tracksById;
+        TracksByCanonicalLocation tracksByCanonicalLocation;
+    };
+    static constexpr std::size_t kShardCount = 16;
+    std::array<Shard, kShardCount> m_shards;
+
+    static std::size_t shardIndexOf(const TrackId& trackId);
+    static std::size_t shardIndexOf(const QString& canonicalLocation);
+    Shard& shardById(const TrackId& trackId);
+    const Shard& shardById(const TrackId& trackId) const;
+    Shard& shardByCanonicalLocation(const QString& canonicalLocation);
+    const Shard& shardByCanonicalLocation(const QString& canonicalLocation) const;
+
+    GlobalTrackCacheEntryPointer findById(
+            const TrackId& trackId) const;
+    GlobalTrackCacheEntryPointer findByCanonicalLocation(
+            const QString& canonicalLocation) const;
+
+    std::size_t sizeById() const;
+    std::size_t sizeByCanonicalLocation() const;
 };
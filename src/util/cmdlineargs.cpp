@@ -208,6 +208,17 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(controllerAbortOnWarning);
 
+    const QCommandLineOption controllerRecordPath(
+            QStringLiteral("controller-record-path"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Directory the raw input of all controllers "
+                                      "is recorded to with timestamps. The "
+                                      "recordings can be replayed by the "
+                                      "controller benchmarks.")
+                            : QString(),
+            QStringLiteral("path"));
+    parser.addOption(controllerRecordPath);
+
     const QCommandLineOption developer(QStringLiteral("developer"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Enables developer-mode. Includes extra log info, stats on "
@@ -345,6 +356,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(controllerRecordPath)) {
+        m_controllerRecordPath = parser.value(controllerRecordPath);
+    }
+
     m_useLegacyVuMeter = parser.isSet(enableLegacyVuMeter);
     m_useLegacySpinny = parser.isSet(enableLegacySpinny);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
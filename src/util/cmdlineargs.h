@@ -60,6 +60,9 @@ class CmdlineArgs final {
     }
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
+    const QString& getControllerRecordPath() const {
+        return m_controllerRecordPath;
+    }
 
     void setScaleFactor(double scaleFactor) {
         m_scaleFactor = scaleFactor;
@@ -95,4 +98,5 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_controllerRecordPath;
 };
@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -317,13 +318,15 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_pragmas(params.pragmas) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_pragmas(prototype.m_pragmas) {
 }
 
 DbConnection::~DbConnection() {
@@ -351,6 +354,18 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    for (const auto& pragma : std::as_const(m_pragmas)) {
+        QSqlQuery query(m_sqlDatabase);
+        if (!query.exec(QStringLiteral("PRAGMA ") + pragma)) {
+            // Only affects performance and is not critical
+            kLogger.warning()
+                    << "Failed to execute"
+                    << query.lastQuery()
+                    << "on database connection"
+                    << *this
+                    << query.lastError();
+        }
+    }
     return true;
 }
 
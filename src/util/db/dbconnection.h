@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QtDebug>
 
 #include "util/string.h"
@@ -29,6 +30,9 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        // Executed as "PRAGMA <pragma>" after opening each
+        // connection, e.g. "synchronous = NORMAL" (SQLite3)
+        QStringList pragmas;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -62,6 +66,7 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    QStringList m_pragmas;
     mixxx::StringCollator m_collator;
 };
 
@@ -0,0 +1,135 @@
+#include "util/disklrueviction.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DiskLruEviction");
+
+// The precision of the last use
+constexpr qint64 kTouchIntervalSeconds = 10 * 60;
+
+// Eviction deletes files until the total size drops below this
+// fraction of the limit
+constexpr qint64 kEvictionTargetNumerator = 7;
+constexpr qint64 kEvictionTargetDenominator = 8;
+
+} // anonymous namespace
+
+DiskLruEviction::DiskLruEviction(
+        QString rootPath,
+        QString fileSuffix,
+        qint64 maxSizeInBytes)
+        : m_rootPath(std::move(rootPath)),
+          m_fileSuffix(std::move(fileSuffix)),
+          m_maxSizeInBytes(maxSizeInBytes),
+          m_totalSizeInBytes(-1),
+          m_evicting(false) {
+    DEBUG_ASSERT(!m_rootPath.isEmpty());
+    DEBUG_ASSERT(m_maxSizeInBytes > 0);
+}
+
+//static
+void DiskLruEviction::touch(
+        const QString& filePath) {
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (QFileInfo(filePath).lastModified().secsTo(now) < kTouchIntervalSeconds) {
+        return;
+    }
+    setLastUsed(filePath, now);
+}
+
+//static
+bool DiskLruEviction::setLastUsed(
+        const QString& filePath,
+        const QDateTime& lastUsed) {
+    // Appending doesn't modify the contents of the file
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    return file.setFileTime(lastUsed, QFileDevice::FileModificationTime);
+}
+
+void DiskLruEviction::fileStored(
+        qint64 sizeInBytes) {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        if (m_totalSizeInBytes >= 0) {
+            m_totalSizeInBytes += sizeInBytes;
+            if (m_totalSizeInBytes <= m_maxSizeInBytes) {
+                return;
+            }
+        }
+        if (m_evicting) {
+            return;
+        }
+        m_evicting = true;
+    }
+    evictUntil(m_maxSizeInBytes / kEvictionTargetDenominator *
+            kEvictionTargetNumerator);
+}
+
+void DiskLruEviction::evict() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        if (m_evicting) {
+            return;
+        }
+        m_evicting = true;
+    }
+    evictUntil(m_maxSizeInBytes);
+}
+
+void DiskLruEviction::evictUntil(
+        qint64 targetSizeInBytes) {
+    std::vector<QFileInfo> fileInfos;
+    qint64 totalSizeInBytes = 0;
+    QDirIterator it(m_rootPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        if (fileInfo.suffix() != m_fileSuffix) {
+            continue;
+        }
+        totalSizeInBytes += fileInfo.size();
+        fileInfos.push_back(fileInfo);
+    }
+    if (totalSizeInBytes > m_maxSizeInBytes) {
+        std::sort(fileInfos.begin(),
+                fileInfos.end(),
+                [](const QFileInfo& lhs, const QFileInfo& rhs) {
+                    return lhs.lastModified() < rhs.lastModified();
+                });
+        int evictedCount = 0;
+        for (const auto& fileInfo : fileInfos) {
+            if (totalSizeInBytes <= targetSizeInBytes) {
+                break;
+            }
+            if (QFile::remove(fileInfo.absoluteFilePath())) {
+                totalSizeInBytes -= fileInfo.size();
+                ++evictedCount;
+            }
+        }
+        kLogger.info()
+                << "Evicted"
+                << evictedCount
+                << "files from"
+                << m_rootPath;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    m_totalSizeInBytes = totalSizeInBytes;
+    m_evicting = false;
+}
+
+} // namespace mixxx
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+namespace mixxx {
+
+/// Limits the total size of the files in a directory tree, e.g. of a
+/// persistent cache, by deleting the least recently used files.
+///
+/// The modification time of a file reflects its last use. Reading a
+/// file only updates it occasionally, see touch(). Only files with the
+/// given suffix are considered, i.e. temporary files of QSaveFile are
+/// ignored.
+///
+/// The total size is estimated from the stored files. The directory is
+/// only scanned when the estimate exceeds the limit and then files are
+/// deleted until the total size drops below a lower threshold. This
+/// leaves some room for storing more files before scanning again.
+///
+/// All functions are thread-safe.
+class DiskLruEviction final {
+  public:
+    /// An empty suffix selects all files without a suffix.
+    DiskLruEviction(
+            QString rootPath,
+            QString fileSuffix,
+            qint64 maxSizeInBytes);
+
+    const QString& rootPath() const {
+        return m_rootPath;
+    }
+    qint64 maxSizeInBytes() const {
+        return m_maxSizeInBytes;
+    }
+
+    /// Marks a file as recently used. The modification time is only
+    /// updated if it is older than a few minutes to avoid writing the
+    /// metadata of a file whenever it is read.
+    static void touch(
+            const QString& filePath);
+
+    /// Updates the modification time through a writable handle, which
+    /// is required on Windows.
+    static bool setLastUsed(
+            const QString& filePath,
+            const QDateTime& lastUsed);
+
+    /// Must be called after a file has been stored. Deletes the least
+    /// recently used files if the estimated total size exceeds the limit.
+    void fileStored(
+            qint64 sizeInBytes);
+
+    /// Deletes the least recently used files until the total size no
+    /// longer exceeds the limit.
+    void evict();
+
+  private:
+    void evictUntil(
+            qint64 targetSizeInBytes);
+
+    const QString m_rootPath;
+    const QString m_fileSuffix;
+    const qint64 m_maxSizeInBytes;
+
+    // Guards the estimated total size, but not the directory walk
+    QMutex m_mutex;
+    // Unknown until the directory has been scanned
+    qint64 m_totalSizeInBytes;
+    bool m_evicting;
+};
+
+} // namespace mixxx
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 
 #include "engine/engine.h"
 #include "util/math.h"
@@ -585,13 +586,19 @@ void SampleUtil::mixMultichannelToMono(CSAMPLE* pDest, const CSAMPLE* pSrc, SINT
 
 // static
 void SampleUtil::doubleMonoToDualMono(CSAMPLE* pBuffer, SINT numFrames) {
-    // backward loop
-    SINT i = numFrames;
-    // not vectorized: vector version will never be profitable.
-    while (0 < i--) {
-        const CSAMPLE s = pBuffer[i];
-        pBuffer[i * 2] = s;
-        pBuffer[i * 2 + 1] = s;
+    // Backward loop over blocks. Each block of mono samples is copied
+    // aside before being expanded, because the first blocks overlap
+    // with their own output. Preceding blocks are never overwritten.
+    // This allows to use the vectorized copyMonoToDualMono().
+    constexpr SINT kBlockFrames = 64;
+    CSAMPLE block[kBlockFrames];
+    SINT blockEnd = numFrames;
+    while (blockEnd > 0) {
+        const SINT blockStart = math_max(blockEnd - kBlockFrames, SINT(0));
+        const SINT blockFrames = blockEnd - blockStart;
+        std::memcpy(block, pBuffer + blockStart, blockFrames * sizeof(CSAMPLE));
+        copyMonoToDualMono(pBuffer + blockStart * 2, block, blockFrames);
+        blockEnd = blockStart;
     }
 }
 
@@ -34,6 +34,7 @@
 #include "preferences/colorpalettesettings.h"
 #include "preferences/configobject.h"
 #include "preferences/dialog/dlgprefdeck.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/defs.h"
@@ -1977,6 +1978,9 @@ class RemoveTrackFilesFromDiskTrackPointerOperation : public mixxx::TrackPointer
             return;
         }
         QString location = pTrack->getLocation();
+        // A pooled source keeps the file open, which prevents deleting
+        // it on Windows
+        mixxx::SoundSourcePool::evict(location);
         QFile file(location);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
         if (file.exists() && !file.moveToTrash()) {
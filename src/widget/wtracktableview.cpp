@@ -2,6 +2,7 @@
 
 #include <QDrag>
 #include <QModelIndex>
+#include <QPointer>
 #include <QScrollBar>
 #include <QShortcut>
 #include <QUrl>
@@ -523,25 +524,42 @@ void WTrackTableView::onSearch(const QString& text) {
         QList<TrackId> selectedTracks = getSelectedTrackIds();
         TrackId prevTrack = getCurrentTrackId();
         saveCurrentIndex();
-        trackModel->search(text);
-        if (queryIsLessSpecific) {
-            // If the user removed query terms, we try to select the same
-            // tracks as before
-            setCurrentTrackId(prevTrack, m_prevColumn);
-            setSelectedTracks(selectedTracks);
-        } else {
-            // The user created a more specific search query, try to restore a
-            // previous state
-            if (!restoreCurrentViewState()) {
-                // We found no saved state for this query, try to select the
-                // tracks last active, if they are part of the result set
-                if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
-                    // if the last focused track is not present try to focus the
-                    // respective index and scroll there
-                    restoreCurrentIndex();
-                }
-                setSelectedTracks(selectedTracks);
+        // The rows might be replaced asynchronously after returning and
+        // the view could have been destroyed or switched to a different
+        // model in the meantime.
+        QPointer<WTrackTableView> pThis(this);
+        trackModel->searchAsync(text,
+                [pThis, trackModel, queryIsLessSpecific, selectedTracks, prevTrack]() {
+                    if (!pThis || pThis->getTrackModel() != trackModel) {
+                        return;
+                    }
+                    pThis->restoreStateAfterSearch(
+                            queryIsLessSpecific, selectedTracks, prevTrack);
+                });
+    }
+}
+
+void WTrackTableView::restoreStateAfterSearch(
+        bool queryIsLessSpecific,
+        const QList<TrackId>& selectedTracks,
+        TrackId prevTrack) {
+    if (queryIsLessSpecific) {
+        // If the user removed query terms, we try to select the same
+        // tracks as before
+        setCurrentTrackId(prevTrack, m_prevColumn);
+        setSelectedTracks(selectedTracks);
+    } else {
+        // The user created a more specific search query, try to restore a
+        // previous state
+        if (!restoreCurrentViewState()) {
+            // We found no saved state for this query, try to select the
+            // tracks last active, if they are part of the result set
+            if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
+                // if the last focused track is not present try to focus the
+                // respective index and scroll there
+                restoreCurrentIndex();
             }
+            setSelectedTracks(selectedTracks);
         }
     }
 }
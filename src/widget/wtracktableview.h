@@ -116,6 +116,13 @@ class WTrackTableView : public WLibraryTableView {
 
     void hideOrRemoveSelectedTracks();
 
+    // Restores the selection and current index after the results
+    // of a search have become available.
+    void restoreStateAfterSearch(
+            bool queryIsLessSpecific,
+            const QList<TrackId>& selectedTracks,
+            TrackId prevTrack);
+
     const UserSettingsPointer m_pConfig;
     Library* const m_pLibrary;
 
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Generates the synthesized DDJ-400 session that is replayed by the
+controller replay benchmarks, see src/test/controllerreplaybenchmark.cpp.
+
+The session touches the most frequently used controls of the mapping:
+play buttons, the channel fader, the crossfader, scratching with the jog
+wheels, the tempo slider, and nudging with the jog wheel rings. The number
+of jog wheel ticks per scratch determines the length of the session. The
+output is deterministic for the same arguments.
+
+Example:
+    tools/generate_controller_input_recording.py \
+        --scratch-ticks 32 --fader-steps 8 \
+        src/test/controller-input-recordings/Pioneer-DDJ-400.controllerinput
+"""
+
+import argparse
+import random
+import sys
+
+# Interval between two jog wheel ticks while scratching
+JOG_TICK_INTERVAL_US = 1000
+# Interval between two jog wheel ring ticks while nudging
+NUDGE_TICK_INTERVAL_US = 2000
+# Interval between two positions of a fader or slider
+FADER_STEP_INTERVAL_US = 4200
+
+
+class Session:
+    def __init__(self):
+        self.events = []
+        self.timestamp_us = 0
+
+    def message(self, *data, delay_us=0):
+        self.timestamp_us += delay_us
+        self.events.append((self.timestamp_us, data))
+
+    def press(self, status, control, hold_us, delay_us=0):
+        self.message(status, control, 0x7F, delay_us=delay_us)
+        self.message(status, control, 0x00, delay_us=hold_us)
+
+    def move_14bit(self, status, msb_control, lsb_control, values):
+        # The LSB is sent after the MSB of each position
+        for value in values:
+            self.message(
+                status, msb_control, value, delay_us=FADER_STEP_INTERVAL_US
+            )
+            self.message(status, lsb_control, 0x00, delay_us=200)
+
+    def scratch(self, deck, ticks, rng):
+        touch_status = 0x90 + deck
+        jog_status = 0xB0 + deck
+        self.message(touch_status, 0x36, 0x7F, delay_us=100000)
+        for _ in range(ticks):
+            # Relative movement around 0x40 in both directions
+            value = rng.choice([0x3D, 0x3E, 0x3F, 0x41, 0x42, 0x43, 0x44])
+            self.message(
+                jog_status, 0x22, value, delay_us=JOG_TICK_INTERVAL_US
+            )
+        self.message(touch_status, 0x36, 0x00, delay_us=100000)
+
+    def tempo(self, deck, values):
+        status = 0xB0 + deck
+        for msb, lsb in values:
+            self.message(status, 0x00, msb, delay_us=8000)
+            self.message(status, 0x20, lsb, delay_us=300)
+
+    def nudge(self, deck, ticks):
+        status = 0xB0 + deck
+        for _ in range(ticks):
+            self.message(status, 0x21, 0x41, delay_us=NUDGE_TICK_INTERVAL_US)
+
+    def write(self, out):
+        out.write("# Mixxx controller input recording\n")
+        out.write("# controller: DDJ-400 MIDI 1\n")
+        out.write("# mapping: Pioneer-DDJ-400.midi.xml\n")
+        out.write(
+            "# Synthesized session: play, volume and crossfader moves, "
+            "scratching on both decks, tempo changes and nudging\n"
+        )
+        out.write(
+            "# Generated by tools/generate_controller_input_recording.py\n"
+        )
+        for timestamp_us, data in self.events:
+            hex_data = " ".join(f"{byte:02x}" for byte in data)
+            out.write(f"{timestamp_us} {hex_data}\n")
+
+
+def generate(scratch_ticks, fader_steps, seed):
+    rng = random.Random(seed)
+    session = Session()
+    fader_values = [
+        min(i * 128 // fader_steps, 0x7F) for i in range(fader_steps)
+    ]
+    tempo_values = [
+        (0x40 - (i % 2), rng.randrange(0x80)) for i in range(fader_steps)
+    ]
+    session.press(0x90, 0x0B, hold_us=90000)
+    # Channel fader and crossfader
+    session.move_14bit(0xB0, 0x13, 0x33, fader_values)
+    session.move_14bit(0xB6, 0x1F, 0x3F, fader_values)
+    session.scratch(0, scratch_ticks, rng)
+    session.scratch(1, scratch_ticks, rng)
+    session.tempo(1, tempo_values)
+    session.nudge(1, scratch_ticks // 4)
+    session.press(0x91, 0x0B, hold_us=80000, delay_us=100000)
+    return session
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description=__doc__.strip().splitlines()[0]
+    )
+    parser.add_argument(
+        "--scratch-ticks",
+        type=int,
+        default=600,
+        help="Number of jog wheel ticks per scratch (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--fader-steps",
+        type=int,
+        default=32,
+        help="Number of positions per fader move (default: %(default)s)",
+    )
+    parser.add_argument("--seed", type=int, default=400)
+    parser.add_argument(
+        "output",
+        nargs="?",
+        type=argparse.FileType("w"),
+        default=sys.stdout,
+    )
+    args = parser.parse_args(argv)
+    session = generate(args.scratch_ticks, args.fader_steps, args.seed)
+    session.write(args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())